@@ -2520,7 +2520,9 @@ void ControllerDialog::on_mergeXYViewButton_clicked()
 
 void ControllerDialog::on_mergesViewButton_clicked()
 {
-    ViewDialog dialog(((PublicFastTable*)mFastTableWidget)->getMerges(), this);
+    QList<QRect> aList=((PublicFastTable*)mFastTableWidget)->getSpans()->spans();
+
+    ViewDialog dialog(&aList, this);
     dialog.exec();
 }
 
@@ -2568,7 +2570,9 @@ void ControllerDialog::on_horizontalMergeXYViewButton_clicked()
 
 void ControllerDialog::on_horizontalMergesViewButton_clicked()
 {
-    ViewDialog dialog(((PublicFastTable*)mFastTableWidget)->horizontalHeader_GetMerges(), this);
+    QList<QRect> aList=((PublicFastTable*)mFastTableWidget)->horizontalHeader_GetSpans()->spans();
+
+    ViewDialog dialog(&aList, this);
     dialog.exec();
 }
 
@@ -2616,7 +2620,9 @@ void ControllerDialog::on_verticalMergeXYViewButton_clicked()
 
 void ControllerDialog::on_verticalMergesViewButton_clicked()
 {
-    ViewDialog dialog(((PublicFastTable*)mFastTableWidget)->verticalHeader_GetMerges(), this);
+    QList<QRect> aList=((PublicFastTable*)mFastTableWidget)->verticalHeader_GetSpans()->spans();
+
+    ViewDialog dialog(&aList, this);
     dialog.exec();
 }
 
@@ -0,0 +1,287 @@
+#include "asyncdataprovider.h"
+
+#include "fastdefines.h"
+
+AsyncDataThread::AsyncDataThread(AsyncDataProvider *provider) :
+    QThread()
+{
+    mProvider=provider;
+}
+
+void AsyncDataThread::run()
+{
+    mProvider->processRequests();
+}
+
+//------------------------------------------------------------------------------
+
+AsyncDataProvider::AsyncDataProvider(const int blockSize, QObject *parent) :
+    QObject(parent),
+    mCache(blockSize)
+{
+    FASTTABLE_ASSERT(blockSize>0);
+
+    mBlockSize=blockSize;
+    mPrefetchBlocks=2;
+    mLastFirstRow=-1;
+    mDirection=1;
+
+    mLoadingBlock=-1;
+    mLoadingValid=false;
+    mRowCount=0;
+    mStopped=false;
+
+    mThread=new AsyncDataThread(this);
+}
+
+AsyncDataProvider::~AsyncDataProvider()
+{
+    // Too late to stop here, loadRows() of destroyed subclass could be running
+    FASTTABLE_ASSERT(!mThread->isRunning());
+
+    delete mThread;
+}
+
+int AsyncDataProvider::blockSize() const
+{
+    return mBlockSize;
+}
+
+int AsyncDataProvider::prefetchBlocks() const
+{
+    return mPrefetchBlocks;
+}
+
+void AsyncDataProvider::setPrefetchBlocks(const int count)
+{
+    FASTTABLE_ASSERT(count>=0);
+
+    mPrefetchBlocks=count;
+}
+
+void AsyncDataProvider::requestRows(const int first, const int last, const int rowCount)
+{
+    FASTTABLE_ASSERT(first>=0 && first<=last && last<rowCount);
+
+    // Direction is kept while the first row is not changed (horizontal scrolling)
+    if (mLastFirstRow>=0 && first!=mLastFirstRow)
+    {
+        mDirection=first>mLastFirstRow ? 1 : -1;
+    }
+
+    mLastFirstRow=first;
+
+    int aFirstBlock=first/mBlockSize;
+    int aLastBlock=last/mBlockSize;
+    int aMaxBlock=(rowCount-1)/mBlockSize;
+
+    QList<int> aWanted;
+
+    for (int i=aFirstBlock; i<=aLastBlock; ++i)
+    {
+        aWanted.append(i);
+    }
+
+    for (int i=1; i<=mPrefetchBlocks; ++i)
+    {
+        int aBlock=mDirection>0 ? aLastBlock+i : aFirstBlock-i;
+
+        if (aBlock>=0 && aBlock<=aMaxBlock)
+        {
+            aWanted.append(aBlock);
+        }
+    }
+
+    // One block behind is kept to scroll back without placeholders
+    if (mDirection>0 && aFirstBlock>0)
+    {
+        aWanted.append(aFirstBlock-1);
+    }
+    else
+    if (mDirection<0 && aLastBlock<aMaxBlock)
+    {
+        aWanted.append(aLastBlock+1);
+    }
+
+    // Other blocks are evicted by cache when budget is exceeded
+    mCache.setPinnedRows(first, last);
+
+    QMutexLocker aLocker(&mMutex);
+
+    mRowCount=rowCount;
+
+    // Pending requests are replaced, so blocks of the old scroll position are not loaded
+    mPending.clear();
+
+    for (int i=0; i<aWanted.length(); ++i)
+    {
+        int aBlock=aWanted.at(i);
+
+        if (mCache.contains(aBlock) || (aBlock==mLoadingBlock && mLoadingValid))
+        {
+            continue;
+        }
+
+        bool aReady=false;
+
+        for (int j=0; j<mReady.length(); ++j)
+        {
+            if (mReady.at(j).first==aBlock)
+            {
+                aReady=true;
+                break;
+            }
+        }
+
+        if (!aReady)
+        {
+            mPending.append(aBlock);
+        }
+    }
+
+    if (!mPending.isEmpty())
+    {
+        if (!mStopped && !mThread->isRunning())
+        {
+            mThread->start(QThread::LowPriority);
+        }
+
+        mRequestsChanged.wakeOne();
+    }
+}
+
+void AsyncDataProvider::invalidate()
+{
+    mCache.clear();
+    mLastFirstRow=-1;
+
+    QMutexLocker aLocker(&mMutex);
+
+    mPending.clear();
+    mReady.clear();
+    mLoadingValid=false;
+}
+
+void AsyncDataProvider::invalidateRows(const int first, const int last)
+{
+    if (first>last)
+    {
+        return;
+    }
+
+    int aFirstBlock=qMax(first, 0)/mBlockSize;
+    int aLastBlock=last/mBlockSize;
+
+    mCache.removeRows(first, last);
+
+    QMutexLocker aLocker(&mMutex);
+
+    for (int i=mReady.length()-1; i>=0; --i)
+    {
+        if (mReady.at(i).first>=aFirstBlock && mReady.at(i).first<=aLastBlock)
+        {
+            mReady.removeAt(i);
+        }
+    }
+
+    if (mLoadingBlock>=aFirstBlock && mLoadingBlock<=aLastBlock)
+    {
+        mLoadingValid=false;
+    }
+}
+
+void AsyncDataProvider::stop()
+{
+    {
+        QMutexLocker aLocker(&mMutex);
+
+        mStopped=true;
+        mPending.clear();
+        mRequestsChanged.wakeOne();
+    }
+
+    mThread->wait();
+
+    // Next request starts the thread again
+    QMutexLocker aLocker(&mMutex);
+
+    mStopped=false;
+}
+
+bool AsyncDataProvider::isRowLoaded(const int row) const
+{
+    return mCache.containsRow(row);
+}
+
+QString AsyncDataProvider::text(const int row, const int column)
+{
+    return mCache.text(row, column);
+}
+
+RowBlockCache *AsyncDataProvider::cache()
+{
+    return &mCache;
+}
+
+void AsyncDataProvider::processRequests()
+{
+    QMutexLocker aLocker(&mMutex);
+
+    while (!mStopped)
+    {
+        if (mPending.isEmpty())
+        {
+            mRequestsChanged.wait(&mMutex);
+            continue;
+        }
+
+        int aBlock=mPending.takeFirst();
+        int aRow=aBlock*mBlockSize;
+        int aCount=qMin(mBlockSize, mRowCount-aRow);
+
+        if (aCount<=0)
+        {
+            continue;
+        }
+
+        mLoadingBlock=aBlock;
+        mLoadingValid=true;
+
+        aLocker.unlock();
+        QList<QStringList> aRows=loadRows(aRow, aCount);
+        aLocker.relock();
+
+        // Block is dropped if it was invalidated while loading
+        if (mLoadingValid)
+        {
+            mReady.append(qMakePair(aBlock, aRows));
+            QMetaObject::invokeMethod(this, "takeReadyBlocks", Qt::QueuedConnection);
+        }
+
+        mLoadingBlock=-1;
+        mLoadingValid=false;
+    }
+}
+
+void AsyncDataProvider::takeReadyBlocks()
+{
+    QList< QPair<int, QList<QStringList> > > aReady;
+
+    {
+        QMutexLocker aLocker(&mMutex);
+        aReady.swap(mReady);
+    }
+
+    for (int i=0; i<aReady.length(); ++i)
+    {
+        int aBlock=aReady.at(i).first;
+        int aCount=aReady.at(i).second.length();
+
+        mCache.insert(aBlock, aReady.at(i).second);
+
+        if (aCount>0)
+        {
+            emit rowsLoaded(aBlock*mBlockSize, aBlock*mBlockSize+aCount-1);
+        }
+    }
+}
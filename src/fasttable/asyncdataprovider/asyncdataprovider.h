@@ -0,0 +1,89 @@
+#ifndef ASYNCDATAPROVIDER_H
+#define ASYNCDATAPROVIDER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+
+#include "rowblockcache.h"
+
+class AsyncDataProvider;
+
+class AsyncDataThread : public QThread
+{
+public:
+    AsyncDataThread(AsyncDataProvider *provider);
+
+protected:
+    AsyncDataProvider *mProvider;
+
+    void run();
+};
+
+// Cell texts loaded by row blocks in worker thread, so slow storage doesn't block painting.
+// Blocks of visible rows are loaded first, then blocks ahead in the scroll direction.
+// Requests that are not needed anymore are dropped, loaded blocks are reported with rowsLoaded() in GUI thread.
+// Loaded blocks are kept in cache with memory budget, visible blocks are pinned in the cache.
+// Worker thread is stopped when provider is detached from the table, or explicitly with stop().
+// It must be stopped before subclass is destroyed, because worker thread could be inside loadRows(). Destructor asserts it.
+class AsyncDataProvider : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AsyncDataProvider(const int blockSize=256, QObject *parent=0);
+    ~AsyncDataProvider();
+
+    int  blockSize() const;
+    int  prefetchBlocks() const;
+    void setPrefetchBlocks(const int count);
+
+    void requestRows(const int first, const int last, const int rowCount);
+    void invalidate();
+    void invalidateRows(const int first, const int last);
+    void stop();
+
+    bool    isRowLoaded(const int row) const;
+    QString text(const int row, const int column);
+
+    RowBlockCache *cache();
+
+protected:
+    friend class AsyncDataThread;
+
+    int mBlockSize;
+    int mPrefetchBlocks;
+    int mLastFirstRow;
+    int mDirection;
+
+    // Used only in GUI thread
+    RowBlockCache mCache;
+
+    // Shared with worker thread
+    QMutex                                     mMutex;
+    QWaitCondition                             mRequestsChanged;
+    QList<int>                                 mPending;
+    QList< QPair<int, QList<QStringList> > >   mReady;
+    int                                        mLoadingBlock;
+    bool                                       mLoadingValid;
+    int                                        mRowCount;
+    bool                                       mStopped;
+
+    AsyncDataThread *mThread;
+
+    // Called in worker thread, count could be less than block size for the last block
+    virtual QList<QStringList> loadRows(const int row, const int count)=0;
+
+    void processRequests();
+
+protected slots:
+    void takeReadyBlocks();
+
+signals:
+    void rowsLoaded(int first, int last);
+};
+
+#endif // ASYNCDATAPROVIDER_H
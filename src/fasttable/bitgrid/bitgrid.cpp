@@ -0,0 +1,362 @@
+#include "bitgrid.h"
+
+#include "fastdefines.h"
+
+static inline int wordsForBits(const int count)
+{
+    return (count+63)>>6;
+}
+
+static inline int lowestBit(quint64 word)
+{
+#if defined(Q_CC_GNU)
+    return __builtin_ctzll(word);
+#else
+    int res=0;
+
+    while ((word & 1)==0)
+    {
+        word>>=1;
+        ++res;
+    }
+
+    return res;
+#endif
+}
+
+// Reads up to 64 bits starting from bit "from"
+static inline quint64 readBits(const quint64 *words, const int from, const int count)
+{
+    int aWord=from>>6;
+    int aShift=from & 63;
+
+    quint64 res=words[aWord]>>aShift;
+
+    if (aShift>0 && aShift+count>64)
+    {
+        res|=words[aWord+1]<<(64-aShift);
+    }
+
+    return count<64? (res & ((Q_UINT64_C(1)<<count)-1)) : res;
+}
+
+// Writes up to 64 bits starting from bit "from", destination bits should be cleared
+static inline void writeBits(quint64 *words, const int from, const int count, const quint64 value)
+{
+    int aWord=from>>6;
+    int aShift=from & 63;
+
+    words[aWord]|=value<<aShift;
+
+    if (aShift>0 && aShift+count>64)
+    {
+        words[aWord+1]|=value>>(64-aShift);
+    }
+}
+
+static void copyBits(const quint64 *source, int sourceFrom, quint64 *destination, int destinationFrom, int count)
+{
+    while (count>0)
+    {
+        int aCount=count<64? count : 64;
+
+        writeBits(destination, destinationFrom, aCount, readBits(source, sourceFrom, aCount));
+
+        sourceFrom+=aCount;
+        destinationFrom+=aCount;
+        count-=aCount;
+    }
+}
+
+BitGrid::Row::Row(const quint64 *words, const int count)
+{
+    mWords=words;
+    mCount=count;
+}
+
+bool BitGrid::Row::at(const int i) const
+{
+    FASTTABLE_ASSERT(i>=0 && i<mCount);
+
+    return mWords && (mWords[i>>6] & (Q_UINT64_C(1)<<(i & 63)));
+}
+
+int BitGrid::Row::length() const
+{
+    return mCount;
+}
+
+int BitGrid::Row::size() const
+{
+    return mCount;
+}
+
+int BitGrid::Row::count() const
+{
+    return mCount;
+}
+
+BitGrid::BitGrid()
+{
+    mRowCount=0;
+    mColumnCount=0;
+    mWordsPerRow=0;
+}
+
+void BitGrid::clear()
+{
+    mWords.clear();
+    mWords.squeeze();
+
+    mRowCount=0;
+    mColumnCount=0;
+    mWordsPerRow=0;
+}
+
+void BitGrid::resize(const int rowCount, const int columnCount)
+{
+    FASTTABLE_ASSERT(rowCount>=0 && columnCount>=0);
+
+    if (columnCount!=mColumnCount)
+    {
+        rebuildColumns(columnCount, qMin(columnCount, mColumnCount), mColumnCount, columnCount);
+    }
+
+    if (rowCount!=mRowCount)
+    {
+        if (!mWords.isEmpty())
+        {
+            mWords.resize(rowCount*mWordsPerRow);
+
+            for (int i=mRowCount*mWordsPerRow; i<mWords.size(); ++i)
+            {
+                mWords[i]=0;
+            }
+        }
+
+        mRowCount=rowCount;
+    }
+}
+
+void BitGrid::insertRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0 && row<=mRowCount && count>=0);
+
+    if (!mWords.isEmpty())
+    {
+        mWords.insert(row*mWordsPerRow, count*mWordsPerRow, 0);
+    }
+
+    mRowCount+=count;
+}
+
+void BitGrid::removeRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0 && count>=0 && row+count<=mRowCount);
+
+    if (!mWords.isEmpty())
+    {
+        mWords.remove(row*mWordsPerRow, count*mWordsPerRow);
+    }
+
+    mRowCount-=count;
+}
+
+void BitGrid::insertColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(column>=0 && column<=mColumnCount && count>=0);
+
+    rebuildColumns(mColumnCount+count, column, column, column+count);
+}
+
+void BitGrid::removeColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(column>=0 && count>=0 && column+count<=mColumnCount);
+
+    rebuildColumns(mColumnCount-count, column, column+count, column);
+}
+
+bool BitGrid::at(const int row, const int column) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    return !mWords.isEmpty() && (mWords.at(row*mWordsPerRow+(column>>6)) & (Q_UINT64_C(1)<<(column & 63)));
+}
+
+BitGrid::Row BitGrid::at(const int row) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+
+    return Row(mWords.isEmpty()? 0 : mWords.constData()+row*mWordsPerRow, mColumnCount);
+}
+
+void BitGrid::setBit(const int row, const int column, const bool value)
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    if (mWords.isEmpty())
+    {
+        if (!value)
+        {
+            return;
+        }
+
+        detach();
+    }
+
+    quint64 &aWord=mWords[row*mWordsPerRow+(column>>6)];
+
+    if (value)
+    {
+        aWord|=Q_UINT64_C(1)<<(column & 63);
+    }
+    else
+    {
+        aWord&=~(Q_UINT64_C(1)<<(column & 63));
+    }
+}
+
+void BitGrid::fill(const bool value)
+{
+    if (!value)
+    {
+        mWords.clear();
+        mWords.squeeze();
+
+        return;
+    }
+
+    if (mRowCount==0 || mColumnCount==0)
+    {
+        return;
+    }
+
+    mWords.fill(~Q_UINT64_C(0), mRowCount*mWordsPerRow);
+
+    // Bits after the last column are kept cleared
+    if (mColumnCount & 63)
+    {
+        quint64 aLastWord=(Q_UINT64_C(1)<<(mColumnCount & 63))-1;
+
+        for (int i=mWordsPerRow-1; i<mWords.size(); i+=mWordsPerRow)
+        {
+            mWords[i]=aLastWord;
+        }
+    }
+}
+
+int BitGrid::nextSetBit(const int row, const int from) const
+{
+    return nextBit(row, from, true);
+}
+
+int BitGrid::nextClearBit(const int row, const int from) const
+{
+    return nextBit(row, from, false);
+}
+
+int BitGrid::length() const
+{
+    return mRowCount;
+}
+
+int BitGrid::size() const
+{
+    return mRowCount;
+}
+
+int BitGrid::count() const
+{
+    return mRowCount;
+}
+
+int BitGrid::rowCount() const
+{
+    return mRowCount;
+}
+
+int BitGrid::columnCount() const
+{
+    return mColumnCount;
+}
+
+void BitGrid::detach()
+{
+    FASTTABLE_ASSERT(mWords.isEmpty());
+
+    mWords.fill(0, mRowCount*mWordsPerRow);
+}
+
+void BitGrid::rebuildColumns(const int columnCount, const int keepCount, const int moveFrom, const int moveTo)
+{
+    // Bits [0, keepCount) stay in place, bits starting from moveFrom are moved to moveTo
+    int aWordsPerRow=wordsForBits(columnCount);
+
+    if (!mWords.isEmpty())
+    {
+        int aMoveCount=qMin(mColumnCount-moveFrom, columnCount-moveTo);
+
+        QVector<quint64> aWords(mRowCount*aWordsPerRow, 0);
+
+        for (int i=0; i<mRowCount; ++i)
+        {
+            const quint64 *aSource=mWords.constData()+i*mWordsPerRow;
+            quint64       *aDestination=aWords.data()+i*aWordsPerRow;
+
+            copyBits(aSource, 0, aDestination, 0, keepCount);
+
+            if (aMoveCount>0)
+            {
+                copyBits(aSource, moveFrom, aDestination, moveTo, aMoveCount);
+            }
+        }
+
+        mWords=aWords;
+    }
+
+    mColumnCount=columnCount;
+    mWordsPerRow=aWordsPerRow;
+}
+
+int BitGrid::nextBit(const int row, const int from, const bool value) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(from>=0);
+
+    if (from>=mColumnCount)
+    {
+        return -1;
+    }
+
+    if (mWords.isEmpty())
+    {
+        return value? -1 : from;
+    }
+
+    const quint64 *aWords=mWords.constData()+row*mWordsPerRow;
+
+    // Words are scanned 64 bits at a time, inverted when clear bit is needed
+    int aWord=from>>6;
+    quint64 aBits=(value? aWords[aWord] : ~aWords[aWord]) & (~Q_UINT64_C(0)<<(from & 63));
+
+    while (true)
+    {
+        if (aBits)
+        {
+            int res=(aWord<<6)+lowestBit(aBits);
+
+            return res<mColumnCount? res : -1;
+        }
+
+        ++aWord;
+
+        if (aWord>=mWordsPerRow)
+        {
+            return -1;
+        }
+
+        aBits=value? aWords[aWord] : ~aWords[aWord];
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef BITGRID_H
+#define BITGRID_H
+
+#include <QVector>
+
+// Two-dimensional array of bits packed in 64-bit words, one run of words per row.
+// While no bit is set the words are not allocated.
+class BitGrid
+{
+public:
+    // Read-only view of one row. It is valid until the grid is modified
+    class Row
+    {
+    public:
+        Row(const quint64 *words, const int count);
+
+        bool at(const int i) const;
+
+        int length() const;
+        int size() const;
+        int count() const;
+
+    protected:
+        const quint64 *mWords;
+        int            mCount;
+    };
+
+    BitGrid();
+
+    void clear();
+    void resize(const int rowCount, const int columnCount);
+
+    void insertRows(const int row, const int count);
+    void removeRows(const int row, const int count);
+    void insertColumns(const int column, const int count);
+    void removeColumns(const int column, const int count);
+
+    bool at(const int row, const int column) const;
+    Row  at(const int row) const;
+    void setBit(const int row, const int column, const bool value);
+    void fill(const bool value);
+
+    int nextSetBit(const int row, const int from) const;
+    int nextClearBit(const int row, const int from) const;
+
+    int length() const;
+    int size() const;
+    int count() const;
+
+    int rowCount() const;
+    int columnCount() const;
+
+protected:
+    QVector<quint64> mWords;
+    int              mRowCount;
+    int              mColumnCount;
+    int              mWordsPerRow;
+
+    void detach();
+    void rebuildColumns(const int columnCount, const int keepCount, const int moveFrom, const int moveTo);
+    int  nextBit(const int row, const int from, const bool value) const;
+};
+
+#endif // BITGRID_H
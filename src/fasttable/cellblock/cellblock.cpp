@@ -0,0 +1,125 @@
+#include "cellblock.h"
+
+#include "fastdefines.h"
+
+CellBlock::CellBlock()
+{
+    mFields=NoFields;
+}
+
+void CellBlock::reset(const QRect &range)
+{
+    // Arrays keep their memory between frames
+    mRange=range;
+    mFields=NoFields;
+}
+
+QRect CellBlock::range() const
+{
+    return mRange;
+}
+
+int CellBlock::cellCount() const
+{
+    return mRange.isValid() ? mRange.width()*mRange.height() : 0;
+}
+
+int CellBlock::fields() const
+{
+    return mFields;
+}
+
+bool CellBlock::hasField(const Field field) const
+{
+    return mFields & field;
+}
+
+int CellBlock::indexOf(const int row, const int column) const
+{
+    if (!mRange.contains(column, row))
+    {
+        return -1;
+    }
+
+    return (row-mRange.top())*mRange.width()+column-mRange.left();
+}
+
+QVector<QString> &CellBlock::texts()
+{
+    mTexts.resize(cellCount());
+    mFields|=Texts;
+
+    return mTexts;
+}
+
+QVector<QBrush> &CellBlock::backgroundBrushes()
+{
+    mBackgroundBrushes.resize(cellCount());
+    mFields|=BackgroundBrushes;
+
+    return mBackgroundBrushes;
+}
+
+QVector<QColor> &CellBlock::foregroundColors()
+{
+    mForegroundColors.resize(cellCount());
+    mFields|=ForegroundColors;
+
+    return mForegroundColors;
+}
+
+QVector<QFont> &CellBlock::fonts()
+{
+    mFonts.resize(cellCount());
+    mFields|=Fonts;
+
+    return mFonts;
+}
+
+QVector<int> &CellBlock::textFlags()
+{
+    mTextFlags.resize(cellCount());
+    mFields|=TextFlags;
+
+    return mTextFlags;
+}
+
+const QString &CellBlock::text(const int index) const
+{
+    FASTTABLE_ASSERT(mFields & Texts);
+    FASTTABLE_ASSERT(index>=0 && index<mTexts.size());
+
+    return mTexts.at(index);
+}
+
+const QBrush &CellBlock::backgroundBrush(const int index) const
+{
+    FASTTABLE_ASSERT(mFields & BackgroundBrushes);
+    FASTTABLE_ASSERT(index>=0 && index<mBackgroundBrushes.size());
+
+    return mBackgroundBrushes.at(index);
+}
+
+const QColor &CellBlock::foregroundColor(const int index) const
+{
+    FASTTABLE_ASSERT(mFields & ForegroundColors);
+    FASTTABLE_ASSERT(index>=0 && index<mForegroundColors.size());
+
+    return mForegroundColors.at(index);
+}
+
+const QFont &CellBlock::font(const int index) const
+{
+    FASTTABLE_ASSERT(mFields & Fonts);
+    FASTTABLE_ASSERT(index>=0 && index<mFonts.size());
+
+    return mFonts.at(index);
+}
+
+int CellBlock::textFlag(const int index) const
+{
+    FASTTABLE_ASSERT(mFields & TextFlags);
+    FASTTABLE_ASSERT(index>=0 && index<mTextFlags.size());
+
+    return mTextFlags.at(index);
+}
@@ -0,0 +1,51 @@
+#ifndef CELLBLOCK_H
+#define CELLBLOCK_H
+
+#include <QVector>
+#include <QRect>
+#include <QString>
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+
+// Cell attributes of rectangular block (x is column, y is row) stored row by row in contiguous arrays.
+// Provider fills only attributes it has, getting array of attribute marks it as filled.
+// Attributes that are not filled are requested from per-cell functions of the table.
+class CellBlock
+{
+public:
+    enum Field {NoFields=0, Texts=1, BackgroundBrushes=2, ForegroundColors=4, Fonts=8, TextFlags=16};
+
+    CellBlock();
+
+    void  reset(const QRect &range);
+    QRect range() const;
+    int   cellCount() const;
+    int   fields() const;
+    bool  hasField(const Field field) const;
+    int   indexOf(const int row, const int column) const;
+
+    QVector<QString> &texts();
+    QVector<QBrush>  &backgroundBrushes();
+    QVector<QColor>  &foregroundColors();
+    QVector<QFont>   &fonts();
+    QVector<int>     &textFlags();
+
+    const QString &text(const int index) const;
+    const QBrush  &backgroundBrush(const int index) const;
+    const QColor  &foregroundColor(const int index) const;
+    const QFont   &font(const int index) const;
+    int            textFlag(const int index) const;
+
+protected:
+    QRect mRange;
+    int   mFields;
+
+    QVector<QString> mTexts;
+    QVector<QBrush>  mBackgroundBrushes;
+    QVector<QColor>  mForegroundColors;
+    QVector<QFont>   mFonts;
+    QVector<int>     mTextFlags;
+};
+
+#endif // CELLBLOCK_H
@@ -0,0 +1,441 @@
+#include "csvimporter.h"
+
+#include <QFile>
+#include <QElapsedTimer>
+
+#include "fastdefines.h"
+#include "mappedcsvfile.h"
+
+CsvImportThread::CsvImportThread(CsvImporter *importer) :
+    QThread()
+{
+    mImporter=importer;
+}
+
+void CsvImportThread::run()
+{
+    mImporter->importFile();
+}
+
+//------------------------------------------------------------------------------
+
+CsvImportTask::CsvImportTask(CsvImporter *importer, CsvImporter::Chunk *chunk, const bool parse) :
+    QRunnable()
+{
+    mImporter=importer;
+    mChunk=chunk;
+    mParse=parse;
+}
+
+void CsvImportTask::run()
+{
+    if (mParse)
+    {
+        mImporter->parseChunk(mChunk);
+    }
+    else
+    {
+        mImporter->countQuotes(mChunk);
+    }
+}
+
+//------------------------------------------------------------------------------
+
+CsvImporter::CsvImporter(QObject *parent) :
+    QObject(parent)
+{
+    mChunkSize=1024*1024;
+    mDelimiter=',';
+
+    mCancelled=false;
+    mParsedRows=0;
+    mColumnCount=0;
+    mRowsPerSecond=0;
+
+    mThread=new CsvImportThread(this);
+}
+
+CsvImporter::~CsvImporter()
+{
+    cancel();
+    wait();
+
+    delete mThread;
+}
+
+int CsvImporter::chunkSize() const
+{
+    return mChunkSize;
+}
+
+void CsvImporter::setChunkSize(const int bytes)
+{
+    FASTTABLE_ASSERT(bytes>0);
+    FASTTABLE_ASSERT(!isRunning());
+
+    mChunkSize=bytes;
+}
+
+bool CsvImporter::start(const QString &fileName, const char delimiter)
+{
+    if (isRunning())
+    {
+        return false;
+    }
+
+    mFileName=fileName;
+    mDelimiter=delimiter;
+
+    {
+        QMutexLocker aLocker(&mMutex);
+
+        mCancelled=false;
+        mParsedRows=0;
+        mRows.clear();
+        mColumnCount=0;
+        mRowsPerSecond=0;
+    }
+
+    mThread->start();
+
+    return true;
+}
+
+void CsvImporter::cancel()
+{
+    QMutexLocker aLocker(&mMutex);
+
+    // Rows of finished import are dropped too
+    mCancelled=true;
+    mRows.clear();
+    mColumnCount=0;
+}
+
+void CsvImporter::wait()
+{
+    mThread->wait();
+}
+
+bool CsvImporter::isRunning() const
+{
+    return mThread->isRunning();
+}
+
+bool CsvImporter::isCancelled()
+{
+    QMutexLocker aLocker(&mMutex);
+
+    return mCancelled;
+}
+
+int CsvImporter::rowCount()
+{
+    QMutexLocker aLocker(&mMutex);
+
+    return mRows.length();
+}
+
+int CsvImporter::columnCount()
+{
+    QMutexLocker aLocker(&mMutex);
+
+    return mColumnCount;
+}
+
+int CsvImporter::rowsPerSecond()
+{
+    QMutexLocker aLocker(&mMutex);
+
+    return mRowsPerSecond;
+}
+
+QList<QStringList> CsvImporter::takeRows()
+{
+    QList<QStringList> res;
+
+    QMutexLocker aLocker(&mMutex);
+    res.swap(mRows);
+
+    return res;
+}
+
+void CsvImporter::importFile()
+{
+    QElapsedTimer aTimer;
+    aTimer.start();
+
+    QFile aFile(mFileName);
+
+    if (!aFile.open(QIODevice::ReadOnly))
+    {
+        emit finished(false);
+        return;
+    }
+
+    // Several chunks per thread, so threads are not idle while the last chunks are parsed
+    qint64 aWindowSize=(qint64)mChunkSize*qMax(mPool.maxThreadCount(), 1)*2;
+    bool   aFirstWindow=true;
+    bool   aAtEnd=false;
+
+    // Rows are only shared between lists here, strings are not copied
+    QList<QStringList> aRows;
+    int aColumnCount=0;
+
+    mData.clear();
+
+    while (!aAtEnd && !isCancelled())
+    {
+        mData.append(aFile.read(aWindowSize));
+        aAtEnd=aFile.atEnd();
+
+        // UTF-8 byte order mark is not a part of the first cell
+        if (aFirstWindow && (mData.size()>=3 || aAtEnd))
+        {
+            if (mData.startsWith("\xEF\xBB\xBF"))
+            {
+                mData.remove(0, 3);
+            }
+
+            aFirstWindow=false;
+        }
+
+        QList<Chunk *> aChunks;
+
+        for (qint64 i=0; i<mData.size(); i+=mChunkSize)
+        {
+            Chunk *aChunk=new Chunk();
+
+            aChunk->begin=i;
+            aChunk->end=qMin(i+mChunkSize, (qint64)mData.size());
+            aChunk->oddQuotes=false;
+            aChunk->startQuoted=false;
+            aChunk->columnCount=0;
+
+            aChunks.append(aChunk);
+        }
+
+        for (int i=0; i<aChunks.length(); ++i)
+        {
+            mPool.start(new CsvImportTask(this, aChunks.at(i), false));
+        }
+
+        mPool.waitForDone();
+
+        // Quote state at the beginning of chunk depends only on quotes before it, window always starts with a new row
+        for (int i=1; i<aChunks.length(); ++i)
+        {
+            aChunks.at(i)->startQuoted=aChunks.at(i-1)->startQuoted ^ aChunks.at(i-1)->oddQuotes;
+        }
+
+        qint64 aEnd=aAtEnd ? mData.size() : completeRowsEnd(aChunks);
+
+        // Chunks after the last complete row are parsed with the next window
+        for (int i=aChunks.length()-1; i>=0 && aChunks.at(i)->end>aEnd; --i)
+        {
+            if (aChunks.at(i)->begin>=aEnd)
+            {
+                delete aChunks.takeAt(i);
+            }
+            else
+            {
+                aChunks.at(i)->end=aEnd;
+            }
+        }
+
+        if (!isCancelled())
+        {
+            for (int i=0; i<aChunks.length(); ++i)
+            {
+                mPool.start(new CsvImportTask(this, aChunks.at(i), true));
+            }
+        }
+
+        while (!mPool.waitForDone(100))
+        {
+            QMutexLocker aLocker(&mMutex);
+
+            int aParsedRows=mParsedRows;
+            int aRowsPerSecond=(int)(aParsedRows*1000LL/qMax(aTimer.elapsed(), (qint64)1));
+
+            aLocker.unlock();
+
+            emit progress(aParsedRows, aRowsPerSecond);
+        }
+
+        for (int i=0; i<aChunks.length(); ++i)
+        {
+            aRows.append(aChunks.at(i)->rows);
+            aColumnCount=qMax(aColumnCount, aChunks.at(i)->columnCount);
+
+            delete aChunks.at(i);
+        }
+
+        // Raw data of parsed rows is released, only incomplete row is kept
+        mData=mData.mid(aEnd);
+    }
+
+    aFile.close();
+    mData.clear();
+
+    bool aSuccess=!isCancelled();
+
+    if (!aSuccess)
+    {
+        aRows.clear();
+        aColumnCount=0;
+    }
+
+    QMutexLocker aLocker(&mMutex);
+
+    aSuccess=aSuccess && !mCancelled;
+
+    if (aSuccess)
+    {
+        mRows.swap(aRows);
+        mColumnCount=aColumnCount;
+        mRowsPerSecond=(int)(mRows.length()*1000LL/qMax(aTimer.elapsed(), (qint64)1));
+    }
+
+    aLocker.unlock();
+
+    emit finished(aSuccess);
+}
+
+qint64 CsvImporter::completeRowsEnd(const QList<Chunk *> &chunks)
+{
+    // Usually line break is found in the last chunk, so previous chunks are not scanned
+    for (int i=chunks.length()-1; i>=0; --i)
+    {
+        Chunk *aChunk=chunks.at(i);
+        const char *aData=mData.constData();
+        bool aQuoted=aChunk->startQuoted;
+        qint64 res=-1;
+
+        for (qint64 j=aChunk->begin; j<aChunk->end; ++j)
+        {
+            if (aData[j]=='"')
+            {
+                aQuoted=!aQuoted;
+            }
+            else
+            if (aData[j]=='\n' && !aQuoted)
+            {
+                res=j+1;
+            }
+        }
+
+        if (res>=0)
+        {
+            return res;
+        }
+    }
+
+    // Row is longer than window, it is parsed when the next window is read
+    return 0;
+}
+
+void CsvImporter::countQuotes(Chunk *chunk)
+{
+    const char *aData=mData.constData();
+    bool aOdd=false;
+
+    for (qint64 i=chunk->begin; i<chunk->end; ++i)
+    {
+        if (aData[i]=='"')
+        {
+            aOdd=!aOdd;
+        }
+    }
+
+    chunk->oddQuotes=aOdd;
+}
+
+void CsvImporter::parseChunk(Chunk *chunk)
+{
+    const char *aData=mData.constData();
+    qint64 aSize=mData.size();
+    qint64 aPos=chunk->begin;
+
+    // Row that started in the previous chunk is parsed there
+    if (aPos>0 && (aData[aPos-1]!='\n' || chunk->startQuoted))
+    {
+        bool aQuoted=chunk->startQuoted;
+
+        while (aPos<chunk->end)
+        {
+            char aChar=aData[aPos];
+            ++aPos;
+
+            if (aChar=='"')
+            {
+                aQuoted=!aQuoted;
+            }
+            else
+            if (aChar=='\n' && !aQuoted)
+            {
+                break;
+            }
+        }
+    }
+
+    int aRows=0;
+
+    while (aPos<chunk->end)
+    {
+        qint64 aRowStart=aPos;
+        bool aQuoted=false;
+
+        while (aPos<aSize)
+        {
+            char aChar=aData[aPos];
+
+            if (aChar=='"')
+            {
+                aQuoted=!aQuoted;
+            }
+            else
+            if (aChar=='\n' && !aQuoted)
+            {
+                break;
+            }
+
+            ++aPos;
+        }
+
+        qint64 aRowEnd=aPos;
+
+        // Line break is not a part of the row
+        if (aPos<aSize)
+        {
+            ++aPos;
+        }
+
+        if (aRowEnd>aRowStart && aData[aRowEnd-1]=='\r')
+        {
+            aRowEnd--;
+        }
+
+        QStringList aRow=MappedCsvFile::parseRecord(aData+aRowStart, (int)(aRowEnd-aRowStart), mDelimiter);
+
+        chunk->columnCount=qMax(chunk->columnCount, aRow.length());
+        chunk->rows.append(aRow);
+
+        ++aRows;
+
+        if ((aRows & 0xFFF)==0)
+        {
+            QMutexLocker aLocker(&mMutex);
+
+            mParsedRows+=0x1000;
+
+            if (mCancelled)
+            {
+                return;
+            }
+        }
+    }
+
+    QMutexLocker aLocker(&mMutex);
+
+    mParsedRows+=aRows & 0xFFF;
+}
@@ -0,0 +1,108 @@
+#ifndef CSVIMPORTER_H
+#define CSVIMPORTER_H
+
+#include <QObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutex>
+#include <QByteArray>
+#include <QList>
+#include <QStringList>
+
+class CsvImporter;
+
+class CsvImportThread : public QThread
+{
+public:
+    CsvImportThread(CsvImporter *importer);
+
+protected:
+    CsvImporter *mImporter;
+
+    void run();
+};
+
+// File is read by windows of several chunks, so only one window of raw data is kept in memory.
+// Window ends after the last line break outside of quotes, incomplete row is carried to the next window.
+// Chunks of the window are parsed in thread pool. Quotes are counted in every chunk first, so each chunk knows if it starts inside quoted field.
+// Chunk parses all rows that start inside it, the last row could end in the next chunk.
+class CsvImporter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit CsvImporter(QObject *parent=0);
+    ~CsvImporter();
+
+    int  chunkSize() const;
+    void setChunkSize(const int bytes);
+
+    bool start(const QString &fileName, const char delimiter=',');
+    void cancel();
+    void wait();
+
+    bool isRunning() const;
+    bool isCancelled();
+
+    int rowCount();
+    int columnCount();
+    int rowsPerSecond();
+
+    QList<QStringList> takeRows();
+
+protected:
+    friend class CsvImportThread;
+    friend class CsvImportTask;
+
+    struct Chunk
+    {
+        qint64             begin;
+        qint64             end;
+        bool               oddQuotes;
+        bool               startQuoted;
+        QList<QStringList> rows;
+        int                columnCount;
+    };
+
+    int     mChunkSize;
+    QString mFileName;
+    char    mDelimiter;
+
+    // Used only in import threads while running
+    QByteArray  mData;
+    QThreadPool mPool;
+
+    // Shared with import threads
+    QMutex             mMutex;
+    bool               mCancelled;
+    int                mParsedRows;
+    QList<QStringList> mRows;
+    int                mColumnCount;
+    int                mRowsPerSecond;
+
+    CsvImportThread *mThread;
+
+    void   importFile();
+    qint64 completeRowsEnd(const QList<Chunk *> &chunks);
+    void   countQuotes(Chunk *chunk);
+    void   parseChunk(Chunk *chunk);
+
+signals:
+    void progress(int rows, int rowsPerSecond);
+    void finished(bool success);
+};
+
+class CsvImportTask : public QRunnable
+{
+public:
+    CsvImportTask(CsvImporter *importer, CsvImporter::Chunk *chunk, const bool parse);
+
+protected:
+    CsvImporter        *mImporter;
+    CsvImporter::Chunk *mChunk;
+    bool                mParse;
+
+    void run();
+};
+
+#endif // CSVIMPORTER_H
@@ -0,0 +1,12 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2012-05-04T17:08:42
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES +=  $$PWD/csvimporter.cpp
+
+HEADERS  += $$PWD/csvimporter.h
@@ -29,6 +29,12 @@ CustomFastTableWidget::~CustomFastTableWidget()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
+    // Provider is not owned, but its worker thread is not needed without the table
+    if (mAsyncDataProvider)
+    {
+        mAsyncDataProvider->stop();
+    }
+
     clear();
     deleteLists();
 
@@ -120,7 +126,19 @@ void CustomFastTableWidget::init(const bool aUseInternalData)
     mEditor=0;
     mEditorPaintByTable=false;
 
+    mUpdateLevel=0;
+    mUpdateViewportWasEnabled=true;
+    mPendingSizes=false;
+    mPendingVerticalHeaderSize=false;
+    mPendingCurrentCellChanged=false;
+    mPendingPreviousRow=-1;
+    mPendingPreviousColumn=-1;
+
+    mAsyncDataProvider=0;
+    mMappedCsvFile=0;
+
     setMouseTracking(true);
+    viewport()->setAttribute(Qt::WA_OpaquePaintEvent);
 
     horizontalScrollBar()->setSingleStep(100);
     verticalScrollBar()->setSingleStep(100);
@@ -142,10 +160,16 @@ void CustomFastTableWidget::createLists()
         mData                         = 0;
     }
 
-    mRowHeights                       = new QList< qint16 >();
-    mColumnWidths                     = new QList< qint16 >();
-    mOffsetX                          = new QList< int >();
-    mOffsetY                          = new QList< int >();
+    // Row storage is used by default
+    mTextColumns                      = 0;
+
+    // Row cache is disabled by default
+    mRowCache                         = 0;
+
+    mRowHeights                       = new SizeList();
+    mColumnWidths                     = new SizeList();
+    mOffsetX                          = new OffsetIndex(mColumnWidths);
+    mOffsetY                          = new OffsetIndex(mRowHeights);
 
     mHorizontalHeader_Data            = new QList< QStringList >();
     mHorizontalHeader_RowHeights      = new QList< qint16 >();
@@ -155,12 +179,13 @@ void CustomFastTableWidget::createLists()
     mVerticalHeader_ColumnWidths      = new QList< qint16 >();
     mVerticalHeader_OffsetX           = new QList< int >();
 
-    mSelectedCells                    = new QList< QList<bool> >();
-    mCurSelection                     = new QList< QPoint >();
-    mHorizontalHeader_SelectedColumns = new QList< int >();
-    mVerticalHeader_SelectedRows      = new QList< int >();
+    mSelection                        = new SelectionRanges();
+    mPendingSelected                  = new SelectionRanges();
+    mPendingDeselected                = new SelectionRanges();
+
+    mMouseBaseSelection               = new SelectionRanges();
 
-    mMouseSelectedCells               = new QList< QList<bool> >();
+    mCellBlock                        = new CellBlock();
 }
 
 void CustomFastTableWidget::deleteLists()
@@ -170,6 +195,16 @@ void CustomFastTableWidget::deleteLists()
         delete mData;
     }
 
+    if (mTextColumns)
+    {
+        delete mTextColumns;
+    }
+
+    if (mRowCache)
+    {
+        delete mRowCache;
+    }
+
     delete mRowHeights;
     delete mColumnWidths;
     delete mOffsetX;
@@ -183,12 +218,13 @@ void CustomFastTableWidget::deleteLists()
     delete mVerticalHeader_ColumnWidths;
     delete mVerticalHeader_OffsetX;
 
-    delete mSelectedCells;
-    delete mCurSelection;
-    delete mHorizontalHeader_SelectedColumns;
-    delete mVerticalHeader_SelectedRows;
+    delete mSelection;
+    delete mPendingSelected;
+    delete mPendingDeselected;
 
-    delete mMouseSelectedCells;
+    delete mMouseBaseSelection;
+
+    delete mCellBlock;
 }
 
 bool CustomFastTableWidget::updatesEnabled() const
@@ -201,6 +237,86 @@ void CustomFastTableWidget::setUpdatesEnabled(bool enable)
     viewport()->setUpdatesEnabled(enable);
 }
 
+void CustomFastTableWidget::beginUpdate()
+{
+    FASTTABLE_DEBUG;
+
+    if (mUpdateLevel==0)
+    {
+        mUpdateViewportWasEnabled=viewport()->updatesEnabled();
+
+        if (mUpdateViewportWasEnabled)
+        {
+            viewport()->setUpdatesEnabled(false);
+        }
+    }
+
+    mUpdateLevel++;
+}
+
+void CustomFastTableWidget::endUpdate()
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    FASTTABLE_ASSERT(mUpdateLevel>0);
+
+    mUpdateLevel--;
+
+    if (mUpdateLevel>0)
+    {
+        return;
+    }
+
+    // Vertical header size may change the sizes, so it goes first
+    if (mPendingVerticalHeaderSize)
+    {
+        mPendingVerticalHeaderSize=false;
+        updateVerticalHeaderSize();
+    }
+
+    if (mPendingSizes)
+    {
+        updateSizes();
+    }
+
+    if (mUpdateViewportWasEnabled)
+    {
+        viewport()->setUpdatesEnabled(true);
+    }
+
+    viewport()->update();
+
+    if (!mPendingSelected->isEmpty() || !mPendingDeselected->isEmpty())
+    {
+        QList<QRect> aSelected=mPendingSelected->ranges();
+        QList<QRect> aDeselected=mPendingDeselected->ranges();
+
+        mPendingSelected->clear();
+        mPendingDeselected->clear();
+
+        emit selectionChanged(aSelected, aDeselected);
+    }
+
+    if (mPendingCurrentCellChanged)
+    {
+        mPendingCurrentCellChanged=false;
+
+        if (mPendingPreviousRow!=mCurrentRow || mPendingPreviousColumn!=mCurrentColumn)
+        {
+            emit currentCellChanged(mCurrentRow, mCurrentColumn, mPendingPreviousRow, mPendingPreviousColumn);
+            emit cellChanged(mCurrentRow, mCurrentColumn);
+        }
+    }
+
+    FASTTABLE_END_PROFILE;
+}
+
+bool CustomFastTableWidget::isUpdating() const
+{
+    return mUpdateLevel>0;
+}
+
 void CustomFastTableWidget::setHorizontalScrollBar(QScrollBar *scrollbar)
 {
     FASTTABLE_DEBUG;
@@ -690,7 +806,7 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
             {
                 mMouseLocationForShift=mMouseLocation;
                 unselectAll();
-                mMouseSelectedCells->clear();
+                mMouseSelectedRange=QRect();
 
                 if (mMouseXForShift>=0 && mMouseYForShift>=0)
                 {
@@ -724,7 +840,7 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
 
             if (event->button()==Qt::LeftButton)
             {
-                mMouseSelectedCells->clear();
+                mMouseSelectedRange=QRect();
 
                 mMouseXForShift=mLastX;
                 mMouseYForShift=mLastY;
@@ -735,10 +851,10 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                 {
                     setCurrentCell(mLastY, mLastX, true);
 
-                    FASTTABLE_ASSERT(mLastY>=0 && mLastY<mSelectedCells->length());
-                    FASTTABLE_ASSERT(mLastX>=0 && mLastX<mSelectedCells->at(mLastY).length());
+                    FASTTABLE_ASSERT(mLastY>=0 && mLastY<mSelection->rowCount());
+                    FASTTABLE_ASSERT(mLastX>=0 && mLastX<mSelection->columnCount());
 
-                    setCellSelected(mLastY, mLastX, !mSelectedCells->at(mLastY).at(mLastX));
+                    setCellSelected(mLastY, mLastX, !mSelection->contains(mLastY, mLastX));
                 }
                 else
                 {
@@ -757,16 +873,13 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                     }
                 }
 
-                QList<bool> aRow;
-                aRow.append(mSelectedCells->at(mLastY).at(mLastX));
-
-                mMouseSelectedCells->append(aRow);
+                startMouseSelection(QRect(mLastX, mLastY, 1, 1));
             }
             else
             {
-                if (!mSelectedCells->at(mLastY).at(mLastX))
+                if (!mSelection->contains(mLastY, mLastX))
                 {
-                    mMouseSelectedCells->clear();
+                    mMouseSelectedRange=QRect();
 
                     mMouseXForShift=mLastX;
                     mMouseYForShift=mLastY;
@@ -899,7 +1012,7 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                     {
                         mMouseLocationForShift=mMouseLocation;
                         unselectAll();
-                        mMouseSelectedCells->clear();
+                        mMouseSelectedRange=QRect();
                     }
 
                     if (mMouseXForShift<0 || mMouseYForShift<0)
@@ -915,29 +1028,12 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                     mLastX=mMouseXForShift;
                     mLastY=mMouseYForShift;
 
-                    if (mMouseSelectedCells->length()==0)
-                    {
-                        int minX=qMin(mCurrentColumn, mLastX);
-                        int maxX=qMax(mCurrentColumn, mLastX);
-
-                        for (int i=0; i<mRowCount; i++)
-                        {
-                            QList<bool> aRow;
-
-                            for (int j=minX; j<=maxX; j++)
-                            {
-                                aRow.append(j==mLastX || mSelectedCells->at(i).at(j));
-                            }
-
-                            mMouseSelectedCells->append(aRow);
-                        }
-                    }
-
+                    horizontalHeader_FillShiftSelection();
                     horizontalHeader_SelectRangeForHandlers(pos.x());
                 }
                 else
                 {
-                    mMouseSelectedCells->clear();
+                    mMouseSelectedRange=QRect();
 
                     mMouseXForShift=mLastX;
                     mMouseYForShift=mLastY;
@@ -948,10 +1044,10 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                     {
                         setCurrentCell(mRowCount-1, mLastX, true);
 
-                        FASTTABLE_ASSERT(mSelectedCells->length()>0);
-                        FASTTABLE_ASSERT(mLastX>=0 && mLastX<mSelectedCells->at(0).length());
+                        FASTTABLE_ASSERT(mSelection->rowCount()>0);
+                        FASTTABLE_ASSERT(mLastX>=0 && mLastX<mSelection->columnCount());
 
-                        if (mSelectedCells->at(0).at(mLastX))
+                        if (mSelection->contains(0, mLastX))
                         {
                             unselectColumn(mLastX);
                         }
@@ -966,13 +1062,7 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                         selectColumn(mLastX);
                     }
 
-                    for (int i=0; i<mRowCount; i++)
-                    {
-                        QList<bool> aRow;
-                        aRow.append(mSelectedCells->at(i).at(mLastX));
-
-                        mMouseSelectedCells->append(aRow);
-                    }
+                    startMouseSelection(QRect(mLastX, 0, 1, mRowCount));
 
                     viewport()->update();
 
@@ -1097,7 +1187,7 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                         {
                             mMouseLocationForShift=mMouseLocation;
                             unselectAll();
-                            mMouseSelectedCells->clear();
+                            mMouseSelectedRange=QRect();
                         }
 
                         if (mMouseXForShift<0 || mMouseYForShift<0)
@@ -1113,29 +1203,12 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                         mLastX=mMouseXForShift;
                         mLastY=mMouseYForShift;
 
-                        if (mMouseSelectedCells->length()==0)
-                        {
-                            int minY=qMin(mCurrentRow, mLastY);
-                            int maxY=qMax(mCurrentRow, mLastY);
-
-                            for (int i=minY; i<=maxY; i++)
-                            {
-                                QList<bool> aRow;
-
-                                for (int j=0; j<mColumnCount; j++)
-                                {
-                                    aRow.append(i==mLastY || mSelectedCells->at(i).at(j));
-                                }
-
-                                mMouseSelectedCells->append(aRow);
-                            }
-                        }
-
+                        verticalHeader_FillShiftSelection();
                         verticalHeader_SelectRangeForHandlers(pos.y());
                     }
                     else
                     {
-                        mMouseSelectedCells->clear();
+                        mMouseSelectedRange=QRect();
 
                         mMouseXForShift=mLastX;
                         mMouseYForShift=mLastY;
@@ -1146,10 +1219,10 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                         {
                             setCurrentCell(mLastY, mColumnCount-1, true);
 
-                            FASTTABLE_ASSERT(mLastY>=0 && mLastY<mSelectedCells->length());
-                            FASTTABLE_ASSERT(mSelectedCells->at(mLastY).length()>0);
+                            FASTTABLE_ASSERT(mLastY>=0 && mLastY<mSelection->rowCount());
+                            FASTTABLE_ASSERT(mSelection->columnCount()>0);
 
-                            if (mSelectedCells->at(mLastY).at(0))
+                            if (mSelection->contains(mLastY, 0))
                             {
                                 unselectRow(mLastY);
                             }
@@ -1164,14 +1237,7 @@ void CustomFastTableWidget::mousePressEvent(QMouseEvent *event)
                             selectRow(mLastY);
                         }
 
-                        QList<bool> aRow;
-
-                        for (int i=0; i<mColumnCount; i++)
-                        {
-                            aRow.append(mSelectedCells->at(mLastY).at(i));
-                        }
-
-                        mMouseSelectedCells->append(aRow);
+                        startMouseSelection(QRect(0, mLastY, mColumnCount, 1));
 
                         viewport()->update();
 
@@ -1306,28 +1372,8 @@ void CustomFastTableWidget::mouseMoveEvent(QMouseEvent *event)
 
         if (mMouseLocation==InCell)
         {
-            int resX=mCurrentColumn;
-            int resY=mCurrentRow;
-
-            while (resX>0 && x<offsetX+mOffsetX->at(resX) && (mColumnWidths->at(resX)<=0 || x<offsetX+mOffsetX->at(resX)+mColumnWidths->at(resX)))
-            {
-                resX--;
-            }
-
-            while (resX<mColumnCount-1 && x>offsetX+mOffsetX->at(resX) && (mColumnWidths->at(resX)<=0 || x>offsetX+mOffsetX->at(resX)+mColumnWidths->at(resX)))
-            {
-                resX++;
-            }
-
-            while (resY>0 && y<offsetY+mOffsetY->at(resY) && (mRowHeights->at(resY)<=0 || y<offsetY+mOffsetY->at(resY)+mRowHeights->at(resY)))
-            {
-                resY--;
-            }
-
-            while (resY<mRowCount-1 && y>offsetY+mOffsetY->at(resY) && (mRowHeights->at(resY)<=0 || y>offsetY+mOffsetY->at(resY)+mRowHeights->at(resY)))
-            {
-                resY++;
-            }
+            int resX=columnAtOffset(x-offsetX);
+            int resY=rowAtOffset(y-offsetY);
 
             if (resX!=mCurrentColumn || resY!=mCurrentRow)
             {
@@ -1417,17 +1463,7 @@ void CustomFastTableWidget::mouseMoveEvent(QMouseEvent *event)
             {
                 if (mMouseLocation==InHorizontalHeaderCell)
                 {
-                    int resX=mCurrentColumn;
-
-                    while (resX>0 && x<offsetX+mOffsetX->at(resX) && (mColumnWidths->at(resX)<=0 || x<offsetX+mOffsetX->at(resX)+mColumnWidths->at(resX)))
-                    {
-                        resX--;
-                    }
-
-                    while (resX<mColumnCount-1 && x>offsetX+mOffsetX->at(resX) && (mColumnWidths->at(resX)<=0 || x>offsetX+mOffsetX->at(resX)+mColumnWidths->at(resX)))
-                    {
-                        resX++;
-                    }
+                    int resX=columnAtOffset(x-offsetX);
 
                     if (resX!=mCurrentColumn)
                     {
@@ -1437,17 +1473,7 @@ void CustomFastTableWidget::mouseMoveEvent(QMouseEvent *event)
                 else
                 if (mMouseLocation==InVerticalHeaderCell)
                 {
-                    int resY=mCurrentRow;
-
-                    while (resY>0 && y<offsetY+mOffsetY->at(resY) && (mRowHeights->at(resY)<=0 || y<offsetY+mOffsetY->at(resY)+mRowHeights->at(resY)))
-                    {
-                        resY--;
-                    }
-
-                    while (resY<mRowCount-1 && y>offsetY+mOffsetY->at(resY) && (mRowHeights->at(resY)<=0 || y>offsetY+mOffsetY->at(resY)+mRowHeights->at(resY)))
-                    {
-                        resY++;
-                    }
+                    int resY=rowAtOffset(y-offsetY);
 
                     if (resY!=mCurrentRow)
                     {
@@ -1622,7 +1648,7 @@ void CustomFastTableWidget::initShiftSelection()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    mMouseSelectedCells->clear();
+    mMouseSelectedRange=QRect();
     mMouseXForShift=mCurrentColumn;
     mMouseYForShift=mCurrentRow;
 
@@ -1634,104 +1660,160 @@ void CustomFastTableWidget::fillShiftSelection()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    if (mMouseSelectedCells->length()==0)
+    if (mMouseSelectedRange.isEmpty())
     {
         int minX=qMin(mCurrentColumn, mLastX);
         int minY=qMin(mCurrentRow, mLastY);
         int maxX=qMax(mCurrentColumn, mLastX);
         int maxY=qMax(mCurrentRow, mLastY);
 
-        for (int i=minY; i<=maxY; i++)
-        {
-            QList<bool> aRow;
+        startMouseSelection(QRect(minX, minY, maxX-minX+1, maxY-minY+1));
 
-            for (int j=minX; j<=maxX; j++)
-            {
-                aRow.append(false);
-            }
+        // Cells between anchor and current cell are considered as selected by mouse
+        mMouseBaseSelection->unselect(mMouseSelectedRange);
+
+        bool aSelected=mSelection->contains(mMouseYForShift, mMouseXForShift);
 
-            mMouseSelectedCells->append(aRow);
+        if (aSelected)
+        {
+            mMouseBaseSelection->select(QRect(mMouseXForShift, mMouseYForShift, 1, 1));
         }
 
-        (*mMouseSelectedCells)[mMouseYForShift-minY][mMouseXForShift-minX]=mSelectedCells->at(mMouseYForShift).at(mMouseXForShift);
+        setRangeSelected(mMouseSelectedRange, aSelected);
     }
 
     FASTTABLE_END_PROFILE;
 }
 
-void CustomFastTableWidget::selectRangeForHandlers(int resX, int resY)
+void CustomFastTableWidget::horizontalHeader_FillShiftSelection()
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    int minX=qMin(resX, mLastX);
-    int minY=qMin(resY, mLastY);
-    int maxX=qMax(resX, mLastX);
-    int maxY=qMax(resY, mLastY);
+    if (mMouseSelectedRange.isEmpty())
+    {
+        int minX=qMin(mCurrentColumn, mLastX);
+        int maxX=qMax(mCurrentColumn, mLastX);
 
-    int lastMinX=qMin(mCurrentColumn, mLastX);
-    int lastMinY=qMin(mCurrentRow, mLastY);
-    int lastMaxX=qMax(mCurrentColumn, mLastX);
-    int lastMaxY=qMax(mCurrentRow, mLastY);
+        startMouseSelection(QRect(minX, 0, maxX-minX+1, mRowCount));
 
-    // Do not process mouse selection if selection was changed programmatically during mouse button holding
+        // Columns between anchor and current column are considered as selected by mouse
+        mMouseBaseSelection->unselect(mMouseSelectedRange);
+        mMouseBaseSelection->select(QRect(mLastX, 0, 1, mRowCount));
+
+        setRangeSelected(mMouseSelectedRange, true);
+    }
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::verticalHeader_FillShiftSelection()
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    if (mMouseSelectedRange.isEmpty())
     {
-        if (lastMaxY-lastMinY+1!=mMouseSelectedCells->length())
-        {
-            return;
-        }
+        int minY=qMin(mCurrentRow, mLastY);
+        int maxY=qMax(mCurrentRow, mLastY);
 
-        for (int i=lastMinY; i<=lastMaxY; i++)
-        {
-            if (lastMaxX-lastMinX+1!=mMouseSelectedCells->at(i-lastMinY).length())
-            {
-                return;
-            }
-        }
+        startMouseSelection(QRect(0, minY, mColumnCount, maxY-minY+1));
+
+        // Rows between anchor and current row are considered as selected by mouse
+        mMouseBaseSelection->unselect(mMouseSelectedRange);
+        mMouseBaseSelection->select(QRect(0, mLastY, mColumnCount, 1));
+
+        setRangeSelected(mMouseSelectedRange, true);
     }
 
-    for (int i=lastMinY; i<=lastMaxY; i++)
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::startMouseSelection(const QRect &range)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    // Implicitly shared, ranges are copied only when base is modified
+    *mMouseBaseSelection=*mSelection;
+    mMouseSelectedRange=range;
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::restoreMouseSelection(const QRect &range)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    setRangeSelected(range, false);
+
+    // Only base ranges inside the range are looked up in the index
+    QList<QRect> aBaseRanges=mMouseBaseSelection->rangesIn(range);
+
+    for (int i=0; i<aBaseRanges.length(); ++i)
     {
-        for (int j=lastMinX; j<=lastMaxX; j++)
-        {
-            setCellSelected(i, j, mMouseSelectedCells->at(i-lastMinY).at(j-lastMinX));
-        }
+        setRangeSelected(aBaseRanges.at(i), true);
     }
 
-    while (mMouseSelectedCells->length()>maxY-minY+1)
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::moveMouseSelection(const QRect &range, const bool selected)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    // Only cells which leave or enter mouse selection are touched
+    QList<QRect> aLeft=SelectionRanges::difference(QList<QRect>() << mMouseSelectedRange, QList<QRect>() << range);
+    QList<QRect> aEntered=SelectionRanges::difference(QList<QRect>() << range, QList<QRect>() << mMouseSelectedRange);
+
+    for (int i=0; i<aLeft.length(); ++i)
     {
-        mMouseSelectedCells->removeLast();
+        restoreMouseSelection(aLeft.at(i));
     }
 
-    while (mMouseSelectedCells->length()<maxY-minY+1)
+    for (int i=0; i<aEntered.length(); ++i)
     {
-        mMouseSelectedCells->append(QList<bool>());
+        setRangeSelected(aEntered.at(i), selected);
     }
 
-    setCurrentCell(resY, resX, true);
+    mMouseSelectedRange=range;
 
-    bool aSelected=mSelectedCells->at(mLastY).at(mLastX);
+    FASTTABLE_END_PROFILE;
+}
 
-    for (int i=minY; i<=maxY; i++)
-    {
-        while (mMouseSelectedCells->at(i-minY).length()>maxX-minX+1)
-        {
-            (*mMouseSelectedCells)[i-minY].removeLast();
-        }
+void CustomFastTableWidget::selectRangeForHandlers(int resX, int resY)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
 
-        while (mMouseSelectedCells->at(i-minY).length()<maxX-minX+1)
-        {
-            (*mMouseSelectedCells)[i-minY].append(false);
-        }
+    int minX=qMin(resX, mLastX);
+    int minY=qMin(resY, mLastY);
+    int maxX=qMax(resX, mLastX);
+    int maxY=qMax(resY, mLastY);
 
-        for (int j=minX; j<=maxX; j++)
-        {
-            (*mMouseSelectedCells)[i-minY][j-minX]=mSelectedCells->at(i).at(j);
+    int lastMinX=qMin(mCurrentColumn, mLastX);
+    int lastMinY=qMin(mCurrentRow, mLastY);
+    int lastMaxX=qMax(mCurrentColumn, mLastX);
+    int lastMaxY=qMax(mCurrentRow, mLastY);
 
-            setCellSelected(i, j, aSelected);
-        }
+    // Do not process mouse selection if selection was changed programmatically during mouse button holding
+    if (mMouseSelectedRange!=QRect(lastMinX, lastMinY, lastMaxX-lastMinX+1, lastMaxY-lastMinY+1))
+    {
+        return;
     }
 
+    // Whole step is reported as one selection change
+    beginUpdate();
+
+    setCurrentCell(resY, resX, true);
+
+    // Anchor cell is always inside mouse selection and keeps its state
+    moveMouseSelection(QRect(minX, minY, maxX-minX+1, maxY-minY+1), mSelection->contains(mLastY, mLastX));
+
+    endUpdate();
+
     FASTTABLE_END_PROFILE;
 }
 
@@ -1746,41 +1828,16 @@ void CustomFastTableWidget::horizontalHeader_SelectRangeForHandlers(int resX)
     int lastMinX=qMin(mCurrentColumn, mLastX);
     int lastMaxX=qMax(mCurrentColumn, mLastX);
 
-    FASTTABLE_ASSERT(mMouseSelectedCells->length()==mRowCount);
+    FASTTABLE_ASSERT(mMouseSelectedRange==QRect(lastMinX, 0, lastMaxX-lastMinX+1, mRowCount));
 
-    for (int i=0; i<mRowCount; i++)
-    {
-        FASTTABLE_ASSERT(lastMaxX-lastMinX+1==mMouseSelectedCells->at(i).length());
-
-        for (int j=lastMinX; j<=lastMaxX; j++)
-        {
-            setCellSelected(i, j, mMouseSelectedCells->at(i).at(j-lastMinX));
-        }
-    }
+    // Whole step is reported as one selection change
+    beginUpdate();
 
     setCurrentCell(mRowCount-1, resX, true);
 
-    bool aSelected=mSelectedCells->at(0).at(mLastX);
-
-    for (int i=0; i<mRowCount; i++)
-    {
-        while (mMouseSelectedCells->at(i).length()>maxX-minX+1)
-        {
-            (*mMouseSelectedCells)[i].removeLast();
-        }
-
-        while (mMouseSelectedCells->at(i).length()<maxX-minX+1)
-        {
-            (*mMouseSelectedCells)[i].append(false);
-        }
-
-        for (int j=minX; j<=maxX; j++)
-        {
-            (*mMouseSelectedCells)[i][j-minX]=mSelectedCells->at(i).at(j);
+    moveMouseSelection(QRect(minX, 0, maxX-minX+1, mRowCount), mSelection->contains(0, mLastX));
 
-            setCellSelected(i, j, aSelected);
-        }
-    }
+    endUpdate();
 
     FASTTABLE_END_PROFILE;
 }
@@ -1796,46 +1853,16 @@ void CustomFastTableWidget::verticalHeader_SelectRangeForHandlers(int resY)
     int lastMinY=qMin(mCurrentRow, mLastY);
     int lastMaxY=qMax(mCurrentRow, mLastY);
 
-    FASTTABLE_ASSERT(lastMaxY-lastMinY+1==mMouseSelectedCells->length());
-
-    for (int i=lastMinY; i<=lastMaxY; i++)
-    {
-        FASTTABLE_ASSERT(mMouseSelectedCells->at(i-lastMinY).length()==mColumnCount);
-
-        for (int j=0; j<mColumnCount; j++)
-        {
-            setCellSelected(i, j, mMouseSelectedCells->at(i-lastMinY).at(j));
-        }
-    }
-
-    while (mMouseSelectedCells->length()>maxY-minY+1)
-    {
-        mMouseSelectedCells->removeLast();
-    }
+    FASTTABLE_ASSERT(mMouseSelectedRange==QRect(0, lastMinY, mColumnCount, lastMaxY-lastMinY+1));
 
-    while (mMouseSelectedCells->length()<maxY-minY+1)
-    {
-        mMouseSelectedCells->append(QList<bool>());
-    }
+    // Whole step is reported as one selection change
+    beginUpdate();
 
     setCurrentCell(resY, mColumnCount-1, true);
 
-    bool aSelected=mSelectedCells->at(mLastY).at(0);
-
-    for (int i=minY; i<=maxY; i++)
-    {
-        while (mMouseSelectedCells->at(i-minY).length()<mColumnCount)
-        {
-            (*mMouseSelectedCells)[i-minY].append(false);
-        }
-
-        for (int j=0; j<mColumnCount; j++)
-        {
-            (*mMouseSelectedCells)[i-minY][j]=mSelectedCells->at(i).at(j);
+    moveMouseSelection(QRect(0, minY, mColumnCount, maxY-minY+1), mSelection->contains(mLastY, 0));
 
-            setCellSelected(i, j, aSelected);
-        }
-    }
+    endUpdate();
 
     FASTTABLE_END_PROFILE;
 }
@@ -1849,7 +1876,7 @@ void CustomFastTableWidget::mouseReleaseEvent(QMouseEvent *event)
     {
         if (atTopLeftCorner(event->x(), event->y()))
         {
-            if (mSelectedCells->at(0).at(0))
+            if (mSelection->contains(0, 0))
             {
                 unselectAll();
             }
@@ -1888,6 +1915,10 @@ void CustomFastTableWidget::mouseReleaseEvent(QMouseEvent *event)
     mLastX=-1;
     mLastY=-1;
 
+    // Next shift selection starts again from the current selection, so the base copy is released
+    mMouseSelectedRange=QRect();
+    *mMouseBaseSelection=SelectionRanges();
+
     mMouseHoldTimer.stop();
 
     mouseMoveEvent(event);
@@ -2058,28 +2089,36 @@ void CustomFastTableWidget::resizeEvent(QResizeEvent *event)
     FASTTABLE_END_PROFILE;
 }
 
-void CustomFastTableWidget::paintEvent(QPaintEvent * /*event*/)
+void CustomFastTableWidget::paintEvent(QPaintEvent *event)
 {
     FASTTABLE_FREQUENT_DEBUG;
     FASTTABLE_FREQUENT_START_PROFILE;
 
     QPainter painter(viewport());
 
-    painter.fillRect(0, 0, viewport()->width(), viewport()->height(), palette().color(QPalette::Window));
+    QRect aExposedRect=event->rect();
+
+    painter.fillRect(aExposedRect, palette().color(QPalette::Window));
 
     int offsetX=-horizontalScrollBar()->value();
     int offsetY=-verticalScrollBar()->value();
 
-    if (mVisibleLeft>=0 && mVisibleTop>=0)
+    QRect aExposedCells=exposedCells(aExposedRect);
+
+    if (aExposedCells.left()<=aExposedCells.right() && aExposedCells.top()<=aExposedCells.bottom())
     {
-        FASTTABLE_ASSERT(mVisibleBottom<mOffsetY->length());
-        FASTTABLE_ASSERT(mVisibleBottom<mRowHeights->length());
-        FASTTABLE_ASSERT(mVisibleRight<mOffsetX->length());
-        FASTTABLE_ASSERT(mVisibleRight<mColumnWidths->length());
+        FASTTABLE_ASSERT(aExposedCells.bottom()<mOffsetY->length());
+        FASTTABLE_ASSERT(aExposedCells.bottom()<mRowHeights->length());
+        FASTTABLE_ASSERT(aExposedCells.right()<mOffsetX->length());
+        FASTTABLE_ASSERT(aExposedCells.right()<mColumnWidths->length());
 
-        for (int i=mVisibleTop; i<=mVisibleBottom; ++i)
+        // Attributes of exposed cells are requested once, missing attributes are requested cell by cell
+        mCellBlock->reset(aExposedCells);
+        fetchVisibleBlock(aExposedCells, *mCellBlock);
+
+        for (int i=aExposedCells.top(); i<=aExposedCells.bottom(); ++i)
         {
-            for (int j=mVisibleLeft; j<=mVisibleRight; ++j)
+            for (int j=aExposedCells.left(); j<=aExposedCells.right(); ++j)
             {
                 if (mColumnWidths->at(j)>0 && mRowHeights->at(i)>0)
                 {
@@ -2087,6 +2126,8 @@ void CustomFastTableWidget::paintEvent(QPaintEvent * /*event*/)
                 }
             }
         }
+
+        mCellBlock->reset(QRect());
     }
 
     if (mEditor)
@@ -2095,16 +2136,16 @@ void CustomFastTableWidget::paintEvent(QPaintEvent * /*event*/)
         mEditor->render(&painter, mapTo(window(), mEditor->pos()));
     }
 
-    if (mHorizontalHeader_VisibleBottom>=0 && mVisibleLeft>=0)
+    if (mHorizontalHeader_VisibleBottom>=0 && aExposedCells.left()<=aExposedCells.right() && aExposedRect.top()<mHorizontalHeader_TotalHeight)
     {
         FASTTABLE_ASSERT(mHorizontalHeader_VisibleBottom<mHorizontalHeader_OffsetY->length());
         FASTTABLE_ASSERT(mHorizontalHeader_VisibleBottom<mHorizontalHeader_RowHeights->length());
-        FASTTABLE_ASSERT(mVisibleRight<mOffsetX->length());
-        FASTTABLE_ASSERT(mVisibleRight<mColumnWidths->length());
+        FASTTABLE_ASSERT(aExposedCells.right()<mOffsetX->length());
+        FASTTABLE_ASSERT(aExposedCells.right()<mColumnWidths->length());
 
         for (int i=0; i<=mHorizontalHeader_VisibleBottom; ++i)
         {
-            for (int j=mVisibleLeft; j<=mVisibleRight; ++j)
+            for (int j=aExposedCells.left(); j<=aExposedCells.right(); ++j)
             {
                 if (mColumnWidths->at(j)>0 && mHorizontalHeader_RowHeights->at(i)>0)
                 {
@@ -2114,14 +2155,14 @@ void CustomFastTableWidget::paintEvent(QPaintEvent * /*event*/)
         }
     }
 
-    if (mVerticalHeader_VisibleRight>=0 && mVisibleTop>=0)
+    if (mVerticalHeader_VisibleRight>=0 && aExposedCells.top()<=aExposedCells.bottom() && aExposedRect.left()<mVerticalHeader_TotalWidth)
     {
-        FASTTABLE_ASSERT(mVisibleBottom<mOffsetY->length());
-        FASTTABLE_ASSERT(mVisibleBottom<mRowHeights->length());
+        FASTTABLE_ASSERT(aExposedCells.bottom()<mOffsetY->length());
+        FASTTABLE_ASSERT(aExposedCells.bottom()<mRowHeights->length());
         FASTTABLE_ASSERT(mVerticalHeader_VisibleRight<mVerticalHeader_OffsetX->length());
         FASTTABLE_ASSERT(mVerticalHeader_VisibleRight<mVerticalHeader_ColumnWidths->length());
 
-        for (int i=mVisibleTop; i<=mVisibleBottom; ++i)
+        for (int i=aExposedCells.top(); i<=aExposedCells.bottom(); ++i)
         {
             for (int j=0; j<=mVerticalHeader_VisibleRight; ++j)
             {
@@ -2133,11 +2174,21 @@ void CustomFastTableWidget::paintEvent(QPaintEvent * /*event*/)
         }
     }
 
-    if (mVerticalHeader_VisibleRight>=0 && mHorizontalHeader_VisibleBottom>=0 && mVerticalHeader_TotalWidth>0 && mHorizontalHeader_TotalHeight>0)
-    {
-        paintCell(painter, 0, 0, mVerticalHeader_TotalWidth, mHorizontalHeader_TotalHeight, -1, -1, DrawTopLeftCorner);
-    }
-
+    if (
+        mVerticalHeader_VisibleRight>=0
+        &&
+        mHorizontalHeader_VisibleBottom>=0
+        &&
+        mVerticalHeader_TotalWidth>0
+        &&
+        mHorizontalHeader_TotalHeight>0
+        &&
+        aExposedRect.intersects(QRect(0, 0, mVerticalHeader_TotalWidth, mHorizontalHeader_TotalHeight))
+       )
+    {
+        paintCell(painter, 0, 0, mVerticalHeader_TotalWidth, mHorizontalHeader_TotalHeight, -1, -1, DrawTopLeftCorner);
+    }
+
     if (mMouseResizeLineX>=0)
     {
         painter.setPen(QPen(QColor(0, 0, 0)));
@@ -2153,6 +2204,69 @@ void CustomFastTableWidget::paintEvent(QPaintEvent * /*event*/)
     FASTTABLE_FREQUENT_END_PROFILE;
 }
 
+void CustomFastTableWidget::scrollContentsBy(int dx, int dy)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+    FASTTABLE_FREQUENT_START_PROFILE;
+
+    if (mUpdateLevel>0)
+    {
+        FASTTABLE_FREQUENT_END_PROFILE;
+        return;
+    }
+
+    if (dx==0 && dy==0)
+    {
+        FASTTABLE_FREQUENT_END_PROFILE;
+        return;
+    }
+
+    QRect aArea=scrolledArea(dx, dy);
+
+    // Already painted content is shifted and only the newly exposed strip is painted
+    if (aArea.isNull())
+    {
+        viewport()->update();
+    }
+    else
+    {
+        viewport()->scroll(dx, dy, aArea);
+    }
+
+    FASTTABLE_FREQUENT_END_PROFILE;
+}
+
+QRect CustomFastTableWidget::scrolledArea(const int dx, const int dy)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    QSize areaSize=viewport()->size();
+
+    // Null rect means the whole viewport should be repainted
+    if (
+        (dx!=0 && dy!=0)
+        ||
+        mMouseResizeLineX>=0
+        ||
+        mMouseResizeLineY>=0
+        ||
+        qAbs(dx)>=areaSize.width()-mVerticalHeader_TotalWidth
+        ||
+        qAbs(dy)>=areaSize.height()-mHorizontalHeader_TotalHeight
+       )
+    {
+        return QRect();
+    }
+
+    // Headers are frozen on their own axis, so vertical header and top-left corner are left out of horizontal shift and horizontal header out of vertical one
+    if (dx!=0)
+    {
+        return QRect(mVerticalHeader_TotalWidth, 0, areaSize.width()-mVerticalHeader_TotalWidth, areaSize.height());
+    }
+
+    return QRect(0, mHorizontalHeader_TotalHeight, areaSize.width(), areaSize.height()-mHorizontalHeader_TotalHeight);
+}
+
 void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int y, const int width, const int height, const int row, const int column, const DrawComponent drawComponent)
 {
     FASTTABLE_FREQUENT_DEBUG;
@@ -2177,12 +2291,14 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
     {
         case DrawCell:
         {
-            FASTTABLE_ASSERT(row>=0 && row<mSelectedCells->length());
-            FASTTABLE_ASSERT(column>=0 && column<mSelectedCells->at(row).length());
+            FASTTABLE_ASSERT(row>=0 && row<mSelection->rowCount());
+            FASTTABLE_ASSERT(column>=0 && column<mSelection->columnCount());
+
+            int aBlockIndex=mCellBlock->indexOf(row, column);
 
             aGridColor=&mGridColor;
 
-            if (mSelectedCells->at(row).at(column))
+            if (mSelection->contains(row, column))
             {
                 aTextBackgroundBrush=aPalette.highlight();
                 aForegroundColor=aPalette.color(QPalette::HighlightedText);
@@ -2194,11 +2310,23 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
                     aTextBackgroundBrush=aPalette.alternateBase();
                 }
                 else
+                if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::BackgroundBrushes))
+                {
+                    aTextBackgroundBrush=mCellBlock->backgroundBrush(aBlockIndex);
+                }
+                else
                 {
                     aTextBackgroundBrush=backgroundBrush(row, column);
                 }
 
-                aForegroundColor=foregroundColor(row, column);
+                if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::ForegroundColors))
+                {
+                    aForegroundColor=mCellBlock->foregroundColor(aBlockIndex);
+                }
+                else
+                {
+                    aForegroundColor=foregroundColor(row, column);
+                }
             }
 
             aBackgroundBrush=&aTextBackgroundBrush;
@@ -2217,24 +2345,56 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
                 aBorderColor=0;
             }
 
-            aTextString=text(row, column);
+            if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::Texts))
+            {
+                aTextString=mCellBlock->text(aBlockIndex);
+            }
+            else
+            {
+                aTextString=cachedText(row, column);
+            }
+
             aText=&aTextString;
 
-            aTextFont=cellFont(row, column);
+            if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::Fonts))
+            {
+                aTextFont=mCellBlock->font(aBlockIndex);
+            }
+            else
+            {
+                aTextFont=cellFont(row, column);
+            }
+
             aFont=&aTextFont;
 
-            textFlags=cellTextFlags(row, column);
+            if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::TextFlags))
+            {
+                textFlags=mCellBlock->textFlag(aBlockIndex);
+            }
+            else
+            {
+                textFlags=cellTextFlags(row, column);
+            }
+
+            // Placeholder is painted while the row is loading
+            if (mAsyncDataProvider && !mAsyncDataProvider->isRowLoaded(row))
+            {
+                aTextBackgroundBrush=aPalette.window();
+                aText=0;
+            }
         }
         break;
         case DrawHorizontalHeaderCell:
         {
             FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_Data->length());
             FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_Data->at(row).length());
-            FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_SelectedColumns->length());
+            FASTTABLE_ASSERT(column>=0 && column<mSelection->columnCount());
 
             aGridColor=&mHorizontalHeader_GridColor;
             aBackgroundBrush=&mHorizontalHeader_DefaultBackgroundBrush;
 
+            int aSelectedCount=mSelection->columnCellCount(column);
+
             if (mMouseLocation==InHorizontalHeaderCell)
             {
                 if (mMousePressed)
@@ -2243,7 +2403,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
                     int maxX=qMax(mCurrentColumn, mLastX);
 
                     if (
-                        mHorizontalHeader_SelectedColumns->at(column)==mRowCount
+                        aSelectedCount==mRowCount
                         ||
                         (
                          mMouseResizeCell<0
@@ -2273,7 +2433,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
                     }
                     else
                     {
-                        if (mHorizontalHeader_SelectedColumns->at(column)==mRowCount)
+                        if (aSelectedCount==mRowCount)
                         {
                             aHeaderPressed=true;
                             aBorderColor=&mHorizontalHeader_CellBorderColor;
@@ -2287,7 +2447,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
             }
             else
             {
-                if (mHorizontalHeader_SelectedColumns->at(column)==mRowCount)
+                if (aSelectedCount==mRowCount)
                 {
                     aHeaderPressed=true;
                     aBorderColor=&mHorizontalHeader_CellBorderColor;
@@ -2305,7 +2465,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
             aTextFont=font();
             aFont=&aTextFont;
 
-            if (mHorizontalHeader_SelectedColumns->at(column))
+            if (aSelectedCount)
             {
                 aFont->setPointSize(aFont->pointSize()+1);
                 aFont->setBold(true);
@@ -2318,11 +2478,13 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
         {
             FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_Data->length());
             FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_Data->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_SelectedRows->length());
+            FASTTABLE_ASSERT(row>=0 && row<mSelection->rowCount());
 
             aGridColor=&mVerticalHeader_GridColor;
             aBackgroundBrush=&mVerticalHeader_DefaultBackgroundBrush;
 
+            int aSelectedCount=mSelection->rowCellCount(row);
+
             if (mMouseLocation==InVerticalHeaderCell)
             {
                 if (mMousePressed)
@@ -2331,7 +2493,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
                     int maxY=qMax(mCurrentRow, mLastY);
 
                     if (
-                        mVerticalHeader_SelectedRows->at(row)==mColumnCount
+                        aSelectedCount==mColumnCount
                         ||
                         (
                          mMouseResizeCell<0
@@ -2361,7 +2523,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
                     }
                     else
                     {
-                        if (mVerticalHeader_SelectedRows->at(row)==mColumnCount)
+                        if (aSelectedCount==mColumnCount)
                         {
                             aHeaderPressed=true;
                             aBorderColor=&mVerticalHeader_CellBorderColor;
@@ -2375,7 +2537,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
             }
             else
             {
-                if (mVerticalHeader_SelectedRows->at(row)==mColumnCount)
+                if (aSelectedCount==mColumnCount)
                 {
                     aHeaderPressed=true;
                     aBorderColor=&mVerticalHeader_CellBorderColor;
@@ -2399,7 +2561,7 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
             aTextFont=font();
             aFont=&aTextFont;
 
-            if (mVerticalHeader_SelectedRows->at(row))
+            if (aSelectedCount)
             {
                 aFont->setPointSize(aFont->pointSize()+1);
                 aFont->setBold(true);
@@ -2483,6 +2645,13 @@ void CustomFastTableWidget::paintCell(QPainter &painter, const int x, const int
     FASTTABLE_FREQUENT_END_PROFILE;
 }
 
+void CustomFastTableWidget::fetchVisibleBlock(const QRect &/*range*/, CellBlock &/*block*/)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    // Reimplement this function to provide attributes of many cells at once. Block is empty by default
+}
+
 void CustomFastTableWidget::paintCellLinux(QPainter &painter, const int x, const int y, const int width, const int height, const bool /*headerPressed*/, QColor *aGridColor, QBrush *aBackgroundBrush, QColor *aBorderColor)
 {
     FASTTABLE_FREQUENT_DEBUG;
@@ -2954,7 +3123,14 @@ void CustomFastTableWidget::scrollBarValueChanged(int /*value*/)
     FASTTABLE_FREQUENT_DEBUG;
     FASTTABLE_FREQUENT_START_PROFILE;
 
+    if (mUpdateLevel>0)
+    {
+        mPendingSizes=true;
+        return;
+    }
+
     updateVisibleRange();
+    requestVisibleRows();
     updateEditorPosition();
 
     FASTTABLE_FREQUENT_END_PROFILE;
@@ -2962,15 +3138,87 @@ void CustomFastTableWidget::scrollBarValueChanged(int /*value*/)
 
 void CustomFastTableWidget::updateVerticalHeaderSize()
 {
+    if (mUpdateLevel>0)
+    {
+        mPendingVerticalHeaderSize=true;
+        return;
+    }
+
     QFont aFont=font();
     aFont.setBold(true);
 
     int aColumnWidth=QFontMetrics(aFont).width(QString::number(rowCount()*10))+FASTTABLE_TEXT_MARGIN*2;
+    bool aChanged=false;
 
     for (int i=0; i<verticalHeader_ColumnCount(); ++i)
     {
-        verticalHeader_SetColumnWidth(i, aColumnWidth);
+        if (verticalHeader_ColumnWidth(i)!=aColumnWidth)
+        {
+            verticalHeader_SetColumnWidth(i, aColumnWidth, false);
+            aChanged=true;
+        }
+    }
+
+    if (aChanged)
+    {
+        verticalHeader_UpdateOffsetsX();
+    }
+}
+
+void CustomFastTableWidget::emitSelectionChanged(const QList<QRect> &selected, const QList<QRect> &deselected)
+{
+    if (selected.isEmpty() && deselected.isEmpty())
+    {
+        return;
+    }
+
+    if (mUpdateLevel==0)
+    {
+        emit selectionChanged(selected, deselected);
+        return;
+    }
+
+    // Changes inside beginUpdate() are accumulated, so cells changed back and forth are not reported
+    for (int i=0; i<selected.length(); ++i)
+    {
+        QList<QRect> aNew=mPendingDeselected->unselectedIn(QList<QRect>()<<selected.at(i));
+        mPendingDeselected->unselect(selected.at(i));
+
+        for (int j=0; j<aNew.length(); ++j)
+        {
+            mPendingSelected->select(aNew.at(j));
+        }
+    }
+
+    for (int i=0; i<deselected.length(); ++i)
+    {
+        QList<QRect> aNew=mPendingSelected->unselectedIn(QList<QRect>()<<deselected.at(i));
+        mPendingSelected->unselect(deselected.at(i));
+
+        for (int j=0; j<aNew.length(); ++j)
+        {
+            mPendingDeselected->select(aNew.at(j));
+        }
+    }
+}
+
+void CustomFastTableWidget::emitCurrentCellChanged(const int previousRow, const int previousColumn)
+{
+    if (mUpdateLevel>0)
+    {
+        // Only the first previous cell is reported on endUpdate
+        if (!mPendingCurrentCellChanged)
+        {
+            mPendingCurrentCellChanged=true;
+            mPendingPreviousRow=previousRow;
+            mPendingPreviousColumn=previousColumn;
+        }
+
+        return;
     }
+
+    emit currentCellChanged(mCurrentRow, mCurrentColumn, previousRow, previousColumn);
+    emit cellChanged(mCurrentRow, mCurrentColumn);
 }
 
 void CustomFastTableWidget::updateSizes()
@@ -2978,6 +3226,14 @@ void CustomFastTableWidget::updateSizes()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
+    if (mUpdateLevel>0)
+    {
+        mPendingSizes=true;
+        return;
+    }
+
+    mPendingSizes=false;
+
     if (mHorizontalHeaderStretchLastSection && mColumnCount>0)
     {
         int aTotalWidth=0;
@@ -3048,6 +3304,7 @@ void CustomFastTableWidget::updateSizes()
 
     updateBarsRanges();
     updateVisibleRange();
+    requestVisibleRows();
     updateEditorPosition();
 
     FASTTABLE_END_PROFILE;
@@ -3058,6 +3315,12 @@ void CustomFastTableWidget::updateBarsRanges()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
+    if (mUpdateLevel>0)
+    {
+        mPendingSizes=true;
+        return;
+    }
+
     if (mTotalWidth<=0 || mTotalHeight<=0)
     {
         horizontalScrollBar()->setRange(0, 0);
@@ -3106,59 +3369,16 @@ void CustomFastTableWidget::updateVisibleRange()
         }
         else
         {
-            if (mVerticalHeader_VisibleRight<0)
-            {
-                mVerticalHeader_VisibleRight=0;
-            }
-            else
-            if (mVerticalHeader_VisibleRight>=mVerticalHeader_ColumnCount)
-            {
-                mVerticalHeader_VisibleRight=mVerticalHeader_ColumnCount-1;
-            }
-
-            FASTTABLE_ASSERT(mVerticalHeader_VisibleRight<mVerticalHeader_OffsetX->length());
-            FASTTABLE_ASSERT(mVerticalHeader_VisibleRight<mVerticalHeader_ColumnWidths->length());
-
-            while (mVerticalHeader_VisibleRight<mVerticalHeader_ColumnCount-1 && mVerticalHeader_OffsetX->at(mVerticalHeader_VisibleRight)<maxX && (mVerticalHeader_ColumnWidths->at(mVerticalHeader_VisibleRight)<=0 || mVerticalHeader_OffsetX->at(mVerticalHeader_VisibleRight)+mVerticalHeader_ColumnWidths->at(mVerticalHeader_VisibleRight)<maxX))
-            {
-                mVerticalHeader_VisibleRight++;
-            }
-
-            while (mVerticalHeader_VisibleRight>0 && mVerticalHeader_OffsetX->at(mVerticalHeader_VisibleRight)>maxX && (mVerticalHeader_ColumnWidths->at(mVerticalHeader_VisibleRight)<=0 || mVerticalHeader_OffsetX->at(mVerticalHeader_VisibleRight)+mVerticalHeader_ColumnWidths->at(mVerticalHeader_VisibleRight)>maxX))
-            {
-                mVerticalHeader_VisibleRight--;
-            }
+            mVerticalHeader_VisibleRight=verticalHeader_columnAtOffset(maxX);
         }
 
-
         if (mHorizontalHeader_RowCount==0)
         {
             mHorizontalHeader_VisibleBottom=-1;
         }
         else
         {
-            if (mHorizontalHeader_VisibleBottom<0)
-            {
-                mHorizontalHeader_VisibleBottom=0;
-            }
-            else
-            if (mHorizontalHeader_VisibleBottom>=mHorizontalHeader_RowCount)
-            {
-                mHorizontalHeader_VisibleBottom=mHorizontalHeader_RowCount-1;
-            }
-
-            FASTTABLE_ASSERT(mHorizontalHeader_VisibleBottom<mHorizontalHeader_OffsetY->length());
-            FASTTABLE_ASSERT(mHorizontalHeader_VisibleBottom<mHorizontalHeader_RowHeights->length());
-
-            while (mHorizontalHeader_VisibleBottom<mHorizontalHeader_RowCount-1 && mHorizontalHeader_OffsetY->at(mHorizontalHeader_VisibleBottom)<maxY && (mHorizontalHeader_RowHeights->at(mHorizontalHeader_VisibleBottom)<=0 || mHorizontalHeader_OffsetY->at(mHorizontalHeader_VisibleBottom)+mHorizontalHeader_RowHeights->at(mHorizontalHeader_VisibleBottom)<maxY))
-            {
-                mHorizontalHeader_VisibleBottom++;
-            }
-
-            while (mHorizontalHeader_VisibleBottom>0 && mHorizontalHeader_OffsetY->at(mHorizontalHeader_VisibleBottom)>maxY && (mHorizontalHeader_RowHeights->at(mHorizontalHeader_VisibleBottom)<=0 || mHorizontalHeader_OffsetY->at(mHorizontalHeader_VisibleBottom)+mHorizontalHeader_RowHeights->at(mHorizontalHeader_VisibleBottom)>maxY))
-            {
-                mHorizontalHeader_VisibleBottom--;
-            }
+            mHorizontalHeader_VisibleBottom=horizontalHeader_rowAtOffset(maxY);
         }
 
         if (
@@ -3172,53 +3392,8 @@ void CustomFastTableWidget::updateVisibleRange()
             )
            )
         {
-            if (
-                mVisibleTop<0
-                ||
-                mVisibleBottom<0
-               )
-            {
-                mVisibleTop=0;
-                mVisibleBottom=0;
-            }
-            else
-            {
-                if (mVisibleTop>=mRowCount)
-                {
-                    mVisibleTop=mRowCount-1;
-                }
-                if (mVisibleBottom>=mRowCount)
-                {
-                    mVisibleBottom=mRowCount-1;
-                }
-            }
-
-            minY+=mHorizontalHeader_TotalHeight;
-
-            FASTTABLE_ASSERT(mVisibleTop<mOffsetY->length());
-            FASTTABLE_ASSERT(mVisibleTop<mRowHeights->length());
-            FASTTABLE_ASSERT(mVisibleBottom<mOffsetY->length());
-            FASTTABLE_ASSERT(mVisibleBottom<mRowHeights->length());
-
-            while (mVisibleTop<mRowCount-1 && mOffsetY->at(mVisibleTop)<minY && (mRowHeights->at(mVisibleTop)<=0 || mOffsetY->at(mVisibleTop)+mRowHeights->at(mVisibleTop)<minY))
-            {
-                mVisibleTop++;
-            }
-
-            while (mVisibleTop>0 && mOffsetY->at(mVisibleTop)>minY && (mRowHeights->at(mVisibleTop)<=0 || mOffsetY->at(mVisibleTop)+mRowHeights->at(mVisibleTop)>minY))
-            {
-                mVisibleTop--;
-            }
-
-            while (mVisibleBottom<mRowCount-1 && mOffsetY->at(mVisibleBottom)<maxY && (mRowHeights->at(mVisibleBottom)<=0 || mOffsetY->at(mVisibleBottom)+mRowHeights->at(mVisibleBottom)<maxY))
-            {
-                mVisibleBottom++;
-            }
-
-            while (mVisibleBottom>0 && mOffsetY->at(mVisibleBottom)>maxY && (mRowHeights->at(mVisibleBottom)<=0 || mOffsetY->at(mVisibleBottom)+mRowHeights->at(mVisibleBottom)>maxY))
-            {
-                mVisibleBottom--;
-            }
+            mVisibleTop=rowAtOffset(minY+mHorizontalHeader_TotalHeight);
+            mVisibleBottom=rowAtOffset(maxY);
         }
         else
         {
@@ -3237,62 +3412,95 @@ void CustomFastTableWidget::updateVisibleRange()
             )
            )
         {
-            if (
-                mVisibleLeft<0
-                ||
-                mVisibleRight<0
-               )
-            {
-                mVisibleLeft=0;
-                mVisibleRight=0;
-            }
-            else
-            {
-                if (mVisibleLeft>=mColumnCount)
-                {
-                    mVisibleLeft=mColumnCount-1;
-                }
-                if (mVisibleRight>=mColumnCount)
-                {
-                    mVisibleRight=mColumnCount-1;
-                }
-            }
+            mVisibleLeft=columnAtOffset(minX+mVerticalHeader_TotalWidth);
+            mVisibleRight=columnAtOffset(maxX);
+        }
+        else
+        {
+            mVisibleLeft=-1;
+            mVisibleRight=-1;
+        }
+    }
 
-            minX+=mVerticalHeader_TotalWidth;
+    FASTTABLE_END_PROFILE;
+}
 
-            FASTTABLE_ASSERT(mVisibleLeft<mOffsetX->length());
-            FASTTABLE_ASSERT(mVisibleLeft<mColumnWidths->length());
-            FASTTABLE_ASSERT(mVisibleRight<mOffsetX->length());
-            FASTTABLE_ASSERT(mVisibleRight<mColumnWidths->length());
+QRect CustomFastTableWidget::exposedCells(const QRect &area)
+{
+    FASTTABLE_FREQUENT_DEBUG;
 
-            while (mVisibleLeft<mColumnCount-1 && mOffsetX->at(mVisibleLeft)<minX && (mColumnWidths->at(mVisibleLeft)<=0 || mOffsetX->at(mVisibleLeft)+mColumnWidths->at(mVisibleLeft)<minX))
-            {
-                mVisibleLeft++;
-            }
+    // Empty ranges are returned as right<left and bottom<top
+    int aLeft=0;
+    int aRight=-1;
+    int aTop=0;
+    int aBottom=-1;
 
-            while (mVisibleLeft>0 && mOffsetX->at(mVisibleLeft)>minX && (mColumnWidths->at(mVisibleLeft)<=0 || mOffsetX->at(mVisibleLeft)+mColumnWidths->at(mVisibleLeft)>minX))
-            {
-                mVisibleLeft--;
-            }
+    if (mVisibleLeft>=0)
+    {
+        aLeft=qMax(columnAtOffset(area.left()+horizontalScrollBar()->value()), mVisibleLeft);
+        aRight=qMin(columnAtOffset(area.right()+horizontalScrollBar()->value()), mVisibleRight);
+    }
 
-            while (mVisibleRight<mColumnCount-1 && mOffsetX->at(mVisibleRight)<maxX && (mColumnWidths->at(mVisibleRight)<=0 || mOffsetX->at(mVisibleRight)+mColumnWidths->at(mVisibleRight)<maxX))
-            {
-                mVisibleRight++;
-            }
+    if (mVisibleTop>=0)
+    {
+        aTop=qMax(rowAtOffset(area.top()+verticalScrollBar()->value()), mVisibleTop);
+        aBottom=qMin(rowAtOffset(area.bottom()+verticalScrollBar()->value()), mVisibleBottom);
+    }
 
-            while (mVisibleRight>0 && mOffsetX->at(mVisibleRight)>maxX && (mColumnWidths->at(mVisibleRight)<=0 || mOffsetX->at(mVisibleRight)+mColumnWidths->at(mVisibleRight)>maxX))
-            {
-                mVisibleRight--;
-            }
+    return QRect(QPoint(aLeft, aTop), QPoint(aRight, aBottom));
+}
+
+void CustomFastTableWidget::updateHeaderAreas()
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    if (mUpdateLevel>0)
+    {
+        return;
+    }
+
+    viewport()->update(0, 0, viewport()->width(), mHorizontalHeader_TotalHeight);
+    viewport()->update(0, 0, mVerticalHeader_TotalWidth, viewport()->height());
+}
+
+int CustomFastTableWidget::searchOffset(const QList<int> *offsets, const QList<qint16> *sizes, const int count, const int position)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    if (count<=0)
+    {
+        return -1;
+    }
+
+    FASTTABLE_ASSERT(count<=offsets->length());
+    FASTTABLE_ASSERT(count<=sizes->length());
+
+    // Hidden cells have negative size and take no space, so cell ends are not decreasing
+    // Result is the first cell that ends after position, or the last cell
+    int aLeft=0;
+    int aRight=count-1;
+
+    while (aLeft<aRight)
+    {
+        int aMiddle=(aLeft+aRight)/2;
+        int aEnd=offsets->at(aMiddle);
+
+        if (sizes->at(aMiddle)>0)
+        {
+            aEnd+=sizes->at(aMiddle);
+        }
+
+        if (aEnd>position)
+        {
+            aRight=aMiddle;
         }
         else
         {
-            mVisibleLeft=-1;
-            mVisibleRight=-1;
+            aLeft=aMiddle+1;
         }
     }
 
-    FASTTABLE_END_PROFILE;
+    return aLeft;
 }
 
 void CustomFastTableWidget::clear()
@@ -3330,6 +3538,21 @@ void CustomFastTableWidget::clear()
         mData->clear();
     }
 
+    if (mTextColumns)
+    {
+        mTextColumns->clear();
+    }
+
+    if (mAsyncDataProvider)
+    {
+        mAsyncDataProvider->invalidate();
+    }
+
+    if (mRowCache)
+    {
+        mRowCache->clear();
+    }
+
     mRowHeights->clear();
     mColumnWidths->clear();
     mOffsetX->clear();
@@ -3343,10 +3566,10 @@ void CustomFastTableWidget::clear()
     mVerticalHeader_ColumnWidths->clear();
     mVerticalHeader_OffsetX->clear();
 
-    mSelectedCells->clear();
-    mCurSelection->clear();
-    mHorizontalHeader_SelectedColumns->clear();
-    mVerticalHeader_SelectedRows->clear();
+    QList<QRect> aDeselected=mSelection->ranges();
+
+    mSelection->clear();
+    mSelection->resize(0, 0);
 
     mMouseXForShift=-1;
     mMouseYForShift=-1;
@@ -3354,7 +3577,7 @@ void CustomFastTableWidget::clear()
     mMouseResizeLineY=-1;
     mMouseResizeCell=-1;
 
-    mMouseSelectedCells->clear();
+    mMouseSelectedRange=QRect();
 
     mEditCellRow=-1;
     mEditCellColumn=-1;
@@ -3364,12 +3587,11 @@ void CustomFastTableWidget::clear()
 
     viewport()->update();
 
-    emit selectionChanged();
+    emitSelectionChanged(QList<QRect>(), aDeselected);
 
     if (aOldCurrentRow!=mCurrentRow || aOldCurrentColumn!=mCurrentColumn)
     {
-        emit currentCellChanged(mCurrentRow, mCurrentColumn, aOldCurrentRow, aOldCurrentColumn);
-        emit cellChanged(mCurrentRow, mCurrentColumn);
+        emitCurrentCellChanged(aOldCurrentRow, aOldCurrentColumn);
     }
 
     FASTTABLE_END_PROFILE;
@@ -3377,12 +3599,24 @@ void CustomFastTableWidget::clear()
 
 void CustomFastTableWidget::copy()
 {
-    QList<QRect> aRanges=selectedRanges();
+    const QList<QRect> &aRanges=mSelection->ranges();
 
     if (aRanges.length()>0)
     {
+        // Ranges are in reading order, so the first one starts at top left selected cell
         QRect aCopyRect=aRanges.at(0);
         QStringList toClipboard;
+        QList<int> aColumns;
+
+        for (int i=aCopyRect.left(); i<=aCopyRect.right(); i++)
+        {
+            if (columnVisible(i))
+            {
+                aColumns.append(i);
+            }
+        }
+
+        toClipboard.reserve(aCopyRect.height());
 
         for (int i=aCopyRect.top(); i<=aCopyRect.bottom(); i++)
         {
@@ -3393,14 +3627,11 @@ void CustomFastTableWidget::copy()
 
             QStringList aRow;
 
-            for (int j=aCopyRect.left(); j<=aCopyRect.right(); j++)
-            {
-                if (!columnVisible(j))
-                {
-                    continue;
-                }
+            aRow.reserve(aColumns.length());
 
-                aRow.append(text(i, j));
+            for (int j=0; j<aColumns.length(); j++)
+            {
+                aRow.append(text(i, aColumns.at(j)));
             }
 
             toClipboard.append(aRow.join("\t"));
@@ -3417,10 +3648,7 @@ void CustomFastTableWidget::selectRow(const int row)
 
     FASTTABLE_ASSERT(row>=0 && row<mRowCount);
 
-    for (int i=0; i<mColumnCount; ++i)
-    {
-        setCellSelected(row, i, true);
-    }
+    setRangeSelected(QRect(0, row, mColumnCount, 1), true);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3432,10 +3660,7 @@ void CustomFastTableWidget::unselectRow(const int row)
 
     FASTTABLE_ASSERT(row>=0 && row<mRowCount);
 
-    for (int i=0; i<mColumnCount; ++i)
-    {
-        setCellSelected(row, i, false);
-    }
+    setRangeSelected(QRect(0, row, mColumnCount, 1), false);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3447,10 +3672,7 @@ void CustomFastTableWidget::selectColumn(const int column)
 
     FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    for (int i=0; i<mRowCount; ++i)
-    {
-        setCellSelected(i, column, true);
-    }
+    setRangeSelected(QRect(column, 0, 1, mRowCount), true);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3462,10 +3684,7 @@ void CustomFastTableWidget::unselectColumn(const int column)
 
     FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    for (int i=0; i<mRowCount; ++i)
-    {
-        setCellSelected(i, column, false);
-    }
+    setRangeSelected(QRect(column, 0, 1, mRowCount), false);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3528,6 +3747,12 @@ void CustomFastTableWidget::searchNext(const QString &pattern, const QTableWidge
                  aCurColumn==column
                 )
                 &&
+                (
+                 mMappedCsvFile==0
+                 ||
+                 mMappedCsvFile->rowMayContain(aCurRow, pattern)
+                )
+                &&
                 text(aCurRow, aCurColumn).contains(pattern, Qt::CaseInsensitive)
                )
             {
@@ -3568,6 +3793,12 @@ void CustomFastTableWidget::searchNext(const QString &pattern, const QTableWidge
                 continue;
             }
 
+            // Raw row is checked before its cells are decoded
+            if (mMappedCsvFile && !mMappedCsvFile->rowMayContain(aCurRow, pattern))
+            {
+                continue;
+            }
+
             if (column<0)
             {
                 bool good=false;
@@ -3659,6 +3890,12 @@ void CustomFastTableWidget::searchPrevious(const QString &pattern, const QTableW
                  aCurColumn==column
                 )
                 &&
+                (
+                 mMappedCsvFile==0
+                 ||
+                 mMappedCsvFile->rowMayContain(aCurRow, pattern)
+                )
+                &&
                 text(aCurRow, aCurColumn).contains(pattern, Qt::CaseInsensitive)
                )
             {
@@ -3699,6 +3936,12 @@ void CustomFastTableWidget::searchPrevious(const QString &pattern, const QTableW
                 continue;
             }
 
+            // Raw row is checked before its cells are decoded
+            if (mMappedCsvFile && !mMappedCsvFile->rowMayContain(aCurRow, pattern))
+            {
+                continue;
+            }
+
             if (column<0)
             {
                 bool good=false;
@@ -3953,59 +4196,15 @@ void CustomFastTableWidget::selectAll()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    bool allSelected=true;
-
-    for (int i=0; i<mColumnCount; ++i)
-    {
-        FASTTABLE_ASSERT(i<mHorizontalHeader_SelectedColumns->length());
-
-        if (mHorizontalHeader_SelectedColumns->at(i)!=mRowCount)
-        {
-            allSelected=false;
-            break;
-        }
-    }
-
-    if (!allSelected)
+    if (!mSelection->isAllSelected())
     {
-        QPoint aCellPos;
-
-        for (int i=0; i<mRowCount; ++i)
-        {
-            for (int j=0; j<mColumnCount; ++j)
-            {
-                FASTTABLE_ASSERT(i<mSelectedCells->length());
-                FASTTABLE_ASSERT(j<mSelectedCells->at(i).length());
-
-                if (!mSelectedCells->at(i).at(j))
-                {
-                    aCellPos.setX(j);
-                    aCellPos.setY(i);
-
-                    mCurSelection->append(aCellPos);
-
-                    (*mSelectedCells)[i][j]=true;
-                }
-            }
-        }
-
-        for (int i=0; i<mRowCount; ++i)
-        {
-            FASTTABLE_ASSERT(i<mVerticalHeader_SelectedRows->length());
-
-            (*mVerticalHeader_SelectedRows)[i]=mColumnCount;
-        }
+        QList<QRect> aSelected=mSelection->unselectedIn(QList<QRect>()<<QRect(0, 0, mColumnCount, mRowCount));
 
-        for (int i=0; i<mColumnCount; ++i)
-        {
-            FASTTABLE_ASSERT(i<mHorizontalHeader_SelectedColumns->length());
-
-            (*mHorizontalHeader_SelectedColumns)[i]=mRowCount;
-        }
+        mSelection->selectAll();
 
         viewport()->update();
 
-        emit selectionChanged();
+        emitSelectionChanged(aSelected, QList<QRect>());
     }
 
     FASTTABLE_END_PROFILE;
@@ -4016,35 +4215,33 @@ void CustomFastTableWidget::unselectAll()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    if (mCurSelection->length()>0)
+    if (!mSelection->isEmpty())
     {
-        for (int i=0; i<mCurSelection->length(); ++i)
-        {
-            FASTTABLE_ASSERT(mCurSelection->at(i).y()<mSelectedCells->length());
-            FASTTABLE_ASSERT(mCurSelection->at(i).x()<mSelectedCells->at(mCurSelection->at(i).y()).length());
+        // Repaint selected cells one by one only while there are fewer of them than visible cells
+        bool aUpdateAll=mSelection->cellCount()>((qint64)(mVisibleBottom-mVisibleTop+1))*(mVisibleRight-mVisibleLeft+1);
+
+        QList<QRect> aDeselected=mSelection->ranges();
 
-            (*mSelectedCells)[mCurSelection->at(i).y()][mCurSelection->at(i).x()]=false;
+        if (!aUpdateAll)
+        {
+            for (int i=0; i<aDeselected.length(); ++i)
+            {
+                updateCells(aDeselected.at(i));
+            }
         }
 
-        mCurSelection->clear();
+        mSelection->clear();
 
-        for (int i=0; i<mRowCount; ++i)
+        if (aUpdateAll)
         {
-            FASTTABLE_ASSERT(i<mVerticalHeader_SelectedRows->length());
-
-            (*mVerticalHeader_SelectedRows)[i]=0;
+            viewport()->update();
         }
-
-        for (int i=0; i<mColumnCount; ++i)
+        else
         {
-            FASTTABLE_ASSERT(i<mHorizontalHeader_SelectedColumns->length());
-
-            (*mHorizontalHeader_SelectedColumns)[i]=0;
+            updateHeaderAreas();
         }
 
-        viewport()->update();
-
-        emit selectionChanged();
+        emitSelectionChanged(QList<QRect>(), aDeselected);
     }
 
     FASTTABLE_END_PROFILE;
@@ -4065,75 +4262,101 @@ void CustomFastTableWidget::insertRow(int row)
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
+    insertRows(row, 1);
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::removeRow(int row)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    removeRows(row, 1);
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::insertRows(int row, int count)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
     FASTTABLE_ASSERT(row>=0 && row<=mRowCount);
     FASTTABLE_ASSERT(row>=0 && row<=mOffsetY->length());
     FASTTABLE_ASSERT(row>=0 && row<=mRowHeights->length());
     FASTTABLE_ASSERT(mData==0 || (row>=0 && row<=mData->length()));
+    FASTTABLE_ASSERT(mTextColumns==0 || (row>=0 && row<=mTextColumns->rowCount()));
     FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_Data->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mSelectedCells->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_SelectedRows->length());
+    FASTTABLE_ASSERT(row>=0 && row<=mSelection->rowCount());
+    FASTTABLE_ASSERT(count>=0);
 
-    mRowCount++;
+    if (count<=0)
+    {
+        return;
+    }
 
     QStringList aNewRow;
-    QList<bool> aNewRowbool;
-
-    mTotalHeight+=mDefaultHeight;
+    QStringList aNewHeaderRow;
 
-    mOffsetY->insert(row, row==0? mHorizontalHeader_TotalHeight : (mRowHeights->at(row-1)<=0? mOffsetY->at(row-1) : (mOffsetY->at(row-1)+mRowHeights->at(row-1))));
-    mRowHeights->insert(row, mDefaultHeight);
-
-    for (int i=row+1; i<mRowCount; ++i)
+    for (int i=0; i<mColumnCount; ++i)
     {
-        (*mOffsetY)[i]+=mDefaultHeight;
+        aNewRow.append("");
     }
 
-    if (mData)
+    for (int i=0; i<mVerticalHeader_ColumnCount; ++i)
     {
-        mData->insert(row, aNewRow);
+        aNewHeaderRow.append("");
     }
 
-    mVerticalHeader_Data->insert(row, aNewRow);
-    mSelectedCells->insert(row, aNewRowbool);
-    mVerticalHeader_SelectedRows->insert(row, 0);
+    mRowCount+=count;
 
-    for (int i=0; i<mVerticalHeader_ColumnCount; ++i)
+    mTotalHeight+=mDefaultHeight*count;
+
+    mRowHeights->insert(row, count, mDefaultHeight);
+    mOffsetY->sizesInserted(row, count);
+
+    // New rows are implicitly shared until modified
+    if (mData)
     {
-        (*mVerticalHeader_Data)[row].append("");
+        fastInsertRange(*mData, row, count, aNewRow);
     }
 
-    for (int i=0; i<mColumnCount; ++i)
+    if (mTextColumns)
     {
-        if (mData)
-        {
-            (*mData)[row].append("");
-        }
+        mTextColumns->insertRows(row, count);
+    }
 
-        (*mSelectedCells)[row].append(false);
+    // Loaded rows after the inserted ones are shifted, so they are loaded again
+    if (mAsyncDataProvider)
+    {
+        mAsyncDataProvider->invalidateRows(row, mRowCount-1);
     }
 
-    for (int i=0; i<mCurSelection->length(); ++i)
+    if (mRowCache)
     {
-        if (mCurSelection->at(i).y()>=row)
-        {
-            (*mCurSelection)[i].setY(mCurSelection->at(i).y()+1);
-        }
+        mRowCache->removeRows(row, mRowCount-1);
     }
 
+    fastInsertRange(*mVerticalHeader_Data, row, count, aNewHeaderRow);
+    mSelection->insertRows(row, count);
+    mPendingSelected->insertRows(row, count);
+    mPendingDeselected->insertRows(row, count);
+
     if (mCurrentRow>=row)
     {
-        mCurrentRow++;
+        mCurrentRow+=count;
     }
 
     if (mEditCellRow>=row)
     {
-        mEditCellRow++;
+        mEditCellRow+=count;
     }
 
     mMouseXForShift=-1;
     mMouseYForShift=-1;
     mMouseLocationForShift=InMiddleWorld;
-    mMouseSelectedCells->clear();
+    mMouseSelectedRange=QRect();
 
     updateSizes();
 
@@ -4144,78 +4367,85 @@ void CustomFastTableWidget::insertRow(int row)
 
     viewport()->update();
 
+    emit rowsInserted(row, count);
+
     FASTTABLE_END_PROFILE;
 }
 
-void CustomFastTableWidget::removeRow(int row)
+void CustomFastTableWidget::removeRows(int row, int count)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
-    FASTTABLE_ASSERT(row>=0 && row<mOffsetY->length());
-    FASTTABLE_ASSERT(row>=0 && row<mRowHeights->length());
-    FASTTABLE_ASSERT(mData==0 || (row>=0 && row<mData->length()));
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_Data->length());
-    FASTTABLE_ASSERT(row>=0 && row<mSelectedCells->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_SelectedRows->length());
-
-    int diff=mRowHeights->at(row);
+    FASTTABLE_ASSERT(count>=0);
+    FASTTABLE_ASSERT(row>=0 && row+count<=mRowCount);
+    FASTTABLE_ASSERT(row>=0 && row+count<=mOffsetY->length());
+    FASTTABLE_ASSERT(row>=0 && row+count<=mRowHeights->length());
+    FASTTABLE_ASSERT(mData==0 || (row>=0 && row+count<=mData->length()));
+    FASTTABLE_ASSERT(mTextColumns==0 || (row>=0 && row+count<=mTextColumns->rowCount()));
+    FASTTABLE_ASSERT(row>=0 && row+count<=mVerticalHeader_Data->length());
+    FASTTABLE_ASSERT(row>=0 && row+count<=mSelection->rowCount());
 
-    if (diff>0)
+    if (count<=0)
     {
-        mTotalHeight-=diff;
+        return;
+    }
 
-        FASTTABLE_ASSERT(mTotalHeight>=0);
+    int aEnd=row+count;
 
-        for (int i=row+1; i<mRowCount; ++i)
+    for (int i=row; i<aEnd; ++i)
+    {
+        if (mRowHeights->at(i)>0)
         {
-            (*mOffsetY)[i]-=diff;
-
-            FASTTABLE_ASSERT(mOffsetY->at(i)>=0);
+            mTotalHeight-=mRowHeights->at(i);
         }
     }
 
-    mOffsetY->removeAt(row);
-    mRowHeights->removeAt(row);
+    FASTTABLE_ASSERT(mTotalHeight>=0);
+
+    mRowHeights->remove(row, count);
+    mOffsetY->sizesRemoved(row, count);
 
     if (mData)
     {
-        mData->removeAt(row);
+        fastRemoveRange(*mData, row, count);
     }
 
-    mVerticalHeader_Data->removeAt(row);
+    if (mTextColumns)
+    {
+        mTextColumns->removeRows(row, count);
+    }
 
-    for (int i=0; i<mColumnCount; ++i)
+    if (mAsyncDataProvider)
     {
-        FASTTABLE_ASSERT(i<mSelectedCells->at(row).length());
+        mAsyncDataProvider->invalidateRows(row, mRowCount-1);
+    }
 
-        if (mSelectedCells->at(row).at(i))
-        {
-            (*mHorizontalHeader_SelectedColumns)[i]--;
-        }
+    if (mRowCache)
+    {
+        mRowCache->removeRows(row, mRowCount-1);
     }
 
-    mSelectedCells->removeAt(row);
-    mVerticalHeader_SelectedRows->removeAt(row);
+    fastRemoveRange(*mVerticalHeader_Data, row, count);
+    mSelection->removeRows(row, count);
+    mPendingSelected->removeRows(row, count);
+    mPendingDeselected->removeRows(row, count);
+
+    mRowCount-=count;
 
-    for (int i=0; i<mCurSelection->length(); ++i)
+    if (mCurrentRow>=aEnd)
     {
-        if (mCurSelection->at(i).y()>row)
-        {
-            (*mCurSelection)[i].setY(mCurSelection->at(i).y()-1);
-        }
-        else
-        if (mCurSelection->at(i).y()==row)
-        {
-            mCurSelection->removeAt(i);
-            --i;
-        }
+        mCurrentRow-=count;
+    }
+    else
+    if (mCurrentRow>=row)
+    {
+        mCurrentRow=row;
     }
 
-    if (mCurrentRow>row || mCurrentRow>mRowCount-2)
+    if (mCurrentRow>=mRowCount)
     {
-        mCurrentRow--;
+        mCurrentRow=mRowCount-1;
     }
 
     if (mCurrentRow>=0 && mCurrentColumn>=0)
@@ -4223,22 +4453,20 @@ void CustomFastTableWidget::removeRow(int row)
         setCellSelected(mCurrentRow, mCurrentColumn, true);
     }
 
-    if (mEditCellRow==row)
+    if (mEditCellRow>=row && mEditCellRow<aEnd)
     {
         removeEditor();
     }
     else
-    if (mEditCellRow>row)
+    if (mEditCellRow>=aEnd)
     {
-        mEditCellRow--;
+        mEditCellRow-=count;
     }
 
     mMouseXForShift=-1;
     mMouseYForShift=-1;
     mMouseLocationForShift=InMiddleWorld;
-    mMouseSelectedCells->clear();
-
-    mRowCount--;
+    mMouseSelectedRange=QRect();
 
     updateSizes();
 
@@ -4249,6 +4477,8 @@ void CustomFastTableWidget::removeRow(int row)
 
     viewport()->update();
 
+    emit rowsRemoved(row, count);
+
     FASTTABLE_END_PROFILE;
 }
 
@@ -4267,148 +4497,199 @@ void CustomFastTableWidget::insertColumn(int column)
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
+    insertColumns(column, 1);
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::removeColumn(int column)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    removeColumns(column, 1);
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::insertColumns(int column, int count)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
     FASTTABLE_ASSERT(column>=0 && column<=mColumnCount);
     FASTTABLE_ASSERT(column>=0 && column<=mOffsetX->length());
     FASTTABLE_ASSERT(column>=0 && column<=mColumnWidths->length());
-    FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_SelectedColumns->length());
+    FASTTABLE_ASSERT(column>=0 && column<=mSelection->columnCount());
+    FASTTABLE_ASSERT(count>=0);
 
-    mColumnCount++;
-
-    mTotalWidth+=mDefaultWidth;
+    if (count<=0)
+    {
+        return;
+    }
 
-    mOffsetX->insert(column, column==0? mVerticalHeader_TotalWidth : (mColumnWidths->at(column-1)<=0? mOffsetX->at(column-1) : (mOffsetX->at(column-1)+mColumnWidths->at(column-1))));
-    mColumnWidths->insert(column, mDefaultWidth);
+    QStringList aNewCells;
 
-    for (int i=column+1; i<mColumnCount; ++i)
+    for (int i=0; i<count; ++i)
     {
-        (*mOffsetX)[i]+=mDefaultWidth;
+        aNewCells.append("");
     }
 
+    mColumnCount+=count;
+
+    mTotalWidth+=mDefaultWidth*count;
+
+    mColumnWidths->insert(column, count, mDefaultWidth);
+    mOffsetX->sizesInserted(column, count);
+
     for (int i=0; i<mHorizontalHeader_Data->length(); ++i)
     {
         FASTTABLE_ASSERT(column<=mHorizontalHeader_Data->at(i).length());
 
-        (*mHorizontalHeader_Data)[i].insert(column, "");
+        fastInsertRange((*mHorizontalHeader_Data)[i], column, aNewCells);
     }
 
-    for (int i=0; i<mSelectedCells->length(); ++i)
+    if (mData)
     {
-        FASTTABLE_ASSERT(mData==0 || column<=mData->at(i).length());
-        FASTTABLE_ASSERT(column<=mSelectedCells->at(i).length());
-
-        if (mData)
+        for (int i=0; i<mData->length(); ++i)
         {
-            (*mData)[i].insert(column, "");
+            FASTTABLE_ASSERT(column<=mData->at(i).length());
+
+            fastInsertRange((*mData)[i], column, aNewCells);
         }
+    }
+
+    // Only new columns are allocated, other columns are not touched
+    if (mTextColumns)
+    {
+        FASTTABLE_ASSERT(column<=mTextColumns->columnCount());
 
-        (*mSelectedCells)[i].insert(column, false);
+        mTextColumns->insertColumns(column, count);
     }
 
-    mHorizontalHeader_SelectedColumns->insert(column, 0);
+    // Cached rows keep all columns. Loaded blocks are requested again by updateSizes()
+    if (mRowCache)
+    {
+        mRowCache->clear();
+    }
 
-    for (int i=0; i<mCurSelection->length(); ++i)
+    if (mAsyncDataProvider)
     {
-        if (mCurSelection->at(i).x()>=column)
-        {
-            (*mCurSelection)[i].setX(mCurSelection->at(i).x()+1);
-        }
+        mAsyncDataProvider->invalidate();
     }
 
+    mSelection->insertColumns(column, count);
+    mPendingSelected->insertColumns(column, count);
+    mPendingDeselected->insertColumns(column, count);
+
     if (mCurrentColumn>=column)
     {
-        mCurrentColumn++;
+        mCurrentColumn+=count;
     }
 
     if (mEditCellColumn>=column)
     {
-        mEditCellColumn++;
+        mEditCellColumn+=count;
     }
 
     mMouseXForShift=-1;
     mMouseYForShift=-1;
     mMouseLocationForShift=InMiddleWorld;
-    mMouseSelectedCells->clear();
+    mMouseSelectedRange=QRect();
 
     updateSizes();
 
     viewport()->update();
 
+    emit columnsInserted(column, count);
+
     FASTTABLE_END_PROFILE;
 }
 
-void CustomFastTableWidget::removeColumn(int column)
+void CustomFastTableWidget::removeColumns(int column, int count)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
-    FASTTABLE_ASSERT(column>=0 && column<mOffsetX->length());
-    FASTTABLE_ASSERT(column>=0 && column<mColumnWidths->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_SelectedColumns->length());
-
-    int diff=mColumnWidths->at(column);
+    FASTTABLE_ASSERT(count>=0);
+    FASTTABLE_ASSERT(column>=0 && column+count<=mColumnCount);
+    FASTTABLE_ASSERT(column>=0 && column+count<=mOffsetX->length());
+    FASTTABLE_ASSERT(column>=0 && column+count<=mColumnWidths->length());
+    FASTTABLE_ASSERT(column>=0 && column+count<=mSelection->columnCount());
 
-    if (diff>0)
+    if (count<=0)
     {
-        mTotalWidth-=diff;
+        return;
+    }
 
-        FASTTABLE_ASSERT(mTotalWidth>=0);
+    int aEnd=column+count;
 
-        for (int i=column+1; i<mColumnCount; ++i)
+    for (int i=column; i<aEnd; ++i)
+    {
+        if (mColumnWidths->at(i)>0)
         {
-            (*mOffsetX)[i]-=diff;
-
-            FASTTABLE_ASSERT(mOffsetX->at(i)>=0);
+            mTotalWidth-=mColumnWidths->at(i);
         }
     }
 
-    mOffsetX->removeAt(column);
-    mColumnWidths->removeAt(column);
+    FASTTABLE_ASSERT(mTotalWidth>=0);
+
+    mColumnWidths->remove(column, count);
+    mOffsetX->sizesRemoved(column, count);
 
     for (int i=0; i<mHorizontalHeader_Data->length(); ++i)
     {
-        FASTTABLE_ASSERT(column<mHorizontalHeader_Data->at(i).length());
+        FASTTABLE_ASSERT(aEnd<=mHorizontalHeader_Data->at(i).length());
 
-        (*mHorizontalHeader_Data)[i].removeAt(column);
+        fastRemoveRange((*mHorizontalHeader_Data)[i], column, count);
     }
 
-    for (int i=0; i<mSelectedCells->length(); ++i)
+    if (mData)
     {
-        FASTTABLE_ASSERT(mData==0 || column<mData->at(i).length());
-        FASTTABLE_ASSERT(column<mSelectedCells->at(i).length());
-
-        if (mData)
+        for (int i=0; i<mRowCount; ++i)
         {
-            (*mData)[i].removeAt(column);
-        }
+            FASTTABLE_ASSERT(aEnd<=mData->at(i).length());
 
-        if (mSelectedCells->at(i).at(column))
-        {
-            (*mVerticalHeader_SelectedRows)[i]--;
+            fastRemoveRange((*mData)[i], column, count);
         }
+    }
+
+    if (mTextColumns)
+    {
+        FASTTABLE_ASSERT(aEnd<=mTextColumns->columnCount());
 
-        (*mSelectedCells)[i].removeAt(column);
+        mTextColumns->removeColumns(column, count);
     }
 
-    mHorizontalHeader_SelectedColumns->removeAt(column);
+    if (mRowCache)
+    {
+        mRowCache->clear();
+    }
 
-    for (int i=0; i<mCurSelection->length(); ++i)
+    if (mAsyncDataProvider)
     {
-        if (mCurSelection->at(i).x()>column)
-        {
-            (*mCurSelection)[i].setX(mCurSelection->at(i).x()-1);
-        }
-        else
-        if (mCurSelection->at(i).x()==column)
-        {
-            mCurSelection->removeAt(i);
-            --i;
-        }
+        mAsyncDataProvider->invalidate();
+    }
+
+    mSelection->removeColumns(column, count);
+    mPendingSelected->removeColumns(column, count);
+    mPendingDeselected->removeColumns(column, count);
+
+    mColumnCount-=count;
+
+    if (mCurrentColumn>=aEnd)
+    {
+        mCurrentColumn-=count;
+    }
+    else
+    if (mCurrentColumn>=column)
+    {
+        mCurrentColumn=column;
     }
 
-    if (mCurrentColumn>column || mCurrentColumn>mColumnCount-2)
+    if (mCurrentColumn>=mColumnCount)
     {
-        mCurrentColumn--;
+        mCurrentColumn=mColumnCount-1;
     }
 
     if (mCurrentRow>=0 && mCurrentColumn>=0)
@@ -4416,27 +4697,27 @@ void CustomFastTableWidget::removeColumn(int column)
         setCellSelected(mCurrentRow, mCurrentColumn, true);
     }
 
-    if (mEditCellColumn==column)
+    if (mEditCellColumn>=column && mEditCellColumn<aEnd)
     {
         removeEditor();
     }
     else
-    if (mEditCellColumn>column)
+    if (mEditCellColumn>=aEnd)
     {
-        mEditCellColumn--;
+        mEditCellColumn-=count;
     }
 
     mMouseXForShift=-1;
     mMouseYForShift=-1;
     mMouseLocationForShift=InMiddleWorld;
-    mMouseSelectedCells->clear();
-
-    mColumnCount--;
+    mMouseSelectedRange=QRect();
 
     updateSizes();
 
     viewport()->update();
 
+    emit columnsRemoved(column, count);
+
     FASTTABLE_END_PROFILE;
 }
 
@@ -4475,12 +4756,7 @@ void CustomFastTableWidget::horizontalHeader_InsertRow(int row)
         (*mHorizontalHeader_OffsetY)[i]+=mDefaultHeight;
     }
 
-    for (int i=0; i<mRowCount; ++i)
-    {
-        FASTTABLE_ASSERT(i<mOffsetY->length());
-
-        (*mOffsetY)[i]+=mDefaultHeight;
-    }
+    mOffsetY->setBase(mHorizontalHeader_TotalHeight);
 
     mHorizontalHeader_Data->insert(row, aNewRow);
 
@@ -4523,14 +4799,7 @@ void CustomFastTableWidget::horizontalHeader_RemoveRow(int row)
             FASTTABLE_ASSERT(mHorizontalHeader_OffsetY->at(i)>=0);
         }
 
-        for (int i=0; i<mRowCount; ++i)
-        {
-            FASTTABLE_ASSERT(i<mOffsetY->length());
-
-            (*mOffsetY)[i]-=diff;
-
-            FASTTABLE_ASSERT(mOffsetY->at(i)>=0);
-        }
+        mOffsetY->setBase(mHorizontalHeader_TotalHeight);
     }
 
     mHorizontalHeader_OffsetY->removeAt(row);
@@ -4578,12 +4847,7 @@ void CustomFastTableWidget::verticalHeader_InsertColumn(int column)
         (*mVerticalHeader_OffsetX)[i]+=mDefaultWidth;
     }
 
-    for (int i=0; i<mColumnCount; ++i)
-    {
-        FASTTABLE_ASSERT(i<mOffsetX->length());
-
-        (*mOffsetX)[i]+=mDefaultWidth;
-    }
+    mOffsetX->setBase(mVerticalHeader_TotalWidth);
 
     for (int i=0; i<mVerticalHeader_Data->length(); ++i)
     {
@@ -4630,14 +4894,7 @@ void CustomFastTableWidget::verticalHeader_RemoveColumn(int column)
             FASTTABLE_ASSERT(mVerticalHeader_OffsetX->at(i)>=0);
         }
 
-        for (int i=0; i<mColumnCount; ++i)
-        {
-            FASTTABLE_ASSERT(i<mOffsetX->length());
-
-            (*mOffsetX)[i]-=diff;
-
-            FASTTABLE_ASSERT(mOffsetX->at(i)>=0);
-        }
+        mOffsetX->setBase(mVerticalHeader_TotalWidth);
     }
 
     mVerticalHeader_OffsetX->removeAt(column);
@@ -4677,29 +4934,161 @@ void CustomFastTableWidget::setRowCount(int count)
 
     if (mRowCount!=count)
     {
-        bool wasAllowUpdates=updatesEnabled();
+        resizeRows(count);
+    }
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::resizeRows(int count)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    FASTTABLE_ASSERT(count>=0);
+
+    int aOldCount=mRowCount;
+
+    if (count>mRowCount)
+    {
+        QStringList aNewRow;
+        QStringList aNewHeaderRow;
+
+        for (int i=0; i<mColumnCount; ++i)
+        {
+            aNewRow.append("");
+        }
+
+        for (int i=0; i<mVerticalHeader_ColumnCount; ++i)
+        {
+            aNewHeaderRow.append("");
+        }
+
+        if (mData)
+        {
+            mData->reserve(count);
+        }
+
+        mVerticalHeader_Data->reserve(count);
+
+        // New rows are implicitly shared until modified
+        for (int i=mRowCount; i<count; ++i)
+        {
+            if (mData)
+            {
+                mData->append(aNewRow);
+            }
+
+            mVerticalHeader_Data->append(aNewHeaderRow);
+        }
+
+        if (mTextColumns)
+        {
+            mTextColumns->insertRows(mRowCount, count-mRowCount);
+        }
+
+        // Last block could be loaded partially
+        if (mAsyncDataProvider)
+        {
+            mAsyncDataProvider->invalidateRows(mRowCount, count-1);
+        }
+
+        if (mRowCache)
+        {
+            mRowCache->removeRows(mRowCount, count-1);
+        }
+
+        mSelection->resize(count, mColumnCount);
+        mPendingSelected->resize(count, mColumnCount);
+        mPendingDeselected->resize(count, mColumnCount);
+
+        mRowHeights->resize(count, mDefaultHeight);
+        mOffsetY->sizesInserted(mRowCount, count-mRowCount);
+
+        mTotalHeight+=mDefaultHeight*(count-mRowCount);
+    }
+    else
+    {
+        for (int i=count; i<mRowCount; ++i)
+        {
+            if (mRowHeights->at(i)>0)
+            {
+                mTotalHeight-=mRowHeights->at(i);
+            }
+        }
+
+        FASTTABLE_ASSERT(mTotalHeight>=0);
+
+        mRowHeights->resize(count, mDefaultHeight);
+        mOffsetY->sizesRemoved(count, mRowCount-count);
+
+        if (mData)
+        {
+            mData->erase(mData->begin()+count, mData->end());
+        }
+
+        if (mTextColumns)
+        {
+            mTextColumns->removeRows(count, mRowCount-count);
+        }
 
-        if (wasAllowUpdates)
+        if (mAsyncDataProvider)
         {
-            setUpdatesEnabled(false);
+            mAsyncDataProvider->invalidateRows(count, mRowCount-1);
         }
 
-        while (mRowCount<count)
+        if (mRowCache)
         {
-            addRow();
+            mRowCache->removeRows(count, mRowCount-1);
         }
 
-        while (mRowCount>count)
+        mVerticalHeader_Data->erase(mVerticalHeader_Data->begin()+count, mVerticalHeader_Data->end());
+        mSelection->resize(count, mColumnCount);
+        mPendingSelected->resize(count, mColumnCount);
+        mPendingDeselected->resize(count, mColumnCount);
+
+        if (mCurrentRow>=count)
+        {
+            mCurrentRow=count-1;
+        }
+
+        if (mCurrentRow>=0 && mCurrentColumn>=0)
         {
-            removeRow(mRowCount-1);
+            setCellSelected(mCurrentRow, mCurrentColumn, true);
         }
 
-        if (wasAllowUpdates)
+        if (mEditCellRow>=count)
         {
-            setUpdatesEnabled(true);
+            removeEditor();
         }
     }
 
+    mRowCount=count;
+
+    mMouseXForShift=-1;
+    mMouseYForShift=-1;
+    mMouseLocationForShift=InMiddleWorld;
+    mMouseSelectedRange=QRect();
+
+    updateSizes();
+
+    if (mAutoVerticalHeaderSize)
+    {
+        updateVerticalHeaderSize();
+    }
+
+    viewport()->update();
+
+    if (count>aOldCount)
+    {
+        emit rowsInserted(aOldCount, count-aOldCount);
+    }
+    else
+    if (count<aOldCount)
+    {
+        emit rowsRemoved(count, aOldCount-count);
+    }
+
     FASTTABLE_END_PROFILE;
 }
 
@@ -4721,29 +5110,151 @@ void CustomFastTableWidget::setColumnCount(int count)
 
     if (mColumnCount!=count)
     {
-        bool wasAllowUpdates=updatesEnabled();
+        resizeColumns(count);
+    }
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::resizeColumns(int count)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    FASTTABLE_ASSERT(count>=0);
+
+    int aOldCount=mColumnCount;
+
+    if (count>mColumnCount)
+    {
+        QStringList aNewCells;
+
+        for (int i=mColumnCount; i<count; ++i)
+        {
+            aNewCells.append("");
+        }
+
+        for (int i=0; i<mHorizontalHeader_Data->length(); ++i)
+        {
+            (*mHorizontalHeader_Data)[i].append(aNewCells);
+        }
+
+        if (mData)
+        {
+            for (int i=0; i<mData->length(); ++i)
+            {
+                (*mData)[i].append(aNewCells);
+            }
+        }
+
+        if (mTextColumns)
+        {
+            mTextColumns->insertColumns(mColumnCount, count-mColumnCount);
+        }
+
+        if (mRowCache)
+        {
+            mRowCache->clear();
+        }
+
+        if (mAsyncDataProvider)
+        {
+            mAsyncDataProvider->invalidate();
+        }
+
+        mSelection->resize(mRowCount, count);
+        mPendingSelected->resize(mRowCount, count);
+        mPendingDeselected->resize(mRowCount, count);
+
+        mColumnWidths->resize(count, mDefaultWidth);
+        mOffsetX->sizesInserted(mColumnCount, count-mColumnCount);
+
+        mTotalWidth+=mDefaultWidth*(count-mColumnCount);
+    }
+    else
+    {
+        for (int i=count; i<mColumnCount; ++i)
+        {
+            if (mColumnWidths->at(i)>0)
+            {
+                mTotalWidth-=mColumnWidths->at(i);
+            }
+        }
+
+        FASTTABLE_ASSERT(mTotalWidth>=0);
+
+        mColumnWidths->resize(count, mDefaultWidth);
+        mOffsetX->sizesRemoved(count, mColumnCount-count);
+
+        for (int i=0; i<mHorizontalHeader_Data->length(); ++i)
+        {
+            (*mHorizontalHeader_Data)[i].erase((*mHorizontalHeader_Data)[i].begin()+count, (*mHorizontalHeader_Data)[i].end());
+        }
+
+        if (mData)
+        {
+            for (int i=0; i<mRowCount; ++i)
+            {
+                (*mData)[i].erase((*mData)[i].begin()+count, (*mData)[i].end());
+            }
+        }
+
+        if (mTextColumns)
+        {
+            mTextColumns->removeColumns(count, mColumnCount-count);
+        }
 
-        if (wasAllowUpdates)
+        if (mRowCache)
         {
-            setUpdatesEnabled(false);
+            mRowCache->clear();
         }
 
-        while (mColumnCount<count)
+        if (mAsyncDataProvider)
+        {
+            mAsyncDataProvider->invalidate();
+        }
+
+        mSelection->resize(mRowCount, count);
+        mPendingSelected->resize(mRowCount, count);
+        mPendingDeselected->resize(mRowCount, count);
+
+        if (mCurrentColumn>=count)
         {
-            addColumn();
+            mCurrentColumn=count-1;
         }
 
-        while (mColumnCount>count)
+        if (mCurrentRow>=0 && mCurrentColumn>=0)
         {
-            removeColumn(mColumnCount-1);
+            setCellSelected(mCurrentRow, mCurrentColumn, true);
         }
 
-        if (wasAllowUpdates)
+        if (mEditCellColumn>=count)
         {
-            setUpdatesEnabled(true);
+            removeEditor();
         }
     }
 
+    mColumnCount=count;
+
+    mMouseXForShift=-1;
+    mMouseYForShift=-1;
+    mMouseLocationForShift=InMiddleWorld;
+    mMouseSelectedRange=QRect();
+
+    updateSizes();
+
+    viewport()->update();
+
+    if (count>aOldCount)
+    {
+        emit columnsInserted(aOldCount, count-aOldCount);
+    }
+    else
+    if (count<aOldCount)
+    {
+        emit columnsRemoved(count, aOldCount-count);
+    }
+
     FASTTABLE_END_PROFILE;
 }
 
@@ -4765,12 +5276,7 @@ void CustomFastTableWidget::horizontalHeader_SetRowCount(qint16 count)
 
     if (mHorizontalHeader_RowCount!=count)
     {
-        bool wasAllowUpdates=updatesEnabled();
-
-        if (wasAllowUpdates)
-        {
-            setUpdatesEnabled(false);
-        }
+        beginUpdate();
 
         while (mHorizontalHeader_RowCount<count)
         {
@@ -4782,10 +5288,7 @@ void CustomFastTableWidget::horizontalHeader_SetRowCount(qint16 count)
             horizontalHeader_RemoveRow(mHorizontalHeader_RowCount-1);
         }
 
-        if (wasAllowUpdates)
-        {
-            setUpdatesEnabled(true);
-        }
+        endUpdate();
     }
 
     FASTTABLE_END_PROFILE;
@@ -4809,12 +5312,7 @@ void CustomFastTableWidget::verticalHeader_SetColumnCount(qint16 count)
 
     if (mVerticalHeader_ColumnCount!=count)
     {
-        bool wasAllowUpdates=updatesEnabled();
-
-        if (wasAllowUpdates)
-        {
-            setUpdatesEnabled(false);
-        }
+        beginUpdate();
 
         while (mVerticalHeader_ColumnCount<count)
         {
@@ -4826,10 +5324,7 @@ void CustomFastTableWidget::verticalHeader_SetColumnCount(qint16 count)
             verticalHeader_RemoveColumn(mVerticalHeader_ColumnCount-1);
         }
 
-        if (wasAllowUpdates)
-        {
-            setUpdatesEnabled(true);
-        }
+        endUpdate();
     }
 
     FASTTABLE_END_PROFILE;
@@ -4840,22 +5335,24 @@ void CustomFastTableWidget::setSizes(int aRowCount, int aColumnCount, qint16 aHo
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    bool wasAllowUpdates=updatesEnabled();
+    beginUpdate();
 
-    if (wasAllowUpdates)
+    // New rows share their cell lists, so columns should be resized before adding rows
+    if (aRowCount<mRowCount)
+    {
+        setRowCount(aRowCount);
+        setColumnCount(aColumnCount);
+    }
+    else
     {
-        setUpdatesEnabled(false);
+        setColumnCount(aColumnCount);
+        setRowCount(aRowCount);
     }
 
-    setRowCount(aRowCount);
-    setColumnCount(aColumnCount);
     horizontalHeader_SetRowCount(aHorizontalHeaderRowCount);
     verticalHeader_SetColumnCount(aVerticalHeaderColumnCount);
 
-    if (wasAllowUpdates)
-    {
-        setUpdatesEnabled(true);
-    }
+    endUpdate();
 
     FASTTABLE_END_PROFILE;
 }
@@ -5223,31 +5720,24 @@ void CustomFastTableWidget::setColumnWidth(const int column, quint16 width, bool
 
     if (mColumnWidths->at(column)<0)
     {
-        (*mColumnWidths)[column]=-width;
+        mColumnWidths->replace(column, -width);
     }
     else
     if (mColumnWidths->at(column)!=width)
     {
         int aDiff=width-mColumnWidths->at(column);
 
-        (*mColumnWidths)[column]=width;
+        mColumnWidths->replace(column, width);
 
         mTotalWidth+=aDiff;
 
         FASTTABLE_ASSERT(mTotalWidth>=0);
 
+        mOffsetX->sizeChanged(column, aDiff);
+
         // If you don't use forceUpdate you need to use updateOffsetsX later
         if (forceUpdate)
         {
-            for (int i=column+1; i<mColumnCount; ++i)
-            {
-                FASTTABLE_ASSERT(i<mOffsetX->length());
-
-                (*mOffsetX)[i]+=aDiff;
-
-                FASTTABLE_ASSERT(mOffsetX->at(i)>=0);
-            }
-
             updateSizes();
 
             viewport()->update();
@@ -5289,31 +5779,24 @@ void CustomFastTableWidget::setRowHeight(const int row, quint16 height, bool for
 
     if (mRowHeights->at(row)<0)
     {
-        (*mRowHeights)[row]=-height;
+        mRowHeights->replace(row, -height);
     }
     else
     if (mRowHeights->at(row)!=height)
     {
         int aDiff=height-mRowHeights->at(row);
 
-        (*mRowHeights)[row]=height;
+        mRowHeights->replace(row, height);
 
         mTotalHeight+=aDiff;
 
         FASTTABLE_ASSERT(mTotalHeight>=0);
 
+        mOffsetY->sizeChanged(row, aDiff);
+
         // If you don't use forceUpdate you need to use updateOffsetsY later
         if (forceUpdate)
         {
-            for (int i=row+1; i<mRowCount; ++i)
-            {
-                FASTTABLE_ASSERT(i<mOffsetY->length());
-
-                (*mOffsetY)[i]+=aDiff;
-
-                FASTTABLE_ASSERT(mOffsetY->at(i)>=0);
-            }
-
             updateSizes();
 
             viewport()->update();
@@ -5370,6 +5853,8 @@ void CustomFastTableWidget::verticalHeader_SetColumnWidth(const int column, quin
         FASTTABLE_ASSERT(mVerticalHeader_TotalWidth>=0);
         FASTTABLE_ASSERT(mTotalWidth>=0);
 
+        mOffsetX->setBase(mVerticalHeader_TotalWidth);
+
         // If you don't use forceUpdate you need to use verticalHeader_UpdateOffsetsX later
         if (forceUpdate)
         {
@@ -5382,15 +5867,6 @@ void CustomFastTableWidget::verticalHeader_SetColumnWidth(const int column, quin
                 FASTTABLE_ASSERT(mVerticalHeader_OffsetX->at(i)>=0);
             }
 
-            for (int i=0; i<mColumnCount; ++i)
-            {
-                FASTTABLE_ASSERT(i<mOffsetX->length());
-
-                (*mOffsetX)[i]+=aDiff;
-
-                FASTTABLE_ASSERT(mOffsetX->at(i)>=0);
-            }
-
             updateSizes();
 
             viewport()->update();
@@ -5447,6 +5923,8 @@ void CustomFastTableWidget::horizontalHeader_SetRowHeight(const int row, quint16
         FASTTABLE_ASSERT(mHorizontalHeader_TotalHeight>=0);
         FASTTABLE_ASSERT(mTotalHeight>=0);
 
+        mOffsetY->setBase(mHorizontalHeader_TotalHeight);
+
         // If you don't use forceUpdate you need to use horizontalHeader_UpdateOffsetsY later
         if (forceUpdate)
         {
@@ -5459,15 +5937,6 @@ void CustomFastTableWidget::horizontalHeader_SetRowHeight(const int row, quint16
                 FASTTABLE_ASSERT(mHorizontalHeader_OffsetY->at(i)>=0);
             }
 
-            for (int i=0; i<mRowCount; ++i)
-            {
-                FASTTABLE_ASSERT(i<mOffsetY->length());
-
-                (*mOffsetY)[i]+=aDiff;
-
-                FASTTABLE_ASSERT(mOffsetY->at(i)>=0);
-            }
-
             updateSizes();
 
             viewport()->update();
@@ -5525,7 +5994,7 @@ void CustomFastTableWidget::setColumnVisible(const int column, bool visible, boo
     {
         if (visible)
         {
-            (*mColumnWidths)[column]=0;
+            mColumnWidths->replace(column, 0);
 
             if (prevWidth==0)
             {
@@ -5537,7 +6006,7 @@ void CustomFastTableWidget::setColumnVisible(const int column, bool visible, boo
         else
         {
             setColumnWidth(column, 0, forceUpdate);
-            (*mColumnWidths)[column]=-prevWidth;
+            mColumnWidths->replace(column, -prevWidth);
         }
     }
 
@@ -5566,7 +6035,7 @@ void CustomFastTableWidget::setRowVisible(const int row, bool visible, bool forc
     {
         if (visible)
         {
-            (*mRowHeights)[row]=0;
+            mRowHeights->replace(row, 0);
 
             if (prevHeight==0)
             {
@@ -5578,7 +6047,7 @@ void CustomFastTableWidget::setRowVisible(const int row, bool visible, bool forc
         else
         {
             setRowHeight(row, 0, forceUpdate);
-            (*mRowHeights)[row]=-prevHeight;
+            mRowHeights->replace(row, -prevHeight);
         }
     }
 
@@ -5699,33 +6168,37 @@ int CustomFastTableWidget::verticalHeader_columnOffset(const int column)
     return mVerticalHeader_OffsetX->at(column);
 }
 
-void CustomFastTableWidget::updateOffsetsX(const int fromIndex)
+int CustomFastTableWidget::rowAtOffset(const int y)
 {
-    int aCurOffset;
+    FASTTABLE_FREQUENT_DEBUG;
+    return mOffsetY->indexAt(y);
+}
 
-    if (fromIndex==0)
-    {
-        aCurOffset=mVerticalHeader_TotalWidth;
-    }
-    else
-    {
-        aCurOffset=mOffsetX->at(fromIndex);
-    }
+int CustomFastTableWidget::columnAtOffset(const int x)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+    return mOffsetX->indexAt(x);
+}
 
-    for (int i=fromIndex; i<mColumnCount; ++i)
-    {
-        FASTTABLE_ASSERT(i<mOffsetX->length());
-        FASTTABLE_ASSERT(i<mColumnWidths->length());
+int CustomFastTableWidget::horizontalHeader_rowAtOffset(const int y)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+    return searchOffset(mHorizontalHeader_OffsetY, mHorizontalHeader_RowHeights, mHorizontalHeader_RowCount, y);
+}
 
-        (*mOffsetX)[i]=aCurOffset;
+int CustomFastTableWidget::verticalHeader_columnAtOffset(const int x)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+    return searchOffset(mVerticalHeader_OffsetX, mVerticalHeader_ColumnWidths, mVerticalHeader_ColumnCount, x);
+}
 
-        if (mColumnWidths->at(i)>0)
-        {
-            aCurOffset+=mColumnWidths->at(i);
-        }
+void CustomFastTableWidget::updateOffsetsX(const int fromIndex)
+{
+    Q_UNUSED(fromIndex);
 
-        FASTTABLE_ASSERT(mOffsetX->at(i)>=0);
-    }
+    // Offsets are maintained by setters. Rebuild them in case if sizes were modified directly
+    mOffsetX->setBase(mVerticalHeader_TotalWidth);
+    mOffsetX->invalidate();
 
     updateSizes();
 
@@ -5734,31 +6207,11 @@ void CustomFastTableWidget::updateOffsetsX(const int fromIndex)
 
 void CustomFastTableWidget::updateOffsetsY(const int fromIndex)
 {
-    int aCurOffset;
-
-    if (fromIndex==0)
-    {
-        aCurOffset=mHorizontalHeader_TotalHeight;
-    }
-    else
-    {
-        aCurOffset=mOffsetY->at(fromIndex);
-    }
-
-    for (int i=fromIndex; i<mRowCount; ++i)
-    {
-        FASTTABLE_ASSERT(i<mOffsetY->length());
-        FASTTABLE_ASSERT(i<mRowHeights->length());
-
-        (*mOffsetY)[i]=aCurOffset;
-
-        if (mRowHeights->at(i)>0)
-        {
-            aCurOffset+=mRowHeights->at(i);
-        }
+    Q_UNUSED(fromIndex);
 
-        FASTTABLE_ASSERT(mOffsetY->at(i)>=0);
-    }
+    // Offsets are maintained by setters. Rebuild them in case if sizes were modified directly
+    mOffsetY->setBase(mHorizontalHeader_TotalHeight);
+    mOffsetY->invalidate();
 
     updateSizes();
 
@@ -5918,12 +6371,87 @@ QRect CustomFastTableWidget::verticalHeader_CellRectangle(const int row, const i
     return QRect(mVerticalHeader_OffsetX->at(column), mOffsetY->at(row), mVerticalHeader_ColumnWidths->at(column), mRowHeights->at(row));
 }
 
-void CustomFastTableWidget::scrollToTop()
+void CustomFastTableWidget::updateCell(const int row, const int column)
 {
-    FASTTABLE_DEBUG;
-    FASTTABLE_START_PROFILE;
-
-    verticalScrollBar()->setValue(0);
+    FASTTABLE_FREQUENT_DEBUG;
+
+    if (mUpdateLevel>0)
+    {
+        return;
+    }
+
+    viewport()->update(cellRectangle(row, column).translated(-horizontalScrollBar()->value(), -verticalScrollBar()->value()));
+}
+
+void CustomFastTableWidget::horizontalHeader_UpdateCell(const int row, const int column)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    if (mUpdateLevel>0)
+    {
+        return;
+    }
+
+    viewport()->update(horizontalHeader_CellRectangle(row, column).translated(-horizontalScrollBar()->value(), 0));
+}
+
+void CustomFastTableWidget::verticalHeader_UpdateCell(const int row, const int column)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    if (mUpdateLevel>0)
+    {
+        return;
+    }
+
+    viewport()->update(verticalHeader_CellRectangle(row, column).translated(0, -verticalScrollBar()->value()));
+}
+
+void CustomFastTableWidget::updateCells(const QRect &range)
+{
+    FASTTABLE_DEBUG;
+
+    if (mUpdateLevel>0)
+    {
+        return;
+    }
+
+    QRect aArea=dirtyArea(range);
+
+    if (!aArea.isEmpty())
+    {
+        viewport()->update(aArea);
+    }
+}
+
+QRect CustomFastTableWidget::dirtyArea(const QRect &range)
+{
+    FASTTABLE_DEBUG;
+
+    // Only visible part of the range is repainted
+    int aTop=qMax(range.top(), mVisibleTop);
+    int aLeft=qMax(range.left(), mVisibleLeft);
+    int aBottom=qMin(range.bottom(), mVisibleBottom);
+    int aRight=qMin(range.right(), mVisibleRight);
+
+    if (aTop<0 || aLeft<0 || aTop>aBottom || aLeft>aRight)
+    {
+        return QRect();
+    }
+
+    // Offsets grow with indexes, so corner cells bound the whole range. Hidden cells are not skipped by united()
+    QPoint aTopLeft(mOffsetX->at(aLeft), mOffsetY->at(aTop));
+    QPoint aBottomRight(mOffsetX->at(aRight)+mColumnWidths->at(aRight)-1, mOffsetY->at(aBottom)+mRowHeights->at(aBottom)-1);
+
+    return QRect(aTopLeft, aBottomRight).translated(-horizontalScrollBar()->value(), -verticalScrollBar()->value());
+}
+
+void CustomFastTableWidget::scrollToTop()
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    verticalScrollBar()->setValue(0);
 
     FASTTABLE_END_PROFILE;
 }
@@ -5997,12 +6525,350 @@ void CustomFastTableWidget::scrollToCurrentCell(const bool centered)
     FASTTABLE_END_PROFILE;
 }
 
+CustomFastTableWidget::DataStorage CustomFastTableWidget::dataStorage()
+{
+    FASTTABLE_DEBUG;
+
+    return mTextColumns ? ColumnStorage : RowStorage;
+}
+
+void CustomFastTableWidget::setDataStorage(DataStorage storage)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    // Storage is used only for internal data
+    FASTTABLE_ASSERT(mUseInternalData);
+
+    if (storage==dataStorage())
+    {
+        FASTTABLE_END_PROFILE;
+        return;
+    }
+
+    if (storage==ColumnStorage)
+    {
+        mTextColumns=new TextColumns();
+        mTextColumns->insertRows(0, mRowCount);
+        mTextColumns->insertColumns(0, mColumnCount);
+
+        for (int i=0; i<mColumnCount; ++i)
+        {
+            TextColumn *aColumn=mTextColumns->column(i);
+
+            for (int j=0; j<mRowCount; ++j)
+            {
+                const QString &aText=mData->at(j).at(i);
+
+                if (!aText.isEmpty())
+                {
+                    aColumn->setText(j, aText);
+                }
+            }
+        }
+
+        delete mData;
+        mData=0;
+    }
+    else
+    {
+        mData=new QList< QStringList >();
+        mData->reserve(mRowCount);
+
+        for (int i=0; i<mRowCount; ++i)
+        {
+            QStringList aRow;
+            aRow.reserve(mColumnCount);
+
+            for (int j=0; j<mColumnCount; ++j)
+            {
+                aRow.append(mTextColumns->text(i, j));
+            }
+
+            mData->append(aRow);
+        }
+
+        delete mTextColumns;
+        mTextColumns=0;
+    }
+
+    FASTTABLE_END_PROFILE;
+}
+
+AsyncDataProvider *CustomFastTableWidget::asyncDataProvider()
+{
+    FASTTABLE_DEBUG;
+
+    return mAsyncDataProvider;
+}
+
+void CustomFastTableWidget::setAsyncDataProvider(AsyncDataProvider *provider)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    // Provider is not owned by the table, detached provider is stopped
+    if (mAsyncDataProvider)
+    {
+        disconnect(mAsyncDataProvider, 0, this, 0);
+
+        if (mAsyncDataProvider!=provider)
+        {
+            mAsyncDataProvider->stop();
+        }
+    }
+
+    mAsyncDataProvider=provider;
+
+    if (mAsyncDataProvider)
+    {
+        connect(mAsyncDataProvider, SIGNAL(rowsLoaded(int,int)), this, SLOT(asyncRowsLoaded(int,int)));
+        connect(mAsyncDataProvider, SIGNAL(destroyed()), this, SLOT(asyncDataProviderDestroyed()));
+
+        mAsyncDataProvider->invalidate();
+        requestVisibleRows();
+    }
+
+    viewport()->update();
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::requestVisibleRows()
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    if (mVisibleTop<0 || mVisibleBottom<mVisibleTop)
+    {
+        return;
+    }
+
+    if (mAsyncDataProvider)
+    {
+        mAsyncDataProvider->requestRows(mVisibleTop, mVisibleBottom, mRowCount);
+    }
+
+    if (mRowCache)
+    {
+        mRowCache->setPinnedRows(mVisibleTop, mVisibleBottom);
+    }
+}
+
+QString CustomFastTableWidget::cachedText(const int row, const int column)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    // Provider has its own cache
+    if (mRowCache==0 || mAsyncDataProvider)
+    {
+        return text(row, column);
+    }
+
+    int aBlockSize=mRowCache->blockSize();
+    int aBlock=row/aBlockSize;
+
+    const QList<QStringList> *aRows=mRowCache->rows(aBlock);
+
+    if (aRows && row%aBlockSize<aRows->length() && column<aRows->at(row%aBlockSize).length())
+    {
+        return aRows->at(row%aBlockSize).at(column);
+    }
+
+    // Whole block is taken from text() at once
+    int aFirst=aBlock*aBlockSize;
+    int aLast=qMin(aFirst+aBlockSize, mRowCount);
+
+    QList<QStringList> aNewRows;
+    aNewRows.reserve(aLast-aFirst);
+
+    for (int i=aFirst; i<aLast; ++i)
+    {
+        QStringList aRow;
+        aRow.reserve(mColumnCount);
+
+        for (int j=0; j<mColumnCount; ++j)
+        {
+            aRow.append(text(i, j));
+        }
+
+        aNewRows.append(aRow);
+    }
+
+    mRowCache->insert(aBlock, aNewRows);
+
+    return aNewRows.at(row-aFirst).at(column);
+}
+
+bool CustomFastTableWidget::isRowCacheEnabled()
+{
+    FASTTABLE_DEBUG;
+
+    return mRowCache!=0;
+}
+
+void CustomFastTableWidget::setRowCacheEnabled(const bool enable)
+{
+    FASTTABLE_DEBUG;
+
+    if (enable==isRowCacheEnabled())
+    {
+        return;
+    }
+
+    if (enable)
+    {
+        mRowCache=new RowBlockCache();
+        requestVisibleRows();
+    }
+    else
+    {
+        delete mRowCache;
+        mRowCache=0;
+    }
+}
+
+RowBlockCache *CustomFastTableWidget::rowCache()
+{
+    FASTTABLE_DEBUG;
+
+    return mRowCache;
+}
+
+MappedCsvFile *CustomFastTableWidget::mappedCsvFile()
+{
+    FASTTABLE_DEBUG;
+
+    return mMappedCsvFile;
+}
+
+void CustomFastTableWidget::setMappedCsvFile(MappedCsvFile *file)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    // File is not owned by the table
+    if (mMappedCsvFile)
+    {
+        disconnect(mMappedCsvFile, 0, this, 0);
+    }
+
+    mMappedCsvFile=file;
+
+    if (mMappedCsvFile)
+    {
+        connect(mMappedCsvFile, SIGNAL(rowsIndexed(int,int)), this, SLOT(mappedRowsIndexed(int,int)));
+        connect(mMappedCsvFile, SIGNAL(destroyed()), this, SLOT(mappedCsvFileDestroyed()));
+
+        mappedRowsIndexed(mMappedCsvFile->rowCount(), mMappedCsvFile->columnCount());
+    }
+
+    viewport()->update();
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::mappedRowsIndexed(int rowCount, int columnCount)
+{
+    FASTTABLE_DEBUG;
+
+    // Table grows while the file is indexed
+    setColumnCount(columnCount);
+    setRowCount(rowCount);
+}
+
+void CustomFastTableWidget::mappedCsvFileDestroyed()
+{
+    FASTTABLE_DEBUG;
+
+    mMappedCsvFile=0;
+    viewport()->update();
+}
+
+void CustomFastTableWidget::asyncRowsLoaded(int first, int last)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    // Only visible cells of loaded rows are repainted
+    updateCells(QRect(0, first, mColumnCount, last-first+1));
+}
+
+void CustomFastTableWidget::asyncDataProviderDestroyed()
+{
+    FASTTABLE_DEBUG;
+
+    mAsyncDataProvider=0;
+    viewport()->update();
+}
+
+bool CustomFastTableWidget::isColumnDictionaryEncoded(const int column)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    return mTextColumns && mTextColumns->column(column)->isDictionaryEncoded();
+}
+
+void CustomFastTableWidget::setColumnDictionaryEncoded(const int column, const bool encoded)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    // Dictionary is used only for internal data
+    FASTTABLE_ASSERT(mUseInternalData);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    if (mTextColumns==0)
+    {
+        if (!encoded)
+        {
+            FASTTABLE_END_PROFILE;
+            return;
+        }
+
+        // Only column storage could keep dictionary
+        setDataStorage(ColumnStorage);
+    }
+
+    mTextColumns->column(column)->setDictionaryEncoded(encoded);
+
+    FASTTABLE_END_PROFILE;
+}
+
+const TextColumn *CustomFastTableWidget::textColumn(const int column)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    // Codes of dictionary encoded column could be compared and sorted instead of texts
+    return mTextColumns ? mTextColumns->column(column) : 0;
+}
+
 QString CustomFastTableWidget::text(const int row, const int column)
 {
     FASTTABLE_DEBUG;
 
+    if (mMappedCsvFile)
+    {
+        return row<mMappedCsvFile->rowCount() ? mMappedCsvFile->text(row, column) : QString();
+    }
+
+    // Rows that are not loaded yet have empty text
+    if (mAsyncDataProvider)
+    {
+        return mAsyncDataProvider->text(row, column);
+    }
+
     // If you don't use internal data, you have to reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
+
+    if (mTextColumns)
+    {
+        FASTTABLE_ASSERT(row>=0 && row<mTextColumns->rowCount());
+        FASTTABLE_ASSERT(column>=0 && column<mTextColumns->columnCount());
+
+        return mTextColumns->text(row, column);
+    }
+
     FASTTABLE_ASSERT(row>=0 && row<mData->length());
     FASTTABLE_ASSERT(column>=0 && column<mData->at(row).length());
 
@@ -6014,12 +6880,98 @@ void CustomFastTableWidget::setText(const int row, const int column, const QStri
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
+    // Mapped file is read-only
+    FASTTABLE_ASSERT(mMappedCsvFile==0);
+
     // If you don't use internal data, you may reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mData->length());
-    FASTTABLE_ASSERT(column>=0 && column<mData->at(row).length());
 
-    (*mData)[row][column]=text;
+    if (mTextColumns)
+    {
+        FASTTABLE_ASSERT(row>=0 && row<mTextColumns->rowCount());
+        FASTTABLE_ASSERT(column>=0 && column<mTextColumns->columnCount());
+
+        mTextColumns->setText(row, column, text);
+    }
+    else
+    {
+        FASTTABLE_ASSERT(row>=0 && row<mData->length());
+        FASTTABLE_ASSERT(column>=0 && column<mData->at(row).length());
+
+        (*mData)[row][column]=text;
+    }
+
+    if (mRowCache)
+    {
+        mRowCache->removeRows(row, row);
+    }
+
+    updateCell(row, column);
+
+    FASTTABLE_END_PROFILE;
+}
+
+void CustomFastTableWidget::setTexts(const QList<QStringList> &rows)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    // If you don't use internal data, you may reimplement this function in your class
+    FASTTABLE_ASSERT(mUseInternalData);
+    FASTTABLE_ASSERT(mMappedCsvFile==0);
+
+    int aColumnCount=0;
+
+    for (int i=0; i<rows.length(); ++i)
+    {
+        aColumnCount=qMax(aColumnCount, rows.at(i).length());
+    }
+
+    // Old cells are released before new ones are taken
+    setRowCount(0);
+    setColumnCount(aColumnCount);
+    setRowCount(rows.length());
+
+    if (mTextColumns)
+    {
+        for (int i=0; i<aColumnCount; ++i)
+        {
+            TextColumn *aColumn=mTextColumns->column(i);
+
+            for (int j=0; j<rows.length(); ++j)
+            {
+                const QStringList &aRow=rows.at(j);
+
+                if (i<aRow.length() && !aRow.at(i).isEmpty())
+                {
+                    aColumn->setText(j, aRow.at(i));
+                }
+            }
+        }
+    }
+    else
+    {
+        // Rows are shared with the given list, only short rows are copied
+        *mData=rows;
+
+        for (int i=0; i<mData->length(); ++i)
+        {
+            if (mData->at(i).length()<aColumnCount)
+            {
+                QStringList &aRow=(*mData)[i];
+
+                while (aRow.length()<aColumnCount)
+                {
+                    aRow.append(QString());
+                }
+            }
+        }
+    }
+
+    if (mRowCache)
+    {
+        mRowCache->clear();
+    }
 
     viewport()->update();
 
@@ -6054,7 +7006,7 @@ void CustomFastTableWidget::horizontalHeader_SetText(const int row, const int co
 
     (*mHorizontalHeader_Data)[row][column]=text;
 
-    viewport()->update();
+    horizontalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -6070,9 +7022,9 @@ void CustomFastTableWidget::horizontalHeader_SetText(const int column, const QSt
         FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_Data->at(i).length());
 
         (*mHorizontalHeader_Data)[i][column]=text;
-    }
 
-    viewport()->update();
+        horizontalHeader_UpdateCell(i, column);
+    }
 
     FASTTABLE_END_PROFILE;
 }
@@ -6105,7 +7057,7 @@ void CustomFastTableWidget::verticalHeader_SetText(const int row, const int colu
 
     (*mVerticalHeader_Data)[row][column]=text;
 
-    viewport()->update();
+    verticalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -6122,9 +7074,9 @@ void CustomFastTableWidget::verticalHeader_SetText(const int row, const QString
         FASTTABLE_ASSERT(i<mVerticalHeader_Data->at(row).length());
 
         (*mVerticalHeader_Data)[row][i]=text;
-    }
 
-    viewport()->update();
+        verticalHeader_UpdateCell(row, i);
+    }
 
     FASTTABLE_END_PROFILE;
 }
@@ -6200,10 +7152,10 @@ void CustomFastTableWidget::setCellTextFlags(const int /*row*/, const int /*colu
 bool CustomFastTableWidget::cellSelected(const int row, const int column)
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_ASSERT(row>=0 && row<mSelectedCells->length());
-    FASTTABLE_ASSERT(column>=0 && column<mSelectedCells->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mSelection->rowCount());
+    FASTTABLE_ASSERT(column>=0 && column<mSelection->columnCount());
 
-    return mSelectedCells->at(row).at(column);
+    return mSelection->contains(row, column);
 }
 
 void CustomFastTableWidget::setCellSelected(const int row, const int column, const bool selected)
@@ -6211,116 +7163,111 @@ void CustomFastTableWidget::setCellSelected(const int row, const int column, con
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mSelectedCells->length());
-    FASTTABLE_ASSERT(column>=0 && column<mSelectedCells->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_SelectedRows->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_SelectedColumns->length());
+    FASTTABLE_ASSERT(row>=0 && row<mSelection->rowCount());
+    FASTTABLE_ASSERT(column>=0 && column<mSelection->columnCount());
 
-    if (mSelectedCells->at(row).at(column)!=selected)
+    if (mSelection->contains(row, column)!=selected)
     {
-        (*mSelectedCells)[row][column]=selected;
+        QList<QRect> aChanged;
+        aChanged.append(QRect(column, row, 1, 1));
 
         if (selected)
         {
-            mCurSelection->append(QPoint(column, row));
-
-            (*mVerticalHeader_SelectedRows)[row]++;
-            (*mHorizontalHeader_SelectedColumns)[column]++;
+            mSelection->select(aChanged.first());
         }
         else
         {
-            for (int i=0; i<mCurSelection->length(); ++i)
-            {
-                if (mCurSelection->at(i).y()==row)
-                {
-                    if (mCurSelection->at(i).x()==column)
-                    {
-                        mCurSelection->removeAt(i);
-                        break;
-                    }
-                }
-            }
-
-            (*mVerticalHeader_SelectedRows)[row]--;
-            (*mHorizontalHeader_SelectedColumns)[column]--;
+            mSelection->unselect(aChanged.first());
         }
 
-        viewport()->update();
+        updateCell(row, column);
+        updateHeaderAreas();
 
-        emit selectionChanged();
+        if (selected)
+        {
+            emitSelectionChanged(aChanged, QList<QRect>());
+        }
+        else
+        {
+            emitSelectionChanged(QList<QRect>(), aChanged);
+        }
     }
 
     FASTTABLE_END_PROFILE;
 }
 
-QList<QPoint> CustomFastTableWidget::selectedCells()
-{
-    FASTTABLE_DEBUG;
-    return *mCurSelection;
-}
-
-QList<QRect> CustomFastTableWidget::selectedRanges()
+void CustomFastTableWidget::setRangeSelected(const QRect &range, const bool selected)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    QList<QRect> res;
+    // Delta is built from the range only, cells outside of it are not changed
+    QList<QRect> aChanged;
 
-    if (mCurSelection->length()==0)
+    if (selected)
     {
-        FASTTABLE_END_PROFILE;
-        return res;
+        aChanged=mSelection->unselectedIn(QList<QRect>()<<range);
+        mSelection->select(range);
+    }
+    else
+    {
+        aChanged=mSelection->rangesIn(range);
+        mSelection->unselect(range);
     }
 
-    for (int i=0; i<mRowCount; i++)
+    if (aChanged.length()>0)
     {
-        for (int j=0; j<mColumnCount; j++)
+        updateCells(range);
+        updateHeaderAreas();
+
+        if (selected)
         {
-            if (mSelectedCells->at(i).at(j))
-            {
-                bool good=true;
+            emitSelectionChanged(aChanged, QList<QRect>());
+        }
+        else
+        {
+            emitSelectionChanged(QList<QRect>(), aChanged);
+        }
+    }
 
-                for (int k=0; k<res.length(); k++)
-                {
-                    if (res.at(k).contains(j, i, false))
-                    {
-                        good=false;
-                        break;
-                    }
-                }
+    FASTTABLE_END_PROFILE;
+}
 
-                if (good)
-                {
-                    int width=1;
+void CustomFastTableWidget::setSelection(const QList<QRect> &ranges)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
 
-                    while (j+width<mColumnCount && mSelectedCells->at(i).at(j+width))
-                    {
-                        width++;
-                    }
+    SelectionRanges aOldSelection=*mSelection;
 
-                    int height=1;
+    mSelection->setRanges(ranges);
 
-                    while (i+height<mRowCount)
-                    {
-                        for (int k=j; k<j+width; k++)
-                        {
-                            if (!mSelectedCells->at(i+height).at(k))
-                            {
-                                good=false;
-                                break;
-                            }
-                        }
+    viewport()->update();
 
-                        if (!good)
-                        {
-                            break;
-                        }
+    // Every side is looked up in the other one, so only changed cells are reported
+    emitSelectionChanged(aOldSelection.unselectedIn(mSelection->ranges()), mSelection->unselectedIn(aOldSelection.ranges()));
 
-                        height++;
-                    }
+    FASTTABLE_END_PROFILE;
+}
 
-                    res.append(QRect(j, i, width, height));
-                }
+QList<QPoint> CustomFastTableWidget::selectedCells()
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    QList<QPoint> res;
+
+    const QList<QRect> &aRanges=mSelection->ranges();
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        const QRect &aRange=aRanges.at(i);
+
+        for (int j=aRange.top(); j<=aRange.bottom(); ++j)
+        {
+            for (int k=aRange.left(); k<=aRange.right(); ++k)
+            {
+                res.append(QPoint(k, j));
             }
         }
     }
@@ -6329,47 +7276,38 @@ QList<QRect> CustomFastTableWidget::selectedRanges()
     return res;
 }
 
+QList<QRect> CustomFastTableWidget::selectedRanges()
+{
+    FASTTABLE_DEBUG;
+    return mSelection->ranges();
+}
+
 QPoint CustomFastTableWidget::topLeftSelectedCell()
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_START_PROFILE;
 
-    if (mCurSelection->length()==0)
+    if (mSelection->isEmpty())
     {
-        FASTTABLE_END_PROFILE;
         return QPoint(-1, -1);
     }
 
-    for (int i=0; i<mRowCount; i++)
-    {
-        for (int j=0; j<mColumnCount; j++)
-        {
-            if (mSelectedCells->at(i).at(j))
-            {
-                FASTTABLE_END_PROFILE;
-                return QPoint(j, i);
-            }
-        }
-    }
-
-    FASTTABLE_END_PROFILE;
-    return QPoint(-1, -1);
+    return mSelection->ranges().first().topLeft();
 }
 
 bool CustomFastTableWidget::rowHasSelection(const int row)
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_SelectedRows->length());
+    FASTTABLE_ASSERT(row>=0 && row<mSelection->rowCount());
 
-    return mVerticalHeader_SelectedRows->at(row)!=0;
+    return mSelection->rowCellCount(row)!=0;
 }
 
 bool CustomFastTableWidget::columnHasSelection(const int column)
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_SelectedColumns->length());
+    FASTTABLE_ASSERT(column>=0 && column<mSelection->columnCount());
 
-    return mHorizontalHeader_SelectedColumns->at(column)!=0;
+    return mSelection->columnCellCount(column)!=0;
 }
 
 QPoint CustomFastTableWidget::currentCell()
@@ -6440,12 +7378,12 @@ void CustomFastTableWidget::setCurrentCell(const int row, const int column, cons
          !keepSelection
          &&
          (
-          mCurSelection->length()>1
+          mSelection->cellCount()>1
           ||
           (
            realRow>=0
            &&
-           !mSelectedCells->at(realRow).at(realColumn)
+           !mSelection->contains(realRow, realColumn)
           )
          )
         )
@@ -6467,7 +7405,15 @@ void CustomFastTableWidget::setCurrentCell(const int row, const int column, cons
             }
         }
 
-        viewport()->update();
+        if (aOldCurrentRow>=0 && aOldCurrentRow<mRowCount && aOldCurrentColumn>=0 && aOldCurrentColumn<mColumnCount)
+        {
+            updateCell(aOldCurrentRow, aOldCurrentColumn);
+        }
+
+        if (mCurrentRow>=0)
+        {
+            updateCell(mCurrentRow, mCurrentColumn);
+        }
 
         if (
             mCurrentRow>=0
@@ -6484,8 +7430,7 @@ void CustomFastTableWidget::setCurrentCell(const int row, const int column, cons
             finishEditing();
         }
 
-        emit currentCellChanged(mCurrentRow, mCurrentColumn, aOldCurrentRow, aOldCurrentColumn);
-        emit cellChanged(mCurrentRow, mCurrentColumn);
+        emitCurrentCellChanged(aOldCurrentRow, aOldCurrentColumn);
     }
 
     FASTTABLE_END_PROFILE;
@@ -6544,18 +7489,10 @@ QPoint CustomFastTableWidget::cellAt(const int x, const int y)
     int offsetX=-horizontalScrollBar()->value();
     int offsetY=-verticalScrollBar()->value();
 
-    int resX=-1;
-
-    for (int i=mVisibleLeft; i<=mVisibleRight; ++i)
-    {
-        if (x>=offsetX+mOffsetX->at(i) && x<offsetX+mOffsetX->at(i)+mColumnWidths->at(i))
-        {
-            resX=i;
-            break;
-        }
-    }
+    int resX=columnAtOffset(x-offsetX);
 
-    if (resX<0)
+    // Offset search stops at the last column, so points after it are checked here
+    if (resX<0 || mColumnWidths->at(resX)<=0 || x<offsetX+mOffsetX->at(resX) || x>=offsetX+mOffsetX->at(resX)+mColumnWidths->at(resX))
     {
         FASTTABLE_END_PROFILE;
         return QPoint(-1, -1);
@@ -6563,18 +7500,9 @@ QPoint CustomFastTableWidget::cellAt(const int x, const int y)
 
 
 
-    int resY=-1;
+    int resY=rowAtOffset(y-offsetY);
 
-    for (int i=mVisibleTop; i<=mVisibleBottom; ++i)
-    {
-        if (y>=offsetY+mOffsetY->at(i) && y<offsetY+mOffsetY->at(i)+mRowHeights->at(i))
-        {
-            resY=i;
-            break;
-        }
-    }
-
-    if (resY<0)
+    if (resY<0 || mRowHeights->at(resY)<=0 || y<offsetY+mOffsetY->at(resY) || y>=offsetY+mOffsetY->at(resY)+mRowHeights->at(resY))
     {
         FASTTABLE_END_PROFILE;
         return QPoint(-1, -1);
@@ -6604,18 +7532,9 @@ QPoint CustomFastTableWidget::horizontalHeader_CellAt(const int x, const int y)
 
     int offsetX=-horizontalScrollBar()->value();
 
-    int resX=-1;
-
-    for (int i=mVisibleLeft; i<=mVisibleRight; ++i)
-    {
-        if (x>=offsetX+mOffsetX->at(i) && x<offsetX+mOffsetX->at(i)+mColumnWidths->at(i))
-        {
-            resX=i;
-            break;
-        }
-    }
+    int resX=columnAtOffset(x-offsetX);
 
-    if (resX<0)
+    if (resX<0 || mColumnWidths->at(resX)<=0 || x<offsetX+mOffsetX->at(resX) || x>=offsetX+mOffsetX->at(resX)+mColumnWidths->at(resX))
     {
         FASTTABLE_END_PROFILE;
         return QPoint(-1, -1);
@@ -6623,18 +7542,9 @@ QPoint CustomFastTableWidget::horizontalHeader_CellAt(const int x, const int y)
 
 
 
-    int resY=-1;
-
-    for (int i=0; i<=mHorizontalHeader_VisibleBottom; ++i)
-    {
-        if (y>=mHorizontalHeader_OffsetY->at(i) && y<mHorizontalHeader_OffsetY->at(i)+mHorizontalHeader_RowHeights->at(i))
-        {
-            resY=i;
-            break;
-        }
-    }
+    int resY=horizontalHeader_rowAtOffset(y);
 
-    if (resY<0)
+    if (resY<0 || mHorizontalHeader_RowHeights->at(resY)<=0 || y<mHorizontalHeader_OffsetY->at(resY) || y>=mHorizontalHeader_OffsetY->at(resY)+mHorizontalHeader_RowHeights->at(resY))
     {
         FASTTABLE_END_PROFILE;
         return QPoint(-1, -1);
@@ -6664,18 +7574,9 @@ QPoint CustomFastTableWidget::verticalHeader_CellAt(const int x, const int y)
 
     int offsetY=-verticalScrollBar()->value();
 
-    int resX=-1;
-
-    for (int i=0; i<=mVerticalHeader_VisibleRight; ++i)
-    {
-        if (x>=mVerticalHeader_OffsetX->at(i) && x<mVerticalHeader_OffsetX->at(i)+mVerticalHeader_ColumnWidths->at(i))
-        {
-            resX=i;
-            break;
-        }
-    }
+    int resX=verticalHeader_columnAtOffset(x);
 
-    if (resX<0)
+    if (resX<0 || mVerticalHeader_ColumnWidths->at(resX)<=0 || x<mVerticalHeader_OffsetX->at(resX) || x>=mVerticalHeader_OffsetX->at(resX)+mVerticalHeader_ColumnWidths->at(resX))
     {
         FASTTABLE_END_PROFILE;
         return QPoint(-1, -1);
@@ -6683,18 +7584,9 @@ QPoint CustomFastTableWidget::verticalHeader_CellAt(const int x, const int y)
 
 
 
-    int resY=-1;
-
-    for (int i=mVisibleTop; i<=mVisibleBottom; ++i)
-    {
-        if (y>=offsetY+mOffsetY->at(i) && y<offsetY+mOffsetY->at(i)+mRowHeights->at(i))
-        {
-            resY=i;
-            break;
-        }
-    }
+    int resY=rowAtOffset(y-offsetY);
 
-    if (resY<0)
+    if (resY<0 || mRowHeights->at(resY)<=0 || y<offsetY+mOffsetY->at(resY) || y>=offsetY+mOffsetY->at(resY)+mRowHeights->at(resY))
     {
         FASTTABLE_END_PROFILE;
         return QPoint(-1, -1);
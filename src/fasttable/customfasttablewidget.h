@@ -19,6 +19,15 @@
 #include <QFontMetrics>
 
 #include "fastdefines.h"
+#include "fastlistutils.h"
+#include "offsetindex.h"
+#include "selectionranges.h"
+#include "textcolumns.h"
+#include "cellblock.h"
+#include "asyncdataprovider.h"
+#include "rowblockcache.h"
+#include "mappedcsvfile.h"
+#include "csvimporter.h"
 
 //------------------------------------------------------------------------------
 
@@ -50,11 +59,12 @@ class CustomFastTableWidget : public QAbstractScrollArea
     Q_PROPERTY(QColor  verticalHeader_CellBorderColor          READ verticalHeader_CellBorderColor          WRITE verticalHeader_SetCellBorderColor)
 
 public:
-    Q_ENUMS(DrawComponent Style MouseLocation)
+    Q_ENUMS(DrawComponent Style MouseLocation DataStorage)
 
     enum DrawComponent {DrawCell, DrawHorizontalHeaderCell, DrawVerticalHeaderCell, DrawTopLeftCorner};
     enum Style {StyleSimple, StyleLinux, StyleWinXP, StyleWin7};
     enum MouseLocation {InMiddleWorld, InCell, InHorizontalHeaderCell, InVerticalHeaderCell, InTopLeftCorner};
+    enum DataStorage {RowStorage, ColumnStorage};
 
     typedef void (*DrawFunction)(QPainter &painter, const int x, const int y, const int width, const int height, const bool headerPressed, QColor *aGridColor, QBrush *aBackgroundBrush, QColor *aBorderColor);
 
@@ -65,6 +75,10 @@ public:
     bool updatesEnabled() const;
     void setUpdatesEnabled(bool enable);
 
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating() const;
+
     void setHorizontalScrollBar(QScrollBar *scrollbar);
     void setVerticalScrollBar(QScrollBar *scrollbar);
 
@@ -93,10 +107,14 @@ public:
     void addRow();
     virtual void insertRow(int row);
     virtual void removeRow(int row);
+    virtual void insertRows(int row, int count);
+    virtual void removeRows(int row, int count);
 
     void addColumn();
     virtual void insertColumn(int column);
     virtual void removeColumn(int column);
+    virtual void insertColumns(int column, int count);
+    virtual void removeColumns(int column, int count);
 
     void horizontalHeader_AddRow();
     virtual void horizontalHeader_InsertRow(int row);
@@ -204,6 +222,11 @@ public:
     int horizontalHeader_rowOffset(const int row);
     int verticalHeader_columnOffset(const int column);
 
+    int rowAtOffset(const int y);
+    int columnAtOffset(const int x);
+    int horizontalHeader_rowAtOffset(const int y);
+    int verticalHeader_columnAtOffset(const int x);
+
     void updateOffsetsX(const int fromIndex=0);
     void updateOffsetsY(const int fromIndex=0);
     void verticalHeader_UpdateOffsetsX(const int fromIndex=0);
@@ -216,10 +239,32 @@ public:
     virtual QRect cellRectangle(const int row, const int column);
     virtual QRect horizontalHeader_CellRectangle(const int row, const int column);
     virtual QRect verticalHeader_CellRectangle(const int row, const int column);
+    virtual void updateCell(const int row, const int column);
+    virtual void horizontalHeader_UpdateCell(const int row, const int column);
+    virtual void verticalHeader_UpdateCell(const int row, const int column);
+    void updateCells(const QRect &range);
     void scrollToCell(const int row, const int column, const bool centered=false);
 
+    DataStorage dataStorage();
+    void setDataStorage(DataStorage storage);
+
+    AsyncDataProvider *asyncDataProvider();
+    void setAsyncDataProvider(AsyncDataProvider *provider);
+
+    bool isRowCacheEnabled();
+    void setRowCacheEnabled(const bool enable);
+    RowBlockCache *rowCache();
+
+    MappedCsvFile *mappedCsvFile();
+    void setMappedCsvFile(MappedCsvFile *file);
+
+    bool isColumnDictionaryEncoded(const int column);
+    void setColumnDictionaryEncoded(const int column, const bool encoded);
+    const TextColumn *textColumn(const int column);
+
     virtual QString text(const int row, const int column);
     virtual void setText(const int row, const int column, const QString text);
+    void setTexts(const QList<QStringList> &rows);
 
     QString horizontalHeader_Text(const int row, const int column);
     QString horizontalHeader_Text(const int column);
@@ -245,6 +290,8 @@ public:
 
     virtual bool cellSelected(const int row, const int column);
     virtual void setCellSelected(const int row, const int column, const bool selected);
+    void setRangeSelected(const QRect &range, const bool selected);
+    void setSelection(const QList<QRect> &ranges);
 
     QList<QPoint> selectedCells();
     QList<QRect> selectedRanges();
@@ -261,7 +308,7 @@ public:
     int currentColumn();
     void setCurrentColumn(const int column, const bool keepSelection=false);
 
-    QPoint cellAt(const int x, const int y);
+    virtual QPoint cellAt(const int x, const int y);
     QPoint horizontalHeader_CellAt(const int x, const int y);
     QPoint verticalHeader_CellAt(const int x, const int y);
     bool atTopLeftCorner(const int x, const int y);
@@ -319,10 +366,11 @@ protected:
     int mVerticalHeader_VisibleRight;
 
     QList< QStringList > *mData;
-    QList< qint16 >      *mRowHeights;
-    QList< qint16 >      *mColumnWidths;
-    QList< int >         *mOffsetX;
-    QList< int >         *mOffsetY;
+    TextColumns          *mTextColumns;
+    SizeList             *mRowHeights;
+    SizeList             *mColumnWidths;
+    OffsetIndex          *mOffsetX;
+    OffsetIndex          *mOffsetY;
 
     QList< QStringList > *mHorizontalHeader_Data;
     QList< qint16 >      *mHorizontalHeader_RowHeights;
@@ -332,10 +380,17 @@ protected:
     QList< qint16 >      *mVerticalHeader_ColumnWidths;
     QList< int >         *mVerticalHeader_OffsetX;
 
-    QList< QList<bool> > *mSelectedCells;
-    QList< QPoint >      *mCurSelection;
-    QList< int >         *mHorizontalHeader_SelectedColumns;
-    QList< int >         *mVerticalHeader_SelectedRows;
+    SelectionRanges      *mSelection;
+    SelectionRanges      *mPendingSelected;
+    SelectionRanges      *mPendingDeselected;
+
+    CellBlock            *mCellBlock;
+
+    AsyncDataProvider    *mAsyncDataProvider;
+
+    RowBlockCache        *mRowCache;
+
+    MappedCsvFile        *mMappedCsvFile;
 
     int mCurrentRow;
     int mCurrentColumn;
@@ -355,7 +410,9 @@ protected:
     MouseLocation mMouseLocation;
     MouseLocation mMouseLocationForShift;
 
-    QList< QList<bool> > *mMouseSelectedCells;
+    // Selection before mouse selection started and rectangle applied over it (empty if none)
+    SelectionRanges      *mMouseBaseSelection;
+    QRect                 mMouseSelectedRange;
 
     QTimer      mMouseHoldTimer;
     QMouseEvent mMouseEvent;
@@ -366,6 +423,14 @@ protected:
     QWidget                        *mEditor;
     bool                            mEditorPaintByTable;
 
+    int  mUpdateLevel;
+    bool mUpdateViewportWasEnabled;
+    bool mPendingSizes;
+    bool mPendingVerticalHeaderSize;
+    bool mPendingCurrentCellChanged;
+    int  mPendingPreviousRow;
+    int  mPendingPreviousColumn;
+
     void init(const bool aUseInternalData);
     void createLists();
     void deleteLists();
@@ -380,6 +445,10 @@ protected:
     void leaveEvent(QEvent *event);
     void resizeEvent(QResizeEvent *event);
     void paintEvent(QPaintEvent *event);
+    void scrollContentsBy(int dx, int dy);
+
+    virtual void resizeRows(int count);
+    virtual void resizeColumns(int count);
 
     virtual void selectRangeForHandlers(int resX, int resY);
     virtual void horizontalHeader_SelectRangeForHandlers(int resX);
@@ -389,6 +458,11 @@ protected:
     virtual void paintCell(QPainter &painter, const int x, const int y, const int width, const int height, const DrawComponent drawComponent, bool headerPressed, QColor *aGridColor,
                            QBrush *aBackgroundBrush, QColor *aBorderColor, QColor *aTextColor, QString *aText, QFont *aFont, int aTextFlags);
 
+    virtual void fetchVisibleBlock(const QRect &range, CellBlock &block);
+
+    void requestVisibleRows();
+    QString cachedText(const int row, const int column);
+
     static void paintCellLinux(QPainter &painter, const int x, const int y, const int width, const int height, const bool headerPressed, QColor *aGridColor, QBrush *aBackgroundBrush, QColor *aBorderColor);
     static void paintCellDefault(QPainter &painter, const int x, const int y, const int width, const int height, const bool headerPressed, QColor *aGridColor, QBrush *aBackgroundBrush, QColor *aBorderColor);
     static void paintHeaderCellLinux(QPainter &painter, const int x, const int y, const int width, const int height, const bool headerPressed, QColor *aGridColor, QBrush *aBackgroundBrush, QColor *aBorderColor);
@@ -400,9 +474,22 @@ protected:
     void updateSizes();
     void updateBarsRanges();
     virtual void updateVisibleRange();
+    virtual QRect exposedCells(const QRect &area);
+    QRect scrolledArea(const int dx, const int dy);
+    QRect dirtyArea(const QRect &range);
+    void updateHeaderAreas();
+
+    void emitSelectionChanged(const QList<QRect> &selected, const QList<QRect> &deselected);
+    void emitCurrentCellChanged(const int previousRow, const int previousColumn);
+    static int searchOffset(const QList<int> *offsets, const QList<qint16> *sizes, const int count, const int position);
     void initShiftSelectionForKeyboard();
     void initShiftSelection();
     void fillShiftSelection();
+    void horizontalHeader_FillShiftSelection();
+    void verticalHeader_FillShiftSelection();
+    void startMouseSelection(const QRect &range);
+    void restoreMouseSelection(const QRect &range);
+    void moveMouseSelection(const QRect &range, const bool selected);
 
     bool isEditKey(const QString aText);
     void removeEditor();
@@ -422,6 +509,11 @@ protected slots:
 
     void mouseHoldTick();
 
+    void asyncRowsLoaded(int first, int last);
+    void asyncDataProviderDestroyed();
+    void mappedRowsIndexed(int rowCount, int columnCount);
+    void mappedCsvFileDestroyed();
+
 signals:
     void cellClicked(int row, int column);
     void cellRightClicked(int row, int column);
@@ -441,13 +533,18 @@ signals:
 
     void currentCellChanged(int currentRow, int currentColumn, int previousRow, int previousColumn);
     void cellChanged(int row, int column);
-    void selectionChanged();
+    void selectionChanged(const QList<QRect> &selected, const QList<QRect> &deselected);
 
     void rowHeightChanged(int row, int value);
     void columnWidthChanged(int column, int value);
 
     void horizontalHeader_RowHeightChanged(int row, int value);
     void verticalHeader_ColumnWidthChanged(int column, int value);
+
+    void rowsInserted(int row, int count);
+    void rowsRemoved(int row, int count);
+    void columnsInserted(int column, int count);
+    void columnsRemoved(int column, int count);
 };
 
 #endif // CUSTOMCustomFastTableWidget_H
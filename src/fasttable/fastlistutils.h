@@ -0,0 +1,90 @@
+#ifndef FASTLISTUTILS_H
+#define FASTLISTUTILS_H
+
+#include <QList>
+
+#include "fastdefines.h"
+
+// Reverses items in [from, to) by swapping list nodes, items are not copied
+template <typename T>
+inline void fastReverseRange(QList<T> &list, int from, int to)
+{
+    for (--to; from<to; ++from, --to)
+    {
+        list.swap(from, to);
+    }
+}
+
+// Moves last count items to index with three reversals
+template <typename T>
+inline void fastRotateTail(QList<T> &list, const int index, const int count)
+{
+    int aLength=list.length();
+
+    FASTTABLE_ASSERT(index>=0 && count>=0 && index+count<=aLength);
+
+    fastReverseRange(list, index, aLength-count);
+    fastReverseRange(list, aLength-count, aLength);
+    fastReverseRange(list, index, aLength);
+}
+
+// Inserts values at index, the block is appended and rotated into place in a single pass
+template <typename T>
+inline void fastInsertRange(QList<T> &list, const int index, const QList<T> &values)
+{
+    FASTTABLE_ASSERT(index>=0 && index<=list.length());
+
+    if (index==list.length())
+    {
+        list.append(values);
+        return;
+    }
+
+    if (values.length()==1)
+    {
+        list.insert(index, values.at(0));
+        return;
+    }
+
+    list.reserve(list.length()+values.length());
+    list.append(values);
+
+    fastRotateTail(list, index, values.length());
+}
+
+// Inserts count copies of value at index, the block is appended and rotated into place in a single pass
+template <typename T>
+inline void fastInsertRange(QList<T> &list, const int index, const int count, const T &value)
+{
+    FASTTABLE_ASSERT(index>=0 && index<=list.length() && count>=0);
+
+    if (count==1)
+    {
+        list.insert(index, value);
+        return;
+    }
+
+    bool aAppend=index==list.length();
+
+    list.reserve(list.length()+count);
+
+    for (int i=0; i<count; ++i)
+    {
+        list.append(value);
+    }
+
+    if (!aAppend)
+    {
+        fastRotateTail(list, index, count);
+    }
+}
+
+template <typename T>
+inline void fastRemoveRange(QList<T> &list, const int index, const int count)
+{
+    FASTTABLE_ASSERT(index>=0 && count>=0 && index+count<=list.length());
+
+    list.erase(list.begin()+index, list.begin()+index+count);
+}
+
+#endif // FASTLISTUTILS_H
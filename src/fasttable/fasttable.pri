@@ -5,6 +5,19 @@
 #-------------------------------------------------
 
 include("optimallist/optimallist.pri")
+include("offsetindex/offsetindex.pri")
+include("bitgrid/bitgrid.pri")
+include("rectindex/rectindex.pri")
+include("rectset/rectset.pri")
+include("selectionranges/selectionranges.pri")
+include("spanindex/spanindex.pri")
+include("styletable/styletable.pri")
+include("textcolumns/textcolumns.pri")
+include("cellblock/cellblock.pri")
+include("rowblockcache/rowblockcache.pri")
+include("asyncdataprovider/asyncdataprovider.pri")
+include("mappedcsvfile/mappedcsvfile.pri")
+include("csvimporter/csvimporter.pri")
 
 INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
@@ -14,4 +27,5 @@ SOURCES += $$PWD/customfasttablewidget.cpp \
 
 HEADERS  += $$PWD/customfasttablewidget.h \
             $$PWD/fasttablewidget.h \
-            $$PWD/fastdefines.h
+            $$PWD/fastdefines.h \
+            $$PWD/fastlistutils.h
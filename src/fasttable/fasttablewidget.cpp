@@ -34,128 +34,76 @@ FastTableWidget::~FastTableWidget()
 
 void FastTableWidget::createLists()
 {
-    if (mUseInternalData)
-    {
-        mBackgroundBrushes                  = new QList< QList<QBrush *> >();
-        mForegroundColors                   = new QList< QList<QColor *> >();
-        mCellFonts                          = new QList< QList<QFont *> >();
-        mCellTextFlags                      = new QList< QList<int> >();
-    }
-    else
-    {
-        mBackgroundBrushes                  = 0;
-        mForegroundColors                   = 0;
-        mCellFonts                          = 0;
-        mCellTextFlags                      = 0;
-    }
-
-    mCellMergeX                             = new QList< QList<quint16> >();
-    mCellMergeY                             = new QList< QList<quint16> >();
-    mCellMergeParentRow                     = new QList< QList<int> >();
-    mCellMergeParentColumn                  = new QList< QList<int> >();
-    mMerges                                 = new QList< QRect >();
-
-    mHorizontalHeader_BackgroundBrushes     = new QList< QList<QBrush *> >();
-    mHorizontalHeader_ForegroundColors      = new QList< QList<QColor *> >();
-    mHorizontalHeader_CellFonts             = new QList< QList<QFont *> >();
-    mHorizontalHeader_CellTextFlags         = new QList< QList<int> >();
-    mHorizontalHeader_CellMergeX            = new QList< QList<quint16> >();
-    mHorizontalHeader_CellMergeY            = new QList< QList<quint16> >();
-    mHorizontalHeader_CellMergeParentRow    = new QList< QList<int> >();
-    mHorizontalHeader_CellMergeParentColumn = new QList< QList<int> >();
-    mHorizontalHeader_Merges                = new QList< QRect >();
-
-    mVerticalHeader_BackgroundBrushes       = new QList< QList<QBrush *> >();
-    mVerticalHeader_ForegroundColors        = new QList< QList<QColor *> >();
-    mVerticalHeader_CellFonts               = new QList< QList<QFont *> >();
-    mVerticalHeader_CellTextFlags           = new QList< QList<int> >();
-    mVerticalHeader_CellMergeX              = new QList< QList<quint16> >();
-    mVerticalHeader_CellMergeY              = new QList< QList<quint16> >();
-    mVerticalHeader_CellMergeParentRow      = new QList< QList<int> >();
-    mVerticalHeader_CellMergeParentColumn   = new QList< QList<int> >();
-    mVerticalHeader_Merges                  = new QList< QRect >();
+    // Cell styles are empty until the first non-default style is set
+    mStyles                                 = new StyleTable(FASTTABLE_DEFAULT_TEXT_FLAG);
+    mCellStyles                             = new QList< QList<int> >();
+    mSpans                                  = new SpanIndex();
+
+    mHorizontalHeader_Styles                = new StyleTable(FASTTABLE_HEADER_DEFAULT_TEXT_FLAG);
+    mHorizontalHeader_CellStyles            = new QList< QList<int> >();
+    mHorizontalHeader_Spans                 = new SpanIndex();
+
+    mVerticalHeader_Styles                  = new StyleTable(FASTTABLE_DEFAULT_TEXT_FLAG);
+    mVerticalHeader_CellStyles              = new QList< QList<int> >();
+    mVerticalHeader_Spans                   = new SpanIndex();
 }
 
 void FastTableWidget::deleteLists()
 {
-    if (mBackgroundBrushes)
-    {
-        delete mBackgroundBrushes;
-    }
-
-    if (mForegroundColors)
-    {
-        delete mForegroundColors;
-    }
-
-    if (mCellFonts)
-    {
-        delete mCellFonts;
-    }
-
-    if (mCellTextFlags)
-    {
-        delete mCellTextFlags;
-    }
-
-    delete mCellMergeX;
-    delete mCellMergeY;
-    delete mCellMergeParentRow;
-    delete mCellMergeParentColumn;
-    delete mMerges;
+    delete mStyles;
+    delete mCellStyles;
+    delete mSpans;
 
-    delete mHorizontalHeader_BackgroundBrushes;
-    delete mHorizontalHeader_ForegroundColors;
-    delete mHorizontalHeader_CellFonts;
-    delete mHorizontalHeader_CellTextFlags;
-    delete mHorizontalHeader_CellMergeX;
-    delete mHorizontalHeader_CellMergeY;
-    delete mHorizontalHeader_CellMergeParentRow;
-    delete mHorizontalHeader_CellMergeParentColumn;
-    delete mHorizontalHeader_Merges;
+    delete mHorizontalHeader_Styles;
+    delete mHorizontalHeader_CellStyles;
+    delete mHorizontalHeader_Spans;
 
-    delete mVerticalHeader_BackgroundBrushes;
-    delete mVerticalHeader_ForegroundColors;
-    delete mVerticalHeader_CellFonts;
-    delete mVerticalHeader_CellTextFlags;
-    delete mVerticalHeader_CellMergeX;
-    delete mVerticalHeader_CellMergeY;
-    delete mVerticalHeader_CellMergeParentRow;
-    delete mVerticalHeader_CellMergeParentColumn;
-    delete mVerticalHeader_Merges;
+    delete mVerticalHeader_Styles;
+    delete mVerticalHeader_CellStyles;
+    delete mVerticalHeader_Spans;
 }
 
-void FastTableWidget::paintEvent(QPaintEvent * /*event*/)
+void FastTableWidget::paintEvent(QPaintEvent *event)
 {
     FASTTABLE_FREQUENT_DEBUG;
     FASTTABLE_FREQUENT_START_PROFILE;
 
     QPainter painter(viewport());
 
-    painter.fillRect(0, 0, viewport()->width(), viewport()->height(), palette().color(QPalette::Window));
+    QRect aExposedRect=event->rect();
+
+    painter.fillRect(aExposedRect, palette().color(QPalette::Window));
 
     int offsetX=-horizontalScrollBar()->value();
     int offsetY=-verticalScrollBar()->value();
 
     QSize areaSize=viewport()->size();
 
-    if (mVisibleLeft>=0 && mVisibleTop>=0)
+    QRect aExposedCells=exposedCells(aExposedRect);
+
+    if (aExposedCells.left()<=aExposedCells.right() && aExposedCells.top()<=aExposedCells.bottom())
     {
         FASTTABLE_ASSERT(mVisibleBottom<mOffsetY->length());
         FASTTABLE_ASSERT(mVisibleBottom<mRowHeights->length());
         FASTTABLE_ASSERT(mVisibleRight<mOffsetX->length());
         FASTTABLE_ASSERT(mVisibleRight<mColumnWidths->length());
 
-        for (int i=mVisibleTop; i<=mVisibleBottom; ++i)
+        // Attributes of exposed cells are requested once, missing attributes are requested cell by cell
+        mCellBlock->reset(aExposedCells);
+        fetchVisibleBlock(aExposedCells, *mCellBlock);
+
+        for (int i=aExposedCells.top(); i<=aExposedCells.bottom(); ++i)
         {
-            for (int j=mVisibleLeft; j<=mVisibleRight; ++j)
+            for (int j=aExposedCells.left(); j<=aExposedCells.right(); ++j)
             {
-                if (mCellMergeParentRow->at(i).at(j)>=0 && mCellMergeParentColumn->at(i).at(j)>=0)
+                QRect aSpan=mSpans->spanAt(i, j);
+
+                if (aSpan.isValid())
                 {
-                    int spanX=mCellMergeX->at(i).at(j);
-                    int spanY=mCellMergeY->at(i).at(j);
+                    int spanX=aSpan.width();
+                    int spanY=aSpan.height();
 
-                    if (spanX>1 || spanY>1)
+                    if (aSpan.left()==j && aSpan.top()==i)
                     {
                         int aWidth=0;
                         int aHeight=0;
@@ -215,6 +163,8 @@ void FastTableWidget::paintEvent(QPaintEvent * /*event*/)
                 }
             }
         }
+
+        mCellBlock->reset(QRect());
     }
 
     if (mEditor)
@@ -223,7 +173,8 @@ void FastTableWidget::paintEvent(QPaintEvent * /*event*/)
         mEditor->render(&painter, mapTo(window(), mEditor->pos()));
     }
 
-    if (mHorizontalHeader_VisibleBottom>=0 && mVisibleLeft>=0)
+    // Header spans are few, so headers are painted in whole visible range if they are exposed
+    if (mHorizontalHeader_VisibleBottom>=0 && mVisibleLeft>=0 && aExposedRect.top()<mHorizontalHeader_TotalHeight)
     {
         FASTTABLE_ASSERT(mHorizontalHeader_VisibleBottom<mHorizontalHeader_OffsetY->length());
         FASTTABLE_ASSERT(mHorizontalHeader_VisibleBottom<mHorizontalHeader_RowHeights->length());
@@ -234,12 +185,14 @@ void FastTableWidget::paintEvent(QPaintEvent * /*event*/)
         {
             for (int j=mVisibleLeft; j<=mVisibleRight; ++j)
             {
-                if (mHorizontalHeader_CellMergeParentRow->at(i).at(j)>=0 && mHorizontalHeader_CellMergeParentColumn->at(i).at(j)>=0)
+                QRect aSpan=mHorizontalHeader_Spans->spanAt(i, j);
+
+                if (aSpan.isValid())
                 {
-                    int spanX=mHorizontalHeader_CellMergeX->at(i).at(j);
-                    int spanY=mHorizontalHeader_CellMergeY->at(i).at(j);
+                    int spanX=aSpan.width();
+                    int spanY=aSpan.height();
 
-                    if (spanX>1 || spanY>1)
+                    if (aSpan.left()==j && aSpan.top()==i)
                     {
                         int aWidth=0;
                         int aHeight=0;
@@ -301,7 +254,7 @@ void FastTableWidget::paintEvent(QPaintEvent * /*event*/)
         }
     }
 
-    if (mVerticalHeader_VisibleRight>=0 && mVisibleTop>=0)
+    if (mVerticalHeader_VisibleRight>=0 && mVisibleTop>=0 && aExposedRect.left()<mVerticalHeader_TotalWidth)
     {
         FASTTABLE_ASSERT(mVisibleBottom<mOffsetY->length());
         FASTTABLE_ASSERT(mVisibleBottom<mRowHeights->length());
@@ -312,12 +265,14 @@ void FastTableWidget::paintEvent(QPaintEvent * /*event*/)
         {
             for (int j=0; j<=mVerticalHeader_VisibleRight; ++j)
             {
-                if (mVerticalHeader_CellMergeParentRow->at(i).at(j)>=0 && mVerticalHeader_CellMergeParentColumn->at(i).at(j)>=0)
+                QRect aSpan=mVerticalHeader_Spans->spanAt(i, j);
+
+                if (aSpan.isValid())
                 {
-                    int spanX=mVerticalHeader_CellMergeX->at(i).at(j);
-                    int spanY=mVerticalHeader_CellMergeY->at(i).at(j);
+                    int spanX=aSpan.width();
+                    int spanY=aSpan.height();
 
-                    if (spanX>1 || spanY>1)
+                    if (aSpan.left()==j && aSpan.top()==i)
                     {
                         int aWidth=0;
                         int aHeight=0;
@@ -379,7 +334,17 @@ void FastTableWidget::paintEvent(QPaintEvent * /*event*/)
         }
     }
 
-    if (mVerticalHeader_VisibleRight>=0 && mHorizontalHeader_VisibleBottom>=0 && mVerticalHeader_TotalWidth>=0 && mHorizontalHeader_TotalHeight>=0)
+    if (
+        mVerticalHeader_VisibleRight>=0
+        &&
+        mHorizontalHeader_VisibleBottom>=0
+        &&
+        mVerticalHeader_TotalWidth>=0
+        &&
+        mHorizontalHeader_TotalHeight>=0
+        &&
+        aExposedRect.intersects(QRect(0, 0, mVerticalHeader_TotalWidth, mHorizontalHeader_TotalHeight))
+       )
     {
         paintCell(painter, 0, 0, mVerticalHeader_TotalWidth, mHorizontalHeader_TotalHeight, -1, -1, DrawTopLeftCorner);
     }
@@ -423,18 +388,16 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
     {
         case DrawCell:
         {
-            FASTTABLE_ASSERT(row>=0 && row<mSelectedCells->length());
-            FASTTABLE_ASSERT(column>=0 && column<mSelectedCells->at(row).length());
-            FASTTABLE_ASSERT(mBackgroundBrushes==0 || (row>=0 && row<mBackgroundBrushes->length()));
-            FASTTABLE_ASSERT(mBackgroundBrushes==0 || (column>=0 && column<mBackgroundBrushes->at(row).length()));
-            FASTTABLE_ASSERT(mForegroundColors==0 || (row>=0 && row<mForegroundColors->length()));
-            FASTTABLE_ASSERT(mForegroundColors==0 || (column>=0 && column<mForegroundColors->at(row).length()));
-            FASTTABLE_ASSERT(mCellFonts==0 || (row>=0 && row<mCellFonts->length()));
-            FASTTABLE_ASSERT(mCellFonts==0 || (column>=0 && column<mCellFonts->at(row).length()));
+            FASTTABLE_ASSERT(row>=0 && row<mSelection->rowCount());
+            FASTTABLE_ASSERT(column>=0 && column<mSelection->columnCount());
+
+            // Attributes set by style table win over block, block wins over per-cell functions
+            int aBlockIndex=mCellBlock->indexOf(row, column);
+            int aStyle=cellStyle(mCellStyles, row, column);
 
             aGridColor=&mGridColor;
 
-            if (mSelectedCells->at(row).at(column))
+            if (mSelection->contains(row, column))
             {
                 aTextBackgroundBrush=aPalette.highlight();
                 aForegroundColor=aPalette.color(QPalette::HighlightedText);
@@ -444,17 +407,15 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
             }
             else
             {
-                if (mBackgroundBrushes)
-                {
-                    aBackgroundBrush=mBackgroundBrushes->at(row).at(column);
-                }
-                else
-                {
-                    aBackgroundBrush=0;
-                }
+                aBackgroundBrush=mStyles->backgroundBrush(aStyle);
 
                 if (aBackgroundBrush==0)
                 {
+                    if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::BackgroundBrushes))
+                    {
+                        aTextBackgroundBrush=mCellBlock->backgroundBrush(aBlockIndex);
+                    }
+                    else
                     if (mUseInternalData && mAlternatingRowColors && (row & 1))
                     {
                         aTextBackgroundBrush=aPalette.alternateBase();
@@ -467,25 +428,26 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                     aBackgroundBrush=&aTextBackgroundBrush;
                 }
 
-                if (mForegroundColors)
-                {
-                    aTextColor=mForegroundColors->at(row).at(column);
-                }
-                else
-                {
-                    aTextColor=0;
-                }
+                aTextColor=mStyles->foregroundColor(aStyle);
 
                 if (aTextColor==0)
                 {
-                    aForegroundColor=foregroundColor(row, column);
+                    if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::ForegroundColors))
+                    {
+                        aForegroundColor=mCellBlock->foregroundColor(aBlockIndex);
+                    }
+                    else
+                    {
+                        aForegroundColor=foregroundColor(row, column);
+                    }
+
                     aTextColor=&aForegroundColor;
                 }
             }
 
             aHeaderPressed=false;
 
-            if (mCurrentRow>=row && mCurrentRow<row+mCellMergeY->at(row).at(column) && mCurrentColumn>=column && mCurrentColumn<column+mCellMergeX->at(row).at(column))
+            if (mCurrentRow>=row && mCurrentRow<row+mSpans->rowSpan(row, column) && mCurrentColumn>=column && mCurrentColumn<column+mSpans->columnSpan(row, column))
             {
                 aBorderColor=&mCellBorderColor;
             }
@@ -494,51 +456,72 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                 aBorderColor=0;
             }
 
-            aTextString=text(row, column);
-            aText=&aTextString;
-
-            if (mCellFonts)
+            if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::Texts))
             {
-                aFont=mCellFonts->at(row).at(column);
+                aTextString=mCellBlock->text(aBlockIndex);
             }
             else
             {
-                aFont=0;
+                aTextString=cachedText(row, column);
             }
 
+            aText=&aTextString;
+
+            aFont=mStyles->font(aStyle);
+
             if (aFont==0)
             {
-                aTextFont=cellFont(row, column);
+                if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::Fonts))
+                {
+                    aTextFont=mCellBlock->font(aBlockIndex);
+                }
+                else
+                {
+                    aTextFont=cellFont(row, column);
+                }
+
                 aFont=&aTextFont;
             }
 
-            textFlags=cellTextFlags(row, column);
+            if (mStyles->hasTextFlags(aStyle))
+            {
+                textFlags=mStyles->textFlags(aStyle);
+            }
+            else
+            if (aBlockIndex>=0 && mCellBlock->hasField(CellBlock::TextFlags))
+            {
+                textFlags=mCellBlock->textFlag(aBlockIndex);
+            }
+            else
+            {
+                textFlags=cellTextFlags(row, column);
+            }
+
+            // Placeholder is painted while the row is loading
+            if (mAsyncDataProvider && !mAsyncDataProvider->isRowLoaded(row))
+            {
+                aTextBackgroundBrush=aPalette.window();
+                aBackgroundBrush=&aTextBackgroundBrush;
+                aText=0;
+            }
         }
         break;
         case DrawHorizontalHeaderCell:
         {
-            FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_BackgroundBrushes->length());
-            FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_BackgroundBrushes->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_ForegroundColors->length());
-            FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_ForegroundColors->at(row).length());
             FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_Data->length());
             FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_Data->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellFonts->length());
-            FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellFonts->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeX->length());
-            FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeX->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellTextFlags->length());
-            FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellTextFlags->at(row).length());
 
             aGridColor=&mHorizontalHeader_GridColor;
 
-            aBackgroundBrush=mHorizontalHeader_BackgroundBrushes->at(row).at(column);
+            aBackgroundBrush=mHorizontalHeader_Styles->backgroundBrush(cellStyle(mHorizontalHeader_CellStyles, row, column));
 
             if (aBackgroundBrush==0)
             {
                 aBackgroundBrush=&mHorizontalHeader_DefaultBackgroundBrush;
             }
 
+            int aSelectedCount=mSelection->columnCellCount(column);
+
             if (mMouseLocation==InHorizontalHeaderCell)
             {
                 if (mMousePressed)
@@ -547,7 +530,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                     int maxX=qMax(mCurrentColumn, mLastX);
 
                     if (
-                        mHorizontalHeader_SelectedColumns->at(column)==mRowCount
+                        aSelectedCount==mRowCount
                         ||
                         (
                          mMouseResizeCell<0
@@ -562,7 +545,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                           (
                            column<minX
                            &&
-                           column+mHorizontalHeader_CellMergeX->at(row).at(column)-1>=minX
+                           column+mHorizontalHeader_Spans->columnSpan(row, column)-1>=minX
                           )
                          )
                         )
@@ -587,7 +570,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                     }
                     else
                     {
-                        if (mHorizontalHeader_SelectedColumns->at(column)==mRowCount)
+                        if (aSelectedCount==mRowCount)
                         {
                             aHeaderPressed=true;
                             aBorderColor=&mHorizontalHeader_CellBorderColor;
@@ -601,7 +584,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
             }
             else
             {
-                if (mHorizontalHeader_SelectedColumns->at(column)==mRowCount)
+                if (aSelectedCount==mRowCount)
                 {
                     aHeaderPressed=true;
                     aBorderColor=&mHorizontalHeader_CellBorderColor;
@@ -613,7 +596,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                 }
             }
 
-            aTextColor=mHorizontalHeader_ForegroundColors->at(row).at(column);
+            aTextColor=mHorizontalHeader_Styles->foregroundColor(cellStyle(mHorizontalHeader_CellStyles, row, column));
 
             if (aTextColor==0)
             {
@@ -622,7 +605,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
 
             aText=&(*mHorizontalHeader_Data)[row][column];
 
-            aFont=mHorizontalHeader_CellFonts->at(row).at(column);
+            aFont=mHorizontalHeader_Styles->font(cellStyle(mHorizontalHeader_CellStyles, row, column));
 
             if (aFont==0)
             {
@@ -631,12 +614,13 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
             }
 
             bool good=false;
+            int aColumnSpan=mHorizontalHeader_Spans->columnSpan(row, column);
 
-            for (int i=0; i<mHorizontalHeader_CellMergeX->at(row).at(column); ++i)
+            for (int i=0; i<aColumnSpan; ++i)
             {
-                FASTTABLE_ASSERT(column+i>=0 && column+i<mHorizontalHeader_SelectedColumns->length());
+                FASTTABLE_ASSERT(column+i>=0 && column+i<mSelection->columnCount());
 
-                if (mHorizontalHeader_SelectedColumns->at(column+i))
+                if (mSelection->columnCellCount(column+i))
                 {
                     good=true;
                     break;
@@ -655,33 +639,25 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                 aFont->setBold(true);
             }
 
-            textFlags=mHorizontalHeader_CellTextFlags->at(row).at(column);
+            textFlags=mHorizontalHeader_Styles->textFlags(cellStyle(mHorizontalHeader_CellStyles, row, column));
         }
         break;
         case DrawVerticalHeaderCell:
         {
-            FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_BackgroundBrushes->length());
-            FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_BackgroundBrushes->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_ForegroundColors->length());
-            FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ForegroundColors->at(row).length());
             FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_Data->length());
             FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_Data->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellFonts->length());
-            FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellFonts->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeY->length());
-            FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeY->at(row).length());
-            FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellTextFlags->length());
-            FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellTextFlags->at(row).length());
 
             aGridColor=&mVerticalHeader_GridColor;
 
-            aBackgroundBrush=mVerticalHeader_BackgroundBrushes->at(row).at(column);
+            aBackgroundBrush=mVerticalHeader_Styles->backgroundBrush(cellStyle(mVerticalHeader_CellStyles, row, column));
 
             if (aBackgroundBrush==0)
             {
                 aBackgroundBrush=&mVerticalHeader_DefaultBackgroundBrush;
             }
 
+            int aSelectedCount=mSelection->rowCellCount(row);
+
             if (mMouseLocation==InVerticalHeaderCell)
             {
                 if (mMousePressed)
@@ -690,7 +666,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                     int maxY=qMax(mCurrentRow, mLastY);
 
                     if (
-                        mVerticalHeader_SelectedRows->at(row)==mColumnCount
+                        aSelectedCount==mColumnCount
                         ||
                         (
                          mMouseResizeCell<0
@@ -705,7 +681,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                           (
                            row<minY
                            &&
-                           row+mVerticalHeader_CellMergeY->at(row).at(column)-1>=minY
+                           row+mVerticalHeader_Spans->rowSpan(row, column)-1>=minY
                           )
                          )
                         )
@@ -730,7 +706,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                     }
                     else
                     {
-                        if (mVerticalHeader_SelectedRows->at(row)==mColumnCount)
+                        if (aSelectedCount==mColumnCount)
                         {
                             aHeaderPressed=true;
                             aBorderColor=&mVerticalHeader_CellBorderColor;
@@ -744,7 +720,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
             }
             else
             {
-                if (mVerticalHeader_SelectedRows->at(row)==mColumnCount)
+                if (aSelectedCount==mColumnCount)
                 {
                     aHeaderPressed=true;
                     aBorderColor=&mVerticalHeader_CellBorderColor;
@@ -756,7 +732,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                 }
             }
 
-            aTextColor=mVerticalHeader_ForegroundColors->at(row).at(column);
+            aTextColor=mVerticalHeader_Styles->foregroundColor(cellStyle(mVerticalHeader_CellStyles, row, column));
 
             if (aTextColor==0)
             {
@@ -771,7 +747,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                 aText=&aTextString;
             }
 
-            aFont=mVerticalHeader_CellFonts->at(row).at(column);
+            aFont=mVerticalHeader_Styles->font(cellStyle(mVerticalHeader_CellStyles, row, column));
 
             if (aFont==0)
             {
@@ -780,12 +756,13 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
             }
 
             bool good=false;
+            int aRowSpan=mVerticalHeader_Spans->rowSpan(row, column);
 
-            for (int i=0; i<mVerticalHeader_CellMergeY->at(row).at(column); ++i)
+            for (int i=0; i<aRowSpan; ++i)
             {
-                FASTTABLE_ASSERT(row+i>=0 && row+i<mVerticalHeader_SelectedRows->length());
+                FASTTABLE_ASSERT(row+i>=0 && row+i<mSelection->rowCount());
 
-                if (mVerticalHeader_SelectedRows->at(row+i))
+                if (mSelection->rowCellCount(row+i))
                 {
                     good=true;
                     break;
@@ -804,7 +781,7 @@ void FastTableWidget::paintCell(QPainter &painter, const int x, const int y, con
                 aFont->setBold(true);
             }
 
-            textFlags=mVerticalHeader_CellTextFlags->at(row).at(column);
+            textFlags=mVerticalHeader_Styles->textFlags(cellStyle(mVerticalHeader_CellStyles, row, column));
         }
         break;
         case DrawTopLeftCorner:
@@ -866,60 +843,31 @@ void FastTableWidget::updateVisibleRange()
     int originalLeft=mVisibleLeft;
     int originalTop=mVisibleTop;
 
+    // Only spans crossing first visible row or column can move visible range
     if (originalLeft>=0)
     {
-        for (int i=0; i<mCellMergeParentColumn->length(); ++i)
-        {
-            if (originalLeft<mCellMergeParentColumn->at(i).length())
-            {
-                int parentColumn=mCellMergeParentColumn->at(i).at(originalLeft);
-
-                if (parentColumn>=0 &&parentColumn<mVisibleLeft)
-                {
-                    mVisibleLeft=parentColumn;
-                }
-            }
-        }
+        QList<QRect> aSpans=mSpans->spansIn(QRect(originalLeft, originalTop, 1, mVisibleBottom-originalTop+1));
+        aSpans.append(mHorizontalHeader_Spans->spansIn(QRect(originalLeft, 0, 1, mHorizontalHeader_RowCount)));
 
-        for (int i=0; i<mHorizontalHeader_CellMergeParentColumn->length(); ++i)
+        for (int i=0; i<aSpans.length(); ++i)
         {
-            if (originalLeft<mHorizontalHeader_CellMergeParentColumn->at(i).length())
+            if (aSpans.at(i).left()<mVisibleLeft)
             {
-                int parentColumn=mHorizontalHeader_CellMergeParentColumn->at(i).at(originalLeft);
-
-                if (parentColumn>=0 &&parentColumn<mVisibleLeft)
-                {
-                    mVisibleLeft=parentColumn;
-                }
+                mVisibleLeft=aSpans.at(i).left();
             }
         }
     }
 
     if (originalTop>=0)
     {
-        if (originalTop<mCellMergeParentRow->length())
-        {
-            for (int i=0; i<mCellMergeParentRow->at(originalTop).length(); ++i)
-            {
-                int parentRow=mCellMergeParentRow->at(originalTop).at(i);
-
-                if (parentRow>=0 && parentRow<mVisibleTop)
-                {
-                    mVisibleTop=parentRow;
-                }
-            }
-        }
+        QList<QRect> aSpans=mSpans->spansIn(QRect(originalLeft, originalTop, mVisibleRight-originalLeft+1, 1));
+        aSpans.append(mVerticalHeader_Spans->spansIn(QRect(0, originalTop, mVerticalHeader_ColumnCount, 1)));
 
-        if (originalTop<mVerticalHeader_CellMergeParentRow->length())
+        for (int i=0; i<aSpans.length(); ++i)
         {
-            for (int i=0; i<mVerticalHeader_CellMergeParentRow->at(originalTop).length(); ++i)
+            if (aSpans.at(i).top()<mVisibleTop)
             {
-                int parentRow=mVerticalHeader_CellMergeParentRow->at(originalTop).at(i);
-
-                if (parentRow>=0 && parentRow<mVisibleTop)
-                {
-                    mVisibleTop=parentRow;
-                }
+                mVisibleTop=aSpans.at(i).top();
             }
         }
     }
@@ -927,69 +875,95 @@ void FastTableWidget::updateVisibleRange()
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::clear()
+QRect FastTableWidget::exposedCells(const QRect &area)
 {
-    FASTTABLE_DEBUG;
-    FASTTABLE_START_PROFILE;
-
-    resetBackgroundBrushes();
-    resetForegroundColors();
-    resetFonts();
-
-    horizontalHeader_ResetBackgroundBrushes();
-    horizontalHeader_ResetForegroundColors();
-    horizontalHeader_ResetFonts();
+    FASTTABLE_FREQUENT_DEBUG;
 
-    verticalHeader_ResetBackgroundBrushes();
-    verticalHeader_ResetForegroundColors();
-    verticalHeader_ResetFonts();
+    QRect res=CustomFastTableWidget::exposedCells(area);
 
-    // If you don't use internal data, you may reimplement this function in your class
-    if (mBackgroundBrushes)
+    if (res.left()>res.right() || res.top()>res.bottom())
     {
-        mBackgroundBrushes->clear();
+        return res;
     }
 
-    if (mForegroundColors)
+    // Merged cells are painted from their parents, so parents outside of exposed area are included
+    int aLeft=res.left();
+    int aTop=res.top();
+
+    for (int i=res.left(); i<=res.right(); ++i)
     {
-        mForegroundColors->clear();
+        QPoint aParent=mSpans->parent(res.top(), i);
+
+        if (aParent.y()>=0 && aParent.y()<aTop)
+        {
+            aTop=aParent.y();
+        }
+
+        if (aParent.x()>=0 && aParent.x()<aLeft)
+        {
+            aLeft=aParent.x();
+        }
     }
 
-    if (mCellFonts)
+    for (int i=res.top(); i<=res.bottom(); ++i)
     {
-        mCellFonts->clear();
+        QPoint aParent=mSpans->parent(i, res.left());
+
+        if (aParent.y()>=0 && aParent.y()<aTop)
+        {
+            aTop=aParent.y();
+        }
+
+        if (aParent.x()>=0 && aParent.x()<aLeft)
+        {
+            aLeft=aParent.x();
+        }
     }
 
-    if (mCellTextFlags)
+    res.setLeft(aLeft);
+    res.setTop(aTop);
+
+    return res;
+}
+
+QPoint FastTableWidget::cellAt(const int x, const int y)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+    FASTTABLE_FREQUENT_START_PROFILE;
+
+    QPoint res=CustomFastTableWidget::cellAt(x, y);
+
+    if (res.x()>=0 && res.y()>=0)
     {
-        mCellTextFlags->clear();
+        QPoint aParent=mSpans->parent(res.y(), res.x());
+
+        // Merged cell is represented by its parent
+        if (aParent.y()>=0)
+        {
+            res=aParent;
+        }
     }
 
-    mCellMergeX->clear();
-    mCellMergeY->clear();
-    mCellMergeParentRow->clear();
-    mCellMergeParentColumn->clear();
-    mMerges->clear();
+    FASTTABLE_FREQUENT_END_PROFILE;
+    return res;
+}
+
+void FastTableWidget::clear()
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    mStyles->clear();
+    mCellStyles->clear();
+    mSpans->clear();
 
-    mHorizontalHeader_BackgroundBrushes->clear();
-    mHorizontalHeader_ForegroundColors->clear();
-    mHorizontalHeader_CellFonts->clear();
-    mHorizontalHeader_CellTextFlags->clear();
-    mHorizontalHeader_CellMergeX->clear();
-    mHorizontalHeader_CellMergeY->clear();
-    mHorizontalHeader_CellMergeParentRow->clear();
-    mHorizontalHeader_CellMergeParentColumn->clear();
-    mHorizontalHeader_Merges->clear();
+    mHorizontalHeader_Styles->clear();
+    mHorizontalHeader_CellStyles->clear();
+    mHorizontalHeader_Spans->clear();
 
-    mVerticalHeader_BackgroundBrushes->clear();
-    mVerticalHeader_ForegroundColors->clear();
-    mVerticalHeader_CellFonts->clear();
-    mVerticalHeader_CellTextFlags->clear();
-    mVerticalHeader_CellMergeX->clear();
-    mVerticalHeader_CellMergeY->clear();
-    mVerticalHeader_CellMergeParentRow->clear();
-    mVerticalHeader_CellMergeParentColumn->clear();
-    mVerticalHeader_Merges->clear();
+    mVerticalHeader_Styles->clear();
+    mVerticalHeader_CellStyles->clear();
+    mVerticalHeader_Spans->clear();
 
     CustomFastTableWidget::clear();
 
@@ -1001,25 +975,9 @@ void FastTableWidget::resetBackgroundBrushes()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    if (mBackgroundBrushes)
-    {
-        for (int i=0; i<mRowCount; ++i)
-        {
-            for (int j=0; j<mColumnCount; ++j)
-            {
-                FASTTABLE_ASSERT(i<mBackgroundBrushes->length());
-                FASTTABLE_ASSERT(j<mBackgroundBrushes->at(i).length());
-
-                if (mBackgroundBrushes->at(i).at(j))
-                {
-                    delete mBackgroundBrushes->at(i).at(j);
-                    (*mBackgroundBrushes)[i][j]=0;
-                }
-            }
-        }
+    resetCellStyles(mStyles, mCellStyles, &StyleTable::resetBackgroundBrush);
 
-        viewport()->update();
-    }
+    viewport()->update();
 
     FASTTABLE_END_PROFILE;
 }
@@ -1029,25 +987,9 @@ void FastTableWidget::resetForegroundColors()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    if (mForegroundColors)
-    {
-        for (int i=0; i<mRowCount; ++i)
-        {
-            for (int j=0; j<mColumnCount; ++j)
-            {
-                FASTTABLE_ASSERT(i<mForegroundColors->length());
-                FASTTABLE_ASSERT(j<mForegroundColors->at(i).length());
-
-                if (mForegroundColors->at(i).at(j))
-                {
-                    delete mForegroundColors->at(i).at(j);
-                    (*mForegroundColors)[i][j]=0;
-                }
-            }
-        }
+    resetCellStyles(mStyles, mCellStyles, &StyleTable::resetForegroundColor);
 
-        viewport()->update();
-    }
+    viewport()->update();
 
     FASTTABLE_END_PROFILE;
 }
@@ -1057,25 +999,9 @@ void FastTableWidget::resetFonts()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    if (mCellFonts)
-    {
-        for (int i=0; i<mRowCount; ++i)
-        {
-            for (int j=0; j<mColumnCount; ++j)
-            {
-                FASTTABLE_ASSERT(i<mCellFonts->length());
-                FASTTABLE_ASSERT(j<mCellFonts->at(i).length());
-
-                if (mCellFonts->at(i).at(j))
-                {
-                    delete mCellFonts->at(i).at(j);
-                    (*mCellFonts)[i][j]=0;
-                }
-            }
-        }
+    resetCellStyles(mStyles, mCellStyles, &StyleTable::resetFont);
 
-        viewport()->update();
-    }
+    viewport()->update();
 
     FASTTABLE_END_PROFILE;
 }
@@ -1085,21 +1011,9 @@ void FastTableWidget::resetCellTextFlags()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    if (mCellTextFlags)
-    {
-        for (int i=0; i<mRowCount; ++i)
-        {
-            for (int j=0; j<mColumnCount; ++j)
-            {
-                FASTTABLE_ASSERT(i<mCellTextFlags->length());
-                FASTTABLE_ASSERT(j<mCellTextFlags->at(i).length());
-
-                (*mCellTextFlags)[i][j]=FASTTABLE_DEFAULT_TEXT_FLAG;
-            }
-        }
+    resetCellStyles(mStyles, mCellStyles, &StyleTable::resetTextFlags);
 
-        viewport()->update();
-    }
+    viewport()->update();
 
     FASTTABLE_END_PROFILE;
 }
@@ -1109,20 +1023,7 @@ void FastTableWidget::horizontalHeader_ResetBackgroundBrushes()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mHorizontalHeader_RowCount; ++i)
-    {
-        for (int j=0; j<mColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mHorizontalHeader_BackgroundBrushes->length());
-            FASTTABLE_ASSERT(j<mHorizontalHeader_BackgroundBrushes->at(i).length());
-
-            if (mHorizontalHeader_BackgroundBrushes->at(i).at(j))
-            {
-                delete mHorizontalHeader_BackgroundBrushes->at(i).at(j);
-                (*mHorizontalHeader_BackgroundBrushes)[i][j]=0;
-            }
-        }
-    }
+    resetCellStyles(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, &StyleTable::resetBackgroundBrush);
 
     viewport()->update();
 
@@ -1134,20 +1035,7 @@ void FastTableWidget::horizontalHeader_ResetForegroundColors()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mHorizontalHeader_RowCount; ++i)
-    {
-        for (int j=0; j<mColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mHorizontalHeader_ForegroundColors->length());
-            FASTTABLE_ASSERT(j<mHorizontalHeader_ForegroundColors->at(i).length());
-
-            if (mHorizontalHeader_ForegroundColors->at(i).at(j))
-            {
-                delete mHorizontalHeader_ForegroundColors->at(i).at(j);
-                (*mHorizontalHeader_ForegroundColors)[i][j]=0;
-            }
-        }
-    }
+    resetCellStyles(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, &StyleTable::resetForegroundColor);
 
     viewport()->update();
 
@@ -1159,20 +1047,7 @@ void FastTableWidget::horizontalHeader_ResetFonts()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mHorizontalHeader_RowCount; ++i)
-    {
-        for (int j=0; j<mColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mHorizontalHeader_CellFonts->length());
-            FASTTABLE_ASSERT(j<mHorizontalHeader_CellFonts->at(i).length());
-
-            if (mHorizontalHeader_CellFonts->at(i).at(j))
-            {
-                delete mHorizontalHeader_CellFonts->at(i).at(j);
-                (*mHorizontalHeader_CellFonts)[i][j]=0;
-            }
-        }
-    }
+    resetCellStyles(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, &StyleTable::resetFont);
 
     viewport()->update();
 
@@ -1184,16 +1059,7 @@ void FastTableWidget::horizontalHeader_ResetCellTextFlags()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mHorizontalHeader_RowCount; ++i)
-    {
-        for (int j=0; j<mColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mHorizontalHeader_CellTextFlags->length());
-            FASTTABLE_ASSERT(j<mHorizontalHeader_CellTextFlags->at(i).length());
-
-            (*mHorizontalHeader_CellTextFlags)[i][j]=FASTTABLE_HEADER_DEFAULT_TEXT_FLAG;
-        }
-    }
+    resetCellStyles(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, &StyleTable::resetTextFlags);
 
     viewport()->update();
 
@@ -1205,20 +1071,7 @@ void FastTableWidget::verticalHeader_ResetBackgroundBrushes()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mRowCount; ++i)
-    {
-        for (int j=0; j<mVerticalHeader_ColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mVerticalHeader_BackgroundBrushes->length());
-            FASTTABLE_ASSERT(j<mVerticalHeader_BackgroundBrushes->at(i).length());
-
-            if (mVerticalHeader_BackgroundBrushes->at(i).at(j))
-            {
-                delete mVerticalHeader_BackgroundBrushes->at(i).at(j);
-                (*mVerticalHeader_BackgroundBrushes)[i][j]=0;
-            }
-        }
-    }
+    resetCellStyles(mVerticalHeader_Styles, mVerticalHeader_CellStyles, &StyleTable::resetBackgroundBrush);
 
     viewport()->update();
 
@@ -1230,20 +1083,7 @@ void FastTableWidget::verticalHeader_ResetForegroundColors()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mRowCount; ++i)
-    {
-        for (int j=0; j<mVerticalHeader_ColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mVerticalHeader_ForegroundColors->length());
-            FASTTABLE_ASSERT(j<mVerticalHeader_ForegroundColors->at(i).length());
-
-            if (mVerticalHeader_ForegroundColors->at(i).at(j))
-            {
-                delete mVerticalHeader_ForegroundColors->at(i).at(j);
-                (*mVerticalHeader_ForegroundColors)[i][j]=0;
-            }
-        }
-    }
+    resetCellStyles(mVerticalHeader_Styles, mVerticalHeader_CellStyles, &StyleTable::resetForegroundColor);
 
     viewport()->update();
 
@@ -1255,20 +1095,7 @@ void FastTableWidget::verticalHeader_ResetFonts()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mRowCount; ++i)
-    {
-        for (int j=0; j<mVerticalHeader_ColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mVerticalHeader_CellFonts->length());
-            FASTTABLE_ASSERT(j<mVerticalHeader_CellFonts->at(i).length());
-
-            if (mVerticalHeader_CellFonts->at(i).at(j))
-            {
-                delete mVerticalHeader_CellFonts->at(i).at(j);
-                (*mVerticalHeader_CellFonts)[i][j]=0;
-            }
-        }
-    }
+    resetCellStyles(mVerticalHeader_Styles, mVerticalHeader_CellStyles, &StyleTable::resetFont);
 
     viewport()->update();
 
@@ -1280,16 +1107,7 @@ void FastTableWidget::verticalHeader_ResetCellTextFlags()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mRowCount; ++i)
-    {
-        for (int j=0; j<mVerticalHeader_ColumnCount; ++j)
-        {
-            FASTTABLE_ASSERT(i<mVerticalHeader_CellTextFlags->length());
-            FASTTABLE_ASSERT(j<mVerticalHeader_CellTextFlags->at(i).length());
-
-            (*mVerticalHeader_CellTextFlags)[i][j]=FASTTABLE_DEFAULT_TEXT_FLAG;
-        }
-    }
+    resetCellStyles(mVerticalHeader_Styles, mVerticalHeader_CellStyles, &StyleTable::resetTextFlags);
 
     viewport()->update();
 
@@ -1302,15 +1120,16 @@ void FastTableWidget::resetBackgroundBrush(const int row, const int column)
     FASTTABLE_START_PROFILE;
 
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row<mBackgroundBrushes->length());
-    FASTTABLE_ASSERT(column<mBackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
+
+    int aStyle=cellStyle(mCellStyles, row, column);
 
-    if (mBackgroundBrushes->at(row).at(column))
+    if (mStyles->backgroundBrush(aStyle))
     {
-        delete mBackgroundBrushes->at(row).at(column);
-        (*mBackgroundBrushes)[row][column]=0;
+        setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->resetBackgroundBrush(aStyle));
 
-        viewport()->update();
+        updateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1322,15 +1141,16 @@ void FastTableWidget::resetForegroundColor(const int row, const int column)
     FASTTABLE_START_PROFILE;
 
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row<mForegroundColors->length());
-    FASTTABLE_ASSERT(column<mForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
 
-    if (mForegroundColors->at(row).at(column))
+    int aStyle=cellStyle(mCellStyles, row, column);
+
+    if (mStyles->foregroundColor(aStyle))
     {
-        delete mForegroundColors->at(row).at(column);
-        (*mForegroundColors)[row][column]=0;
+        setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->resetForegroundColor(aStyle));
 
-        viewport()->update();
+        updateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1342,15 +1162,16 @@ void FastTableWidget::resetFont(const int row, const int column)
     FASTTABLE_START_PROFILE;
 
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row<mCellFonts->length());
-    FASTTABLE_ASSERT(column<mCellFonts->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
+
+    int aStyle=cellStyle(mCellStyles, row, column);
 
-    if (mCellFonts->at(row).at(column))
+    if (mStyles->font(aStyle))
     {
-        delete mCellFonts->at(row).at(column);
-        (*mCellFonts)[row][column]=0;
+        setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->resetFont(aStyle));
 
-        viewport()->update();
+        updateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1362,12 +1183,12 @@ void FastTableWidget::resetCellTextFlag(const int row, const int column)
     FASTTABLE_START_PROFILE;
 
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row<mCellTextFlags->length());
-    FASTTABLE_ASSERT(column<mCellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
 
-    (*mCellTextFlags)[row][column]=FASTTABLE_DEFAULT_TEXT_FLAG;
+    setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->resetTextFlags(cellStyle(mCellStyles, row, column)));
 
-    viewport()->update();
+    updateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -1377,15 +1198,16 @@ void FastTableWidget::horizontalHeader_ResetBackgroundBrush(const int row, const
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mHorizontalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(column<mHorizontalHeader_BackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
+
+    int aStyle=cellStyle(mHorizontalHeader_CellStyles, row, column);
 
-    if (mHorizontalHeader_BackgroundBrushes->at(row).at(column))
+    if (mHorizontalHeader_Styles->backgroundBrush(aStyle))
     {
-        delete mHorizontalHeader_BackgroundBrushes->at(row).at(column);
-        (*mHorizontalHeader_BackgroundBrushes)[row][column]=0;
+        setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->resetBackgroundBrush(aStyle));
 
-        viewport()->update();
+        horizontalHeader_UpdateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1396,15 +1218,16 @@ void FastTableWidget::horizontalHeader_ResetForegroundColor(const int row, const
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mHorizontalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(column<mHorizontalHeader_ForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
 
-    if (mHorizontalHeader_ForegroundColors->at(row).at(column))
+    int aStyle=cellStyle(mHorizontalHeader_CellStyles, row, column);
+
+    if (mHorizontalHeader_Styles->foregroundColor(aStyle))
     {
-        delete mHorizontalHeader_ForegroundColors->at(row).at(column);
-        (*mHorizontalHeader_ForegroundColors)[row][column]=0;
+        setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->resetForegroundColor(aStyle));
 
-        viewport()->update();
+        horizontalHeader_UpdateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1415,15 +1238,16 @@ void FastTableWidget::horizontalHeader_ResetFont(const int row, const int column
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mHorizontalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(column<mHorizontalHeader_CellFonts->at(row).length());
+    FASTTABLE_ASSERT(row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
+
+    int aStyle=cellStyle(mHorizontalHeader_CellStyles, row, column);
 
-    if (mHorizontalHeader_CellFonts->at(row).at(column))
+    if (mHorizontalHeader_Styles->font(aStyle))
     {
-        delete mHorizontalHeader_CellFonts->at(row).at(column);
-        (*mHorizontalHeader_CellFonts)[row][column]=0;
+        setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->resetFont(aStyle));
 
-        viewport()->update();
+        horizontalHeader_UpdateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1434,12 +1258,12 @@ void FastTableWidget::horizontalHeader_ResetCellTextFlag(const int row, const in
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mHorizontalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(column<mHorizontalHeader_CellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column<mColumnCount);
 
-    (*mHorizontalHeader_CellTextFlags)[row][column]=FASTTABLE_HEADER_DEFAULT_TEXT_FLAG;
+    setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->resetTextFlags(cellStyle(mHorizontalHeader_CellStyles, row, column)));
 
-    viewport()->update();
+    horizontalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -1449,15 +1273,16 @@ void FastTableWidget::verticalHeader_ResetBackgroundBrush(const int row, const i
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mVerticalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(column<mVerticalHeader_BackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mVerticalHeader_ColumnCount);
+
+    int aStyle=cellStyle(mVerticalHeader_CellStyles, row, column);
 
-    if (mVerticalHeader_BackgroundBrushes->at(row).at(column))
+    if (mVerticalHeader_Styles->backgroundBrush(aStyle))
     {
-        delete mVerticalHeader_BackgroundBrushes->at(row).at(column);
-        (*mVerticalHeader_BackgroundBrushes)[row][column]=0;
+        setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->resetBackgroundBrush(aStyle));
 
-        viewport()->update();
+        verticalHeader_UpdateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1468,15 +1293,16 @@ void FastTableWidget::verticalHeader_ResetForegroundColor(const int row, const i
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mVerticalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(column<mVerticalHeader_ForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mVerticalHeader_ColumnCount);
 
-    if (mVerticalHeader_ForegroundColors->at(row).at(column))
+    int aStyle=cellStyle(mVerticalHeader_CellStyles, row, column);
+
+    if (mVerticalHeader_Styles->foregroundColor(aStyle))
     {
-        delete mVerticalHeader_ForegroundColors->at(row).at(column);
-        (*mVerticalHeader_ForegroundColors)[row][column]=0;
+        setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->resetForegroundColor(aStyle));
 
-        viewport()->update();
+        verticalHeader_UpdateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1487,15 +1313,16 @@ void FastTableWidget::verticalHeader_ResetFont(const int row, const int column)
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mVerticalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(column<mVerticalHeader_CellFonts->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mVerticalHeader_ColumnCount);
+
+    int aStyle=cellStyle(mVerticalHeader_CellStyles, row, column);
 
-    if (mVerticalHeader_CellFonts->at(row).at(column))
+    if (mVerticalHeader_Styles->font(aStyle))
     {
-        delete mVerticalHeader_CellFonts->at(row).at(column);
-        (*mVerticalHeader_CellFonts)[row][column]=0;
+        setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->resetFont(aStyle));
 
-        viewport()->update();
+        verticalHeader_UpdateCell(row, column);
     }
 
     FASTTABLE_END_PROFILE;
@@ -1506,1046 +1333,509 @@ void FastTableWidget::verticalHeader_ResetCellTextFlag(const int row, const int
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row<mVerticalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(column<mVerticalHeader_CellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row<mRowCount);
+    FASTTABLE_ASSERT(column<mVerticalHeader_ColumnCount);
 
-    (*mVerticalHeader_CellTextFlags)[row][column]=FASTTABLE_DEFAULT_TEXT_FLAG;
+    setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->resetTextFlags(cellStyle(mVerticalHeader_CellStyles, row, column)));
 
-    viewport()->update();
+    verticalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::insertRow(int row)
+void FastTableWidget::resetCellStyles(StyleTable *styles, QList< QList<int> > *cellStyles, int (StyleTable::*resetFunction)(const int))
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(mBackgroundBrushes==0 || (row>=0 && row<=mBackgroundBrushes->length()));
-    FASTTABLE_ASSERT(mForegroundColors==0 || (row>=0 && row<=mForegroundColors->length()));
-    FASTTABLE_ASSERT(mCellFonts==0 || (row>=0 && row<=mCellFonts->length()));
-    FASTTABLE_ASSERT(mCellTextFlags==0 || (row>=0 && row<=mCellTextFlags->length()));
-    FASTTABLE_ASSERT(row>=0 && row<=mCellMergeX->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mCellMergeY->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mCellMergeParentRow->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mCellMergeParentColumn->length());
-
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mVerticalHeader_CellMergeParentColumn->length());
-
-    CustomFastTableWidget::insertRow(row);
-
-    QList<QBrush *> aNewRowBrush;
-    QList<QColor *> aNewRowColor;
-    QList<QFont *> aNewRowFont;
-    QList<int> aNewRowint;
-    QList<quint16> aNewRowqint16;
+    // Every style is reset once, then cells just take new indexes
+    int aCount=styles->count();
+    QList<int> aNewStyles;
+    aNewStyles.reserve(aCount);
 
-    if (mBackgroundBrushes)
+    for (int i=0; i<aCount; ++i)
     {
-        mBackgroundBrushes->insert(row, aNewRowBrush);
+        aNewStyles.append((styles->*resetFunction)(i));
     }
 
-    if (mForegroundColors)
+    bool aAllDefault=true;
+
+    for (int i=0; i<cellStyles->length(); ++i)
     {
-        mForegroundColors->insert(row, aNewRowColor);
+        for (int j=0; j<cellStyles->at(i).length(); ++j)
+        {
+            int aNewStyle=aNewStyles.at(cellStyles->at(i).at(j));
+
+            // Rows stay implicitly shared if nothing is changed
+            if (aNewStyle!=cellStyles->at(i).at(j))
+            {
+                (*cellStyles)[i][j]=aNewStyle;
+            }
+
+            if (aNewStyle!=0)
+            {
+                aAllDefault=false;
+            }
+        }
     }
 
-    if (mCellFonts)
+    // Plane is released when there is nothing to keep, and styles are released with it
+    if (aAllDefault)
     {
-        mCellFonts->insert(row, aNewRowFont);
+        cellStyles->clear();
+        styles->clear();
     }
-
-    if (mCellTextFlags)
+    else
     {
-        mCellTextFlags->insert(row, aNewRowint);
+        compactCellStyles(styles, cellStyles);
     }
 
-    mCellMergeX->insert(row, aNewRowqint16);
-    mCellMergeY->insert(row, aNewRowqint16);
-    mCellMergeParentRow->insert(row, aNewRowint);
-    mCellMergeParentColumn->insert(row, aNewRowint);
+    FASTTABLE_END_PROFILE;
+}
 
-    mVerticalHeader_BackgroundBrushes->insert(row, aNewRowBrush);
-    mVerticalHeader_ForegroundColors->insert(row, aNewRowColor);
-    mVerticalHeader_CellFonts->insert(row, aNewRowFont);
-    mVerticalHeader_CellTextFlags->insert(row, aNewRowint);
-    mVerticalHeader_CellMergeX->insert(row, aNewRowqint16);
-    mVerticalHeader_CellMergeY->insert(row, aNewRowqint16);
-    mVerticalHeader_CellMergeParentRow->insert(row, aNewRowint);
-    mVerticalHeader_CellMergeParentColumn->insert(row, aNewRowint);
+void FastTableWidget::compactCellStyles(StyleTable *styles, QList< QList<int> > *cellStyles)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mColumnCount; ++i)
-    {
-        if (mBackgroundBrushes)
-        {
-            (*mBackgroundBrushes)[row].append(0);
-        }
+    QList<bool> aUsedStyles;
+    aUsedStyles.reserve(styles->count());
 
-        if (mForegroundColors)
-        {
-            (*mForegroundColors)[row].append(0);
-        }
-
-        if (mCellFonts)
-        {
-            (*mCellFonts)[row].append(0);
-        }
-
-        if (mCellTextFlags)
-        {
-            (*mCellTextFlags)[row].append(FASTTABLE_DEFAULT_TEXT_FLAG);
-        }
-
-        (*mCellMergeX)[row].append(1);
-        (*mCellMergeY)[row].append(1);
-        (*mCellMergeParentRow)[row].append(-1);
-        (*mCellMergeParentColumn)[row].append(-1);
-    }
-
-    for (int i=0; i<mVerticalHeader_ColumnCount; ++i)
+    for (int i=0; i<styles->count(); ++i)
     {
-        (*mVerticalHeader_BackgroundBrushes)[row].append(0);
-        (*mVerticalHeader_ForegroundColors)[row].append(0);
-        (*mVerticalHeader_CellFonts)[row].append(0);
-        (*mVerticalHeader_CellTextFlags)[row].append(FASTTABLE_DEFAULT_TEXT_FLAG);
-        (*mVerticalHeader_CellMergeX)[row].append(1);
-        (*mVerticalHeader_CellMergeY)[row].append(1);
-        (*mVerticalHeader_CellMergeParentRow)[row].append(-1);
-        (*mVerticalHeader_CellMergeParentColumn)[row].append(-1);
+        aUsedStyles.append(false);
     }
 
-    for (int i=0; i<mMerges->length(); i++)
+    for (int i=0; i<cellStyles->length(); ++i)
     {
-        if (mMerges->at(i).top()>=row)
-        {
-            (*mMerges)[i].moveTop(mMerges->at(i).top()+1);
-
-            for (int j=mMerges->at(i).top(); j<=mMerges->at(i).bottom(); j++)
-            {
-                for (int k=mMerges->at(i).left(); k<=mMerges->at(i).right(); k++)
-                {
-                    (*mCellMergeParentRow)[j][k]++;
-                }
-            }
-        }
-        else
-        if (mMerges->at(i).bottom()>=row)
+        for (int j=0; j<cellStyles->at(i).length(); ++j)
         {
-            (*mMerges)[i].setHeight(mMerges->at(i).height()+1);
-
-            for (int j=mMerges->at(i).left(); j<=mMerges->at(i).right(); j++)
-            {
-                (*mCellMergeParentRow)[row][j]=mMerges->at(i).top();
-                (*mCellMergeParentColumn)[row][j]=mMerges->at(i).left();
-            }
-
-            (*mCellMergeY)[mMerges->at(i).top()][mMerges->at(i).left()]++;
+            aUsedStyles[cellStyles->at(i).at(j)]=true;
         }
     }
 
-    for (int i=0; i<mVerticalHeader_Merges->length(); i++)
-    {
-        if (mVerticalHeader_Merges->at(i).top()>=row)
-        {
-            (*mVerticalHeader_Merges)[i].moveTop(mVerticalHeader_Merges->at(i).top()+1);
+    QList<int> aNewStyles=styles->compact(aUsedStyles);
 
-            for (int j=mVerticalHeader_Merges->at(i).top(); j<=mVerticalHeader_Merges->at(i).bottom(); j++)
-            {
-                for (int k=mVerticalHeader_Merges->at(i).left(); k<=mVerticalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mVerticalHeader_CellMergeParentRow)[j][k]++;
-                }
-            }
-        }
-        else
-        if (mVerticalHeader_Merges->at(i).bottom()>=row)
+    for (int i=0; i<cellStyles->length(); ++i)
+    {
+        for (int j=0; j<cellStyles->at(i).length(); ++j)
         {
-            (*mVerticalHeader_Merges)[i].setHeight(mVerticalHeader_Merges->at(i).height()+1);
+            int aNewStyle=aNewStyles.at(cellStyles->at(i).at(j));
 
-            for (int j=mVerticalHeader_Merges->at(i).left(); j<=mVerticalHeader_Merges->at(i).right(); j++)
+            // Rows stay implicitly shared if nothing is changed
+            if (aNewStyle!=cellStyles->at(i).at(j))
             {
-                (*mVerticalHeader_CellMergeParentRow)[row][j]=mVerticalHeader_Merges->at(i).top();
-                (*mVerticalHeader_CellMergeParentColumn)[row][j]=mVerticalHeader_Merges->at(i).left();
+                (*cellStyles)[i][j]=aNewStyle;
             }
-
-            (*mVerticalHeader_CellMergeY)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]++;
         }
     }
 
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::removeRow(int row)
+int FastTableWidget::cellStyle(QList< QList<int> > *cellStyles, const int row, const int column)
 {
-    FASTTABLE_DEBUG;
-    FASTTABLE_START_PROFILE;
-
-    FASTTABLE_ASSERT(mBackgroundBrushes==0 || (row>=0 && row<mBackgroundBrushes->length()));
-    FASTTABLE_ASSERT(mForegroundColors==0 || (row>=0 && row<mForegroundColors->length()));
-    FASTTABLE_ASSERT(mCellFonts==0 || (row>=0 && row<mCellFonts->length()));
-    FASTTABLE_ASSERT(mCellTextFlags==0 || (row>=0 && row<mCellTextFlags->length()));
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeX->length());
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeY->length());
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeParentRow->length());
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeParentColumn->length());
-
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeParentColumn->length());
+    FASTTABLE_FREQUENT_DEBUG;
 
-    if (mUseInternalData)
+    // Empty plane means that all cells have default style
+    if (cellStyles->isEmpty())
     {
-        for (int i=0; i<mColumnCount; ++i)
-        {
-            if (mBackgroundBrushes->at(row).at(i))
-            {
-                delete mBackgroundBrushes->at(row).at(i);
-            }
+        return 0;
+    }
 
-            if (mForegroundColors->at(row).at(i))
-            {
-                delete mForegroundColors->at(row).at(i);
-            }
+    FASTTABLE_ASSERT(row>=0 && row<cellStyles->length());
+    FASTTABLE_ASSERT(column>=0 && column<cellStyles->at(row).length());
 
-            if (mCellFonts->at(row).at(i))
-            {
-                delete mCellFonts->at(row).at(i);
-            }
-        }
-    }
+    return cellStyles->at(row).at(column);
+}
 
-    for (int i=0; i<mVerticalHeader_ColumnCount; ++i)
+void FastTableWidget::setCellStyle(StyleTable *styles, QList< QList<int> > *cellStyles, const int rowCount, const int columnCount, const int row, const int column, const int style)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    if (cellStyles->isEmpty())
     {
-        if (mVerticalHeader_BackgroundBrushes->at(row).at(i))
+        if (style==0)
         {
-            delete mVerticalHeader_BackgroundBrushes->at(row).at(i);
+            FASTTABLE_END_PROFILE;
+            return;
         }
 
-        if (mVerticalHeader_ForegroundColors->at(row).at(i))
-        {
-            delete mVerticalHeader_ForegroundColors->at(row).at(i);
-        }
+        // Plane is created on first non-default style, rows are implicitly shared until modified
+        QList<int> aNewRowStyles;
+        aNewRowStyles.reserve(columnCount);
 
-        if (mVerticalHeader_CellFonts->at(row).at(i))
+        for (int i=0; i<columnCount; ++i)
         {
-            delete mVerticalHeader_CellFonts->at(row).at(i);
+            aNewRowStyles.append(0);
         }
-    }
 
-    for (int i=0; i<mMerges->length(); i++)
-    {
-        if (mMerges->at(i).top()>row)
-        {
-            for (int j=mMerges->at(i).top(); j<=mMerges->at(i).bottom(); j++)
-            {
-                for (int k=mMerges->at(i).left(); k<=mMerges->at(i).right(); k++)
-                {
-                    (*mCellMergeParentRow)[j][k]--;
-                }
-            }
+        cellStyles->reserve(rowCount);
 
-            (*mMerges)[i].moveTop(mMerges->at(i).top()-1);
-        }
-        else
-        if (mMerges->at(i).bottom()>=row)
+        for (int i=0; i<rowCount; ++i)
         {
-            if (mMerges->at(i).top()==row)
-            {
-                if (mMerges->at(i).height()>1)
-                {
-                    (*mCellMergeX)[mMerges->at(i).top()+1][mMerges->at(i).left()]=mCellMergeX->at(mMerges->at(i).top()).at(mMerges->at(i).left());
-                    (*mCellMergeY)[mMerges->at(i).top()+1][mMerges->at(i).left()]=mCellMergeY->at(mMerges->at(i).top()).at(mMerges->at(i).left())-1;
-                }
-            }
-            else
-            {
-                (*mCellMergeY)[mMerges->at(i).top()][mMerges->at(i).left()]--;
-            }
-
-            if (mMerges->at(i).height()==1)
-            {
-                mMerges->removeAt(i);
-                --i;
-            }
-            else
-            {
-                (*mMerges)[i].setHeight(mMerges->at(i).height()-1);
-
-                if (mMerges->at(i).width()==1 && mMerges->at(i).height()==1)
-                {
-                    (*mCellMergeParentRow)[mMerges->at(i).top()][mMerges->at(i).left()]=-1;
-                    (*mCellMergeParentColumn)[mMerges->at(i).top()][mMerges->at(i).left()]=-1;
-                    (*mCellMergeParentRow)[mMerges->at(i).top()+1][mMerges->at(i).left()]=-1;
-                    (*mCellMergeParentColumn)[mMerges->at(i).top()+1][mMerges->at(i).left()]=-1;
-
-                    mMerges->removeAt(i);
-                    --i;
-                }
-            }
+            cellStyles->append(aNewRowStyles);
         }
     }
 
-    for (int i=0; i<mVerticalHeader_Merges->length(); i++)
+    FASTTABLE_ASSERT(row>=0 && row<cellStyles->length());
+    FASTTABLE_ASSERT(column>=0 && column<cellStyles->at(row).length());
+
+    (*cellStyles)[row][column]=style;
+
+    // Styles replaced by this and previous calls are released when the table has grown enough
+    if (styles->isCompactionNeeded())
     {
-        if (mVerticalHeader_Merges->at(i).top()>row)
-        {
-            for (int j=mVerticalHeader_Merges->at(i).top(); j<=mVerticalHeader_Merges->at(i).bottom(); j++)
-            {
-                for (int k=mVerticalHeader_Merges->at(i).left(); k<=mVerticalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mVerticalHeader_CellMergeParentRow)[j][k]--;
-                }
-            }
+        compactCellStyles(styles, cellStyles);
+    }
 
-            (*mVerticalHeader_Merges)[i].moveTop(mVerticalHeader_Merges->at(i).top()-1);
-        }
-        else
-        if (mVerticalHeader_Merges->at(i).bottom()>=row)
-        {
-            if (mVerticalHeader_Merges->at(i).top()==row)
-            {
-                if (mVerticalHeader_Merges->at(i).height()>1)
-                {
-                    (*mVerticalHeader_CellMergeX)[mVerticalHeader_Merges->at(i).top()+1][mVerticalHeader_Merges->at(i).left()]=mVerticalHeader_CellMergeX->at(mVerticalHeader_Merges->at(i).top()).at(mVerticalHeader_Merges->at(i).left());
-                    (*mVerticalHeader_CellMergeY)[mVerticalHeader_Merges->at(i).top()+1][mVerticalHeader_Merges->at(i).left()]=mVerticalHeader_CellMergeY->at(mVerticalHeader_Merges->at(i).top()).at(mVerticalHeader_Merges->at(i).left())-1;
-                }
-            }
-            else
-            {
-                (*mVerticalHeader_CellMergeY)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]--;
-            }
+    FASTTABLE_END_PROFILE;
+}
 
-            if (mVerticalHeader_Merges->at(i).height()==1)
-            {
-                mVerticalHeader_Merges->removeAt(i);
-                --i;
-            }
-            else
-            {
-                (*mVerticalHeader_Merges)[i].setHeight(mVerticalHeader_Merges->at(i).height()-1);
+void FastTableWidget::insertRows(int row, int count)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
 
-                if (mVerticalHeader_Merges->at(i).width()==1 && mVerticalHeader_Merges->at(i).height()==1)
-                {
-                    (*mVerticalHeader_CellMergeParentRow)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]=-1;
-                    (*mVerticalHeader_CellMergeParentColumn)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]=-1;
-                    (*mVerticalHeader_CellMergeParentRow)[mVerticalHeader_Merges->at(i).top()+1][mVerticalHeader_Merges->at(i).left()]=-1;
-                    (*mVerticalHeader_CellMergeParentColumn)[mVerticalHeader_Merges->at(i).top()+1][mVerticalHeader_Merges->at(i).left()]=-1;
+    FASTTABLE_ASSERT(mCellStyles->isEmpty() || (row>=0 && row<=mCellStyles->length()));
+    FASTTABLE_ASSERT(mVerticalHeader_CellStyles->isEmpty() || (row>=0 && row<=mVerticalHeader_CellStyles->length()));
+    FASTTABLE_ASSERT(count>=0);
 
-                    mVerticalHeader_Merges->removeAt(i);
-                    --i;
-                }
-            }
-        }
+    if (count<=0)
+    {
+        return;
     }
 
-    if (mBackgroundBrushes)
+    // New cells have default style
+    QList<int> aNewRowStyles;
+    QList<int> aNewHeaderRowStyles;
+
+    for (int i=0; i<mColumnCount; ++i)
     {
-        mBackgroundBrushes->removeAt(row);
+        aNewRowStyles.append(0);
     }
 
-    if (mForegroundColors)
+    for (int i=0; i<mVerticalHeader_ColumnCount; ++i)
     {
-        mForegroundColors->removeAt(row);
+        aNewHeaderRowStyles.append(0);
     }
 
-    if (mCellFonts)
+    // New rows are implicitly shared until modified
+    if (!mCellStyles->isEmpty())
     {
-        mCellFonts->removeAt(row);
+        fastInsertRange(*mCellStyles, row, count, aNewRowStyles);
     }
 
-    if (mCellTextFlags)
+    if (!mVerticalHeader_CellStyles->isEmpty())
     {
-        mCellTextFlags->removeAt(row);
+        fastInsertRange(*mVerticalHeader_CellStyles, row, count, aNewHeaderRowStyles);
     }
 
-    mCellMergeX->removeAt(row);
-    mCellMergeY->removeAt(row);
-    mCellMergeParentRow->removeAt(row);
-    mCellMergeParentColumn->removeAt(row);
-
-    mVerticalHeader_BackgroundBrushes->removeAt(row);
-    mVerticalHeader_ForegroundColors->removeAt(row);
-    mVerticalHeader_CellFonts->removeAt(row);
-    mVerticalHeader_CellTextFlags->removeAt(row);
-    mVerticalHeader_CellMergeX->removeAt(row);
-    mVerticalHeader_CellMergeY->removeAt(row);
-    mVerticalHeader_CellMergeParentRow->removeAt(row);
-    mVerticalHeader_CellMergeParentColumn->removeAt(row);
+    mSpans->insertRows(row, count);
+    mVerticalHeader_Spans->insertRows(row, count);
 
-    CustomFastTableWidget::removeRow(row);
+    CustomFastTableWidget::insertRows(row, count);
 
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::insertColumn(int column)
+void FastTableWidget::removeRows(int row, int count)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    CustomFastTableWidget::insertColumn(column);
+    FASTTABLE_ASSERT(mCellStyles->isEmpty() || (row>=0 && row+count<=mCellStyles->length()));
+    FASTTABLE_ASSERT(mVerticalHeader_CellStyles->isEmpty() || (row>=0 && row+count<=mVerticalHeader_CellStyles->length()));
+    FASTTABLE_ASSERT(count>=0);
 
-    for (int i=0; i<mRowHeights->length(); ++i)
+    if (count<=0)
     {
-        FASTTABLE_ASSERT(mBackgroundBrushes==0 || (column>=0 && column<=mBackgroundBrushes->at(i).length()));
-        FASTTABLE_ASSERT(mForegroundColors==0 || (column>=0 && column<=mForegroundColors->at(i).length()));
-        FASTTABLE_ASSERT(mCellFonts==0 || (column>=0 && column<=mCellFonts->at(i).length()));
-        FASTTABLE_ASSERT(mCellTextFlags==0 || (column>=0 && column<=mCellTextFlags->at(i).length()));
-        FASTTABLE_ASSERT(column>=0 && column<=mCellMergeX->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mCellMergeY->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mCellMergeParentRow->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mCellMergeParentColumn->at(i).length());
-
-        if (mBackgroundBrushes)
-        {
-            (*mBackgroundBrushes)[i].insert(column, 0);
-        }
-
-        if (mForegroundColors)
-        {
-            (*mForegroundColors)[i].insert(column, 0);
-        }
-
-        if (mCellFonts)
-        {
-            (*mCellFonts)[i].insert(column, 0);
-        }
-
-        if (mCellTextFlags)
-        {
-            (*mCellTextFlags)[i].insert(column, FASTTABLE_DEFAULT_TEXT_FLAG);
-        }
-
-        (*mCellMergeX)[i].insert(column, 1);
-        (*mCellMergeY)[i].insert(column, 1);
-        (*mCellMergeParentRow)[i].insert(column, -1);
-        (*mCellMergeParentColumn)[i].insert(column, -1);
+        return;
     }
 
-    for (int i=0; i<mHorizontalHeader_RowHeights->length(); ++i)
-    {
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_BackgroundBrushes->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_ForegroundColors->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_CellFonts->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_CellTextFlags->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_CellMergeX->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_CellMergeY->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_CellMergeParentRow->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_CellMergeParentColumn->at(i).length());
-
-        (*mHorizontalHeader_BackgroundBrushes)[i].insert(column, 0);
-        (*mHorizontalHeader_ForegroundColors)[i].insert(column, 0);
-        (*mHorizontalHeader_CellFonts)[i].insert(column, 0);
-        (*mHorizontalHeader_CellTextFlags)[i].insert(column, FASTTABLE_HEADER_DEFAULT_TEXT_FLAG);
-        (*mHorizontalHeader_CellMergeX)[i].insert(column, 1);
-        (*mHorizontalHeader_CellMergeY)[i].insert(column, 1);
-        (*mHorizontalHeader_CellMergeParentRow)[i].insert(column, -1);
-        (*mHorizontalHeader_CellMergeParentColumn)[i].insert(column, -1);
-    }
+    mSpans->removeRows(row, count);
+    mVerticalHeader_Spans->removeRows(row, count);
 
-    for (int i=0; i<mMerges->length(); i++)
+    if (!mCellStyles->isEmpty())
     {
-        if (mMerges->at(i).left()>=column)
-        {
-            (*mMerges)[i].moveLeft(mMerges->at(i).left()+1);
-
-            for (int j=mMerges->at(i).top(); j<=mMerges->at(i).bottom(); j++)
-            {
-                for (int k=mMerges->at(i).left(); k<=mMerges->at(i).right(); k++)
-                {
-                    (*mCellMergeParentColumn)[j][k]++;
-                }
-            }
-        }
-        else
-        if (mMerges->at(i).right()>=column)
-        {
-            (*mMerges)[i].setWidth(mMerges->at(i).width()+1);
-
-            for (int j=mMerges->at(i).top(); j<=mMerges->at(i).bottom(); j++)
-            {
-                (*mCellMergeParentRow)[j][column]=mMerges->at(i).top();
-                (*mCellMergeParentColumn)[j][column]=mMerges->at(i).left();
-            }
-
-            (*mCellMergeX)[mMerges->at(i).top()][mMerges->at(i).left()]++;
-        }
+        fastRemoveRange(*mCellStyles, row, count);
     }
 
-    for (int i=0; i<mHorizontalHeader_Merges->length(); i++)
+    if (!mVerticalHeader_CellStyles->isEmpty())
     {
-        if (mHorizontalHeader_Merges->at(i).left()>=column)
-        {
-            (*mHorizontalHeader_Merges)[i].moveLeft(mHorizontalHeader_Merges->at(i).left()+1);
-
-            for (int j=mHorizontalHeader_Merges->at(i).top(); j<=mHorizontalHeader_Merges->at(i).bottom(); j++)
-            {
-                for (int k=mHorizontalHeader_Merges->at(i).left(); k<=mHorizontalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mHorizontalHeader_CellMergeParentColumn)[j][k]++;
-                }
-            }
-        }
-        else
-        if (mHorizontalHeader_Merges->at(i).right()>=column)
-        {
-            (*mHorizontalHeader_Merges)[i].setWidth(mHorizontalHeader_Merges->at(i).width()+1);
-
-            for (int j=mHorizontalHeader_Merges->at(i).top(); j<=mHorizontalHeader_Merges->at(i).bottom(); j++)
-            {
-                (*mHorizontalHeader_CellMergeParentRow)[j][column]=mHorizontalHeader_Merges->at(i).top();
-                (*mHorizontalHeader_CellMergeParentColumn)[j][column]=mHorizontalHeader_Merges->at(i).left();
-            }
-
-            (*mHorizontalHeader_CellMergeX)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]++;
-        }
+        fastRemoveRange(*mVerticalHeader_CellStyles, row, count);
     }
 
+    CustomFastTableWidget::removeRows(row, count);
+
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::removeColumn(int column)
+void FastTableWidget::insertColumns(int column, int count)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mMerges->length(); i++)
-    {
-        if (mMerges->at(i).left()>column)
-        {
-            for (int j=mMerges->at(i).top(); j<=mMerges->at(i).bottom(); j++)
-            {
-                for (int k=mMerges->at(i).left(); k<=mMerges->at(i).right(); k++)
-                {
-                    (*mCellMergeParentColumn)[j][k]--;
-                }
-            }
-
-            (*mMerges)[i].moveLeft(mMerges->at(i).left()-1);
-        }
-        else
-        if (mMerges->at(i).right()>=column)
-        {
-            if (mMerges->at(i).left()==column)
-            {
-                if (mMerges->at(i).width()>1)
-                {
-                    (*mCellMergeX)[mMerges->at(i).top()][mMerges->at(i).left()+1]=mCellMergeX->at(mMerges->at(i).top()).at(mMerges->at(i).left())-1;
-                    (*mCellMergeY)[mMerges->at(i).top()][mMerges->at(i).left()+1]=mCellMergeY->at(mMerges->at(i).top()).at(mMerges->at(i).left());
-                }
-            }
-            else
-            {
-                (*mCellMergeX)[mMerges->at(i).top()][mMerges->at(i).left()]--;
-            }
+    FASTTABLE_ASSERT(count>=0);
 
-            if (mMerges->at(i).width()==1)
-            {
-                mMerges->removeAt(i);
-                --i;
-            }
-            else
-            {
-                (*mMerges)[i].setWidth(mMerges->at(i).width()-1);
+    if (count<=0)
+    {
+        return;
+    }
 
-                if (mMerges->at(i).width()==1 && mMerges->at(i).height()==1)
-                {
-                    (*mCellMergeParentRow)[mMerges->at(i).top()][mMerges->at(i).left()]=-1;
-                    (*mCellMergeParentColumn)[mMerges->at(i).top()][mMerges->at(i).left()]=-1;
-                    (*mCellMergeParentRow)[mMerges->at(i).top()][mMerges->at(i).left()+1]=-1;
-                    (*mCellMergeParentColumn)[mMerges->at(i).top()][mMerges->at(i).left()+1]=-1;
+    QList<int> aNewCellsStyles;
 
-                    mMerges->removeAt(i);
-                    --i;
-                }
-            }
-        }
+    for (int i=0; i<count; ++i)
+    {
+        aNewCellsStyles.append(0);
     }
 
-    for (int i=0; i<mHorizontalHeader_Merges->length(); i++)
+    for (int i=0; i<mCellStyles->length(); ++i)
     {
-        if (mHorizontalHeader_Merges->at(i).left()>column)
-        {
-            for (int j=mHorizontalHeader_Merges->at(i).top(); j<=mHorizontalHeader_Merges->at(i).bottom(); j++)
-            {
-                for (int k=mHorizontalHeader_Merges->at(i).left(); k<=mHorizontalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mHorizontalHeader_CellMergeParentColumn)[j][k]--;
-                }
-            }
-
-            (*mHorizontalHeader_Merges)[i].moveLeft(mHorizontalHeader_Merges->at(i).left()-1);
-        }
-        else
-        if (mHorizontalHeader_Merges->at(i).right()>=column)
-        {
-            if (mHorizontalHeader_Merges->at(i).left()==column)
-            {
-                if (mHorizontalHeader_Merges->at(i).width()>1)
-                {
-                    (*mHorizontalHeader_CellMergeX)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()+1]=mHorizontalHeader_CellMergeX->at(mHorizontalHeader_Merges->at(i).top()).at(mHorizontalHeader_Merges->at(i).left())-1;
-                    (*mHorizontalHeader_CellMergeY)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()+1]=mHorizontalHeader_CellMergeY->at(mHorizontalHeader_Merges->at(i).top()).at(mHorizontalHeader_Merges->at(i).left());
-                }
-            }
-            else
-            {
-                (*mHorizontalHeader_CellMergeX)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]--;
-            }
+        FASTTABLE_ASSERT(column>=0 && column<=mCellStyles->at(i).length());
 
-            if (mHorizontalHeader_Merges->at(i).width()==1)
-            {
-                mHorizontalHeader_Merges->removeAt(i);
-                --i;
-            }
-            else
-            {
-                (*mHorizontalHeader_Merges)[i].setWidth(mHorizontalHeader_Merges->at(i).width()-1);
-
-                if (mHorizontalHeader_Merges->at(i).width()==1 && mHorizontalHeader_Merges->at(i).height()==1)
-                {
-                    (*mHorizontalHeader_CellMergeParentRow)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]=-1;
-                    (*mHorizontalHeader_CellMergeParentColumn)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]=-1;
-                    (*mHorizontalHeader_CellMergeParentRow)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()+1]=-1;
-                    (*mHorizontalHeader_CellMergeParentColumn)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()+1]=-1;
-
-                    mHorizontalHeader_Merges->removeAt(i);
-                    --i;
-                }
-            }
-        }
+        fastInsertRange((*mCellStyles)[i], column, aNewCellsStyles);
     }
 
-    for (int i=0; i<mRowHeights->length(); ++i)
+    for (int i=0; i<mHorizontalHeader_CellStyles->length(); ++i)
     {
-        FASTTABLE_ASSERT(mBackgroundBrushes==0 || (column>=0 && column<mBackgroundBrushes->at(i).length()));
-        FASTTABLE_ASSERT(mForegroundColors==0 || (column>=0 && column<mForegroundColors->at(i).length()));
-        FASTTABLE_ASSERT(mCellFonts==0 || (column>=0 && column<mCellFonts->at(i).length()));
-        FASTTABLE_ASSERT(mCellTextFlags==0 || (column>=0 && column<mCellTextFlags->at(i).length()));
-        FASTTABLE_ASSERT(column>=0 && column<mCellMergeX->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mCellMergeY->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mCellMergeParentRow->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mCellMergeParentColumn->at(i).length());
+        FASTTABLE_ASSERT(column>=0 && column<=mHorizontalHeader_CellStyles->at(i).length());
 
-        if (mBackgroundBrushes)
-        {
-            if (mBackgroundBrushes->at(i).at(column))
-            {
-                delete mBackgroundBrushes->at(i).at(column);
-            }
-
-            (*mBackgroundBrushes)[i].removeAt(column);
-        }
+        fastInsertRange((*mHorizontalHeader_CellStyles)[i], column, aNewCellsStyles);
+    }
 
-        if (mForegroundColors)
-        {
-            if (mForegroundColors->at(i).at(column))
-            {
-                delete mForegroundColors->at(i).at(column);
-            }
+    mSpans->insertColumns(column, count);
+    mHorizontalHeader_Spans->insertColumns(column, count);
 
-            (*mForegroundColors)[i].removeAt(column);
-        }
+    CustomFastTableWidget::insertColumns(column, count);
 
-        if (mCellFonts)
-        {
-            if (mCellFonts->at(i).at(column))
-            {
-                delete mCellFonts->at(i).at(column);
-            }
+    FASTTABLE_END_PROFILE;
+}
 
-            (*mCellFonts)[i].removeAt(column);
-        }
+void FastTableWidget::removeColumns(int column, int count)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
 
-        if (mCellTextFlags)
-        {
-            (*mCellTextFlags)[i].removeAt(column);
-        }
+    FASTTABLE_ASSERT(count>=0);
 
-        (*mCellMergeX)[i].removeAt(column);
-        (*mCellMergeY)[i].removeAt(column);
-        (*mCellMergeParentRow)[i].removeAt(column);
-        (*mCellMergeParentColumn)[i].removeAt(column);
+    if (count<=0)
+    {
+        return;
     }
 
-    for (int i=0; i<mHorizontalHeader_RowHeights->length(); ++i)
-    {
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_BackgroundBrushes->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_ForegroundColors->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellFonts->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellTextFlags->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeX->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeY->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeParentRow->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeParentColumn->at(i).length());
+    mSpans->removeColumns(column, count);
+    mHorizontalHeader_Spans->removeColumns(column, count);
 
-        if (mHorizontalHeader_BackgroundBrushes->at(i).at(column))
-        {
-            delete mHorizontalHeader_BackgroundBrushes->at(i).at(column);
-        }
+    for (int i=0; i<mCellStyles->length(); ++i)
+    {
+        FASTTABLE_ASSERT(column>=0 && column+count<=mCellStyles->at(i).length());
 
-        if (mHorizontalHeader_ForegroundColors->at(i).at(column))
-        {
-            delete mHorizontalHeader_ForegroundColors->at(i).at(column);
-        }
+        fastRemoveRange((*mCellStyles)[i], column, count);
+    }
 
-        if (mHorizontalHeader_CellFonts->at(i).at(column))
-        {
-            delete mHorizontalHeader_CellFonts->at(i).at(column);
-        }
+    for (int i=0; i<mHorizontalHeader_CellStyles->length(); ++i)
+    {
+        FASTTABLE_ASSERT(column>=0 && column+count<=mHorizontalHeader_CellStyles->at(i).length());
 
-        (*mHorizontalHeader_BackgroundBrushes)[i].removeAt(column);
-        (*mHorizontalHeader_ForegroundColors)[i].removeAt(column);
-        (*mHorizontalHeader_CellFonts)[i].removeAt(column);
-        (*mHorizontalHeader_CellTextFlags)[i].removeAt(column);
-        (*mHorizontalHeader_CellMergeX)[i].removeAt(column);
-        (*mHorizontalHeader_CellMergeY)[i].removeAt(column);
-        (*mHorizontalHeader_CellMergeParentRow)[i].removeAt(column);
-        (*mHorizontalHeader_CellMergeParentColumn)[i].removeAt(column);
+        fastRemoveRange((*mHorizontalHeader_CellStyles)[i], column, count);
     }
 
-    CustomFastTableWidget::removeColumn(column);
+    CustomFastTableWidget::removeColumns(column, count);
 
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::horizontalHeader_InsertRow(int row)
+void FastTableWidget::resizeRows(int count)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(row>=0 && row<=mHorizontalHeader_CellMergeParentColumn->length());
+    FASTTABLE_ASSERT(count>=0);
 
-    CustomFastTableWidget::horizontalHeader_InsertRow(row);
+    if (count>mRowCount)
+    {
+        QList<int> aNewRowStyles;
+        QList<int> aNewHeaderRowStyles;
 
-    QList<QBrush *> aNewRowBrush;
-    QList<QColor *> aNewRowColor;
-    QList<QFont *> aNewRowFont;
-    QList<int> aNewRowint;
-    QList<quint16> aNewRowqint16;
-
-    mHorizontalHeader_BackgroundBrushes->insert(row, aNewRowBrush);
-    mHorizontalHeader_ForegroundColors->insert(row, aNewRowColor);
-    mHorizontalHeader_CellFonts->insert(row, aNewRowFont);
-    mHorizontalHeader_CellTextFlags->insert(row, aNewRowint);
-    mHorizontalHeader_CellMergeX->insert(row, aNewRowqint16);
-    mHorizontalHeader_CellMergeY->insert(row, aNewRowqint16);
-    mHorizontalHeader_CellMergeParentRow->insert(row, aNewRowint);
-    mHorizontalHeader_CellMergeParentColumn->insert(row, aNewRowint);
+        for (int i=0; i<mColumnCount; ++i)
+        {
+            aNewRowStyles.append(0);
+        }
 
-    for (int i=0; i<mColumnCount; ++i)
-    {
-        (*mHorizontalHeader_BackgroundBrushes)[row].append(0);
-        (*mHorizontalHeader_ForegroundColors)[row].append(0);
-        (*mHorizontalHeader_CellFonts)[row].append(0);
-        (*mHorizontalHeader_CellTextFlags)[row].append(FASTTABLE_HEADER_DEFAULT_TEXT_FLAG);
-        (*mHorizontalHeader_CellMergeX)[row].append(1);
-        (*mHorizontalHeader_CellMergeY)[row].append(1);
-        (*mHorizontalHeader_CellMergeParentRow)[row].append(-1);
-        (*mHorizontalHeader_CellMergeParentColumn)[row].append(-1);
-    }
+        for (int i=0; i<mVerticalHeader_ColumnCount; ++i)
+        {
+            aNewHeaderRowStyles.append(0);
+        }
 
-    for (int i=0; i<mHorizontalHeader_Merges->length(); i++)
-    {
-        if (mHorizontalHeader_Merges->at(i).top()>=row)
+        // New rows are implicitly shared until modified
+        if (!mCellStyles->isEmpty())
         {
-            (*mHorizontalHeader_Merges)[i].moveTop(mHorizontalHeader_Merges->at(i).top()+1);
+            mCellStyles->reserve(count);
 
-            for (int j=mHorizontalHeader_Merges->at(i).top(); j<=mHorizontalHeader_Merges->at(i).bottom(); j++)
+            for (int i=mRowCount; i<count; ++i)
             {
-                for (int k=mHorizontalHeader_Merges->at(i).left(); k<=mHorizontalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mHorizontalHeader_CellMergeParentRow)[j][k]++;
-                }
+                mCellStyles->append(aNewRowStyles);
             }
         }
-        else
-        if (mHorizontalHeader_Merges->at(i).bottom()>=row)
+
+        if (!mVerticalHeader_CellStyles->isEmpty())
         {
-            (*mHorizontalHeader_Merges)[i].setHeight(mHorizontalHeader_Merges->at(i).height()+1);
+            mVerticalHeader_CellStyles->reserve(count);
 
-            for (int j=mHorizontalHeader_Merges->at(i).left(); j<=mHorizontalHeader_Merges->at(i).right(); j++)
+            for (int i=mRowCount; i<count; ++i)
             {
-                (*mHorizontalHeader_CellMergeParentRow)[row][j]=mHorizontalHeader_Merges->at(i).top();
-                (*mHorizontalHeader_CellMergeParentColumn)[row][j]=mHorizontalHeader_Merges->at(i).left();
+                mVerticalHeader_CellStyles->append(aNewHeaderRowStyles);
             }
+        }
+    }
+    else
+    if (count<mRowCount)
+    {
+        mSpans->removeRows(count, mRowCount-count);
+        mVerticalHeader_Spans->removeRows(count, mRowCount-count);
+
+        if (!mCellStyles->isEmpty())
+        {
+            mCellStyles->erase(mCellStyles->begin()+count, mCellStyles->end());
+        }
 
-            (*mHorizontalHeader_CellMergeY)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]++;
+        if (!mVerticalHeader_CellStyles->isEmpty())
+        {
+            mVerticalHeader_CellStyles->erase(mVerticalHeader_CellStyles->begin()+count, mVerticalHeader_CellStyles->end());
         }
     }
 
+    CustomFastTableWidget::resizeRows(count);
+
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::horizontalHeader_RemoveRow(int row)
+void FastTableWidget::resizeColumns(int count)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeParentColumn->length());
+    FASTTABLE_ASSERT(count>=0);
 
-    for (int i=0; i<mColumnCount; ++i)
+    if (count>mColumnCount)
     {
-        if (mHorizontalHeader_BackgroundBrushes->at(row).at(i))
+        QList<int> aNewCellsStyles;
+
+        for (int i=mColumnCount; i<count; ++i)
         {
-            delete mHorizontalHeader_BackgroundBrushes->at(row).at(i);
+            aNewCellsStyles.append(0);
         }
 
-        if (mHorizontalHeader_ForegroundColors->at(row).at(i))
+        for (int i=0; i<mCellStyles->length(); ++i)
         {
-            delete mHorizontalHeader_ForegroundColors->at(row).at(i);
+            (*mCellStyles)[i].append(aNewCellsStyles);
         }
 
-        if (mHorizontalHeader_CellFonts->at(row).at(i))
+        for (int i=0; i<mHorizontalHeader_CellStyles->length(); ++i)
         {
-            delete mHorizontalHeader_CellFonts->at(row).at(i);
+            (*mHorizontalHeader_CellStyles)[i].append(aNewCellsStyles);
         }
     }
-
-    for (int i=0; i<mHorizontalHeader_Merges->length(); i++)
+    else
+    if (count<mColumnCount)
     {
-        if (mHorizontalHeader_Merges->at(i).top()>row)
-        {
-            for (int j=mHorizontalHeader_Merges->at(i).top(); j<=mHorizontalHeader_Merges->at(i).bottom(); j++)
-            {
-                for (int k=mHorizontalHeader_Merges->at(i).left(); k<=mHorizontalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mHorizontalHeader_CellMergeParentRow)[j][k]--;
-                }
-            }
+        mSpans->removeColumns(count, mColumnCount-count);
+        mHorizontalHeader_Spans->removeColumns(count, mColumnCount-count);
 
-            (*mHorizontalHeader_Merges)[i].moveTop(mHorizontalHeader_Merges->at(i).top()-1);
-        }
-        else
-        if (mHorizontalHeader_Merges->at(i).bottom()>=row)
+        for (int i=0; i<mCellStyles->length(); ++i)
         {
-            if (mHorizontalHeader_Merges->at(i).top()==row)
-            {
-                if (mHorizontalHeader_Merges->at(i).height()>1)
-                {
-                    (*mHorizontalHeader_CellMergeX)[mHorizontalHeader_Merges->at(i).top()+1][mHorizontalHeader_Merges->at(i).left()]=mHorizontalHeader_CellMergeX->at(mHorizontalHeader_Merges->at(i).top()).at(mHorizontalHeader_Merges->at(i).left());
-                    (*mHorizontalHeader_CellMergeY)[mHorizontalHeader_Merges->at(i).top()+1][mHorizontalHeader_Merges->at(i).left()]=mHorizontalHeader_CellMergeY->at(mHorizontalHeader_Merges->at(i).top()).at(mHorizontalHeader_Merges->at(i).left())-1;
-                }
-            }
-            else
-            {
-                (*mHorizontalHeader_CellMergeY)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]--;
-            }
-
-            if (mHorizontalHeader_Merges->at(i).height()==1)
-            {
-                mHorizontalHeader_Merges->removeAt(i);
-                --i;
-            }
-            else
-            {
-                (*mHorizontalHeader_Merges)[i].setHeight(mHorizontalHeader_Merges->at(i).height()-1);
-
-                if (mHorizontalHeader_Merges->at(i).width()==1 && mHorizontalHeader_Merges->at(i).height()==1)
-                {
-                    (*mHorizontalHeader_CellMergeParentRow)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]=-1;
-                    (*mHorizontalHeader_CellMergeParentColumn)[mHorizontalHeader_Merges->at(i).top()][mHorizontalHeader_Merges->at(i).left()]=-1;
-                    (*mHorizontalHeader_CellMergeParentRow)[mHorizontalHeader_Merges->at(i).top()+1][mHorizontalHeader_Merges->at(i).left()]=-1;
-                    (*mHorizontalHeader_CellMergeParentColumn)[mHorizontalHeader_Merges->at(i).top()+1][mHorizontalHeader_Merges->at(i).left()]=-1;
+            (*mCellStyles)[i].erase((*mCellStyles)[i].begin()+count, (*mCellStyles)[i].end());
+        }
 
-                    mHorizontalHeader_Merges->removeAt(i);
-                    --i;
-                }
-            }
+        for (int i=0; i<mHorizontalHeader_CellStyles->length(); ++i)
+        {
+            (*mHorizontalHeader_CellStyles)[i].erase((*mHorizontalHeader_CellStyles)[i].begin()+count, (*mHorizontalHeader_CellStyles)[i].end());
         }
     }
 
-    mHorizontalHeader_BackgroundBrushes->removeAt(row);
-    mHorizontalHeader_ForegroundColors->removeAt(row);
-    mHorizontalHeader_CellFonts->removeAt(row);
-    mHorizontalHeader_CellTextFlags->removeAt(row);
-    mHorizontalHeader_CellMergeX->removeAt(row);
-    mHorizontalHeader_CellMergeY->removeAt(row);
-    mHorizontalHeader_CellMergeParentRow->removeAt(row);
-    mHorizontalHeader_CellMergeParentColumn->removeAt(row);
-
-    CustomFastTableWidget::horizontalHeader_RemoveRow(row);
+    CustomFastTableWidget::resizeColumns(count);
 
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::verticalHeader_InsertColumn(int column)
+void FastTableWidget::horizontalHeader_InsertRow(int row)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    CustomFastTableWidget::verticalHeader_InsertColumn(column);
+    FASTTABLE_ASSERT(mHorizontalHeader_CellStyles->isEmpty() || (row>=0 && row<=mHorizontalHeader_CellStyles->length()));
 
-    for (int i=0; i<mRowHeights->length(); ++i)
+    CustomFastTableWidget::horizontalHeader_InsertRow(row);
+
+    if (!mHorizontalHeader_CellStyles->isEmpty())
     {
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_BackgroundBrushes->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_ForegroundColors->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_CellFonts->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_CellTextFlags->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_CellMergeX->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_CellMergeY->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_CellMergeParentRow->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_CellMergeParentColumn->at(i).length());
+        QList<int> aNewRowStyles;
+
+        for (int i=0; i<mColumnCount; ++i)
+        {
+            aNewRowStyles.append(0);
+        }
 
-        (*mVerticalHeader_BackgroundBrushes)[i].insert(column, 0);
-        (*mVerticalHeader_ForegroundColors)[i].insert(column, 0);
-        (*mVerticalHeader_CellFonts)[i].insert(column, 0);
-        (*mVerticalHeader_CellTextFlags)[i].insert(column, FASTTABLE_DEFAULT_TEXT_FLAG);
-        (*mVerticalHeader_CellMergeX)[i].insert(column, 1);
-        (*mVerticalHeader_CellMergeY)[i].insert(column, 1);
-        (*mVerticalHeader_CellMergeParentRow)[i].insert(column, -1);
-        (*mVerticalHeader_CellMergeParentColumn)[i].insert(column, -1);
+        mHorizontalHeader_CellStyles->insert(row, aNewRowStyles);
     }
 
-    for (int i=0; i<mVerticalHeader_Merges->length(); i++)
-    {
-        if (mVerticalHeader_Merges->at(i).left()>=column)
-        {
-            (*mVerticalHeader_Merges)[i].moveLeft(mVerticalHeader_Merges->at(i).left()+1);
+    mHorizontalHeader_Spans->insertRows(row, 1);
 
-            for (int j=mVerticalHeader_Merges->at(i).top(); j<=mVerticalHeader_Merges->at(i).bottom(); j++)
-            {
-                for (int k=mVerticalHeader_Merges->at(i).left(); k<=mVerticalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mVerticalHeader_CellMergeParentColumn)[j][k]++;
-                }
-            }
-        }
-        else
-        if (mVerticalHeader_Merges->at(i).right()>=column)
-        {
-            (*mVerticalHeader_Merges)[i].setWidth(mVerticalHeader_Merges->at(i).width()+1);
+    FASTTABLE_END_PROFILE;
+}
 
-            for (int j=mVerticalHeader_Merges->at(i).top(); j<=mVerticalHeader_Merges->at(i).bottom(); j++)
-            {
-                (*mVerticalHeader_CellMergeParentRow)[j][column]=mVerticalHeader_Merges->at(i).top();
-                (*mVerticalHeader_CellMergeParentColumn)[j][column]=mVerticalHeader_Merges->at(i).left();
-            }
+void FastTableWidget::horizontalHeader_RemoveRow(int row)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
+
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
 
-            (*mVerticalHeader_CellMergeX)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]++;
-        }
+    mHorizontalHeader_Spans->removeRows(row, 1);
+
+    if (!mHorizontalHeader_CellStyles->isEmpty())
+    {
+        mHorizontalHeader_CellStyles->removeAt(row);
     }
 
+    CustomFastTableWidget::horizontalHeader_RemoveRow(row);
 
     FASTTABLE_END_PROFILE;
 }
 
-void FastTableWidget::verticalHeader_RemoveColumn(int column)
+void FastTableWidget::verticalHeader_InsertColumn(int column)
 {
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mVerticalHeader_Merges->length(); i++)
-    {
-        if (mVerticalHeader_Merges->at(i).left()>column)
-        {
-            for (int j=mVerticalHeader_Merges->at(i).top(); j<=mVerticalHeader_Merges->at(i).bottom(); j++)
-            {
-                for (int k=mVerticalHeader_Merges->at(i).left(); k<=mVerticalHeader_Merges->at(i).right(); k++)
-                {
-                    (*mVerticalHeader_CellMergeParentColumn)[j][k]--;
-                }
-            }
-
-            (*mVerticalHeader_Merges)[i].moveLeft(mVerticalHeader_Merges->at(i).left()-1);
-        }
-        else
-        if (mVerticalHeader_Merges->at(i).right()>=column)
-        {
-            if (mVerticalHeader_Merges->at(i).left()==column)
-            {
-                if (mVerticalHeader_Merges->at(i).width()>1)
-                {
-                    (*mVerticalHeader_CellMergeX)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()+1]=mVerticalHeader_CellMergeX->at(mVerticalHeader_Merges->at(i).top()).at(mVerticalHeader_Merges->at(i).left())-1;
-                    (*mVerticalHeader_CellMergeY)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()+1]=mVerticalHeader_CellMergeY->at(mVerticalHeader_Merges->at(i).top()).at(mVerticalHeader_Merges->at(i).left());
-                }
-            }
-            else
-            {
-                (*mVerticalHeader_CellMergeX)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]--;
-            }
-
-            if (mVerticalHeader_Merges->at(i).width()==1)
-            {
-                mVerticalHeader_Merges->removeAt(i);
-                --i;
-            }
-            else
-            {
-                (*mVerticalHeader_Merges)[i].setWidth(mVerticalHeader_Merges->at(i).width()-1);
+    CustomFastTableWidget::verticalHeader_InsertColumn(column);
 
-                if (mVerticalHeader_Merges->at(i).width()==1 && mVerticalHeader_Merges->at(i).height()==1)
-                {
-                    (*mVerticalHeader_CellMergeParentRow)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]=-1;
-                    (*mVerticalHeader_CellMergeParentColumn)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()]=-1;
-                    (*mVerticalHeader_CellMergeParentRow)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()+1]=-1;
-                    (*mVerticalHeader_CellMergeParentColumn)[mVerticalHeader_Merges->at(i).top()][mVerticalHeader_Merges->at(i).left()+1]=-1;
+    for (int i=0; i<mVerticalHeader_CellStyles->length(); ++i)
+    {
+        FASTTABLE_ASSERT(column>=0 && column<=mVerticalHeader_CellStyles->at(i).length());
 
-                    mVerticalHeader_Merges->removeAt(i);
-                    --i;
-                }
-            }
-        }
+        (*mVerticalHeader_CellStyles)[i].insert(column, 0);
     }
 
-    for (int i=0; i<mRowHeights->length(); ++i)
-    {
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_BackgroundBrushes->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ForegroundColors->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellFonts->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellTextFlags->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeX->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeY->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeParentRow->at(i).length());
-        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeParentColumn->at(i).length());
+    mVerticalHeader_Spans->insertColumns(column, 1);
 
-        if (mVerticalHeader_BackgroundBrushes->at(i).at(column))
-        {
-            delete mVerticalHeader_BackgroundBrushes->at(i).at(column);
-        }
+    FASTTABLE_END_PROFILE;
+}
 
-        if (mVerticalHeader_ForegroundColors->at(i).at(column))
-        {
-            delete mVerticalHeader_ForegroundColors->at(i).at(column);
-        }
+void FastTableWidget::verticalHeader_RemoveColumn(int column)
+{
+    FASTTABLE_DEBUG;
+    FASTTABLE_START_PROFILE;
 
-        if (mVerticalHeader_CellFonts->at(i).at(column))
-        {
-            delete mVerticalHeader_CellFonts->at(i).at(column);
-        }
+    mVerticalHeader_Spans->removeColumns(column, 1);
+
+    for (int i=0; i<mVerticalHeader_CellStyles->length(); ++i)
+    {
+        FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellStyles->at(i).length());
 
-        (*mVerticalHeader_BackgroundBrushes)[i].removeAt(column);
-        (*mVerticalHeader_ForegroundColors)[i].removeAt(column);
-        (*mVerticalHeader_CellFonts)[i].removeAt(column);
-        (*mVerticalHeader_CellTextFlags)[i].removeAt(column);
-        (*mVerticalHeader_CellMergeX)[i].removeAt(column);
-        (*mVerticalHeader_CellMergeY)[i].removeAt(column);
-        (*mVerticalHeader_CellMergeParentRow)[i].removeAt(column);
-        (*mVerticalHeader_CellMergeParentColumn)[i].removeAt(column);
+        (*mVerticalHeader_CellStyles)[i].removeAt(column);
     }
 
     CustomFastTableWidget::verticalHeader_RemoveColumn(column);
@@ -2560,10 +1850,10 @@ QBrush FastTableWidget::backgroundBrush(const int row, const int column)
 
     // If you don't use internal data, you have to reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mBackgroundBrushes->length());
-    FASTTABLE_ASSERT(column>=0 && column<mBackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    QBrush *aBrush=mBackgroundBrushes->at(row).at(column);
+    QBrush *aBrush=mStyles->backgroundBrush(cellStyle(mCellStyles, row, column));
 
     if (aBrush==0)
     {
@@ -2590,19 +1880,12 @@ void FastTableWidget::setBackgroundBrush(const int row, const int column, const
 
     // If you don't use internal data, you may reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mBackgroundBrushes->length());
-    FASTTABLE_ASSERT(column>=0 && column<mBackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mBackgroundBrushes->at(row).at(column))
-    {
-        *(*mBackgroundBrushes)[row][column]=brush;
-    }
-    else
-    {
-        (*mBackgroundBrushes)[row][column]=new QBrush(brush);
-    }
+    setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->setBackgroundBrush(cellStyle(mCellStyles, row, column), brush));
 
-    viewport()->update();
+    updateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2612,10 +1895,10 @@ QBrush FastTableWidget::horizontalHeader_BackgroundBrush(const int row, const in
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_BackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    QBrush *aBrush=mHorizontalHeader_BackgroundBrushes->at(row).at(column);
+    QBrush *aBrush=mHorizontalHeader_Styles->backgroundBrush(cellStyle(mHorizontalHeader_CellStyles, row, column));
 
     if (aBrush==0)
     {
@@ -2632,19 +1915,12 @@ void FastTableWidget::horizontalHeader_SetBackgroundBrush(const int row, const i
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_BackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mHorizontalHeader_BackgroundBrushes->at(row).at(column))
-    {
-        *(*mHorizontalHeader_BackgroundBrushes)[row][column]=brush;
-    }
-    else
-    {
-        (*mHorizontalHeader_BackgroundBrushes)[row][column]=new QBrush(brush);
-    }
+    setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->setBackgroundBrush(cellStyle(mHorizontalHeader_CellStyles, row, column), brush));
 
-    viewport()->update();
+    horizontalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2654,10 +1930,10 @@ QBrush FastTableWidget::verticalHeader_BackgroundBrush(const int row, const int
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_BackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    QBrush *aBrush=mVerticalHeader_BackgroundBrushes->at(row).at(column);
+    QBrush *aBrush=mVerticalHeader_Styles->backgroundBrush(cellStyle(mVerticalHeader_CellStyles, row, column));
 
     if (aBrush==0)
     {
@@ -2674,19 +1950,12 @@ void FastTableWidget::verticalHeader_SetBackgroundBrush(const int row, const int
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_BackgroundBrushes->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_BackgroundBrushes->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    if (mVerticalHeader_BackgroundBrushes->at(row).at(column))
-    {
-        *(*mVerticalHeader_BackgroundBrushes)[row][column]=brush;
-    }
-    else
-    {
-        (*mVerticalHeader_BackgroundBrushes)[row][column]=new QBrush(brush);
-    }
+    setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->setBackgroundBrush(cellStyle(mVerticalHeader_CellStyles, row, column), brush));
 
-    viewport()->update();
+    verticalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2698,10 +1967,10 @@ QColor FastTableWidget::foregroundColor(const int row, const int column)
 
     // If you don't use internal data, you have to reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mForegroundColors->length());
-    FASTTABLE_ASSERT(column>=0 && column<mForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    QColor *aColor=mForegroundColors->at(row).at(column);
+    QColor *aColor=mStyles->foregroundColor(cellStyle(mCellStyles, row, column));
 
     if (aColor==0)
     {
@@ -2720,19 +1989,12 @@ void FastTableWidget::setForegroundColor(const int row, const int column, const
 
     // If you don't use internal data, you may reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mForegroundColors->length());
-    FASTTABLE_ASSERT(column>=0 && column<mForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mForegroundColors->at(row).at(column))
-    {
-        *(*mForegroundColors)[row][column]=color;
-    }
-    else
-    {
-        (*mForegroundColors)[row][column]=new QColor(color);
-    }
+    setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->setForegroundColor(cellStyle(mCellStyles, row, column), color));
 
-    viewport()->update();
+    updateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2742,10 +2004,10 @@ QColor FastTableWidget::horizontalHeader_ForegroundColor(const int row, const in
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_ForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    QColor *aColor=mHorizontalHeader_ForegroundColors->at(row).at(column);
+    QColor *aColor=mHorizontalHeader_Styles->foregroundColor(cellStyle(mHorizontalHeader_CellStyles, row, column));
 
     if (aColor==0)
     {
@@ -2762,19 +2024,12 @@ void FastTableWidget::horizontalHeader_SetForegroundColor(const int row, const i
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_ForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mHorizontalHeader_ForegroundColors->at(row).at(column))
-    {
-        *(*mHorizontalHeader_ForegroundColors)[row][column]=color;
-    }
-    else
-    {
-        (*mHorizontalHeader_ForegroundColors)[row][column]=new QColor(color);
-    }
+    setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->setForegroundColor(cellStyle(mHorizontalHeader_CellStyles, row, column), color));
 
-    viewport()->update();
+    horizontalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2784,10 +2039,10 @@ QColor FastTableWidget::verticalHeader_ForegroundColor(const int row, const int
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    QColor *aColor=mVerticalHeader_ForegroundColors->at(row).at(column);
+    QColor *aColor=mVerticalHeader_Styles->foregroundColor(cellStyle(mVerticalHeader_CellStyles, row, column));
 
     if (aColor==0)
     {
@@ -2804,19 +2059,12 @@ void FastTableWidget::verticalHeader_SetForegroundColor(const int row, const int
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_ForegroundColors->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ForegroundColors->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    if (mVerticalHeader_ForegroundColors->at(row).at(column))
-    {
-        *(*mVerticalHeader_ForegroundColors)[row][column]=color;
-    }
-    else
-    {
-        (*mVerticalHeader_ForegroundColors)[row][column]=new QColor(color);
-    }
+    setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->setForegroundColor(cellStyle(mVerticalHeader_CellStyles, row, column), color));
 
-    viewport()->update();
+    verticalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2827,12 +2075,12 @@ QFont FastTableWidget::cellFont(const int row, const int column)
 
     // If you don't use internal data, you have to reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mCellFonts->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellFonts->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mCellFonts->at(row).at(column))
+    if (mStyles->font(cellStyle(mCellStyles, row, column)))
     {
-        return *mCellFonts->at(row).at(column);
+        return *mStyles->font(cellStyle(mCellStyles, row, column));
     }
 
     return this->font();
@@ -2845,19 +2093,12 @@ void FastTableWidget::setCellFont(const int row, const int column, const QFont f
 
     // If you don't use internal data, you may reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mCellFonts->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellFonts->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mCellFonts->at(row).at(column))
-    {
-        *(*mCellFonts)[row][column]=font;
-    }
-    else
-    {
-        (*mCellFonts)[row][column]=new QFont(font);
-    }
+    setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->setFont(cellStyle(mCellStyles, row, column), font));
 
-    viewport()->update();
+    updateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2865,12 +2106,12 @@ void FastTableWidget::setCellFont(const int row, const int column, const QFont f
 QFont FastTableWidget::horizontalHeader_CellFont(const int row, const int column)
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellFonts->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mHorizontalHeader_CellFonts->at(row).at(column))
+    if (mHorizontalHeader_Styles->font(cellStyle(mHorizontalHeader_CellStyles, row, column)))
     {
-        return *mHorizontalHeader_CellFonts->at(row).at(column);
+        return *mHorizontalHeader_Styles->font(cellStyle(mHorizontalHeader_CellStyles, row, column));
     }
 
     return this->font();
@@ -2881,19 +2122,12 @@ void FastTableWidget::horizontalHeader_SetCellFont(const int row, const int colu
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellFonts->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    if (mHorizontalHeader_CellFonts->at(row).at(column))
-    {
-        *(*mHorizontalHeader_CellFonts)[row][column]=font;
-    }
-    else
-    {
-        (*mHorizontalHeader_CellFonts)[row][column]=new QFont(font);
-    }
+    setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->setFont(cellStyle(mHorizontalHeader_CellStyles, row, column), font));
 
-    viewport()->update();
+    horizontalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2901,12 +2135,12 @@ void FastTableWidget::horizontalHeader_SetCellFont(const int row, const int colu
 QFont FastTableWidget::verticalHeader_CellFont(const int row, const int column)
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellFonts->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    if (mVerticalHeader_CellFonts->at(row).at(column))
+    if (mVerticalHeader_Styles->font(cellStyle(mVerticalHeader_CellStyles, row, column)))
     {
-        return *mVerticalHeader_CellFonts->at(row).at(column);
+        return *mVerticalHeader_Styles->font(cellStyle(mVerticalHeader_CellStyles, row, column));
     }
 
     return this->font();
@@ -2917,19 +2151,12 @@ void FastTableWidget::verticalHeader_SetCellFont(const int row, const int column
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellFonts->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellFonts->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    if (mVerticalHeader_CellFonts->at(row).at(column))
-    {
-        *(*mVerticalHeader_CellFonts)[row][column]=font;
-    }
-    else
-    {
-        (*mVerticalHeader_CellFonts)[row][column]=new QFont(font);
-    }
+    setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->setFont(cellStyle(mVerticalHeader_CellStyles, row, column), font));
 
-    viewport()->update();
+    verticalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2940,10 +2167,10 @@ int FastTableWidget::cellTextFlags(const int row, const int column)
 
     // If you don't use internal data, you have to reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mCellTextFlags->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return mCellTextFlags->at(row).at(column);
+    return mStyles->textFlags(cellStyle(mCellStyles, row, column));
 }
 
 void FastTableWidget::setCellTextFlags(const int row, const int column, const int flags)
@@ -2953,12 +2180,12 @@ void FastTableWidget::setCellTextFlags(const int row, const int column, const in
 
     // If you don't use internal data, you may reimplement this function in your class
     FASTTABLE_ASSERT(mUseInternalData);
-    FASTTABLE_ASSERT(row>=0 && row<mCellTextFlags->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    (*mCellTextFlags)[row][column]=flags;
+    setCellStyle(mStyles, mCellStyles, mRowCount, mColumnCount, row, column, mStyles->setTextFlags(cellStyle(mCellStyles, row, column), flags));
 
-    viewport()->update();
+    updateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2966,10 +2193,10 @@ void FastTableWidget::setCellTextFlags(const int row, const int column, const in
 int FastTableWidget::horizontalHeader_CellTextFlags(const int row, const int column)
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return mHorizontalHeader_CellTextFlags->at(row).at(column);
+    return mHorizontalHeader_Styles->textFlags(cellStyle(mHorizontalHeader_CellStyles, row, column));
 }
 
 void FastTableWidget::horizontalHeader_SetCellTextFlags(const int row, const int column, const int flags)
@@ -2977,12 +2204,12 @@ void FastTableWidget::horizontalHeader_SetCellTextFlags(const int row, const int
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    (*mHorizontalHeader_CellTextFlags)[row][column]=flags;
+    setCellStyle(mHorizontalHeader_Styles, mHorizontalHeader_CellStyles, mHorizontalHeader_RowCount, mColumnCount, row, column, mHorizontalHeader_Styles->setTextFlags(cellStyle(mHorizontalHeader_CellStyles, row, column), flags));
 
-    viewport()->update();
+    horizontalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -2990,10 +2217,10 @@ void FastTableWidget::horizontalHeader_SetCellTextFlags(const int row, const int
 int FastTableWidget::verticalHeader_CellTextFlags(const int row, const int column)
 {
     FASTTABLE_DEBUG;
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    return mVerticalHeader_CellTextFlags->at(row).at(column);
+    return mVerticalHeader_Styles->textFlags(cellStyle(mVerticalHeader_CellStyles, row, column));
 }
 
 void FastTableWidget::verticalHeader_SetCellTextFlags(const int row, const int column, const int flags)
@@ -3001,12 +2228,12 @@ void FastTableWidget::verticalHeader_SetCellTextFlags(const int row, const int c
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellTextFlags->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellTextFlags->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    (*mVerticalHeader_CellTextFlags)[row][column]=flags;
+    setCellStyle(mVerticalHeader_Styles, mVerticalHeader_CellStyles, mRowCount, mVerticalHeader_ColumnCount, row, column, mVerticalHeader_Styles->setTextFlags(cellStyle(mVerticalHeader_CellStyles, row, column), flags));
 
-    viewport()->update();
+    verticalHeader_UpdateCell(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3016,30 +2243,7 @@ void FastTableWidget::clearSpans()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mMerges->length(); ++i)
-    {
-        for (int j=mMerges->at(i).top(); j<=mMerges->at(i).bottom(); ++j)
-        {
-            for (int k=mMerges->at(i).left(); k<=mMerges->at(i).right(); ++k)
-            {
-                FASTTABLE_ASSERT(j>=0 && j<mCellMergeX->length());
-                FASTTABLE_ASSERT(k>=0 && k<mCellMergeX->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mCellMergeY->length());
-                FASTTABLE_ASSERT(k>=0 && k<mCellMergeY->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mCellMergeParentRow->length());
-                FASTTABLE_ASSERT(k>=0 && k<mCellMergeParentRow->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mCellMergeParentColumn->length());
-                FASTTABLE_ASSERT(k>=0 && k<mCellMergeParentColumn->at(j).length());
-
-                (*mCellMergeX)[j][k]=1;
-                (*mCellMergeY)[j][k]=1;
-                (*mCellMergeParentRow)[j][k]=-1;
-                (*mCellMergeParentColumn)[j][k]=-1;
-            }
-        }
-    }
-
-    mMerges->clear();
+    mSpans->clear();
 
     viewport()->update();
 
@@ -3051,14 +2255,8 @@ void FastTableWidget::setSpan(const int row, const int column, quint16 rowSpan,
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeX->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeX->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeY->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeY->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeParentRow->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeParentRow->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeParentColumn->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeParentColumn->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
     if (row+rowSpan>mRowCount)
     {
@@ -3080,77 +2278,7 @@ void FastTableWidget::setSpan(const int row, const int column, quint16 rowSpan,
         columnSpan=1;
     }
 
-    int parentRow;
-    int parentColumn;
-
-    for (int i=0; i<rowSpan; ++i)
-    {
-        for (int j=0; j<columnSpan; ++j)
-        {
-            FASTTABLE_ASSERT(row+i>=0 && row+i<mCellMergeParentRow->length());
-            FASTTABLE_ASSERT(column+j>=0 && column+j<mCellMergeParentRow->at(row+i).length());
-            FASTTABLE_ASSERT(row+i>=0 && row+i<mCellMergeParentColumn->length());
-            FASTTABLE_ASSERT(column+j>=0 && column+j<mCellMergeParentColumn->at(row+i).length());
-
-            parentRow=mCellMergeParentRow->at(row+i).at(column+j);
-            parentColumn=mCellMergeParentColumn->at(row+i).at(column+j);
-
-            if (parentRow>=0 && parentColumn>=0)
-            {
-                FASTTABLE_ASSERT(parentRow>=0 && parentRow<mCellMergeX->length());
-                FASTTABLE_ASSERT(parentColumn>=0 && parentColumn<mCellMergeX->at(parentRow).length());
-                FASTTABLE_ASSERT(parentRow>=0 && parentRow<mCellMergeY->length());
-                FASTTABLE_ASSERT(parentColumn>=0 && parentColumn<mCellMergeY->at(parentRow).length());
-
-                int parentSpanX=mCellMergeX->at(parentRow).at(parentColumn);
-                int parentSpanY=mCellMergeY->at(parentRow).at(parentColumn);
-
-                QRect oldMerge(parentColumn, parentRow, parentSpanX, parentSpanY);
-
-                for (int g=0; g<mMerges->length(); ++g)
-                {
-                    if (mMerges->at(g)==oldMerge)
-                    {
-                        mMerges->removeAt(g);
-                        break;
-                    }
-                }
-
-                for (int g=0; g<parentSpanY; ++g)
-                {
-                    for (int h=0; h<parentSpanX; ++h)
-                    {
-                        FASTTABLE_ASSERT(parentRow+g>=0 && parentRow+g<mCellMergeParentRow->length());
-                        FASTTABLE_ASSERT(parentColumn+h>=0 && parentColumn+h<mCellMergeParentRow->at(parentRow).length());
-                        FASTTABLE_ASSERT(parentRow+g>=0 && parentRow+g<mCellMergeParentColumn->length());
-                        FASTTABLE_ASSERT(parentColumn+h>=0 && parentColumn+h<mCellMergeParentColumn->at(parentRow).length());
-
-                        (*mCellMergeParentRow)[parentRow+g][parentColumn+h]=-1;
-                        (*mCellMergeParentColumn)[parentRow+g][parentColumn+h]=-1;
-                    }
-                }
-
-                (*mCellMergeX)[parentRow][parentColumn]=1;
-                (*mCellMergeY)[parentRow][parentColumn]=1;
-            }
-
-            (*mCellMergeParentRow)[row+i][column+j]=row;
-            (*mCellMergeParentColumn)[row+i][column+j]=column;
-        }
-    }
-
-    (*mCellMergeX)[row][column]=columnSpan;
-    (*mCellMergeY)[row][column]=rowSpan;
-
-    if (rowSpan==1 && columnSpan==1)
-    {
-        (*mCellMergeParentRow)[row][column]=-1;
-        (*mCellMergeParentColumn)[row][column]=-1;
-    }
-    else
-    {
-        mMerges->append(QRect(column, row, columnSpan, rowSpan));
-    }
+    mSpans->setSpan(QRect(column, row, columnSpan, rowSpan));
 
     viewport()->update();
 
@@ -3172,10 +2300,10 @@ quint16 FastTableWidget::rowSpan(const int row, const int column)
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeY->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeY->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return mCellMergeY->at(row).at(column);
+    return mSpans->rowSpan(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3185,10 +2313,10 @@ quint16 FastTableWidget::columnSpan(const int row, const int column)
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeX->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeX->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return mCellMergeX->at(row).at(column);
+    return mSpans->columnSpan(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3198,12 +2326,10 @@ QPoint FastTableWidget::spanParent(const int row, const int column)
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeParentRow->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeParentRow->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mCellMergeParentColumn->length());
-    FASTTABLE_ASSERT(column>=0 && column<mCellMergeParentColumn->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return QPoint(mCellMergeParentColumn->at(row).at(column), mCellMergeParentRow->at(row).at(column));
+    return mSpans->parent(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3213,30 +2339,7 @@ void FastTableWidget::horizontalHeader_ClearSpans()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mHorizontalHeader_Merges->length(); ++i)
-    {
-        for (int j=mHorizontalHeader_Merges->at(i).top(); j<=mHorizontalHeader_Merges->at(i).bottom(); ++j)
-        {
-            for (int k=mHorizontalHeader_Merges->at(i).left(); k<=mHorizontalHeader_Merges->at(i).right(); ++k)
-            {
-                FASTTABLE_ASSERT(j>=0 && j<mHorizontalHeader_CellMergeX->length());
-                FASTTABLE_ASSERT(k>=0 && k<mHorizontalHeader_CellMergeX->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mHorizontalHeader_CellMergeY->length());
-                FASTTABLE_ASSERT(k>=0 && k<mHorizontalHeader_CellMergeY->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mHorizontalHeader_CellMergeParentRow->length());
-                FASTTABLE_ASSERT(k>=0 && k<mHorizontalHeader_CellMergeParentRow->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mHorizontalHeader_CellMergeParentColumn->length());
-                FASTTABLE_ASSERT(k>=0 && k<mHorizontalHeader_CellMergeParentColumn->at(j).length());
-
-                (*mHorizontalHeader_CellMergeX)[j][k]=1;
-                (*mHorizontalHeader_CellMergeY)[j][k]=1;
-                (*mHorizontalHeader_CellMergeParentRow)[j][k]=-1;
-                (*mHorizontalHeader_CellMergeParentColumn)[j][k]=-1;
-            }
-        }
-    }
-
-    mHorizontalHeader_Merges->clear();
+    mHorizontalHeader_Spans->clear();
 
     viewport()->update();
 
@@ -3248,14 +2351,8 @@ void FastTableWidget::horizontalHeader_SetSpan(const int row, const int column,
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeX->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeY->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeParentRow->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeParentColumn->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeParentColumn->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
     if (row+rowSpan>mHorizontalHeader_RowCount)
     {
@@ -3277,77 +2374,7 @@ void FastTableWidget::horizontalHeader_SetSpan(const int row, const int column,
         columnSpan=1;
     }
 
-    int parentRow;
-    int parentColumn;
-
-    for (int i=0; i<rowSpan; ++i)
-    {
-        for (int j=0; j<columnSpan; ++j)
-        {
-            FASTTABLE_ASSERT(row+i>=0 && row+i<mHorizontalHeader_CellMergeParentRow->length());
-            FASTTABLE_ASSERT(column+j>=0 && column+j<mHorizontalHeader_CellMergeParentRow->at(row+i).length());
-            FASTTABLE_ASSERT(row+i>=0 && row+i<mHorizontalHeader_CellMergeParentColumn->length());
-            FASTTABLE_ASSERT(column+j>=0 && column+j<mHorizontalHeader_CellMergeParentColumn->at(row+i).length());
-
-            parentRow=mHorizontalHeader_CellMergeParentRow->at(row+i).at(column+j);
-            parentColumn=mHorizontalHeader_CellMergeParentColumn->at(row+i).at(column+j);
-
-            if (parentRow>=0 && parentColumn>=0)
-            {
-                FASTTABLE_ASSERT(parentRow>=0 && parentRow<mHorizontalHeader_CellMergeX->length());
-                FASTTABLE_ASSERT(parentColumn>=0 && parentColumn<mHorizontalHeader_CellMergeX->at(parentRow).length());
-                FASTTABLE_ASSERT(parentRow>=0 && parentRow<mHorizontalHeader_CellMergeY->length());
-                FASTTABLE_ASSERT(parentColumn>=0 && parentColumn<mHorizontalHeader_CellMergeY->at(parentRow).length());
-
-                int parentSpanX=mHorizontalHeader_CellMergeX->at(parentRow).at(parentColumn);
-                int parentSpanY=mHorizontalHeader_CellMergeY->at(parentRow).at(parentColumn);
-
-                QRect oldMerge(parentColumn, parentRow, parentSpanX, parentSpanY);
-
-                for (int g=0; g<mHorizontalHeader_Merges->length(); ++g)
-                {
-                    if (mHorizontalHeader_Merges->at(g)==oldMerge)
-                    {
-                        mHorizontalHeader_Merges->removeAt(g);
-                        break;
-                    }
-                }
-
-                for (int g=0; g<parentSpanY; ++g)
-                {
-                    for (int h=0; h<parentSpanX; ++h)
-                    {
-                        FASTTABLE_ASSERT(parentRow+g>=0 && parentRow+g<mHorizontalHeader_CellMergeParentRow->length());
-                        FASTTABLE_ASSERT(parentColumn+h>=0 && parentColumn+h<mHorizontalHeader_CellMergeParentRow->at(parentRow).length());
-                        FASTTABLE_ASSERT(parentRow+g>=0 && parentRow+g<mHorizontalHeader_CellMergeParentColumn->length());
-                        FASTTABLE_ASSERT(parentColumn+h>=0 && parentColumn+h<mHorizontalHeader_CellMergeParentColumn->at(parentRow).length());
-
-                        (*mHorizontalHeader_CellMergeParentRow)[parentRow+g][parentColumn+h]=-1;
-                        (*mHorizontalHeader_CellMergeParentColumn)[parentRow+g][parentColumn+h]=-1;
-                    }
-                }
-
-                (*mHorizontalHeader_CellMergeX)[parentRow][parentColumn]=1;
-                (*mHorizontalHeader_CellMergeY)[parentRow][parentColumn]=1;
-            }
-
-            (*mHorizontalHeader_CellMergeParentRow)[row+i][column+j]=row;
-            (*mHorizontalHeader_CellMergeParentColumn)[row+i][column+j]=column;
-        }
-    }
-
-    (*mHorizontalHeader_CellMergeX)[row][column]=columnSpan;
-    (*mHorizontalHeader_CellMergeY)[row][column]=rowSpan;
-
-    if (rowSpan==1 && columnSpan==1)
-    {
-        (*mHorizontalHeader_CellMergeParentRow)[row][column]=-1;
-        (*mHorizontalHeader_CellMergeParentColumn)[row][column]=-1;
-    }
-    else
-    {
-        mHorizontalHeader_Merges->append(QRect(column, row, columnSpan, rowSpan));
-    }
+    mHorizontalHeader_Spans->setSpan(QRect(column, row, columnSpan, rowSpan));
 
     viewport()->update();
 
@@ -3369,10 +2396,10 @@ quint16 FastTableWidget::horizontalHeader_RowSpan(const int row, const int colum
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeY->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return mHorizontalHeader_CellMergeY->at(row).at(column);
+    return mHorizontalHeader_Spans->rowSpan(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3382,10 +2409,10 @@ quint16 FastTableWidget::horizontalHeader_ColumnSpan(const int row, const int co
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeX->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return mHorizontalHeader_CellMergeX->at(row).at(column);
+    return mHorizontalHeader_Spans->columnSpan(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3395,12 +2422,10 @@ QPoint FastTableWidget::horizontalHeader_SpanParent(const int row, const int col
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeParentRow->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_CellMergeParentColumn->length());
-    FASTTABLE_ASSERT(column>=0 && column<mHorizontalHeader_CellMergeParentColumn->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
 
-    return QPoint(mHorizontalHeader_CellMergeParentColumn->at(row).at(column), mHorizontalHeader_CellMergeParentRow->at(row).at(column));
+    return mHorizontalHeader_Spans->parent(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3410,30 +2435,7 @@ void FastTableWidget::verticalHeader_ClearSpans()
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    for (int i=0; i<mVerticalHeader_Merges->length(); ++i)
-    {
-        for (int j=mVerticalHeader_Merges->at(i).top(); j<=mVerticalHeader_Merges->at(i).bottom(); ++j)
-        {
-            for (int k=mVerticalHeader_Merges->at(i).left(); k<=mVerticalHeader_Merges->at(i).right(); ++k)
-            {
-                FASTTABLE_ASSERT(j>=0 && j<mVerticalHeader_CellMergeX->length());
-                FASTTABLE_ASSERT(k>=0 && k<mVerticalHeader_CellMergeX->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mVerticalHeader_CellMergeY->length());
-                FASTTABLE_ASSERT(k>=0 && k<mVerticalHeader_CellMergeY->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mVerticalHeader_CellMergeParentRow->length());
-                FASTTABLE_ASSERT(k>=0 && k<mVerticalHeader_CellMergeParentRow->at(j).length());
-                FASTTABLE_ASSERT(j>=0 && j<mVerticalHeader_CellMergeParentColumn->length());
-                FASTTABLE_ASSERT(k>=0 && k<mVerticalHeader_CellMergeParentColumn->at(j).length());
-
-                (*mVerticalHeader_CellMergeX)[j][k]=1;
-                (*mVerticalHeader_CellMergeY)[j][k]=1;
-                (*mVerticalHeader_CellMergeParentRow)[j][k]=-1;
-                (*mVerticalHeader_CellMergeParentColumn)[j][k]=-1;
-            }
-        }
-    }
-
-    mVerticalHeader_Merges->clear();
+    mVerticalHeader_Spans->clear();
 
     viewport()->update();
 
@@ -3445,14 +2447,8 @@ void FastTableWidget::verticalHeader_SetSpan(const int row, const int column, qu
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeX->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeY->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeParentRow->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeParentColumn->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeParentColumn->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
     if (row+rowSpan>mRowCount)
     {
@@ -3474,77 +2470,7 @@ void FastTableWidget::verticalHeader_SetSpan(const int row, const int column, qu
         columnSpan=1;
     }
 
-    int parentRow;
-    int parentColumn;
-
-    for (int i=0; i<rowSpan; ++i)
-    {
-        for (int j=0; j<columnSpan; ++j)
-        {
-            FASTTABLE_ASSERT(row+i>=0 && row+i<mVerticalHeader_CellMergeParentRow->length());
-            FASTTABLE_ASSERT(column+j>=0 && column+j<mVerticalHeader_CellMergeParentRow->at(row+i).length());
-            FASTTABLE_ASSERT(row+i>=0 && row+i<mVerticalHeader_CellMergeParentColumn->length());
-            FASTTABLE_ASSERT(column+j>=0 && column+j<mVerticalHeader_CellMergeParentColumn->at(row+i).length());
-
-            parentRow=mVerticalHeader_CellMergeParentRow->at(row+i).at(column+j);
-            parentColumn=mVerticalHeader_CellMergeParentColumn->at(row+i).at(column+j);
-
-            if (parentRow>=0 && parentColumn>=0)
-            {
-                FASTTABLE_ASSERT(parentRow>=0 && parentRow<mVerticalHeader_CellMergeX->length());
-                FASTTABLE_ASSERT(parentColumn>=0 && parentColumn<mVerticalHeader_CellMergeX->at(parentRow).length());
-                FASTTABLE_ASSERT(parentRow>=0 && parentRow<mVerticalHeader_CellMergeY->length());
-                FASTTABLE_ASSERT(parentColumn>=0 && parentColumn<mVerticalHeader_CellMergeY->at(parentRow).length());
-
-                int parentSpanX=mVerticalHeader_CellMergeX->at(parentRow).at(parentColumn);
-                int parentSpanY=mVerticalHeader_CellMergeY->at(parentRow).at(parentColumn);
-
-                QRect oldMerge(parentColumn, parentRow, parentSpanX, parentSpanY);
-
-                for (int g=0; g<mVerticalHeader_Merges->length(); ++g)
-                {
-                    if (mVerticalHeader_Merges->at(g)==oldMerge)
-                    {
-                        mVerticalHeader_Merges->removeAt(g);
-                        break;
-                    }
-                }
-
-                for (int g=0; g<parentSpanY; ++g)
-                {
-                    for (int h=0; h<parentSpanX; ++h)
-                    {
-                        FASTTABLE_ASSERT(parentRow+g>=0 && parentRow+g<mVerticalHeader_CellMergeParentRow->length());
-                        FASTTABLE_ASSERT(parentColumn+h>=0 && parentColumn+h<mVerticalHeader_CellMergeParentRow->at(parentRow).length());
-                        FASTTABLE_ASSERT(parentRow+g>=0 && parentRow+g<mVerticalHeader_CellMergeParentColumn->length());
-                        FASTTABLE_ASSERT(parentColumn+h>=0 && parentColumn+h<mVerticalHeader_CellMergeParentColumn->at(parentRow).length());
-
-                        (*mVerticalHeader_CellMergeParentRow)[parentRow+g][parentColumn+h]=-1;
-                        (*mVerticalHeader_CellMergeParentColumn)[parentRow+g][parentColumn+h]=-1;
-                    }
-                }
-
-                (*mVerticalHeader_CellMergeX)[parentRow][parentColumn]=1;
-                (*mVerticalHeader_CellMergeY)[parentRow][parentColumn]=1;
-            }
-
-            (*mVerticalHeader_CellMergeParentRow)[row+i][column+j]=row;
-            (*mVerticalHeader_CellMergeParentColumn)[row+i][column+j]=column;
-        }
-    }
-
-    (*mVerticalHeader_CellMergeX)[row][column]=columnSpan;
-    (*mVerticalHeader_CellMergeY)[row][column]=rowSpan;
-
-    if (rowSpan==1 && columnSpan==1)
-    {
-        (*mVerticalHeader_CellMergeParentRow)[row][column]=-1;
-        (*mVerticalHeader_CellMergeParentColumn)[row][column]=-1;
-    }
-    else
-    {
-        mVerticalHeader_Merges->append(QRect(column, row, columnSpan, rowSpan));
-    }
+    mVerticalHeader_Spans->setSpan(QRect(column, row, columnSpan, rowSpan));
 
     viewport()->update();
 
@@ -3566,10 +2492,10 @@ quint16 FastTableWidget::verticalHeader_RowSpan(const int row, const int column)
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeY->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeY->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    return mVerticalHeader_CellMergeY->at(row).at(column);
+    return mVerticalHeader_Spans->rowSpan(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3579,10 +2505,10 @@ quint16 FastTableWidget::verticalHeader_ColumnSpan(const int row, const int colu
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeX->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeX->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    return mVerticalHeader_CellMergeX->at(row).at(column);
+    return mVerticalHeader_Spans->columnSpan(row, column);
 
     FASTTABLE_END_PROFILE;
 }
@@ -3592,12 +2518,94 @@ QPoint FastTableWidget::verticalHeader_SpanParent(const int row, const int colum
     FASTTABLE_DEBUG;
     FASTTABLE_START_PROFILE;
 
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeParentRow->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeParentRow->at(row).length());
-    FASTTABLE_ASSERT(row>=0 && row<mVerticalHeader_CellMergeParentColumn->length());
-    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_CellMergeParentColumn->at(row).length());
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
 
-    return QPoint(mVerticalHeader_CellMergeParentColumn->at(row).at(column), mVerticalHeader_CellMergeParentRow->at(row).at(column));
+    return mVerticalHeader_Spans->parent(row, column);
 
     FASTTABLE_END_PROFILE;
 }
+
+void FastTableWidget::updateCell(const int row, const int column)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    QRect aSpan=mSpans->spanAt(row, column);
+
+    if (!aSpan.isValid() || mUpdateLevel>0)
+    {
+        CustomFastTableWidget::updateCell(row, column);
+        return;
+    }
+
+    int parentRow=aSpan.top();
+    int parentColumn=aSpan.left();
+    int lastRow=aSpan.bottom();
+    int lastColumn=aSpan.right();
+
+    int aLeft=mOffsetX->at(parentColumn);
+    int aTop=mOffsetY->at(parentRow);
+    int aRight=mOffsetX->at(lastColumn)+qMax((int)mColumnWidths->at(lastColumn), 0);
+    int aBottom=mOffsetY->at(lastRow)+qMax((int)mRowHeights->at(lastRow), 0);
+
+    viewport()->update(aLeft-horizontalScrollBar()->value(), aTop-verticalScrollBar()->value(), aRight-aLeft, aBottom-aTop);
+}
+
+void FastTableWidget::horizontalHeader_UpdateCell(const int row, const int column)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    FASTTABLE_ASSERT(row>=0 && row<mHorizontalHeader_RowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    QRect aSpan=mHorizontalHeader_Spans->spanAt(row, column);
+
+    if (!aSpan.isValid() || mUpdateLevel>0)
+    {
+        CustomFastTableWidget::horizontalHeader_UpdateCell(row, column);
+        return;
+    }
+
+    int parentRow=aSpan.top();
+    int parentColumn=aSpan.left();
+    int lastRow=aSpan.bottom();
+    int lastColumn=aSpan.right();
+
+    int aLeft=mOffsetX->at(parentColumn);
+    int aTop=mHorizontalHeader_OffsetY->at(parentRow);
+    int aRight=mOffsetX->at(lastColumn)+qMax((int)mColumnWidths->at(lastColumn), 0);
+    int aBottom=mHorizontalHeader_OffsetY->at(lastRow)+qMax((int)mHorizontalHeader_RowHeights->at(lastRow), 0);
+
+    viewport()->update(aLeft-horizontalScrollBar()->value(), aTop, aRight-aLeft, aBottom-aTop);
+}
+
+void FastTableWidget::verticalHeader_UpdateCell(const int row, const int column)
+{
+    FASTTABLE_FREQUENT_DEBUG;
+
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mVerticalHeader_ColumnCount);
+
+    QRect aSpan=mVerticalHeader_Spans->spanAt(row, column);
+
+    if (!aSpan.isValid() || mUpdateLevel>0)
+    {
+        CustomFastTableWidget::verticalHeader_UpdateCell(row, column);
+        return;
+    }
+
+    int parentRow=aSpan.top();
+    int parentColumn=aSpan.left();
+    int lastRow=aSpan.bottom();
+    int lastColumn=aSpan.right();
+
+    int aLeft=mVerticalHeader_OffsetX->at(parentColumn);
+    int aTop=mOffsetY->at(parentRow);
+    int aRight=mVerticalHeader_OffsetX->at(lastColumn)+qMax((int)mVerticalHeader_ColumnWidths->at(lastColumn), 0);
+    int aBottom=mOffsetY->at(lastRow)+qMax((int)mRowHeights->at(lastRow), 0);
+
+    viewport()->update(aLeft, aTop-verticalScrollBar()->value(), aRight-aLeft, aBottom-aTop);
+}
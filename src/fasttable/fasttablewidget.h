@@ -2,6 +2,8 @@
 #define FASTTABLEWIDGET_H
 
 #include "customfasttablewidget.h"
+#include "spanindex.h"
+#include "styletable.h"
 
 //------------------------------------------------------------------------------
 
@@ -46,11 +48,11 @@ public:
     void verticalHeader_ResetFont(const int row, const int column);
     void verticalHeader_ResetCellTextFlag(const int row, const int column);
 
-    void insertRow(int row);
-    void removeRow(int row);
+    void insertRows(int row, int count);
+    void removeRows(int row, int count);
 
-    void insertColumn(int column);
-    void removeColumn(int column);
+    void insertColumns(int column, int count);
+    void removeColumns(int column, int count);
 
     void horizontalHeader_InsertRow(int row);
     void horizontalHeader_RemoveRow(int row);
@@ -115,44 +117,41 @@ public:
     quint16 verticalHeader_ColumnSpan(const int row, const int column);
     QPoint verticalHeader_SpanParent(const int row, const int column);
 
+    void updateCell(const int row, const int column);
+    void horizontalHeader_UpdateCell(const int row, const int column);
+    void verticalHeader_UpdateCell(const int row, const int column);
+
+    QPoint cellAt(const int x, const int y);
+
 protected:
-    QList< QList<QBrush *> > *mBackgroundBrushes;
-    QList< QList<QColor *> > *mForegroundColors;
-    QList< QList<QFont *> >  *mCellFonts;
-    QList< QList<int> >      *mCellTextFlags;
-    QList< QList<quint16> >  *mCellMergeX;
-    QList< QList<quint16> >  *mCellMergeY;
-    QList< QList<int> >      *mCellMergeParentRow;
-    QList< QList<int> >      *mCellMergeParentColumn;
-    QList< QRect >           *mMerges;
-
-    QList< QList<QBrush *> > *mHorizontalHeader_BackgroundBrushes;
-    QList< QList<QColor *> > *mHorizontalHeader_ForegroundColors;
-    QList< QList<QFont *> >  *mHorizontalHeader_CellFonts;
-    QList< QList<int> >      *mHorizontalHeader_CellTextFlags;
-    QList< QList<quint16> >  *mHorizontalHeader_CellMergeX;
-    QList< QList<quint16> >  *mHorizontalHeader_CellMergeY;
-    QList< QList<int> >      *mHorizontalHeader_CellMergeParentRow;
-    QList< QList<int> >      *mHorizontalHeader_CellMergeParentColumn;
-    QList< QRect >           *mHorizontalHeader_Merges;
-
-    QList< QList<QBrush *> > *mVerticalHeader_BackgroundBrushes;
-    QList< QList<QColor *> > *mVerticalHeader_ForegroundColors;
-    QList< QList<QFont *> >  *mVerticalHeader_CellFonts;
-    QList< QList<int> >      *mVerticalHeader_CellTextFlags;
-    QList< QList<quint16> >  *mVerticalHeader_CellMergeX;
-    QList< QList<quint16> >  *mVerticalHeader_CellMergeY;
-    QList< QList<int> >      *mVerticalHeader_CellMergeParentRow;
-    QList< QList<int> >      *mVerticalHeader_CellMergeParentColumn;
-    QList< QRect >           *mVerticalHeader_Merges;
+    StyleTable               *mStyles;
+    QList< QList<int> >      *mCellStyles;
+    SpanIndex                *mSpans;
+
+    StyleTable               *mHorizontalHeader_Styles;
+    QList< QList<int> >      *mHorizontalHeader_CellStyles;
+    SpanIndex                *mHorizontalHeader_Spans;
+
+    StyleTable               *mVerticalHeader_Styles;
+    QList< QList<int> >      *mVerticalHeader_CellStyles;
+    SpanIndex                *mVerticalHeader_Spans;
 
     void createLists();
     void deleteLists();
 
+    void resetCellStyles(StyleTable *styles, QList< QList<int> > *cellStyles, int (StyleTable::*resetFunction)(const int));
+    void compactCellStyles(StyleTable *styles, QList< QList<int> > *cellStyles);
+    int cellStyle(QList< QList<int> > *cellStyles, const int row, const int column);
+    void setCellStyle(StyleTable *styles, QList< QList<int> > *cellStyles, const int rowCount, const int columnCount, const int row, const int column, const int style);
+
+    void resizeRows(int count);
+    void resizeColumns(int count);
+
     void paintEvent(QPaintEvent *event);
     void paintCell(QPainter &painter, const int x, const int y, const int width, const int height, const int row, const int column, const DrawComponent drawComponent);
 
     void updateVisibleRange();
+    QRect exposedCells(const QRect &area);
 };
 
 #endif // FASTTABLEWIDGET_H
@@ -0,0 +1,533 @@
+#include "mappedcsvfile.h"
+
+#include <string.h>
+
+#include "fastdefines.h"
+
+MappedCsvIndexThread::MappedCsvIndexThread(MappedCsvFile *file) :
+    QThread()
+{
+    mFile=file;
+}
+
+void MappedCsvIndexThread::run()
+{
+    mFile->buildIndex();
+}
+
+//------------------------------------------------------------------------------
+
+static inline char asciiLower(const char value)
+{
+    return value>='A' && value<='Z' ? value+('a'-'A') : value;
+}
+
+static bool isAscii(const char *data, const int length)
+{
+    for (int i=0; i<length; ++i)
+    {
+        if ((uchar)data[i]>=0x80)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// ASCII bytes never appear inside UTF-8 sequences, so ASCII pattern is searched without decoding
+static bool containsAscii(const char *data, const int length, const QByteArray &pattern, const Qt::CaseSensitivity sensitivity)
+{
+    if (sensitivity==Qt::CaseSensitive)
+    {
+        return QByteArray::fromRawData(data, length).indexOf(pattern)>=0;
+    }
+
+    int aPatternLength=pattern.length();
+
+    for (int i=0; i+aPatternLength<=length; ++i)
+    {
+        int j=0;
+
+        while (j<aPatternLength && asciiLower(data[i+j])==pattern.at(j))
+        {
+            ++j;
+        }
+
+        if (j==aPatternLength)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+MappedCsvFile::MappedCsvFile(QObject *parent) :
+    QObject(parent)
+{
+    mData=0;
+    mSize=0;
+    mStart=0;
+    mDelimiter=',';
+
+    mColumnCount=0;
+    mProgress=0;
+    mIndexing=false;
+
+    mLastRow=-1;
+    mLastSearchRow=-1;
+    mLastSearchSensitivity=Qt::CaseInsensitive;
+    mLastSearchResult=false;
+
+    mIndexedColumnCount=0;
+    mIndexedBytes=0;
+    mIndexedAll=false;
+    mStopped=false;
+
+    mThread=new MappedCsvIndexThread(this);
+}
+
+MappedCsvFile::~MappedCsvFile()
+{
+    close();
+
+    delete mThread;
+}
+
+bool MappedCsvFile::open(const QString &fileName, const char delimiter)
+{
+    close();
+
+    mFile.setFileName(fileName);
+
+    if (!mFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    mSize=mFile.size();
+    mDelimiter=delimiter;
+
+    if (mSize>0)
+    {
+        mData=(const char *)mFile.map(0, mSize);
+
+        if (mData==0)
+        {
+            mFile.close();
+            mSize=0;
+
+            return false;
+        }
+
+        // UTF-8 byte order mark is not a part of the first cell
+        if (mSize>=3 && memcmp(mData, "\xEF\xBB\xBF", 3)==0)
+        {
+            mStart=3;
+        }
+    }
+
+    mIndexing=true;
+
+    {
+        QMutexLocker aLocker(&mMutex);
+
+        mStopped=false;
+    }
+
+    mThread->start();
+
+    return true;
+}
+
+void MappedCsvFile::close()
+{
+    {
+        QMutexLocker aLocker(&mMutex);
+
+        mStopped=true;
+        mIndexedRowEnds.clear();
+        mIndexedColumnCount=0;
+        mIndexedBytes=0;
+        mIndexedAll=false;
+    }
+
+    mThread->wait();
+
+    bool aWasOpen=mFile.isOpen();
+
+    if (mData)
+    {
+        mFile.unmap((uchar *)mData);
+        mData=0;
+    }
+
+    mFile.close();
+
+    mSize=0;
+    mStart=0;
+
+    mRowEnds.clear();
+    mColumnCount=0;
+    mProgress=0;
+    mIndexing=false;
+
+    mLastRow=-1;
+    mLastRowTexts.clear();
+    mLastSearchRow=-1;
+
+    if (aWasOpen)
+    {
+        emit rowsIndexed(0, 0);
+    }
+}
+
+bool MappedCsvFile::isOpen() const
+{
+    return mFile.isOpen();
+}
+
+QString MappedCsvFile::fileName() const
+{
+    return mFile.fileName();
+}
+
+char MappedCsvFile::delimiter() const
+{
+    return mDelimiter;
+}
+
+bool MappedCsvFile::isIndexing() const
+{
+    return mIndexing;
+}
+
+int MappedCsvFile::progress() const
+{
+    return mProgress;
+}
+
+int MappedCsvFile::rowCount() const
+{
+    return mRowEnds.size();
+}
+
+int MappedCsvFile::columnCount() const
+{
+    return mColumnCount;
+}
+
+QStringList MappedCsvFile::rowTexts(const int row)
+{
+    // Cells are requested row by row, so the row is parsed once
+    if (row!=mLastRow)
+    {
+        const char *aData;
+        int aLength;
+
+        record(row, aData, aLength);
+
+        mLastRowTexts=parseRecord(aData, aLength, mDelimiter);
+        mLastRow=row;
+    }
+
+    return mLastRowTexts;
+}
+
+QString MappedCsvFile::text(const int row, const int column)
+{
+    FASTTABLE_ASSERT(column>=0);
+
+    if (row!=mLastRow)
+    {
+        rowTexts(row);
+    }
+
+    return column<mLastRowTexts.length() ? mLastRowTexts.at(column) : QString();
+}
+
+bool MappedCsvFile::rowMayContain(const int row, const QString &pattern, const Qt::CaseSensitivity sensitivity)
+{
+    if (row<0 || row>=mRowEnds.size())
+    {
+        return false;
+    }
+
+    if (row==mLastSearchRow && sensitivity==mLastSearchSensitivity && pattern==mLastSearchPattern)
+    {
+        return mLastSearchResult;
+    }
+
+    const char *aData;
+    int aLength;
+
+    record(row, aData, aLength);
+
+    bool aAscii=true;
+
+    for (int i=0; i<pattern.length(); ++i)
+    {
+        if (pattern.at(i).unicode()>=0x80)
+        {
+            aAscii=false;
+            break;
+        }
+    }
+
+    bool res;
+
+    if (pattern.contains('"'))
+    {
+        // Quotes are doubled in the file, so the row couldn't be skipped
+        res=true;
+    }
+    else
+    if (aAscii && (sensitivity==Qt::CaseSensitive || isAscii(aData, aLength)))
+    {
+        // Non-ASCII characters could fold to ASCII ones (KELVIN SIGN to 'k'), so such rows are decoded below
+        QByteArray aPattern=pattern.toLatin1();
+
+        if (sensitivity==Qt::CaseInsensitive)
+        {
+            for (int i=0; i<aPattern.length(); ++i)
+            {
+                aPattern[i]=asciiLower(aPattern.at(i));
+            }
+        }
+
+        res=containsAscii(aData, aLength, aPattern, sensitivity);
+    }
+    else
+    {
+        res=QString::fromUtf8(aData, aLength).contains(pattern, sensitivity);
+    }
+
+    mLastSearchRow=row;
+    mLastSearchPattern=pattern;
+    mLastSearchSensitivity=sensitivity;
+    mLastSearchResult=res;
+
+    return res;
+}
+
+QStringList MappedCsvFile::parseRecord(const char *data, const int length, const char delimiter)
+{
+    QStringList res;
+    QByteArray aField;
+    bool aBuffered=false;
+    bool aQuoted=false;
+    int aFieldStart=0;
+
+    for (int i=0; i<length; ++i)
+    {
+        char aChar=data[i];
+
+        if (aQuoted)
+        {
+            if (aChar!='"')
+            {
+                aField.append(aChar);
+            }
+            else
+            if (i+1<length && data[i+1]=='"')
+            {
+                // Doubled quote is a quote inside the field
+                aField.append('"');
+                ++i;
+            }
+            else
+            {
+                aQuoted=false;
+            }
+        }
+        else
+        if (aChar=='"')
+        {
+            // Only quoted fields are copied before decoding
+            if (!aBuffered)
+            {
+                aField=QByteArray(data+aFieldStart, i-aFieldStart);
+                aBuffered=true;
+            }
+
+            aQuoted=true;
+        }
+        else
+        if (aChar==delimiter)
+        {
+            res.append(aBuffered ? QString::fromUtf8(aField) : QString::fromUtf8(data+aFieldStart, i-aFieldStart));
+
+            aField.clear();
+            aBuffered=false;
+            aFieldStart=i+1;
+        }
+        else
+        if (aBuffered)
+        {
+            aField.append(aChar);
+        }
+    }
+
+    res.append(aBuffered ? QString::fromUtf8(aField) : QString::fromUtf8(data+aFieldStart, length-aFieldStart));
+
+    return res;
+}
+
+void MappedCsvFile::buildIndex()
+{
+    QVector<qint64> aRowEnds;
+    int aColumnCount=0;
+    int aFields=1;
+    int aChunkSize=1024;
+    bool aQuoted=false;
+    qint64 aRowStart=mStart;
+
+    for (qint64 i=mStart; i<mSize; ++i)
+    {
+        // Long rows don't delay stopping
+        if ((i & 0xFFFFFF)==0)
+        {
+            QMutexLocker aLocker(&mMutex);
+
+            if (mStopped)
+            {
+                return;
+            }
+        }
+
+        char aChar=mData[i];
+
+        if (aChar=='"')
+        {
+            // Doubled quote inside the field toggles the state twice
+            aQuoted=!aQuoted;
+        }
+        else
+        if (!aQuoted)
+        {
+            if (aChar==mDelimiter)
+            {
+                aFields++;
+            }
+            else
+            if (aChar=='\n')
+            {
+                aRowEnds.append(i+1);
+                aColumnCount=qMax(aColumnCount, aFields);
+                aFields=1;
+                aRowStart=i+1;
+
+                if (aRowEnds.size()>=aChunkSize)
+                {
+                    if (!publishIndex(aRowEnds, aColumnCount, i+1, false))
+                    {
+                        return;
+                    }
+
+                    aRowEnds.clear();
+
+                    // First rows are shown soon, then chunks grow to reduce overhead
+                    aChunkSize=qMin(aChunkSize*2, 65536);
+                }
+            }
+        }
+    }
+
+    // The last row could have no line break
+    if (aRowStart<mSize)
+    {
+        aRowEnds.append(mSize);
+        aColumnCount=qMax(aColumnCount, aFields);
+    }
+
+    publishIndex(aRowEnds, aColumnCount, mSize, true);
+}
+
+bool MappedCsvFile::publishIndex(const QVector<qint64> &rowEnds, const int columnCount, const qint64 bytes, const bool finished)
+{
+    QMutexLocker aLocker(&mMutex);
+
+    if (mStopped)
+    {
+        return false;
+    }
+
+    mIndexedRowEnds+=rowEnds;
+    mIndexedColumnCount=qMax(mIndexedColumnCount, columnCount);
+    mIndexedBytes=bytes;
+    mIndexedAll=finished;
+
+    QMetaObject::invokeMethod(this, "takeIndexedRows", Qt::QueuedConnection);
+
+    return true;
+}
+
+void MappedCsvFile::record(const int row, const char *&data, int &length) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowEnds.size());
+
+    qint64 aStart=row>0 ? mRowEnds.at(row-1) : mStart;
+    qint64 aEnd=mRowEnds.at(row);
+
+    // Line break is not a part of the row
+    if (aEnd>aStart && mData[aEnd-1]=='\n')
+    {
+        aEnd--;
+    }
+
+    if (aEnd>aStart && mData[aEnd-1]=='\r')
+    {
+        aEnd--;
+    }
+
+    FASTTABLE_ASSERT(aEnd-aStart<=0x7FFFFFFF);
+
+    data=mData+aStart;
+    length=(int)(aEnd-aStart);
+}
+
+void MappedCsvFile::takeIndexedRows()
+{
+    QVector<qint64> aRowEnds;
+    int aColumnCount;
+    qint64 aBytes;
+    bool aFinished;
+
+    {
+        QMutexLocker aLocker(&mMutex);
+
+        qSwap(aRowEnds, mIndexedRowEnds);
+        aColumnCount=mIndexedColumnCount;
+        aBytes=mIndexedBytes;
+        aFinished=mIndexedAll;
+    }
+
+    // Call could be queued before close()
+    if (!mIndexing)
+    {
+        return;
+    }
+
+    if (!aRowEnds.isEmpty() || aColumnCount>mColumnCount)
+    {
+        mRowEnds+=aRowEnds;
+        mColumnCount=qMax(mColumnCount, aColumnCount);
+
+        emit rowsIndexed(mRowEnds.size(), mColumnCount);
+    }
+
+    int aProgress=mSize>0 ? (int)(aBytes*100/mSize) : 100;
+
+    if (aProgress!=mProgress)
+    {
+        mProgress=aProgress;
+        emit indexingProgress(mProgress);
+    }
+
+    if (aFinished)
+    {
+        mIndexing=false;
+        emit indexingFinished();
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef MAPPEDCSVFILE_H
+#define MAPPEDCSVFILE_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QFile>
+#include <QVector>
+#include <QStringList>
+
+class MappedCsvFile;
+
+class MappedCsvIndexThread : public QThread
+{
+public:
+    MappedCsvIndexThread(MappedCsvFile *file);
+
+protected:
+    MappedCsvFile *mFile;
+
+    void run();
+};
+
+// Read-only CSV/TSV file mapped into memory, so cell texts are never copied into the table.
+// Row offsets are found in worker thread and reported with rowsIndexed() in GUI thread, so row count grows while indexing.
+// Fields follow RFC 4180 quoting and are decoded from UTF-8 only when requested.
+class MappedCsvFile : public QObject
+{
+    Q_OBJECT
+public:
+    explicit MappedCsvFile(QObject *parent=0);
+    ~MappedCsvFile();
+
+    bool open(const QString &fileName, const char delimiter=',');
+    void close();
+
+    bool    isOpen() const;
+    QString fileName() const;
+    char    delimiter() const;
+
+    bool isIndexing() const;
+    int  progress() const;
+
+    int rowCount() const;
+    int columnCount() const;
+
+    QStringList rowTexts(const int row);
+    QString     text(const int row, const int column);
+    bool        rowMayContain(const int row, const QString &pattern, const Qt::CaseSensitivity sensitivity=Qt::CaseInsensitive);
+
+    static QStringList parseRecord(const char *data, const int length, const char delimiter);
+
+protected:
+    friend class MappedCsvIndexThread;
+
+    QFile       mFile;
+    const char *mData;
+    qint64      mSize;
+    qint64      mStart;
+    char        mDelimiter;
+
+    // Used only in GUI thread. Offset after the end of every row
+    QVector<qint64> mRowEnds;
+    int             mColumnCount;
+    int             mProgress;
+    bool            mIndexing;
+
+    int         mLastRow;
+    QStringList mLastRowTexts;
+
+    int                 mLastSearchRow;
+    QString             mLastSearchPattern;
+    Qt::CaseSensitivity mLastSearchSensitivity;
+    bool                mLastSearchResult;
+
+    // Shared with worker thread
+    QMutex          mMutex;
+    QVector<qint64> mIndexedRowEnds;
+    int             mIndexedColumnCount;
+    qint64          mIndexedBytes;
+    bool            mIndexedAll;
+    bool            mStopped;
+
+    MappedCsvIndexThread *mThread;
+
+    void buildIndex();
+    bool publishIndex(const QVector<qint64> &rowEnds, const int columnCount, const qint64 bytes, const bool finished);
+    void record(const int row, const char *&data, int &length) const;
+
+protected slots:
+    void takeIndexedRows();
+
+signals:
+    void rowsIndexed(int rowCount, int columnCount);
+    void indexingProgress(int percent);
+    void indexingFinished();
+};
+
+#endif // MAPPEDCSVFILE_H
@@ -0,0 +1,252 @@
+#include "offsetindex.h"
+
+#include "fastdefines.h"
+
+OffsetIndex::OffsetIndex(const SizeList *sizes)
+{
+    mSizes=sizes;
+    mValid=false;
+    mBase=0;
+    mRebuildCount=0;
+}
+
+void OffsetIndex::clear()
+{
+    mTree.clear();
+    mTree.squeeze();
+
+    mValid=false;
+    mBase=0;
+}
+
+void OffsetIndex::invalidate()
+{
+    mValid=false;
+}
+
+int OffsetIndex::base() const
+{
+    return mBase;
+}
+
+void OffsetIndex::setBase(const int base)
+{
+    mBase=base;
+}
+
+void OffsetIndex::sizeInserted(const int index)
+{
+    sizesInserted(index, 1);
+}
+
+void OffsetIndex::sizeRemoved(const int index)
+{
+    sizesRemoved(index, 1);
+}
+
+void OffsetIndex::sizesInserted(const int index, const int count)
+{
+    FASTTABLE_ASSERT(index>=0 && count>=0 && index+count<=mSizes->length());
+
+    if (!mValid)
+    {
+        return;
+    }
+
+    // Appending keeps all existing nodes valid, so only the new nodes are computed
+    if (index==mTree.size()-1)
+    {
+        for (int i=index; i<index+count; ++i)
+        {
+            int aNode=i+1;
+            int aSize=mSizes->at(i);
+
+            if (aSize<0)
+            {
+                aSize=0;
+            }
+
+            mTree.append(aSize+prefixSum(aNode-1)-prefixSum(aNode-(aNode & -aNode)));
+        }
+    }
+    else
+    {
+        mValid=false;
+    }
+}
+
+void OffsetIndex::sizesRemoved(const int index, const int count)
+{
+    FASTTABLE_ASSERT(index>=0 && count>=0 && index<=mSizes->length());
+
+    if (!mValid)
+    {
+        return;
+    }
+
+    // Removing last nodes doesn't affect others
+    if (index+count==mTree.size()-1)
+    {
+        mTree.resize(index+1);
+    }
+    else
+    {
+        mValid=false;
+    }
+}
+
+void OffsetIndex::sizeChanged(const int index, const int diff)
+{
+    FASTTABLE_ASSERT(index>=0 && index<mSizes->length());
+
+    if (!mValid || diff==0)
+    {
+        return;
+    }
+
+    int aCount=mTree.size()-1;
+
+    for (int i=index+1; i<=aCount; i+=(i & -i))
+    {
+        mTree[i]+=diff;
+
+        FASTTABLE_ASSERT(mTree.at(i)>=0);
+    }
+}
+
+int OffsetIndex::at(const int index) const
+{
+    FASTTABLE_ASSERT(index>=0 && index<mSizes->length());
+
+    if (mSizes->isUniform())
+    {
+        return mSizes->uniformSize()>0? mBase+index*mSizes->uniformSize() : mBase;
+    }
+
+    if (!mValid)
+    {
+        rebuild();
+    }
+
+    return mBase+prefixSum(index);
+}
+
+int OffsetIndex::indexAt(const int position) const
+{
+    int aCount=mSizes->length();
+
+    if (aCount<=0)
+    {
+        return -1;
+    }
+
+    if (mSizes->isUniform())
+    {
+        int aSize=mSizes->uniformSize();
+
+        if (aSize<=0)
+        {
+            return aCount-1;
+        }
+
+        if (position<mBase)
+        {
+            return 0;
+        }
+
+        int res=(position-mBase)/aSize;
+
+        return res<aCount? res : aCount-1;
+    }
+
+    if (!mValid)
+    {
+        rebuild();
+    }
+
+    int aStep=1;
+
+    while ((aStep<<1)<=aCount)
+    {
+        aStep<<=1;
+    }
+
+    // Find the last node which prefix sum is not greater than position
+    int aIndex=0;
+    int aRemaining=position-mBase;
+
+    for (; aStep>0; aStep>>=1)
+    {
+        if (aIndex+aStep<=aCount && mTree.at(aIndex+aStep)<=aRemaining)
+        {
+            aIndex+=aStep;
+            aRemaining-=mTree.at(aIndex);
+        }
+    }
+
+    if (aIndex>=aCount)
+    {
+        return aCount-1;
+    }
+
+    return aIndex;
+}
+
+int OffsetIndex::length() const
+{
+    return mSizes->length();
+}
+
+int OffsetIndex::size() const
+{
+    return mSizes->length();
+}
+
+int OffsetIndex::count() const
+{
+    return mSizes->length();
+}
+
+int OffsetIndex::rebuildCount() const
+{
+    return mRebuildCount;
+}
+
+void OffsetIndex::rebuild() const
+{
+    int aCount=mSizes->length();
+
+    mTree.resize(aCount+1);
+    mTree[0]=0;
+
+    for (int i=0; i<aCount; ++i)
+    {
+        int aSize=mSizes->at(i);
+        mTree[i+1]=aSize>0? aSize : 0;
+    }
+
+    for (int i=1; i<=aCount; ++i)
+    {
+        int aParent=i+(i & -i);
+
+        if (aParent<=aCount)
+        {
+            mTree[aParent]+=mTree.at(i);
+        }
+    }
+
+    mValid=true;
+    mRebuildCount++;
+}
+
+int OffsetIndex::prefixSum(int index) const
+{
+    int res=0;
+
+    for (; index>0; index-=(index & -index))
+    {
+        res+=mTree.at(index);
+    }
+
+    return res;
+}
@@ -0,0 +1,48 @@
+#ifndef OFFSETINDEX_H
+#define OFFSETINDEX_H
+
+#include <QVector>
+
+#include "sizelist.h"
+
+// Prefix sums of row heights (or column widths) stored as Fenwick tree.
+// Hidden sections have negative size and are counted as zero.
+// While sizes are uniform offsets are calculated directly and the tree is not allocated.
+class OffsetIndex
+{
+public:
+    OffsetIndex(const SizeList *sizes);
+
+    void clear();
+    void invalidate();
+
+    int  base() const;
+    void setBase(const int base);
+
+    void sizeInserted(const int index);
+    void sizeRemoved(const int index);
+    void sizesInserted(const int index, const int count);
+    void sizesRemoved(const int index, const int count);
+    void sizeChanged(const int index, const int diff);
+
+    int at(const int index) const;
+    int indexAt(const int position) const;
+
+    int length() const;
+    int size() const;
+    int count() const;
+
+    int rebuildCount() const;
+
+protected:
+    const SizeList      *mSizes;
+    mutable QVector<int> mTree;
+    mutable bool         mValid;
+    mutable int          mRebuildCount;
+    int                  mBase;
+
+    void rebuild() const;
+    int  prefixSum(int index) const;
+};
+
+#endif // OFFSETINDEX_H
@@ -0,0 +1,14 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2012-05-04T17:08:42
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES +=  $$PWD/offsetindex.cpp \
+            $$PWD/sizelist.cpp
+
+HEADERS  += $$PWD/offsetindex.h \
+            $$PWD/sizelist.h
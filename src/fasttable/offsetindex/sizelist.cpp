@@ -0,0 +1,201 @@
+#include "sizelist.h"
+
+#include "fastdefines.h"
+
+SizeList::SizeList()
+{
+    mCount=0;
+    mUniform=true;
+    mUniformSize=0;
+}
+
+void SizeList::clear()
+{
+    mSizes.clear();
+    mCount=0;
+    mUniform=true;
+    mUniformSize=0;
+}
+
+void SizeList::reserve(const int size)
+{
+    if (!mUniform)
+    {
+        mSizes.reserve(size);
+    }
+}
+
+void SizeList::resize(const int count, const qint16 size)
+{
+    FASTTABLE_ASSERT(count>=0);
+
+    if (count<=mCount)
+    {
+        if (!mUniform)
+        {
+            mSizes.resize(count);
+        }
+
+        mCount=count;
+        return;
+    }
+
+    if (mUniform)
+    {
+        if (mCount==0)
+        {
+            mUniformSize=size;
+        }
+
+        if (size==mUniformSize)
+        {
+            mCount=count;
+            return;
+        }
+
+        detach();
+    }
+
+    mSizes.insert(mCount, count-mCount, size);
+    mCount=count;
+}
+
+void SizeList::insert(const int i, const qint16 size)
+{
+    FASTTABLE_ASSERT(i>=0 && i<=mCount);
+
+    if (mUniform)
+    {
+        if (mCount==0)
+        {
+            mUniformSize=size;
+        }
+
+        if (size==mUniformSize)
+        {
+            mCount++;
+            return;
+        }
+
+        detach();
+    }
+
+    mSizes.insert(i, size);
+    mCount++;
+}
+
+void SizeList::insert(const int i, const int count, const qint16 size)
+{
+    FASTTABLE_ASSERT(i>=0 && i<=mCount);
+    FASTTABLE_ASSERT(count>=0);
+
+    if (mUniform)
+    {
+        if (mCount==0)
+        {
+            mUniformSize=size;
+        }
+
+        if (size==mUniformSize)
+        {
+            mCount+=count;
+            return;
+        }
+
+        detach();
+    }
+
+    mSizes.insert(i, count, size);
+    mCount+=count;
+}
+
+void SizeList::append(const qint16 size)
+{
+    insert(mCount, size);
+}
+
+void SizeList::removeAt(const int i)
+{
+    FASTTABLE_ASSERT(i>=0 && i<mCount);
+
+    if (!mUniform)
+    {
+        mSizes.remove(i);
+    }
+
+    mCount--;
+}
+
+void SizeList::remove(const int i, const int count)
+{
+    FASTTABLE_ASSERT(i>=0 && count>=0 && i+count<=mCount);
+
+    if (!mUniform)
+    {
+        mSizes.remove(i, count);
+    }
+
+    mCount-=count;
+}
+
+void SizeList::replace(const int i, const qint16 size)
+{
+    FASTTABLE_ASSERT(i>=0 && i<mCount);
+
+    if (mUniform)
+    {
+        if (size==mUniformSize)
+        {
+            return;
+        }
+
+        detach();
+    }
+
+    mSizes[i]=size;
+}
+
+qint16 SizeList::at(const int i) const
+{
+    FASTTABLE_ASSERT(i>=0 && i<mCount);
+
+    if (mUniform)
+    {
+        return mUniformSize;
+    }
+
+    return mSizes.at(i);
+}
+
+int SizeList::length() const
+{
+    return mCount;
+}
+
+int SizeList::size() const
+{
+    return mCount;
+}
+
+int SizeList::count() const
+{
+    return mCount;
+}
+
+bool SizeList::isUniform() const
+{
+    return mUniform;
+}
+
+qint16 SizeList::uniformSize() const
+{
+    return mUniformSize;
+}
+
+void SizeList::detach()
+{
+    FASTTABLE_ASSERT(mUniform);
+
+    mSizes.fill(mUniformSize, mCount);
+    mUniform=false;
+}
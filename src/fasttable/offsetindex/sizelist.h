@@ -0,0 +1,43 @@
+#ifndef SIZELIST_H
+#define SIZELIST_H
+
+#include <QVector>
+
+// List of row heights (or column widths).
+// While all sizes are equal only the count is stored, per-item storage is created on first deviation.
+// Sizes are stored contiguously, so block inserts and removals are single moves.
+class SizeList
+{
+public:
+    SizeList();
+
+    void clear();
+    void reserve(const int size);
+    void resize(const int count, const qint16 size);
+
+    void insert(const int i, const qint16 size);
+    void insert(const int i, const int count, const qint16 size);
+    void append(const qint16 size);
+    void removeAt(const int i);
+    void remove(const int i, const int count);
+    void replace(const int i, const qint16 size);
+
+    qint16 at(const int i) const;
+
+    int length() const;
+    int size() const;
+    int count() const;
+
+    bool isUniform() const;
+    qint16 uniformSize() const;
+
+protected:
+    QVector<qint16> mSizes;
+    int             mCount;
+    bool            mUniform;
+    qint16          mUniformSize;
+
+    void detach();
+};
+
+#endif // SIZELIST_H
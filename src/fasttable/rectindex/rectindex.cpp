@@ -0,0 +1,215 @@
+#include "rectindex.h"
+
+#include <QtAlgorithms>
+#include <QPair>
+
+#include "fastdefines.h"
+
+RectIndex::RectIndex()
+{
+    mValid=false;
+}
+
+void RectIndex::clear()
+{
+    mValid=false;
+    mBands.clear();
+    mNodes.clear();
+}
+
+void RectIndex::build(const QList<QRect> &rects)
+{
+    // Bands are rows between neighbour rectangle edges, every leaf of the tree is a band
+    QList<int> aBounds;
+    aBounds.reserve(rects.length()*2);
+
+    for (int i=0; i<rects.length(); ++i)
+    {
+        aBounds.append(rects.at(i).top());
+        aBounds.append(rects.at(i).bottom()+1);
+    }
+
+    qSort(aBounds);
+
+    mBands.clear();
+
+    for (int i=0; i<aBounds.length(); ++i)
+    {
+        if (mBands.isEmpty() || mBands.last()!=aBounds.at(i))
+        {
+            mBands.append(aBounds.at(i));
+        }
+    }
+
+    int aLeafCount=mBands.length()-1;
+
+    mNodes.clear();
+
+    for (int i=0; i<aLeafCount*2; ++i)
+    {
+        mNodes.append(QList<int>());
+    }
+
+    // Rectangles are added in column order, so every node stays sorted by column
+    QList< QPair<int, int> > aOrder;
+    aOrder.reserve(rects.length());
+
+    for (int i=0; i<rects.length(); ++i)
+    {
+        aOrder.append(qMakePair(rects.at(i).left(), i));
+    }
+
+    qSort(aOrder);
+
+    for (int i=0; i<aOrder.length(); ++i)
+    {
+        int aIndex=aOrder.at(i).second;
+        const QRect &aRect=rects.at(aIndex);
+
+        int aFirst=qLowerBound(mBands.begin(), mBands.end(), aRect.top())-mBands.begin()+aLeafCount;
+        int aLast=qLowerBound(mBands.begin(), mBands.end(), aRect.bottom()+1)-mBands.begin()+aLeafCount;
+
+        while (aFirst<aLast)
+        {
+            if (aFirst & 1)
+            {
+                mNodes[aFirst].append(aIndex);
+                aFirst++;
+            }
+
+            if (aLast & 1)
+            {
+                aLast--;
+                mNodes[aLast].append(aIndex);
+            }
+
+            aFirst>>=1;
+            aLast>>=1;
+        }
+    }
+
+    mValid=true;
+}
+
+bool RectIndex::isValid() const
+{
+    return mValid;
+}
+
+int RectIndex::indexAt(const QList<QRect> &rects, const int row, const int column) const
+{
+    FASTTABLE_ASSERT(mValid || rects.isEmpty());
+
+    if (rects.isEmpty())
+    {
+        return -1;
+    }
+
+    int aLeafCount=mBands.length()-1;
+    int aBand=qUpperBound(mBands.begin(), mBands.end(), row)-mBands.begin()-1;
+
+    if (aBand<0 || aBand>=aLeafCount)
+    {
+        return -1;
+    }
+
+    // Rectangles of all nodes on the path contain the row, so they don't overlap by columns
+    for (int aNode=aBand+aLeafCount; aNode>=1; aNode>>=1)
+    {
+        const QList<int> &aRects=mNodes.at(aNode);
+
+        int aLow=0;
+        int aHigh=aRects.length();
+
+        while (aLow<aHigh)
+        {
+            int aMiddle=(aLow+aHigh)>>1;
+
+            if (rects.at(aRects.at(aMiddle)).left()<=column)
+            {
+                aLow=aMiddle+1;
+            }
+            else
+            {
+                aHigh=aMiddle;
+            }
+        }
+
+        if (aLow>0 && rects.at(aRects.at(aLow-1)).right()>=column)
+        {
+            return aRects.at(aLow-1);
+        }
+    }
+
+    return -1;
+}
+
+QList<int> RectIndex::indexesIn(const QList<QRect> &rects, const QRect &area) const
+{
+    FASTTABLE_ASSERT(mValid || rects.isEmpty());
+
+    QList<int> res;
+
+    if (rects.isEmpty() || area.isEmpty())
+    {
+        return res;
+    }
+
+    int aLeafCount=mBands.length()-1;
+    int aFirst=qUpperBound(mBands.begin(), mBands.end(), area.top())-mBands.begin()-1;
+    int aLast=qUpperBound(mBands.begin(), mBands.end(), area.bottom())-mBands.begin()-1;
+
+    aFirst=qMax(aFirst, 0);
+    aLast=qMin(aLast, aLeafCount-1);
+
+    if (aFirst>aLast)
+    {
+        return res;
+    }
+
+    // Only bands inside the area and their ancestors are visited
+    QList<int> aFound;
+
+    for (aFirst+=aLeafCount, aLast+=aLeafCount; aFirst>=1; aFirst>>=1, aLast>>=1)
+    {
+        for (int i=aFirst; i<=aLast; ++i)
+        {
+            const QList<int> &aRects=mNodes.at(i);
+
+            int aLow=0;
+            int aHigh=aRects.length();
+
+            while (aLow<aHigh)
+            {
+                int aMiddle=(aLow+aHigh)>>1;
+
+                if (rects.at(aRects.at(aMiddle)).right()<area.left())
+                {
+                    aLow=aMiddle+1;
+                }
+                else
+                {
+                    aHigh=aMiddle;
+                }
+            }
+
+            for (; aLow<aRects.length() && rects.at(aRects.at(aLow)).left()<=area.right(); ++aLow)
+            {
+                aFound.append(aRects.at(aLow));
+            }
+        }
+    }
+
+    // Rectangle could be stored in several nodes
+    qSort(aFound);
+
+    for (int i=0; i<aFound.length(); ++i)
+    {
+        if (i==0 || aFound.at(i)!=aFound.at(i-1))
+        {
+            res.append(aFound.at(i));
+        }
+    }
+
+    return res;
+}
@@ -0,0 +1,29 @@
+#ifndef RECTINDEX_H
+#define RECTINDEX_H
+
+#include <QList>
+#include <QRect>
+
+// Lookup index for a list of disjoint rectangles (x is column, y is row).
+// Segment tree over row bands, each node keeps its rectangles ordered by column.
+// Index doesn't own the list. It should be cleared when the list is modified and rebuilt before next lookup.
+class RectIndex
+{
+public:
+    RectIndex();
+
+    void clear();
+    void build(const QList<QRect> &rects);
+
+    bool isValid() const;
+
+    int        indexAt(const QList<QRect> &rects, const int row, const int column) const;
+    QList<int> indexesIn(const QList<QRect> &rects, const QRect &area) const;
+
+protected:
+    bool                mValid;
+    QList<int>          mBands;
+    QList< QList<int> > mNodes;
+};
+
+#endif // RECTINDEX_H
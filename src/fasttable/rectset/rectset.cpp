@@ -0,0 +1,238 @@
+#include "rectset.h"
+
+#include "fastdefines.h"
+
+// Rectangles are disjoint, so top left cell is a unique key in reading order
+static qint64 readingKey(const QRect &rect)
+{
+    return (((qint64)rect.top())<<32) | ((quint32)rect.left());
+}
+
+RectSet::RectSet()
+{
+    mRowCount=0;
+    mLeafCount=1;
+}
+
+void RectSet::clear()
+{
+    mRects.clear();
+    mNodes.clear();
+    mNodeCounts.clear();
+}
+
+void RectSet::reset(const int rowCount)
+{
+    FASTTABLE_ASSERT(rowCount>=0);
+
+    clear();
+
+    mRowCount=rowCount;
+    mLeafCount=1;
+
+    while (mLeafCount<mRowCount)
+    {
+        mLeafCount<<=1;
+    }
+}
+
+void RectSet::insert(const QRect &rect)
+{
+    FASTTABLE_ASSERT(!rect.isEmpty());
+    FASTTABLE_ASSERT(rect.top()>=0 && rect.bottom()<mRowCount);
+    FASTTABLE_ASSERT(!mRects.contains(readingKey(rect)));
+
+    mRects.insert(readingKey(rect), rect);
+    update(1, 0, mLeafCount-1, rect, true);
+}
+
+void RectSet::remove(const QRect &rect)
+{
+    FASTTABLE_ASSERT(mRects.value(readingKey(rect))==rect);
+
+    mRects.remove(readingKey(rect));
+    update(1, 0, mLeafCount-1, rect, false);
+}
+
+bool RectSet::isEmpty() const
+{
+    return mRects.isEmpty();
+}
+
+int RectSet::count() const
+{
+    return mRects.count();
+}
+
+QRect RectSet::rectAt(const int row, const int column) const
+{
+    if (row<0 || row>=mRowCount)
+    {
+        return QRect();
+    }
+
+    int aNode=1;
+    int aLow=0;
+    int aHigh=mLeafCount-1;
+
+    // Rectangles of all nodes on the path contain the row, so they don't overlap by columns
+    while (mNodeCounts.contains(aNode))
+    {
+        QHash<int, QMap<int, QRect> >::const_iterator aFound=mNodes.constFind(aNode);
+
+        if (aFound!=mNodes.constEnd())
+        {
+            QMap<int, QRect>::const_iterator aNext=aFound.value().upperBound(column);
+
+            if (aNext!=aFound.value().constBegin())
+            {
+                --aNext;
+
+                if (aNext.value().right()>=column)
+                {
+                    return aNext.value();
+                }
+            }
+        }
+
+        if (aLow==aHigh)
+        {
+            break;
+        }
+
+        int aMiddle=(aLow+aHigh)>>1;
+
+        if (row<=aMiddle)
+        {
+            aNode=aNode*2;
+            aHigh=aMiddle;
+        }
+        else
+        {
+            aNode=aNode*2+1;
+            aLow=aMiddle+1;
+        }
+    }
+
+    return QRect();
+}
+
+QList<QRect> RectSet::rectsIn(const QRect &area) const
+{
+    QList<QRect> res;
+
+    if (!area.isEmpty() && !mRects.isEmpty())
+    {
+        collect(1, 0, mLeafCount-1, area, res);
+    }
+
+    return res;
+}
+
+QList<QRect> RectSet::rects() const
+{
+    return mRects.values();
+}
+
+int RectSet::rowCount() const
+{
+    return mRowCount;
+}
+
+int RectSet::update(const int node, const int low, const int high, const QRect &rect, const bool add)
+{
+    // Returns how many nodes of the subtree got or lost the rectangle
+    int res=0;
+
+    if (rect.top()<=low && high<=rect.bottom())
+    {
+        QMap<int, QRect> &aRects=mNodes[node];
+
+        if (add)
+        {
+            aRects.insert(rect.left(), rect);
+        }
+        else
+        {
+            aRects.remove(rect.left());
+        }
+
+        if (aRects.isEmpty())
+        {
+            mNodes.remove(node);
+        }
+
+        res=add? 1 : -1;
+    }
+    else
+    {
+        int aMiddle=(low+high)>>1;
+
+        if (rect.top()<=aMiddle)
+        {
+            res+=update(node*2, low, aMiddle, rect, add);
+        }
+
+        if (rect.bottom()>aMiddle)
+        {
+            res+=update(node*2+1, aMiddle+1, high, rect, add);
+        }
+    }
+
+    int &aCount=mNodeCounts[node];
+    aCount+=res;
+
+    if (aCount==0)
+    {
+        mNodeCounts.remove(node);
+    }
+
+    return res;
+}
+
+void RectSet::collect(const int node, const int low, const int high, const QRect &area, QList<QRect> &res) const
+{
+    if (high<area.top() || low>area.bottom() || !mNodeCounts.contains(node))
+    {
+        return;
+    }
+
+    QHash<int, QMap<int, QRect> >::const_iterator aFound=mNodes.constFind(node);
+
+    if (aFound!=mNodes.constEnd())
+    {
+        const QMap<int, QRect> &aRects=aFound.value();
+        QMap<int, QRect>::const_iterator aIterator=aRects.upperBound(area.left());
+
+        if (aIterator!=aRects.constBegin())
+        {
+            --aIterator;
+        }
+
+        for (; aIterator!=aRects.constEnd() && aIterator.key()<=area.right(); ++aIterator)
+        {
+            const QRect &aRect=aIterator.value();
+
+            if (aRect.right()<area.left())
+            {
+                continue;
+            }
+
+            // Rectangle is stored in several nodes, it is reported by the node with its first row in the area
+            int aRow=qMax(aRect.top(), area.top());
+
+            if (aRow>=low && aRow<=high)
+            {
+                res.append(aRect);
+            }
+        }
+    }
+
+    if (low<high)
+    {
+        int aMiddle=(low+high)>>1;
+
+        collect(node*2, low, aMiddle, area, res);
+        collect(node*2+1, aMiddle+1, high, area, res);
+    }
+}
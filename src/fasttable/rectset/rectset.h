@@ -0,0 +1,42 @@
+#ifndef RECTSET_H
+#define RECTSET_H
+
+#include <QHash>
+#include <QMap>
+#include <QRect>
+
+// Set of disjoint rectangles (x is column, y is row) with lookups by cell and by area.
+// Segment tree over rows, every rectangle is stored in nodes covering its rows and ordered by column there.
+// Only nodes with rectangles are allocated, so inserting and removing take O(log(rows)*log(n)).
+class RectSet
+{
+public:
+    RectSet();
+
+    void clear();
+    void reset(const int rowCount);
+
+    void insert(const QRect &rect);
+    void remove(const QRect &rect);
+
+    bool isEmpty() const;
+    int  count() const;
+
+    QRect        rectAt(const int row, const int column) const;
+    QList<QRect> rectsIn(const QRect &area) const;
+    QList<QRect> rects() const;
+
+    int rowCount() const;
+
+protected:
+    QMap<qint64, QRect>           mRects;
+    QHash<int, QMap<int, QRect> > mNodes;
+    QHash<int, int>               mNodeCounts;
+    int                           mRowCount;
+    int                           mLeafCount;
+
+    int  update(const int node, const int low, const int high, const QRect &rect, const bool add);
+    void collect(const int node, const int low, const int high, const QRect &area, QList<QRect> &res) const;
+};
+
+#endif // RECTSET_H
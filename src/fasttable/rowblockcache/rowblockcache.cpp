@@ -0,0 +1,287 @@
+#include "rowblockcache.h"
+
+#include "fastdefines.h"
+
+RowBlockCache::RowBlockCache(const int blockSize, const qint64 budget)
+{
+    FASTTABLE_ASSERT(blockSize>0);
+    FASTTABLE_ASSERT(budget>=0);
+
+    mBlockSize=blockSize;
+    mBudget=budget;
+    mUsedBytes=0;
+
+    mFirst=-1;
+    mLast=-1;
+
+    mPinnedFirst=0;
+    mPinnedLast=-1;
+
+    mHits=0;
+    mMisses=0;
+}
+
+void RowBlockCache::clear()
+{
+    mEntries.clear();
+    mUsedBytes=0;
+
+    mFirst=-1;
+    mLast=-1;
+}
+
+int RowBlockCache::blockSize() const
+{
+    return mBlockSize;
+}
+
+qint64 RowBlockCache::budget() const
+{
+    return mBudget;
+}
+
+void RowBlockCache::setBudget(const qint64 budget)
+{
+    FASTTABLE_ASSERT(budget>=0);
+
+    mBudget=budget;
+    evict(-1);
+}
+
+qint64 RowBlockCache::usedBytes() const
+{
+    return mUsedBytes;
+}
+
+int RowBlockCache::count() const
+{
+    return mEntries.count();
+}
+
+bool RowBlockCache::contains(const int block) const
+{
+    return mEntries.contains(block);
+}
+
+bool RowBlockCache::containsRow(const int row) const
+{
+    QHash<int, Entry>::const_iterator aEntry=mEntries.constFind(row/mBlockSize);
+
+    // The last block could have less rows
+    return aEntry!=mEntries.constEnd() && row%mBlockSize<aEntry.value().rows.length();
+}
+
+const QList<QStringList> *RowBlockCache::rows(const int block)
+{
+    QHash<int, Entry>::iterator aEntry=mEntries.find(block);
+
+    if (aEntry==mEntries.end())
+    {
+        mMisses++;
+        return 0;
+    }
+
+    mHits++;
+
+    if (mFirst!=block)
+    {
+        unlink(aEntry.value());
+        linkFirst(block, aEntry.value());
+    }
+
+    return &aEntry.value().rows;
+}
+
+QString RowBlockCache::text(const int row, const int column)
+{
+    const QList<QStringList> *aRows=rows(row/mBlockSize);
+
+    if (aRows==0 || row%mBlockSize>=aRows->length())
+    {
+        return QString();
+    }
+
+    const QStringList &aRow=aRows->at(row%mBlockSize);
+
+    return column<aRow.length() ? aRow.at(column) : QString();
+}
+
+void RowBlockCache::insert(const int block, const QList<QStringList> &rows)
+{
+    FASTTABLE_ASSERT(block>=0);
+    FASTTABLE_ASSERT(rows.length()<=mBlockSize);
+
+    remove(block);
+
+    Entry aEntry;
+    aEntry.rows=rows;
+    aEntry.bytes=rowsBytes(rows);
+
+    QHash<int, Entry>::iterator aInserted=mEntries.insert(block, aEntry);
+    linkFirst(block, aInserted.value());
+
+    mUsedBytes+=aEntry.bytes;
+
+    // New block is kept even if it doesn't fit, otherwise it would be loaded again and again
+    evict(block);
+}
+
+void RowBlockCache::remove(const int block)
+{
+    QHash<int, Entry>::iterator aEntry=mEntries.find(block);
+
+    if (aEntry==mEntries.end())
+    {
+        return;
+    }
+
+    unlink(aEntry.value());
+    mUsedBytes-=aEntry.value().bytes;
+
+    mEntries.erase(aEntry);
+}
+
+void RowBlockCache::removeRows(const int first, const int last)
+{
+    if (first>last || mEntries.isEmpty())
+    {
+        return;
+    }
+
+    int aFirstBlock=qMax(first, 0)/mBlockSize;
+    int aLastBlock=last/mBlockSize;
+
+    if (aLastBlock-aFirstBlock+1<mEntries.count())
+    {
+        for (int i=aFirstBlock; i<=aLastBlock; ++i)
+        {
+            remove(i);
+        }
+    }
+    else
+    {
+        QList<int> aBlocks=mEntries.keys();
+
+        for (int i=0; i<aBlocks.length(); ++i)
+        {
+            if (aBlocks.at(i)>=aFirstBlock && aBlocks.at(i)<=aLastBlock)
+            {
+                remove(aBlocks.at(i));
+            }
+        }
+    }
+}
+
+void RowBlockCache::setPinnedRows(const int first, const int last)
+{
+    if (first>last)
+    {
+        mPinnedFirst=0;
+        mPinnedLast=-1;
+    }
+    else
+    {
+        mPinnedFirst=qMax(first, 0)/mBlockSize;
+        mPinnedLast=last/mBlockSize;
+    }
+
+    evict(-1);
+}
+
+qint64 RowBlockCache::hits() const
+{
+    return mHits;
+}
+
+qint64 RowBlockCache::misses() const
+{
+    return mMisses;
+}
+
+void RowBlockCache::resetCounters()
+{
+    mHits=0;
+    mMisses=0;
+}
+
+void RowBlockCache::unlink(Entry &entry)
+{
+    if (entry.previous>=0)
+    {
+        mEntries[entry.previous].next=entry.next;
+    }
+    else
+    {
+        mFirst=entry.next;
+    }
+
+    if (entry.next>=0)
+    {
+        mEntries[entry.next].previous=entry.previous;
+    }
+    else
+    {
+        mLast=entry.previous;
+    }
+
+    entry.previous=-1;
+    entry.next=-1;
+}
+
+void RowBlockCache::linkFirst(const int block, Entry &entry)
+{
+    entry.previous=-1;
+    entry.next=mFirst;
+
+    if (mFirst>=0)
+    {
+        mEntries[mFirst].previous=block;
+    }
+    else
+    {
+        mLast=block;
+    }
+
+    mFirst=block;
+}
+
+void RowBlockCache::evict(const int keepBlock)
+{
+    int aBlock=mLast;
+
+    while (mUsedBytes>mBudget && aBlock>=0)
+    {
+        QHash<int, Entry>::iterator aEntry=mEntries.find(aBlock);
+        int aPrevious=aEntry.value().previous;
+
+        if (aBlock!=keepBlock && (aBlock<mPinnedFirst || aBlock>mPinnedLast))
+        {
+            unlink(aEntry.value());
+            mUsedBytes-=aEntry.value().bytes;
+
+            mEntries.erase(aEntry);
+        }
+
+        aBlock=aPrevious;
+    }
+}
+
+qint64 RowBlockCache::rowsBytes(const QList<QStringList> &rows)
+{
+    // Approximate size of strings with their headers
+    qint64 res=sizeof(Entry)+rows.length()*sizeof(QStringList);
+
+    for (int i=0; i<rows.length(); ++i)
+    {
+        const QStringList &aRow=rows.at(i);
+
+        res+=aRow.length()*(sizeof(QString)+24);
+
+        for (int j=0; j<aRow.length(); ++j)
+        {
+            res+=aRow.at(j).length()*sizeof(QChar);
+        }
+    }
+
+    return res;
+}
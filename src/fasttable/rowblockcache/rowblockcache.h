@@ -0,0 +1,71 @@
+#ifndef ROWBLOCKCACHE_H
+#define ROWBLOCKCACHE_H
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+
+// Cell texts cached by blocks of rows with memory budget.
+// Least recently used blocks are evicted when budget is exceeded, but pinned blocks (visible range) are never evicted.
+// Lookups of blocks count hits and misses.
+class RowBlockCache
+{
+public:
+    RowBlockCache(const int blockSize=256, const qint64 budget=64*1024*1024);
+
+    void clear();
+
+    int    blockSize() const;
+    qint64 budget() const;
+    void   setBudget(const qint64 budget);
+    qint64 usedBytes() const;
+    int    count() const;
+
+    bool contains(const int block) const;
+    bool containsRow(const int row) const;
+
+    const QList<QStringList> *rows(const int block);
+    QString text(const int row, const int column);
+
+    void insert(const int block, const QList<QStringList> &rows);
+    void remove(const int block);
+    void removeRows(const int first, const int last);
+
+    void setPinnedRows(const int first, const int last);
+
+    qint64 hits() const;
+    qint64 misses() const;
+    void   resetCounters();
+
+protected:
+    struct Entry
+    {
+        QList<QStringList> rows;
+        qint64             bytes;
+        int                previous;
+        int                next;
+    };
+
+    int    mBlockSize;
+    qint64 mBudget;
+    qint64 mUsedBytes;
+
+    // Entries are linked from the most recently used (mFirst) to the least recently used (mLast)
+    QHash<int, Entry> mEntries;
+    int               mFirst;
+    int               mLast;
+
+    int mPinnedFirst;
+    int mPinnedLast;
+
+    qint64 mHits;
+    qint64 mMisses;
+
+    void unlink(Entry &entry);
+    void linkFirst(const int block, Entry &entry);
+    void evict(const int keepBlock);
+
+    static qint64 rowsBytes(const QList<QStringList> &rows);
+};
+
+#endif // ROWBLOCKCACHE_H
@@ -0,0 +1,1525 @@
+#include "selectionranges.h"
+
+#include <QtAlgorithms>
+
+#include "fastdefines.h"
+
+// Row and column counts are Fenwick trees of differences between neighbour counts.
+// Adding to a range of rows and reading count of one row take O(log n).
+static QVector<int> unpackCounts(const QVector<int> &tree, const int size)
+{
+    QVector<int> aDiffs=tree;
+
+    // Reversed linear build gives the differences back
+    for (int i=size; i>=1; --i)
+    {
+        int j=i+(i & -i);
+
+        if (j<=size)
+        {
+            aDiffs[j]-=aDiffs.at(i);
+        }
+    }
+
+    QVector<int> res(size, 0);
+    int aSum=0;
+
+    for (int i=0; i<size; ++i)
+    {
+        aSum+=aDiffs.at(i+1);
+        res[i]=aSum;
+    }
+
+    return res;
+}
+
+static void packCounts(QVector<int> &tree, const QVector<int> &counts)
+{
+    int aSize=counts.size();
+
+    tree.fill(0, aSize+1);
+
+    for (int i=0; i<aSize; ++i)
+    {
+        tree[i+1]=counts.at(i)-(i>0? counts.at(i-1) : 0);
+    }
+
+    for (int i=1; i<=aSize; ++i)
+    {
+        int j=i+(i & -i);
+
+        if (j<=aSize)
+        {
+            tree[j]+=tree.at(i);
+        }
+    }
+}
+
+static bool columnOrder(const QRect &range1, const QRect &range2)
+{
+    if (range1.left()!=range2.left())
+    {
+        return range1.left()<range2.left();
+    }
+
+    if (range1.right()!=range2.right())
+    {
+        return range1.right()<range2.right();
+    }
+
+    return range1.top()<range2.top();
+}
+
+static bool rowOrder(const QRect &range1, const QRect &range2)
+{
+    if (range1.top()!=range2.top())
+    {
+        return range1.top()<range2.top();
+    }
+
+    if (range1.bottom()!=range2.bottom())
+    {
+        return range1.bottom()<range2.bottom();
+    }
+
+    return range1.left()<range2.left();
+}
+
+static bool readingOrder(const QRect &range1, const QRect &range2)
+{
+    if (range1.top()!=range2.top())
+    {
+        return range1.top()<range2.top();
+    }
+
+    return range1.left()<range2.left();
+}
+
+// Merges neighbours of sorted ranges. Returns true if something was merged
+static bool mergeSorted(QList<QRect> &ranges, const bool vertical)
+{
+    bool res=false;
+    int aLength=0;
+
+    for (int i=0; i<ranges.length(); ++i)
+    {
+        const QRect &aRange=ranges.at(i);
+
+        if (aLength>0)
+        {
+            QRect &aLast=ranges[aLength-1];
+
+            if (
+                vertical?
+                (aLast.left()==aRange.left() && aLast.right()==aRange.right() && aLast.bottom()+1==aRange.top())
+                :
+                (aLast.top()==aRange.top() && aLast.bottom()==aRange.bottom() && aLast.right()+1==aRange.left())
+               )
+            {
+                aLast=aLast.united(aRange);
+                res=true;
+
+                continue;
+            }
+        }
+
+        ranges[aLength]=aRange;
+        aLength++;
+    }
+
+    ranges.erase(ranges.begin()+aLength, ranges.end());
+
+    return res;
+}
+
+SelectionRanges::SelectionRanges()
+{
+    mRangeCellCount=0;
+    mExceptionCount=0;
+    mSelectedRowCount=0;
+    mSelectedColumnCount=0;
+    mRowCount=0;
+    mColumnCount=0;
+    mAllSelected=false;
+    mViewValid=false;
+}
+
+void SelectionRanges::clear()
+{
+    mRanges.reset(mRowCount);
+
+    mSelectedRows.clear();
+    mSelectedColumns.clear();
+    mSelectedRowCount=0;
+    mSelectedColumnCount=0;
+    mAllSelected=false;
+
+    mExceptions.fill(false);
+    mExceptionCount=0;
+
+    mRowCounts.clear();
+    mRowCounts.squeeze();
+    mColumnCounts.clear();
+    mColumnCounts.squeeze();
+    mRangeCellCount=0;
+
+    changed();
+}
+
+void SelectionRanges::resize(const int rowCount, const int columnCount)
+{
+    FASTTABLE_ASSERT(rowCount>=0 && columnCount>=0);
+
+    if (rowCount<mRowCount)
+    {
+        removeRows(rowCount, mRowCount-rowCount);
+    }
+    else
+    if (rowCount>mRowCount)
+    {
+        insertRows(mRowCount, rowCount-mRowCount);
+    }
+
+    if (columnCount<mColumnCount)
+    {
+        removeColumns(columnCount, mColumnCount-columnCount);
+    }
+    else
+    if (columnCount>mColumnCount)
+    {
+        insertColumns(mColumnCount, columnCount-mColumnCount);
+    }
+}
+
+void SelectionRanges::insertRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0 && row<=mRowCount);
+    FASTTABLE_ASSERT(count>=0);
+
+    if (count==0)
+    {
+        return;
+    }
+
+    releaseAll();
+
+    // New rows are not selected, so whole columns become ranges which are split below
+    if (mSelectedColumnCount>0)
+    {
+        releaseColumns();
+    }
+
+    QList<QRect> aRanges=mRanges.rects();
+    QList<QRect> aPieces;
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        QRect &aRange=aRanges[i];
+
+        if (aRange.top()>=row)
+        {
+            aRange.translate(0, count);
+        }
+        else
+        if (aRange.bottom()>=row)
+        {
+            // New rows are not selected, so the range is split
+            aPieces.append(QRect(aRange.left(), row+count, aRange.width(), aRange.bottom()-row+1));
+            aRange.setBottom(row-1);
+        }
+    }
+
+    aRanges.append(aPieces);
+
+    insertCounts(mRowCounts, mRowCount, row, count);
+
+    insertRunItems(mSelectedRows, row, count);
+
+    mExceptions.insertRows(row, count);
+    mRowCount+=count;
+
+    // Split ranges may become neighbours of others
+    rebuild(aRanges);
+}
+
+void SelectionRanges::removeRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(count>=0);
+    FASTTABLE_ASSERT(row>=0 && row+count<=mRowCount);
+
+    if (count==0)
+    {
+        return;
+    }
+
+    releaseAll();
+
+    // Cells of removed rows are unselected first, so column counts are updated by the usual way
+    QRect aBand(0, row, mColumnCount, count);
+
+    subtract(aBand);
+    clearExceptions(aBand);
+
+    mSelectedRowCount-=removeRunItems(mSelectedRows, row, count);
+
+    QList<QRect> aRanges=mRanges.rects();
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        if (aRanges.at(i).top()>=row+count)
+        {
+            aRanges[i].translate(0, -count);
+        }
+    }
+
+    removeCounts(mRowCounts, mRowCount, row, count);
+    mExceptions.removeRows(row, count);
+    mRowCount-=count;
+
+    // Flagged columns have no cells without rows
+    if (mRowCount==0 && mSelectedColumnCount>0)
+    {
+        mSelectedColumns.clear();
+        mSelectedColumnCount=0;
+    }
+
+    // Ranges around removed rows may become neighbours
+    rebuild(aRanges);
+}
+
+void SelectionRanges::insertColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(column>=0 && column<=mColumnCount);
+    FASTTABLE_ASSERT(count>=0);
+
+    if (count==0)
+    {
+        return;
+    }
+
+    releaseAll();
+
+    // New columns are not selected, so whole rows become ranges which are split below
+    if (mSelectedRowCount>0)
+    {
+        releaseRows();
+    }
+
+    QList<QRect> aRanges=mRanges.rects();
+    QList<QRect> aPieces;
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        QRect &aRange=aRanges[i];
+
+        if (aRange.left()>=column)
+        {
+            aRange.translate(count, 0);
+        }
+        else
+        if (aRange.right()>=column)
+        {
+            // New columns are not selected, so the range is split
+            aPieces.append(QRect(column+count, aRange.top(), aRange.right()-column+1, aRange.height()));
+            aRange.setRight(column-1);
+        }
+    }
+
+    aRanges.append(aPieces);
+
+    insertCounts(mColumnCounts, mColumnCount, column, count);
+
+    insertRunItems(mSelectedColumns, column, count);
+
+    mExceptions.insertColumns(column, count);
+    mColumnCount+=count;
+
+    // Split ranges may become neighbours of others
+    rebuild(aRanges);
+}
+
+void SelectionRanges::removeColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(count>=0);
+    FASTTABLE_ASSERT(column>=0 && column+count<=mColumnCount);
+
+    if (count==0)
+    {
+        return;
+    }
+
+    releaseAll();
+
+    // Cells of removed columns are unselected first, so row counts are updated by the usual way
+    QRect aBand(column, 0, count, mRowCount);
+
+    subtract(aBand);
+    clearExceptions(aBand);
+
+    mSelectedColumnCount-=removeRunItems(mSelectedColumns, column, count);
+
+    QList<QRect> aRanges=mRanges.rects();
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        if (aRanges.at(i).left()>=column+count)
+        {
+            aRanges[i].translate(-count, 0);
+        }
+    }
+
+    removeCounts(mColumnCounts, mColumnCount, column, count);
+    mExceptions.removeColumns(column, count);
+    mColumnCount-=count;
+
+    // Flagged rows have no cells without columns
+    if (mColumnCount==0 && mSelectedRowCount>0)
+    {
+        mSelectedRows.clear();
+        mSelectedRowCount=0;
+    }
+
+    // Ranges around removed columns may become neighbours
+    rebuild(aRanges);
+}
+
+void SelectionRanges::select(const QRect &range)
+{
+    QRect aRange=range.intersected(QRect(0, 0, mColumnCount, mRowCount));
+
+    if (aRange.isEmpty() || mAllSelected)
+    {
+        return;
+    }
+
+    if (aRange.width()==mColumnCount)
+    {
+        selectRows(aRange.top(), aRange.bottom());
+        return;
+    }
+
+    if (aRange.height()==mRowCount)
+    {
+        selectColumns(aRange.left(), aRange.right());
+        return;
+    }
+
+    // Cells of flagged rows and columns are selected back by removing their exceptions
+    clearExceptions(aRange);
+
+    // The rest of the range is split by flagged rows and columns into ranges
+    QList<QRect> aPieces=unflaggedPieces(aRange);
+
+    for (int i=0; i<aPieces.length(); ++i)
+    {
+        selectRange(aPieces.at(i));
+    }
+}
+
+void SelectionRanges::unselect(const QRect &range)
+{
+    QRect aRange=range.intersected(QRect(0, 0, mColumnCount, mRowCount));
+
+    if (aRange.isEmpty())
+    {
+        return;
+    }
+
+    if (aRange.width()==mColumnCount && aRange.height()==mRowCount)
+    {
+        clear();
+        return;
+    }
+
+    releaseAll();
+    subtract(aRange);
+
+    // Single cell inside flags gets an exception, flags crossing bigger areas are split into ranges
+    if (aRange.width()==1 && aRange.height()==1)
+    {
+        if (rowSelected(aRange.top()) || columnSelected(aRange.left()))
+        {
+            setException(aRange.top(), aRange.left(), true);
+        }
+    }
+    else
+    {
+        releaseFlags(aRange);
+    }
+}
+
+void SelectionRanges::selectAll()
+{
+    clear();
+
+    if (mRowCount>0 && mColumnCount>0)
+    {
+        mAllSelected=true;
+        mSelectedRowCount=mRowCount;
+    }
+
+    changed();
+}
+
+void SelectionRanges::setRanges(const QList<QRect> &ranges)
+{
+    clear();
+
+    QList<QRect> aClipped;
+    aClipped.reserve(ranges.length());
+
+    for (int i=0; i<ranges.length(); ++i)
+    {
+        QRect aRange=ranges.at(i).intersected(QRect(0, 0, mColumnCount, mRowCount));
+
+        if (!aRange.isEmpty())
+        {
+            aClipped.append(aRange);
+        }
+    }
+
+    QList<QRect> aRanges=united(aClipped);
+
+    // Whole rows and columns become flags first, so other ranges are split by them only once
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        const QRect &aRange=aRanges.at(i);
+
+        if (aRange.width()==mColumnCount || aRange.height()==mRowCount)
+        {
+            select(aRange);
+        }
+    }
+
+    // Pieces are disjoint already, so they are added without lookups and merged once
+    QList<QRect> aPieces;
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        const QRect &aRange=aRanges.at(i);
+
+        if (aRange.width()!=mColumnCount && aRange.height()!=mRowCount)
+        {
+            aPieces.append(unflaggedPieces(aRange));
+        }
+    }
+
+    for (int i=0; i<aPieces.length(); ++i)
+    {
+        addRangeCells(aPieces.at(i), 1);
+    }
+
+    rebuild(aPieces);
+}
+
+bool SelectionRanges::contains(const int row, const int column) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    if (rowSelected(row) || columnSelected(column))
+    {
+        return !mExceptions.at(row, column);
+    }
+
+    return !mRanges.rectAt(row, column).isNull();
+}
+
+bool SelectionRanges::isEmpty() const
+{
+    return cellCount()==0;
+}
+
+bool SelectionRanges::isAllSelected() const
+{
+    return cellCount()==((qint64)mRowCount)*mColumnCount;
+}
+
+bool SelectionRanges::rowSelected(const int row) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+
+    return mAllSelected || runsContain(mSelectedRows, row);
+}
+
+bool SelectionRanges::columnSelected(const int column) const
+{
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    return runsContain(mSelectedColumns, column);
+}
+
+qint64 SelectionRanges::cellCount() const
+{
+    return mRangeCellCount
+           +((qint64)mSelectedRowCount)*mColumnCount
+           +((qint64)mSelectedColumnCount)*mRowCount
+           -((qint64)mSelectedRowCount)*mSelectedColumnCount
+           -mExceptionCount;
+}
+
+int SelectionRanges::rowCellCount(const int row) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<mRowCount);
+
+    return (rowSelected(row)? mColumnCount : mSelectedColumnCount)+countAt(mRowCounts, row);
+}
+
+int SelectionRanges::columnCellCount(const int column) const
+{
+    FASTTABLE_ASSERT(column>=0 && column<mColumnCount);
+
+    return (columnSelected(column)? mRowCount : mSelectedRowCount)+countAt(mColumnCounts, column);
+}
+
+qint64 SelectionRanges::exceptionCount() const
+{
+    return mExceptionCount;
+}
+
+const QList<QRect> &SelectionRanges::ranges() const
+{
+    if (mViewValid)
+    {
+        return mView;
+    }
+
+    QList<QRect> aRanges=flaggedIn(QRect(0, 0, mColumnCount, mRowCount));
+
+    mView=mRanges.rects();
+    mView.append(aRanges);
+
+    mergeRanges(mView);
+
+    mViewValid=true;
+
+    return mView;
+}
+
+QList<QRect> SelectionRanges::explicitRanges() const
+{
+    return mRanges.rects();
+}
+
+QList<QRect> SelectionRanges::rangesIn(const QRect &area) const
+{
+    QRect aArea=area.intersected(QRect(0, 0, mColumnCount, mRowCount));
+
+    if (aArea.isEmpty())
+    {
+        return QList<QRect>();
+    }
+
+    QList<QRect> res=flaggedIn(aArea);
+    QList<QRect> aFound=mRanges.rectsIn(aArea);
+
+    for (int i=0; i<aFound.length(); ++i)
+    {
+        res.append(aFound.at(i).intersected(aArea));
+    }
+
+    return res;
+}
+
+QList<QRect> SelectionRanges::unselectedIn(const QList<QRect> &ranges) const
+{
+    QList<QRect> res;
+
+    for (int i=0; i<ranges.length(); ++i)
+    {
+        QRect aRange=ranges.at(i).intersected(QRect(0, 0, mColumnCount, mRowCount));
+
+        if (!aRange.isEmpty())
+        {
+            res.append(difference(QList<QRect>()<<aRange, rangesIn(aRange)));
+        }
+    }
+
+    return res;
+}
+
+QList<QRect> SelectionRanges::difference(const QList<QRect> &ranges, const QList<QRect> &subtrahend)
+{
+    QList<QRect> res=ranges;
+
+    for (int i=0; i<subtrahend.length() && res.length()>0; ++i)
+    {
+        const QRect &aCut=subtrahend.at(i);
+        QList<QRect> aPieces;
+
+        for (int j=0; j<res.length(); ++j)
+        {
+            const QRect &aRange=res.at(j);
+            QRect aCommon=aRange.intersected(aCut);
+
+            if (aCommon.isEmpty())
+            {
+                aPieces.append(aRange);
+            }
+            else
+            {
+                appendPieces(aRange, aCommon, aPieces);
+            }
+        }
+
+        res=aPieces;
+    }
+
+    return res;
+}
+
+QList<QRect> SelectionRanges::united(const QList<QRect> &ranges)
+{
+    // Sweep over row bands, every band is a sorted list of merged column intervals.
+    // Intervals equal to intervals of the previous band continue its rectangles
+    QList<QRect> res;
+    QList<QRect> aSorted=ranges;
+    QList<int>   aBounds;
+
+    qSort(aSorted.begin(), aSorted.end(), readingOrder);
+
+    for (int i=0; i<aSorted.length(); ++i)
+    {
+        aBounds.append(aSorted.at(i).top());
+        aBounds.append(aSorted.at(i).bottom()+1);
+    }
+
+    qSort(aBounds);
+
+    QList<QRect> aActive;
+    QList<QRect> aOpen;
+    int          aNext=0;
+
+    for (int i=0; i<aBounds.length(); ++i)
+    {
+        int aTop=aBounds.at(i);
+
+        if (i>0 && aBounds.at(i-1)==aTop)
+        {
+            continue;
+        }
+
+        for (int j=aActive.length()-1; j>=0; --j)
+        {
+            if (aActive.at(j).bottom()<aTop)
+            {
+                aActive.removeAt(j);
+            }
+        }
+
+        while (aNext<aSorted.length() && aSorted.at(aNext).top()==aTop)
+        {
+            aActive.append(aSorted.at(aNext));
+            aNext++;
+        }
+
+        QList<QRect> aIntervals;
+
+        if (aActive.length()>0)
+        {
+            QList<QRect> aColumns=aActive;
+            qSort(aColumns.begin(), aColumns.end(), columnOrder);
+
+            for (int j=0; j<aColumns.length(); ++j)
+            {
+                const QRect &aColumn=aColumns.at(j);
+
+                if (aIntervals.length()>0 && aIntervals.last().right()+1>=aColumn.left())
+                {
+                    aIntervals.last().setRight(qMax(aIntervals.last().right(), aColumn.right()));
+                }
+                else
+                {
+                    aIntervals.append(QRect(aColumn.left(), aTop, aColumn.width(), 1));
+                }
+            }
+        }
+
+        // Both lists are sorted by column, so equal intervals are found in one pass
+        QList<QRect> aNewOpen;
+        int aOpenIndex=0;
+
+        for (int j=0; j<aIntervals.length(); ++j)
+        {
+            const QRect &aInterval=aIntervals.at(j);
+
+            while (aOpenIndex<aOpen.length() && aOpen.at(aOpenIndex).left()<aInterval.left())
+            {
+                res.append(aOpen.at(aOpenIndex));
+                aOpenIndex++;
+            }
+
+            if (
+                aOpenIndex<aOpen.length()
+                &&
+                aOpen.at(aOpenIndex).left()==aInterval.left()
+                &&
+                aOpen.at(aOpenIndex).right()==aInterval.right()
+               )
+            {
+                aNewOpen.append(aOpen.at(aOpenIndex));
+                aOpenIndex++;
+            }
+            else
+            {
+                aNewOpen.append(aInterval);
+            }
+        }
+
+        while (aOpenIndex<aOpen.length())
+        {
+            res.append(aOpen.at(aOpenIndex));
+            aOpenIndex++;
+        }
+
+        // Rectangles are extended to the next bound
+        int aBottom=i+1<aBounds.length()? aBounds.at(i+1)-1 : aTop;
+
+        for (int j=i+1; j<aBounds.length() && aBounds.at(j)==aTop; ++j)
+        {
+            aBottom=j+1<aBounds.length()? aBounds.at(j+1)-1 : aTop;
+        }
+
+        for (int j=0; j<aNewOpen.length(); ++j)
+        {
+            aNewOpen[j].setBottom(aBottom);
+        }
+
+        aOpen=aNewOpen;
+    }
+
+    res.append(aOpen);
+
+    return res;
+}
+
+int SelectionRanges::rowCount() const
+{
+    return mRowCount;
+}
+
+int SelectionRanges::columnCount() const
+{
+    return mColumnCount;
+}
+
+void SelectionRanges::appendPieces(const QRect &range, const QRect &common, QList<QRect> &pieces)
+{
+    // Up to four pieces remain around the removed part
+    if (range.top()<common.top())
+    {
+        pieces.append(QRect(range.left(), range.top(), range.width(), common.top()-range.top()));
+    }
+
+    if (range.bottom()>common.bottom())
+    {
+        pieces.append(QRect(range.left(), common.bottom()+1, range.width(), range.bottom()-common.bottom()));
+    }
+
+    if (range.left()<common.left())
+    {
+        pieces.append(QRect(range.left(), common.top(), common.left()-range.left(), common.height()));
+    }
+
+    if (range.right()>common.right())
+    {
+        pieces.append(QRect(common.right()+1, common.top(), range.right()-common.right(), common.height()));
+    }
+}
+
+void SelectionRanges::mergeRanges(QList<QRect> &ranges)
+{
+    // Sorting puts neighbours together, passes are repeated until nothing is merged
+    bool aMerged=true;
+
+    while (aMerged)
+    {
+        qSort(ranges.begin(), ranges.end(), columnOrder);
+        aMerged=mergeSorted(ranges, true);
+
+        qSort(ranges.begin(), ranges.end(), rowOrder);
+
+        if (mergeSorted(ranges, false))
+        {
+            aMerged=true;
+        }
+    }
+
+    qSort(ranges.begin(), ranges.end(), readingOrder);
+}
+
+bool SelectionRanges::runsContain(const QMap<int, int> &runs, const int index)
+{
+    QMap<int, int>::const_iterator aRun=runs.upperBound(index);
+
+    if (aRun==runs.constBegin())
+    {
+        return false;
+    }
+
+    --aRun;
+
+    return aRun.value()>=index;
+}
+
+QList< QPair<int, int> > SelectionRanges::runsIn(const QMap<int, int> &runs, const int first, const int last, const bool flagged)
+{
+    // Returns flagged runs or gaps between them, clipped by first and last
+    QList< QPair<int, int> > res;
+    QMap<int, int>::const_iterator aRun=runs.upperBound(first);
+    int aNext=first;
+
+    if (aRun!=runs.constBegin())
+    {
+        --aRun;
+
+        if (aRun.value()<first)
+        {
+            ++aRun;
+        }
+    }
+
+    for (; aRun!=runs.constEnd() && aRun.key()<=last; ++aRun)
+    {
+        int aFirst=qMax(aRun.key(), first);
+        int aLast=qMin(aRun.value(), last);
+
+        if (flagged)
+        {
+            res.append(qMakePair(aFirst, aLast));
+        }
+        else
+        if (aFirst>aNext)
+        {
+            res.append(qMakePair(aNext, aFirst-1));
+        }
+
+        aNext=aLast+1;
+    }
+
+    if (!flagged && aNext<=last)
+    {
+        res.append(qMakePair(aNext, last));
+    }
+
+    return res;
+}
+
+int SelectionRanges::addRun(QMap<int, int> &runs, const int first, const int last)
+{
+    // Touching runs are merged into one. Returns count of newly flagged items
+    int res=last-first+1;
+    int aFirst=first;
+    int aLast=last;
+    QList<int> aMerged;
+
+    QMap<int, int>::const_iterator aRun=runs.upperBound(first);
+
+    if (aRun!=runs.constBegin())
+    {
+        --aRun;
+
+        if (aRun.value()+1<first)
+        {
+            ++aRun;
+        }
+    }
+
+    for (; aRun!=runs.constEnd() && aRun.key()<=last+1; ++aRun)
+    {
+        int aCommon=qMin(aRun.value(), last)-qMax(aRun.key(), first)+1;
+
+        if (aCommon>0)
+        {
+            res-=aCommon;
+        }
+
+        aFirst=qMin(aFirst, aRun.key());
+        aLast=qMax(aLast, aRun.value());
+
+        aMerged.append(aRun.key());
+    }
+
+    for (int i=0; i<aMerged.length(); ++i)
+    {
+        runs.remove(aMerged.at(i));
+    }
+
+    runs.insert(aFirst, aLast);
+
+    return res;
+}
+
+int SelectionRanges::removeRun(QMap<int, int> &runs, const int first, const int last)
+{
+    // Runs crossing the bounds are cut. Returns count of unflagged items
+    int res=0;
+    QList< QPair<int, int> > aRemoved=runsIn(runs, first, last, true);
+
+    for (int i=0; i<aRemoved.length(); ++i)
+    {
+        const QPair<int, int> &aPart=aRemoved.at(i);
+        QMap<int, int>::const_iterator aRun=runs.upperBound(aPart.first);
+
+        --aRun;
+
+        int aKey=aRun.key();
+        int aValue=aRun.value();
+
+        runs.remove(aKey);
+
+        if (aKey<aPart.first)
+        {
+            runs.insert(aKey, aPart.first-1);
+        }
+
+        if (aValue>aPart.second)
+        {
+            runs.insert(aPart.second+1, aValue);
+        }
+
+        res+=aPart.second-aPart.first+1;
+    }
+
+    return res;
+}
+
+void SelectionRanges::insertRunItems(QMap<int, int> &runs, const int index, const int count)
+{
+    // New items are not flagged, so the run crossing index is split
+    if (runs.isEmpty())
+    {
+        return;
+    }
+
+    QMap<int, int> aRuns;
+
+    for (QMap<int, int>::const_iterator aRun=runs.constBegin(); aRun!=runs.constEnd(); ++aRun)
+    {
+        if (aRun.key()>=index)
+        {
+            aRuns.insert(aRun.key()+count, aRun.value()+count);
+        }
+        else
+        if (aRun.value()>=index)
+        {
+            aRuns.insert(aRun.key(), index-1);
+            aRuns.insert(index+count, aRun.value()+count);
+        }
+        else
+        {
+            aRuns.insert(aRun.key(), aRun.value());
+        }
+    }
+
+    runs=aRuns;
+}
+
+int SelectionRanges::removeRunItems(QMap<int, int> &runs, const int index, const int count)
+{
+    // Runs around removed items may touch each other. Returns count of removed flagged items
+    if (runs.isEmpty())
+    {
+        return 0;
+    }
+
+    int res=removeRun(runs, index, index+count-1);
+
+    QMap<int, int> aRuns;
+    int aLastKey=-1;
+
+    for (QMap<int, int>::const_iterator aRun=runs.constBegin(); aRun!=runs.constEnd(); ++aRun)
+    {
+        int aKey=aRun.key();
+        int aValue=aRun.value();
+
+        if (aKey>index)
+        {
+            aKey-=count;
+            aValue-=count;
+        }
+
+        if (aLastKey>=0 && aRuns.value(aLastKey)+1==aKey)
+        {
+            aRuns.insert(aLastKey, aValue);
+        }
+        else
+        {
+            aRuns.insert(aKey, aValue);
+            aLastKey=aKey;
+        }
+    }
+
+    runs=aRuns;
+
+    return res;
+}
+
+void SelectionRanges::addCounts(QVector<int> &tree, const int size, const int from, const int to, const int delta)
+{
+    if (delta==0 || from>to)
+    {
+        return;
+    }
+
+    // Tree is allocated on first nonzero count
+    if (tree.isEmpty())
+    {
+        tree.fill(0, size+1);
+    }
+
+    for (int i=from+1; i<=size; i+=i & -i)
+    {
+        tree[i]+=delta;
+    }
+
+    for (int i=to+2; i<=size; i+=i & -i)
+    {
+        tree[i]-=delta;
+    }
+}
+
+int SelectionRanges::countAt(const QVector<int> &tree, const int index)
+{
+    int res=0;
+
+    if (tree.isEmpty())
+    {
+        return res;
+    }
+
+    for (int i=index+1; i>0; i-=i & -i)
+    {
+        res+=tree.at(i);
+    }
+
+    return res;
+}
+
+void SelectionRanges::insertCounts(QVector<int> &tree, const int size, const int index, const int count)
+{
+    if (tree.isEmpty())
+    {
+        return;
+    }
+
+    QVector<int> aCounts=unpackCounts(tree, size);
+    aCounts.insert(index, count, 0);
+    packCounts(tree, aCounts);
+}
+
+void SelectionRanges::removeCounts(QVector<int> &tree, const int size, const int index, const int count)
+{
+    if (tree.isEmpty())
+    {
+        return;
+    }
+
+    QVector<int> aCounts=unpackCounts(tree, size);
+    aCounts.remove(index, count);
+    packCounts(tree, aCounts);
+}
+
+QList<QRect> SelectionRanges::flaggedIn(const QRect &area) const
+{
+    // Flagged rows and flagged columns outside of flagged rows without exceptions
+    QList<QRect> res;
+
+    if (mAllSelected)
+    {
+        res.append(area);
+
+        return res;
+    }
+
+    if (mSelectedRowCount==0 && mSelectedColumnCount==0)
+    {
+        return res;
+    }
+
+    QList< QPair<int, int> > aRows=runsIn(mSelectedRows, area.top(), area.bottom(), true);
+
+    for (int i=0; i<aRows.length(); ++i)
+    {
+        res.append(QRect(area.left(), aRows.at(i).first, area.width(), aRows.at(i).second-aRows.at(i).first+1));
+    }
+
+    if (mSelectedColumnCount>0)
+    {
+        QList< QPair<int, int> > aGaps=runsIn(mSelectedRows, area.top(), area.bottom(), false);
+        QList< QPair<int, int> > aColumns=runsIn(mSelectedColumns, area.left(), area.right(), true);
+
+        for (int i=0; i<aGaps.length(); ++i)
+        {
+            for (int j=0; j<aColumns.length(); ++j)
+            {
+                res.append(QRect(aColumns.at(j).first, aGaps.at(i).first, aColumns.at(j).second-aColumns.at(j).first+1, aGaps.at(i).second-aGaps.at(i).first+1));
+            }
+        }
+    }
+
+    if (mExceptionCount>0)
+    {
+        res=difference(res, exceptionsIn(area));
+    }
+
+    return res;
+}
+
+QList<QRect> SelectionRanges::unflaggedPieces(const QRect &range) const
+{
+    QList<QRect> res;
+
+    if (mAllSelected)
+    {
+        return res;
+    }
+
+    QList< QPair<int, int> > aRows=runsIn(mSelectedRows, range.top(), range.bottom(), false);
+    QList< QPair<int, int> > aColumns=runsIn(mSelectedColumns, range.left(), range.right(), false);
+
+    for (int i=0; i<aRows.length(); ++i)
+    {
+        for (int j=0; j<aColumns.length(); ++j)
+        {
+            res.append(QRect(aColumns.at(j).first, aRows.at(i).first, aColumns.at(j).second-aColumns.at(j).first+1, aRows.at(i).second-aRows.at(i).first+1));
+        }
+    }
+
+    return res;
+}
+
+void SelectionRanges::selectRows(const int top, const int bottom)
+{
+    QRect aBand(0, top, mColumnCount, bottom-top+1);
+
+    // Ranges and exceptions of these rows are covered by the flags
+    subtract(aBand);
+    clearExceptions(aBand);
+
+    mSelectedRowCount+=addRun(mSelectedRows, top, bottom);
+
+    changed();
+}
+
+void SelectionRanges::selectColumns(const int left, const int right)
+{
+    QRect aBand(left, 0, right-left+1, mRowCount);
+
+    // Ranges and exceptions of these columns are covered by the flags
+    subtract(aBand);
+    clearExceptions(aBand);
+
+    mSelectedColumnCount+=addRun(mSelectedColumns, left, right);
+
+    changed();
+}
+
+void SelectionRanges::releaseRows()
+{
+    // Cells of flagged rows outside of flagged columns become ranges
+    QList< QPair<int, int> > aRows=runsIn(mSelectedRows, 0, mRowCount-1, true);
+    QList< QPair<int, int> > aColumns=runsIn(mSelectedColumns, 0, mColumnCount-1, false);
+    QList<QRect> aPieces;
+
+    for (int i=0; i<aRows.length(); ++i)
+    {
+        for (int j=0; j<aColumns.length(); ++j)
+        {
+            aPieces.append(QRect(aColumns.at(j).first, aRows.at(i).first, aColumns.at(j).second-aColumns.at(j).first+1, aRows.at(i).second-aRows.at(i).first+1));
+        }
+    }
+
+    mSelectedRows.clear();
+    mSelectedRowCount=0;
+
+    releasePieces(aPieces, QRect());
+}
+
+void SelectionRanges::releaseColumns()
+{
+    // Cells of flagged columns outside of flagged rows become ranges
+    QList< QPair<int, int> > aRows=runsIn(mSelectedRows, 0, mRowCount-1, false);
+    QList< QPair<int, int> > aColumns=runsIn(mSelectedColumns, 0, mColumnCount-1, true);
+    QList<QRect> aPieces;
+
+    for (int i=0; i<aRows.length(); ++i)
+    {
+        for (int j=0; j<aColumns.length(); ++j)
+        {
+            aPieces.append(QRect(aColumns.at(j).first, aRows.at(i).first, aColumns.at(j).second-aColumns.at(j).first+1, aRows.at(i).second-aRows.at(i).first+1));
+        }
+    }
+
+    mSelectedColumns.clear();
+    mSelectedColumnCount=0;
+
+    releasePieces(aPieces, QRect());
+}
+
+void SelectionRanges::releaseAll()
+{
+    // Whole selection becomes one run of flagged rows
+    if (!mAllSelected)
+    {
+        return;
+    }
+
+    mAllSelected=false;
+    mSelectedRows.insert(0, mRowCount-1);
+
+    changed();
+}
+
+void SelectionRanges::releaseFlags(const QRect &area)
+{
+    // Flagged rows crossing the area become ranges outside of the area and outside of flagged columns
+    QList< QPair<int, int> > aRows=runsIn(mSelectedRows, area.top(), area.bottom(), true);
+
+    if (!aRows.isEmpty())
+    {
+        QList< QPair<int, int> > aColumns=runsIn(mSelectedColumns, 0, mColumnCount-1, false);
+        QList<QRect> aPieces;
+
+        for (int i=0; i<aRows.length(); ++i)
+        {
+            for (int j=0; j<aColumns.length(); ++j)
+            {
+                aPieces.append(QRect(aColumns.at(j).first, aRows.at(i).first, aColumns.at(j).second-aColumns.at(j).first+1, aRows.at(i).second-aRows.at(i).first+1));
+            }
+
+            mSelectedRowCount-=removeRun(mSelectedRows, aRows.at(i).first, aRows.at(i).second);
+        }
+
+        releasePieces(aPieces, area);
+    }
+
+    // Then flagged columns crossing the area become ranges outside of the area and outside of remaining flagged rows
+    QList< QPair<int, int> > aColumns=runsIn(mSelectedColumns, area.left(), area.right(), true);
+
+    if (!aColumns.isEmpty())
+    {
+        QList< QPair<int, int> > aGaps=runsIn(mSelectedRows, 0, mRowCount-1, false);
+        QList<QRect> aPieces;
+
+        for (int i=0; i<aColumns.length(); ++i)
+        {
+            for (int j=0; j<aGaps.length(); ++j)
+            {
+                aPieces.append(QRect(aColumns.at(i).first, aGaps.at(j).first, aColumns.at(i).second-aColumns.at(i).first+1, aGaps.at(j).second-aGaps.at(j).first+1));
+            }
+
+            mSelectedColumnCount-=removeRun(mSelectedColumns, aColumns.at(i).first, aColumns.at(i).second);
+        }
+
+        releasePieces(aPieces, area);
+    }
+}
+
+void SelectionRanges::releasePieces(const QList<QRect> &pieces, const QRect &area)
+{
+    // Cells of pieces lost their flags, so exceptions inside them become holes between ranges
+    QList<QRect> aCuts;
+
+    for (int i=0; i<pieces.length(); ++i)
+    {
+        aCuts.append(exceptionsIn(pieces.at(i)));
+        clearExceptions(pieces.at(i));
+    }
+
+    if (!area.isEmpty())
+    {
+        aCuts.append(area);
+    }
+
+    QList<QRect> aRanges=difference(pieces, aCuts);
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        addRangeCells(aRanges.at(i), 1);
+        append(aRanges.at(i));
+    }
+
+    changed();
+}
+
+void SelectionRanges::selectRange(const QRect &range)
+{
+    QList<QRect> aFound=mRanges.rectsIn(range);
+
+    if (aFound.length()==1 && aFound.first().contains(range))
+    {
+        return;
+    }
+
+    subtract(range);
+
+    addRangeCells(range, 1);
+    append(range);
+}
+
+void SelectionRanges::subtract(const QRect &range)
+{
+    QList<QRect> aFound=mRanges.rectsIn(range);
+
+    if (aFound.isEmpty())
+    {
+        return;
+    }
+
+    QList<QRect> aPieces;
+
+    for (int i=0; i<aFound.length(); ++i)
+    {
+        const QRect &aRange=aFound.at(i);
+        QRect aCommon=aRange.intersected(range);
+
+        mRanges.remove(aRange);
+
+        addRangeCells(aCommon, -1);
+        appendPieces(aRange, aCommon, aPieces);
+    }
+
+    for (int i=0; i<aPieces.length(); ++i)
+    {
+        append(aPieces.at(i));
+    }
+
+    changed();
+}
+
+void SelectionRanges::append(const QRect &range)
+{
+    // Merge with ranges sharing a whole edge, so selecting cell by cell doesn't fragment the set
+    QRect aRange=range;
+    bool aMerged=true;
+
+    while (aMerged)
+    {
+        aMerged=false;
+
+        QRect aNeighbours[4]={
+                               mRanges.rectAt(aRange.top()-1,    aRange.left()),
+                               mRanges.rectAt(aRange.bottom()+1, aRange.left()),
+                               mRanges.rectAt(aRange.top(),      aRange.left()-1),
+                               mRanges.rectAt(aRange.top(),      aRange.right()+1)
+                             };
+
+        for (int i=0; i<4; ++i)
+        {
+            const QRect &aNeighbour=aNeighbours[i];
+
+            if (
+                !aNeighbour.isNull()
+                &&
+                (
+                 (i<2 && aNeighbour.left()==aRange.left() && aNeighbour.right()==aRange.right())
+                 ||
+                 (i>=2 && aNeighbour.top()==aRange.top() && aNeighbour.bottom()==aRange.bottom())
+                )
+               )
+            {
+                mRanges.remove(aNeighbour);
+                aRange=aRange.united(aNeighbour);
+
+                aMerged=true;
+                break;
+            }
+        }
+    }
+
+    mRanges.insert(aRange);
+
+    changed();
+}
+
+void SelectionRanges::rebuild(const QList<QRect> &ranges)
+{
+    QList<QRect> aRanges=ranges;
+
+    mergeRanges(aRanges);
+
+    mRanges.reset(mRowCount);
+
+    for (int i=0; i<aRanges.length(); ++i)
+    {
+        mRanges.insert(aRanges.at(i));
+    }
+
+    changed();
+}
+
+void SelectionRanges::addRangeCells(const QRect &range, const int sign)
+{
+    mRangeCellCount+=sign*((qint64)range.width())*range.height();
+
+    addCounts(mRowCounts, mRowCount, range.top(), range.bottom(), sign*range.width());
+    addCounts(mColumnCounts, mColumnCount, range.left(), range.right(), sign*range.height());
+}
+
+void SelectionRanges::setException(const int row, const int column, const bool value)
+{
+    if (mExceptions.at(row, column)==value)
+    {
+        return;
+    }
+
+    mExceptions.setBit(row, column, value);
+
+    int aDelta=value? -1 : 1;
+
+    mExceptionCount-=aDelta;
+
+    addCounts(mRowCounts, mRowCount, row, row, aDelta);
+    addCounts(mColumnCounts, mColumnCount, column, column, aDelta);
+
+    // Bits are released with the last exception
+    if (mExceptionCount==0)
+    {
+        mExceptions.fill(false);
+    }
+
+    changed();
+}
+
+void SelectionRanges::clearExceptions(const QRect &area)
+{
+    for (int i=area.top(); i<=area.bottom() && mExceptionCount>0; ++i)
+    {
+        int aColumn=mExceptions.nextSetBit(i, area.left());
+
+        while (aColumn>=0 && aColumn<=area.right())
+        {
+            setException(i, aColumn, false);
+            aColumn=mExceptions.nextSetBit(i, aColumn+1);
+        }
+    }
+}
+
+QList<QRect> SelectionRanges::exceptionsIn(const QRect &area) const
+{
+    QList<QRect> res;
+
+    for (int i=area.top(); i<=area.bottom() && mExceptionCount>0; ++i)
+    {
+        int aFirst=mExceptions.nextSetBit(i, area.left());
+
+        while (aFirst>=0 && aFirst<=area.right())
+        {
+            int aLast=mExceptions.nextClearBit(i, aFirst);
+
+            aLast=qMin(aLast<0? mColumnCount-1 : aLast-1, area.right());
+
+            res.append(QRect(aFirst, i, aLast-aFirst+1, 1));
+
+            aFirst=mExceptions.nextSetBit(i, aLast+1);
+        }
+    }
+
+    return res;
+}
+
+void SelectionRanges::changed()
+{
+    mViewValid=false;
+}
@@ -0,0 +1,115 @@
+#ifndef SELECTIONRANGES_H
+#define SELECTIONRANGES_H
+
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QRect>
+#include <QVector>
+
+#include "bitgrid.h"
+#include "rectset.h"
+
+// Selected cells (x is column, y is row).
+// Whole rows and columns are kept as runs of flags, single cells unselected inside them are kept as exception bits.
+// Unselecting a bigger area inside flags turns the flags around it back into rectangles, selecting everything is one flag.
+// Other cells are kept as disjoint rectangles outside of flagged rows and columns, rectangles sharing a whole edge are merged.
+// Cell counts of rows and columns are updated on every change, ranges() combines all parts into disjoint rectangles on demand.
+class SelectionRanges
+{
+public:
+    SelectionRanges();
+
+    void clear();
+    void resize(const int rowCount, const int columnCount);
+
+    void insertRows(const int row, const int count);
+    void removeRows(const int row, const int count);
+    void insertColumns(const int column, const int count);
+    void removeColumns(const int column, const int count);
+
+    void select(const QRect &range);
+    void unselect(const QRect &range);
+    void selectAll();
+    void setRanges(const QList<QRect> &ranges);
+
+    bool contains(const int row, const int column) const;
+    bool isEmpty() const;
+    bool isAllSelected() const;
+
+    bool rowSelected(const int row) const;
+    bool columnSelected(const int column) const;
+
+    qint64 cellCount() const;
+    int    rowCellCount(const int row) const;
+    int    columnCellCount(const int column) const;
+    qint64 exceptionCount() const;
+
+    const QList<QRect> &ranges() const;
+    QList<QRect>        explicitRanges() const;
+
+    QList<QRect> rangesIn(const QRect &area) const;
+    QList<QRect> unselectedIn(const QList<QRect> &ranges) const;
+
+    static QList<QRect> difference(const QList<QRect> &ranges, const QList<QRect> &subtrahend);
+    static QList<QRect> united(const QList<QRect> &ranges);
+
+    int rowCount() const;
+    int columnCount() const;
+
+protected:
+    RectSet         mRanges;
+    QMap<int, int>  mSelectedRows;    // First row of the run => last row of the run
+    QMap<int, int>  mSelectedColumns; // First column of the run => last column of the run
+    BitGrid         mExceptions;
+    QVector<int>    mRowCounts;
+    QVector<int>    mColumnCounts;
+    qint64          mRangeCellCount;
+    qint64          mExceptionCount;
+    int             mSelectedRowCount;
+    int             mSelectedColumnCount;
+    int             mRowCount;
+    int             mColumnCount;
+    bool            mAllSelected;
+
+    mutable QList<QRect> mView;
+    mutable bool         mViewValid;
+
+    static void appendPieces(const QRect &range, const QRect &common, QList<QRect> &pieces);
+    static void mergeRanges(QList<QRect> &ranges);
+
+    static bool runsContain(const QMap<int, int> &runs, const int index);
+    static QList< QPair<int, int> > runsIn(const QMap<int, int> &runs, const int first, const int last, const bool flagged);
+    static int  addRun(QMap<int, int> &runs, const int first, const int last);
+    static int  removeRun(QMap<int, int> &runs, const int first, const int last);
+    static void insertRunItems(QMap<int, int> &runs, const int index, const int count);
+    static int  removeRunItems(QMap<int, int> &runs, const int index, const int count);
+
+    static void addCounts(QVector<int> &tree, const int size, const int from, const int to, const int delta);
+    static int  countAt(const QVector<int> &tree, const int index);
+    static void insertCounts(QVector<int> &tree, const int size, const int index, const int count);
+    static void removeCounts(QVector<int> &tree, const int size, const int index, const int count);
+
+    QList<QRect> flaggedIn(const QRect &area) const;
+    QList<QRect> unflaggedPieces(const QRect &range) const;
+
+    void selectRows(const int top, const int bottom);
+    void selectColumns(const int left, const int right);
+    void releaseRows();
+    void releaseColumns();
+    void releaseAll();
+    void releaseFlags(const QRect &area);
+    void releasePieces(const QList<QRect> &pieces, const QRect &area);
+
+    void selectRange(const QRect &range);
+    void subtract(const QRect &range);
+    void append(const QRect &range);
+    void rebuild(const QList<QRect> &ranges);
+    void addRangeCells(const QRect &range, const int sign);
+    void setException(const int row, const int column, const bool value);
+    void clearExceptions(const QRect &area);
+    QList<QRect> exceptionsIn(const QRect &area) const;
+    void changed();
+};
+
+#endif // SELECTIONRANGES_H
@@ -0,0 +1,276 @@
+#include "spanindex.h"
+
+#include "fastdefines.h"
+
+SpanIndex::SpanIndex()
+{
+}
+
+void SpanIndex::clear()
+{
+    mSpans.clear();
+    invalidate();
+}
+
+void SpanIndex::insertRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0);
+    FASTTABLE_ASSERT(count>=0);
+
+    for (int i=0; i<mSpans.length(); ++i)
+    {
+        QRect aSpan=mSpans.at(i);
+
+        if (aSpan.top()>=row)
+        {
+            aSpan.translate(0, count);
+        }
+        else
+        if (aSpan.bottom()>=row)
+        {
+            // New rows inside the span are merged too
+            aSpan.setHeight(aSpan.height()+count);
+        }
+
+        mSpans[i]=aSpan;
+    }
+
+    invalidate();
+}
+
+void SpanIndex::removeRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0);
+    FASTTABLE_ASSERT(count>=0);
+
+    int aEnd=row+count;
+    int aLength=0;
+
+    for (int i=0; i<mSpans.length(); ++i)
+    {
+        QRect aSpan=mSpans.at(i);
+
+        if (aSpan.top()>=aEnd)
+        {
+            aSpan.translate(0, -count);
+        }
+        else
+        if (aSpan.bottom()>=row)
+        {
+            int aHeight=aSpan.height()-(qMin(aSpan.bottom(), aEnd-1)-qMax(aSpan.top(), row)+1);
+
+            // First remaining row becomes the parent if parent row is removed
+            aSpan=QRect(aSpan.left(), qMin(aSpan.top(), row), aSpan.width(), aHeight);
+
+            if (aHeight<=0 || (aSpan.width()==1 && aHeight==1))
+            {
+                continue;
+            }
+        }
+
+        mSpans[aLength]=aSpan;
+        aLength++;
+    }
+
+    mSpans.erase(mSpans.begin()+aLength, mSpans.end());
+
+    invalidate();
+}
+
+void SpanIndex::insertColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(column>=0);
+    FASTTABLE_ASSERT(count>=0);
+
+    for (int i=0; i<mSpans.length(); ++i)
+    {
+        QRect aSpan=mSpans.at(i);
+
+        if (aSpan.left()>=column)
+        {
+            aSpan.translate(count, 0);
+        }
+        else
+        if (aSpan.right()>=column)
+        {
+            // New columns inside the span are merged too
+            aSpan.setWidth(aSpan.width()+count);
+        }
+
+        mSpans[i]=aSpan;
+    }
+
+    invalidate();
+}
+
+void SpanIndex::removeColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(column>=0);
+    FASTTABLE_ASSERT(count>=0);
+
+    int aEnd=column+count;
+    int aLength=0;
+
+    for (int i=0; i<mSpans.length(); ++i)
+    {
+        QRect aSpan=mSpans.at(i);
+
+        if (aSpan.left()>=aEnd)
+        {
+            aSpan.translate(-count, 0);
+        }
+        else
+        if (aSpan.right()>=column)
+        {
+            int aWidth=aSpan.width()-(qMin(aSpan.right(), aEnd-1)-qMax(aSpan.left(), column)+1);
+
+            // First remaining column becomes the parent if parent column is removed
+            aSpan=QRect(qMin(aSpan.left(), column), aSpan.top(), aWidth, aSpan.height());
+
+            if (aWidth<=0 || (aWidth==1 && aSpan.height()==1))
+            {
+                continue;
+            }
+        }
+
+        mSpans[aLength]=aSpan;
+        aLength++;
+    }
+
+    mSpans.erase(mSpans.begin()+aLength, mSpans.end());
+
+    invalidate();
+}
+
+void SpanIndex::setSpan(const QRect &span)
+{
+    FASTTABLE_ASSERT(span.left()>=0 && span.top()>=0);
+    FASTTABLE_ASSERT(span.width()>=1 && span.height()>=1);
+
+    // Spans overlapped by the new one are removed completely
+    int aLength=0;
+
+    for (int i=0; i<mSpans.length(); ++i)
+    {
+        if (mSpans.at(i).intersects(span))
+        {
+            continue;
+        }
+
+        mSpans[aLength]=mSpans.at(i);
+        aLength++;
+    }
+
+    mSpans.erase(mSpans.begin()+aLength, mSpans.end());
+
+    if (span.width()>1 || span.height()>1)
+    {
+        mSpans.append(span);
+    }
+
+    invalidate();
+}
+
+QRect SpanIndex::spanAt(const int row, const int column) const
+{
+    int aIndex=indexAt(row, column);
+
+    if (aIndex<0)
+    {
+        return QRect();
+    }
+
+    return mSpans.at(aIndex);
+}
+
+QPoint SpanIndex::parent(const int row, const int column) const
+{
+    int aIndex=indexAt(row, column);
+
+    if (aIndex<0)
+    {
+        return QPoint(-1, -1);
+    }
+
+    return mSpans.at(aIndex).topLeft();
+}
+
+int SpanIndex::rowSpan(const int row, const int column) const
+{
+    int aIndex=indexAt(row, column);
+
+    // Only parent cell has the size of its span
+    if (aIndex<0 || mSpans.at(aIndex).topLeft()!=QPoint(column, row))
+    {
+        return 1;
+    }
+
+    return mSpans.at(aIndex).height();
+}
+
+int SpanIndex::columnSpan(const int row, const int column) const
+{
+    int aIndex=indexAt(row, column);
+
+    // Only parent cell has the size of its span
+    if (aIndex<0 || mSpans.at(aIndex).topLeft()!=QPoint(column, row))
+    {
+        return 1;
+    }
+
+    return mSpans.at(aIndex).width();
+}
+
+QList<QRect> SpanIndex::spansIn(const QRect &area) const
+{
+    QList<QRect> res;
+
+    if (mSpans.isEmpty() || area.isEmpty())
+    {
+        return res;
+    }
+
+    if (!mIndex.isValid())
+    {
+        mIndex.build(mSpans);
+    }
+
+    QList<int> aFound=mIndex.indexesIn(mSpans, area);
+
+    for (int i=0; i<aFound.length(); ++i)
+    {
+        res.append(mSpans.at(aFound.at(i)));
+    }
+
+    return res;
+}
+
+const QList<QRect> &SpanIndex::spans() const
+{
+    return mSpans;
+}
+
+bool SpanIndex::isEmpty() const
+{
+    return mSpans.isEmpty();
+}
+
+void SpanIndex::invalidate()
+{
+    mIndex.clear();
+}
+
+int SpanIndex::indexAt(const int row, const int column) const
+{
+    if (mSpans.isEmpty())
+    {
+        return -1;
+    }
+
+    if (!mIndex.isValid())
+    {
+        mIndex.build(mSpans);
+    }
+
+    return mIndex.indexAt(mSpans, row, column);
+}
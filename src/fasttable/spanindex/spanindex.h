@@ -0,0 +1,45 @@
+#ifndef SPANINDEX_H
+#define SPANINDEX_H
+
+#include <QList>
+#include <QPoint>
+#include <QRect>
+
+#include "rectindex.h"
+
+// Merged cells stored as disjoint rectangles (x is column, y is row).
+// Lookups use RectIndex, it is rebuilt on first lookup after modification and its size depends only on span count.
+class SpanIndex
+{
+public:
+    SpanIndex();
+
+    void clear();
+
+    void insertRows(const int row, const int count);
+    void removeRows(const int row, const int count);
+    void insertColumns(const int column, const int count);
+    void removeColumns(const int column, const int count);
+
+    void setSpan(const QRect &span);
+
+    QRect  spanAt(const int row, const int column) const;
+    QPoint parent(const int row, const int column) const;
+    int    rowSpan(const int row, const int column) const;
+    int    columnSpan(const int row, const int column) const;
+
+    QList<QRect> spansIn(const QRect &area) const;
+
+    const QList<QRect> &spans() const;
+    bool isEmpty() const;
+
+protected:
+    QList<QRect> mSpans;
+
+    mutable RectIndex mIndex;
+
+    void invalidate();
+    int  indexAt(const int row, const int column) const;
+};
+
+#endif // SPANINDEX_H
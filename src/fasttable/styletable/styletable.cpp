@@ -0,0 +1,331 @@
+#include "styletable.h"
+
+#include "fastdefines.h"
+
+// Small tables are not compacted
+#define STYLETABLE_MIN_COMPACTION_LIMIT 64
+
+// Returns index of value equal to the given one, value is added if not found
+template <typename T>
+static int internValue(QList<T *> &values, QMultiHash<uint, int> &index, const T &value, const uint hash)
+{
+    for (QMultiHash<uint, int>::const_iterator i=index.constFind(hash); i!=index.constEnd() && i.key()==hash; ++i)
+    {
+        if (*values.at(i.value())==value)
+        {
+            return i.value();
+        }
+    }
+
+    values.append(new T(value));
+    index.insert(hash, values.length()-1);
+
+    return values.length()-1;
+}
+
+template <typename T>
+static void deleteValues(QList<T *> &values)
+{
+    for (int i=0; i<values.length(); ++i)
+    {
+        delete values.at(i);
+    }
+
+    values.clear();
+}
+
+// Keeps only used values, returns new index of every old value (-1 for removed)
+template <typename T>
+static QList<int> compactValues(QList<T *> &values, QMultiHash<uint, int> &index, const QList<bool> &usedValues)
+{
+    QList<int> res;
+    res.reserve(values.length());
+
+    QList<T *> aValues;
+
+    for (int i=0; i<values.length(); ++i)
+    {
+        if (usedValues.at(i))
+        {
+            res.append(aValues.length());
+            aValues.append(values.at(i));
+        }
+        else
+        {
+            res.append(-1);
+            delete values.at(i);
+        }
+    }
+
+    QMultiHash<uint, int> aIndex;
+
+    for (QMultiHash<uint, int>::const_iterator i=index.constBegin(); i!=index.constEnd(); ++i)
+    {
+        if (res.at(i.value())>=0)
+        {
+            aIndex.insert(i.key(), res.at(i.value()));
+        }
+    }
+
+    values=aValues;
+    index=aIndex;
+
+    return res;
+}
+
+static int remapValue(const QList<int> &newIndexes, const int value)
+{
+    return value<0 ? -1 : newIndexes.at(value);
+}
+
+StyleTable::StyleTable(const int defaultTextFlags)
+{
+    mDefaultTextFlags=defaultTextFlags;
+    mCompactionLimit=STYLETABLE_MIN_COMPACTION_LIMIT;
+
+    styleIndex(-1, -1, -1, mDefaultTextFlags);
+}
+
+StyleTable::~StyleTable()
+{
+    deleteValues(mBrushes);
+    deleteValues(mColors);
+    deleteValues(mFonts);
+}
+
+void StyleTable::clear()
+{
+    deleteValues(mBrushes);
+    deleteValues(mColors);
+    deleteValues(mFonts);
+
+    mBrushesIndex.clear();
+    mColorsIndex.clear();
+    mFontsIndex.clear();
+
+    mStyles.clear();
+    mStylesIndex.clear();
+
+    mCompactionLimit=STYLETABLE_MIN_COMPACTION_LIMIT;
+
+    styleIndex(-1, -1, -1, mDefaultTextFlags);
+}
+
+int StyleTable::count() const
+{
+    return mStyles.length();
+}
+
+bool StyleTable::isCompactionNeeded() const
+{
+    return mStyles.length()>=mCompactionLimit;
+}
+
+QList<int> StyleTable::compact(const QList<bool> &usedStyles)
+{
+    FASTTABLE_ASSERT(usedStyles.length()==mStyles.length());
+
+    // Default style always stays with index 0
+    QList<int> res;
+    res.reserve(mStyles.length());
+
+    QList<Style> aStyles;
+
+    QList<bool> aUsedBrushes;
+    QList<bool> aUsedColors;
+    QList<bool> aUsedFonts;
+
+    for (int i=0; i<mBrushes.length(); ++i)
+    {
+        aUsedBrushes.append(false);
+    }
+
+    for (int i=0; i<mColors.length(); ++i)
+    {
+        aUsedColors.append(false);
+    }
+
+    for (int i=0; i<mFonts.length(); ++i)
+    {
+        aUsedFonts.append(false);
+    }
+
+    for (int i=0; i<mStyles.length(); ++i)
+    {
+        if (i==0 || usedStyles.at(i))
+        {
+            const Style &aStyle=mStyles.at(i);
+
+            if (aStyle.first.first>=0)
+            {
+                aUsedBrushes[aStyle.first.first]=true;
+            }
+
+            if (aStyle.first.second>=0)
+            {
+                aUsedColors[aStyle.first.second]=true;
+            }
+
+            if (aStyle.second.first>=0)
+            {
+                aUsedFonts[aStyle.second.first]=true;
+            }
+
+            res.append(aStyles.length());
+            aStyles.append(aStyle);
+        }
+        else
+        {
+            res.append(-1);
+        }
+    }
+
+    QList<int> aNewBrushes=compactValues(mBrushes, mBrushesIndex, aUsedBrushes);
+    QList<int> aNewColors=compactValues(mColors, mColorsIndex, aUsedColors);
+    QList<int> aNewFonts=compactValues(mFonts, mFontsIndex, aUsedFonts);
+
+    mStyles.clear();
+    mStylesIndex.clear();
+
+    for (int i=0; i<aStyles.length(); ++i)
+    {
+        const Style &aStyle=aStyles.at(i);
+
+        styleIndex(remapValue(aNewBrushes, aStyle.first.first), remapValue(aNewColors, aStyle.first.second), remapValue(aNewFonts, aStyle.second.first), aStyle.second.second);
+    }
+
+    FASTTABLE_ASSERT(mStyles.length()==aStyles.length());
+
+    // Table may grow twice before the next compaction, so its cost is spread over new styles
+    mCompactionLimit=qMax(mStyles.length()*2, STYLETABLE_MIN_COMPACTION_LIMIT);
+
+    return res;
+}
+
+QBrush *StyleTable::backgroundBrush(const int style) const
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    int aIndex=mStyles.at(style).first.first;
+
+    return aIndex<0 ? 0 : mBrushes.at(aIndex);
+}
+
+QColor *StyleTable::foregroundColor(const int style) const
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    int aIndex=mStyles.at(style).first.second;
+
+    return aIndex<0 ? 0 : mColors.at(aIndex);
+}
+
+QFont *StyleTable::font(const int style) const
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    int aIndex=mStyles.at(style).second.first;
+
+    return aIndex<0 ? 0 : mFonts.at(aIndex);
+}
+
+int StyleTable::textFlags(const int style) const
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    return mStyles.at(style).second.second;
+}
+
+bool StyleTable::hasTextFlags(const int style) const
+{
+    // Setting default flags is the same as resetting them
+    return textFlags(style)!=mDefaultTextFlags;
+}
+
+int StyleTable::setBackgroundBrush(const int style, const QBrush &brush)
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    int aBrush=internValue(mBrushes, mBrushesIndex, brush, brush.color().rgba() ^ ((uint)brush.style()<<24));
+    const Style &aStyle=mStyles.at(style);
+
+    return styleIndex(aBrush, aStyle.first.second, aStyle.second.first, aStyle.second.second);
+}
+
+int StyleTable::resetBackgroundBrush(const int style)
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    const Style &aStyle=mStyles.at(style);
+
+    return styleIndex(-1, aStyle.first.second, aStyle.second.first, aStyle.second.second);
+}
+
+int StyleTable::setForegroundColor(const int style, const QColor &color)
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    int aColor=internValue(mColors, mColorsIndex, color, color.rgba());
+    const Style &aStyle=mStyles.at(style);
+
+    return styleIndex(aStyle.first.first, aColor, aStyle.second.first, aStyle.second.second);
+}
+
+int StyleTable::resetForegroundColor(const int style)
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    const Style &aStyle=mStyles.at(style);
+
+    return styleIndex(aStyle.first.first, -1, aStyle.second.first, aStyle.second.second);
+}
+
+int StyleTable::setFont(const int style, const QFont &font)
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    int aFont=internValue(mFonts, mFontsIndex, font, qHash(font.key()));
+    const Style &aStyle=mStyles.at(style);
+
+    return styleIndex(aStyle.first.first, aStyle.first.second, aFont, aStyle.second.second);
+}
+
+int StyleTable::resetFont(const int style)
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    const Style &aStyle=mStyles.at(style);
+
+    return styleIndex(aStyle.first.first, aStyle.first.second, -1, aStyle.second.second);
+}
+
+int StyleTable::setTextFlags(const int style, const int flags)
+{
+    FASTTABLE_ASSERT(style>=0 && style<mStyles.length());
+
+    const Style &aStyle=mStyles.at(style);
+
+    return styleIndex(aStyle.first.first, aStyle.first.second, aStyle.second.first, flags);
+}
+
+int StyleTable::resetTextFlags(const int style)
+{
+    return setTextFlags(style, mDefaultTextFlags);
+}
+
+int StyleTable::styleIndex(const int brush, const int color, const int font, const int textFlags)
+{
+    Style aStyle(qMakePair(brush, color), qMakePair(font, textFlags));
+
+    QHash<Style, int>::const_iterator aFound=mStylesIndex.constFind(aStyle);
+
+    if (aFound!=mStylesIndex.constEnd())
+    {
+        return aFound.value();
+    }
+
+    mStyles.append(aStyle);
+    mStylesIndex.insert(aStyle, mStyles.length()-1);
+
+    return mStyles.length()-1;
+}
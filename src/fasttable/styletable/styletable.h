@@ -0,0 +1,64 @@
+#ifndef STYLETABLE_H
+#define STYLETABLE_H
+
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+
+// Unique combinations of cell attributes. Cells keep only index of their style.
+// Style 0 is default style: no brush, color and font with default text flags.
+// Brushes, colors and fonts are stored once. Styles are never removed on their own, owner calls compact() with styles still in use.
+class StyleTable
+{
+public:
+    StyleTable(const int defaultTextFlags);
+    ~StyleTable();
+
+    void clear();
+    int count() const;
+
+    bool isCompactionNeeded() const;
+    QList<int> compact(const QList<bool> &usedStyles);
+
+    QBrush *backgroundBrush(const int style) const;
+    QColor *foregroundColor(const int style) const;
+    QFont  *font(const int style) const;
+    int     textFlags(const int style) const;
+    bool    hasTextFlags(const int style) const;
+
+    int setBackgroundBrush(const int style, const QBrush &brush);
+    int resetBackgroundBrush(const int style);
+    int setForegroundColor(const int style, const QColor &color);
+    int resetForegroundColor(const int style);
+    int setFont(const int style, const QFont &font);
+    int resetFont(const int style);
+    int setTextFlags(const int style, const int flags);
+    int resetTextFlags(const int style);
+
+protected:
+    // Indexes of brush and color, index of font and text flags. Index is -1 if attribute is not set
+    typedef QPair< QPair<int, int>, QPair<int, int> > Style;
+
+    int mDefaultTextFlags;
+    int mCompactionLimit;
+
+    QList<QBrush *>       mBrushes;
+    QList<QColor *>       mColors;
+    QList<QFont *>        mFonts;
+    QMultiHash<uint, int> mBrushesIndex;
+    QMultiHash<uint, int> mColorsIndex;
+    QMultiHash<uint, int> mFontsIndex;
+
+    QList<Style>          mStyles;
+    QHash<Style, int>     mStylesIndex;
+
+    int styleIndex(const int brush, const int color, const int font, const int textFlags);
+
+private:
+    Q_DISABLE_COPY(StyleTable)
+};
+
+#endif // STYLETABLE_H
@@ -0,0 +1,517 @@
+#include "textcolumns.h"
+
+#include <string.h>
+#include <QtAlgorithms>
+#include <QPair>
+
+#include "fastdefines.h"
+
+// Arena is not compacted while garbage is small
+#define TEXTCOLUMN_MIN_GARBAGE 4096
+
+// Dictionary is not compacted while it is small
+#define TEXTCOLUMN_MIN_DICTIONARY 1024
+
+// Codes are 16-bit while dictionary has no more texts than this
+#define TEXTCOLUMN_MAX_SHORT_CODES 65536
+
+TextColumn::TextColumn(const int rowCount)
+{
+    FASTTABLE_ASSERT(rowCount>=0);
+
+    mOffsets.fill(0, rowCount);
+    mLengths.fill(0, rowCount);
+    mGarbage=0;
+
+    mDictionaryEncoded=false;
+}
+
+int TextColumn::rowCount() const
+{
+    if (mDictionaryEncoded)
+    {
+        return longCodes() ? mLongCodes.size() : mShortCodes.size();
+    }
+
+    return mOffsets.size();
+}
+
+void TextColumn::insertRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0 && row<=rowCount());
+    FASTTABLE_ASSERT(count>=0);
+
+    if (mDictionaryEncoded)
+    {
+        if (longCodes())
+        {
+            mLongCodes.insert(row, count, 0);
+        }
+        else
+        {
+            mShortCodes.insert(row, count, 0);
+        }
+
+        return;
+    }
+
+    mOffsets.insert(row, count, 0);
+    mLengths.insert(row, count, 0);
+}
+
+void TextColumn::removeRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0 && row+count<=rowCount());
+    FASTTABLE_ASSERT(count>=0);
+
+    if (mDictionaryEncoded)
+    {
+        if (longCodes())
+        {
+            mLongCodes.remove(row, count);
+        }
+        else
+        {
+            mShortCodes.remove(row, count);
+        }
+
+        if (mDictionary.length()>TEXTCOLUMN_MIN_DICTIONARY && mDictionary.length()>rowCount()*2)
+        {
+            compactDictionary();
+        }
+
+        return;
+    }
+
+    for (int i=row; i<row+count; ++i)
+    {
+        mGarbage+=mLengths.at(i);
+    }
+
+    mOffsets.remove(row, count);
+    mLengths.remove(row, count);
+
+    if (mOffsets.isEmpty())
+    {
+        mArena.clear();
+        mGarbage=0;
+    }
+    else
+    if (mGarbage>TEXTCOLUMN_MIN_GARBAGE && mGarbage*2>mArena.length())
+    {
+        compact();
+    }
+}
+
+QString TextColumn::text(const int row) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<rowCount());
+
+    if (mDictionaryEncoded)
+    {
+        // Texts are implicitly shared with the dictionary
+        return mDictionary.at(code(row));
+    }
+
+    return mArena.mid(mOffsets.at(row), mLengths.at(row));
+}
+
+void TextColumn::setText(const int row, const QString &text)
+{
+    FASTTABLE_ASSERT(row>=0 && row<rowCount());
+
+    if (mDictionaryEncoded)
+    {
+        setCode(row, internText(text));
+
+        if (mDictionary.length()>TEXTCOLUMN_MIN_DICTIONARY && mDictionary.length()>rowCount()*2)
+        {
+            compactDictionary();
+        }
+
+        return;
+    }
+
+    int aLength=mLengths.at(row);
+
+    if (text.length()<=aLength)
+    {
+        // Text fits into the old place
+        if (text.length()>0)
+        {
+            memcpy(mArena.data()+mOffsets.at(row), text.constData(), text.length()*sizeof(QChar));
+        }
+
+        mGarbage+=aLength-text.length();
+    }
+    else
+    {
+        mOffsets[row]=mArena.length();
+        mArena.append(text);
+
+        mGarbage+=aLength;
+    }
+
+    mLengths[row]=text.length();
+
+    if (mGarbage>TEXTCOLUMN_MIN_GARBAGE && mGarbage*2>mArena.length())
+    {
+        compact();
+    }
+}
+
+const QChar *TextColumn::textData(const int row) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<rowCount());
+
+    if (mDictionaryEncoded)
+    {
+        return mDictionary.at(code(row)).constData();
+    }
+
+    return mArena.constData()+mOffsets.at(row);
+}
+
+int TextColumn::textLength(const int row) const
+{
+    FASTTABLE_ASSERT(row>=0 && row<rowCount());
+
+    if (mDictionaryEncoded)
+    {
+        return mDictionary.at(code(row)).length();
+    }
+
+    return mLengths.at(row);
+}
+
+bool TextColumn::isDictionaryEncoded() const
+{
+    return mDictionaryEncoded;
+}
+
+void TextColumn::setDictionaryEncoded(const bool encoded)
+{
+    if (mDictionaryEncoded==encoded)
+    {
+        return;
+    }
+
+    int aRowCount=rowCount();
+
+    if (encoded)
+    {
+        mDictionaryEncoded=true;
+
+        internText(QString());
+        mShortCodes.fill(0, aRowCount);
+
+        for (int i=0; i<aRowCount; ++i)
+        {
+            if (mLengths.at(i)>0)
+            {
+                setCode(i, internText(mArena.mid(mOffsets.at(i), mLengths.at(i))));
+            }
+        }
+
+        mArena.clear();
+        mOffsets.clear();
+        mLengths.clear();
+        mGarbage=0;
+    }
+    else
+    {
+        mOffsets.fill(0, aRowCount);
+        mLengths.fill(0, aRowCount);
+
+        for (int i=0; i<aRowCount; ++i)
+        {
+            const QString &aText=mDictionary.at(code(i));
+
+            mOffsets[i]=mArena.length();
+            mLengths[i]=aText.length();
+            mArena.append(aText);
+        }
+
+        mDictionary.clear();
+        mDictionaryIndex.clear();
+        mShortCodes.clear();
+        mLongCodes.clear();
+
+        mDictionaryEncoded=false;
+    }
+}
+
+int TextColumn::code(const int row) const
+{
+    FASTTABLE_ASSERT(mDictionaryEncoded);
+    FASTTABLE_ASSERT(row>=0 && row<rowCount());
+
+    return longCodes() ? mLongCodes.at(row) : mShortCodes.at(row);
+}
+
+int TextColumn::findCode(const QString &text) const
+{
+    FASTTABLE_ASSERT(mDictionaryEncoded);
+
+    return mDictionaryIndex.value(text, -1);
+}
+
+int TextColumn::dictionaryCount() const
+{
+    return mDictionary.length();
+}
+
+QString TextColumn::dictionaryText(const int code) const
+{
+    FASTTABLE_ASSERT(code>=0 && code<mDictionary.length());
+
+    return mDictionary.at(code);
+}
+
+QVector<int> TextColumn::codeOrder() const
+{
+    FASTTABLE_ASSERT(mDictionaryEncoded);
+
+    // Rank of every code by its text, so rows could be sorted by comparing ranks
+    QList< QPair<QString, int> > aTexts;
+    aTexts.reserve(mDictionary.length());
+
+    for (int i=0; i<mDictionary.length(); ++i)
+    {
+        aTexts.append(qMakePair(mDictionary.at(i), i));
+    }
+
+    qSort(aTexts);
+
+    QVector<int> res(mDictionary.length());
+
+    for (int i=0; i<aTexts.length(); ++i)
+    {
+        res[aTexts.at(i).second]=i;
+    }
+
+    return res;
+}
+
+void TextColumn::compact()
+{
+    QString aArena;
+    aArena.reserve(mArena.length()-mGarbage);
+
+    for (int i=0; i<mOffsets.size(); ++i)
+    {
+        int aOffset=aArena.length();
+
+        aArena.append(QString::fromRawData(mArena.constData()+mOffsets.at(i), mLengths.at(i)));
+        mOffsets[i]=aOffset;
+    }
+
+    mArena=aArena;
+    mGarbage=0;
+}
+
+bool TextColumn::longCodes() const
+{
+    return mDictionary.length()>TEXTCOLUMN_MAX_SHORT_CODES;
+}
+
+int TextColumn::internText(const QString &text)
+{
+    QHash<QString, int>::const_iterator aFound=mDictionaryIndex.constFind(text);
+
+    if (aFound!=mDictionaryIndex.constEnd())
+    {
+        return aFound.value();
+    }
+
+    mDictionary.append(text);
+    mDictionaryIndex.insert(text, mDictionary.length()-1);
+
+    // Codes become 32-bit when the new code doesn't fit into 16 bits
+    if (mDictionary.length()==TEXTCOLUMN_MAX_SHORT_CODES+1)
+    {
+        mLongCodes.resize(mShortCodes.size());
+
+        for (int i=0; i<mShortCodes.size(); ++i)
+        {
+            mLongCodes[i]=mShortCodes.at(i);
+        }
+
+        mShortCodes.clear();
+    }
+
+    return mDictionary.length()-1;
+}
+
+void TextColumn::setCode(const int row, const int code)
+{
+    if (longCodes())
+    {
+        mLongCodes[row]=code;
+    }
+    else
+    {
+        mShortCodes[row]=code;
+    }
+}
+
+void TextColumn::compactDictionary()
+{
+    // Texts that are not used by any row are removed, other texts keep their order
+    int aRowCount=rowCount();
+    QVector<int> aCodes(mDictionary.length(), -1);
+
+    aCodes[0]=1;
+
+    for (int i=0; i<aRowCount; ++i)
+    {
+        aCodes[code(i)]=1;
+    }
+
+    QStringList aDictionary;
+
+    for (int i=0; i<mDictionary.length(); ++i)
+    {
+        if (aCodes.at(i)>0)
+        {
+            aCodes[i]=aDictionary.length();
+            aDictionary.append(mDictionary.at(i));
+        }
+    }
+
+    QVector<int> aRows(aRowCount);
+
+    for (int i=0; i<aRowCount; ++i)
+    {
+        aRows[i]=aCodes.at(code(i));
+    }
+
+    mDictionary=aDictionary;
+    mDictionaryIndex.clear();
+
+    for (int i=0; i<mDictionary.length(); ++i)
+    {
+        mDictionaryIndex.insert(mDictionary.at(i), i);
+    }
+
+    mShortCodes.clear();
+    mLongCodes.clear();
+
+    if (longCodes())
+    {
+        mLongCodes.resize(aRowCount);
+    }
+    else
+    {
+        mShortCodes.resize(aRowCount);
+    }
+
+    for (int i=0; i<aRowCount; ++i)
+    {
+        setCode(i, aRows.at(i));
+    }
+}
+
+//------------------------------------------------------------------------------
+
+TextColumns::TextColumns()
+{
+    mRowCount=0;
+}
+
+TextColumns::~TextColumns()
+{
+    clear();
+}
+
+void TextColumns::clear()
+{
+    for (int i=0; i<mColumns.length(); ++i)
+    {
+        delete mColumns.at(i);
+    }
+
+    mColumns.clear();
+    mRowCount=0;
+}
+
+int TextColumns::rowCount() const
+{
+    return mRowCount;
+}
+
+int TextColumns::columnCount() const
+{
+    return mColumns.length();
+}
+
+void TextColumns::insertRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0 && row<=mRowCount);
+    FASTTABLE_ASSERT(count>=0);
+
+    for (int i=0; i<mColumns.length(); ++i)
+    {
+        mColumns.at(i)->insertRows(row, count);
+    }
+
+    mRowCount+=count;
+}
+
+void TextColumns::removeRows(const int row, const int count)
+{
+    FASTTABLE_ASSERT(row>=0 && row+count<=mRowCount);
+    FASTTABLE_ASSERT(count>=0);
+
+    for (int i=0; i<mColumns.length(); ++i)
+    {
+        mColumns.at(i)->removeRows(row, count);
+    }
+
+    mRowCount-=count;
+}
+
+void TextColumns::insertColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(column>=0 && column<=mColumns.length());
+    FASTTABLE_ASSERT(count>=0);
+
+    for (int i=0; i<count; ++i)
+    {
+        mColumns.insert(column+i, new TextColumn(mRowCount));
+    }
+}
+
+void TextColumns::removeColumns(const int column, const int count)
+{
+    FASTTABLE_ASSERT(column>=0 && column+count<=mColumns.length());
+    FASTTABLE_ASSERT(count>=0);
+
+    for (int i=column; i<column+count; ++i)
+    {
+        delete mColumns.at(i);
+    }
+
+    mColumns.erase(mColumns.begin()+column, mColumns.begin()+column+count);
+}
+
+QString TextColumns::text(const int row, const int column) const
+{
+    FASTTABLE_ASSERT(column>=0 && column<mColumns.length());
+
+    return mColumns.at(column)->text(row);
+}
+
+void TextColumns::setText(const int row, const int column, const QString &text)
+{
+    FASTTABLE_ASSERT(column>=0 && column<mColumns.length());
+
+    mColumns.at(column)->setText(row, text);
+}
+
+TextColumn *TextColumns::column(const int column) const
+{
+    FASTTABLE_ASSERT(column>=0 && column<mColumns.length());
+
+    return mColumns.at(column);
+}
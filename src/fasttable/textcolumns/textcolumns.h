@@ -0,0 +1,88 @@
+#ifndef TEXTCOLUMNS_H
+#define TEXTCOLUMNS_H
+
+#include <QList>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Texts of one column stored in single arena. Every row keeps offset and length of its text.
+// Replaced texts leave garbage in the arena, arena is compacted when garbage takes more than a half.
+// Dictionary encoded column keeps every distinct text once and rows keep only 16-bit (32-bit for large dictionary) codes.
+// Code 0 is always empty text.
+class TextColumn
+{
+public:
+    TextColumn(const int rowCount=0);
+
+    int rowCount() const;
+
+    void insertRows(const int row, const int count);
+    void removeRows(const int row, const int count);
+
+    QString      text(const int row) const;
+    void         setText(const int row, const QString &text);
+    const QChar *textData(const int row) const;
+    int          textLength(const int row) const;
+
+    bool isDictionaryEncoded() const;
+    void setDictionaryEncoded(const bool encoded);
+
+    int          code(const int row) const;
+    int          findCode(const QString &text) const;
+    int          dictionaryCount() const;
+    QString      dictionaryText(const int code) const;
+    QVector<int> codeOrder() const;
+
+protected:
+    QString      mArena;
+    QVector<int> mOffsets;
+    QVector<int> mLengths;
+    int          mGarbage;
+
+    bool                mDictionaryEncoded;
+    QStringList         mDictionary;
+    QHash<QString, int> mDictionaryIndex;
+    QVector<quint16>    mShortCodes;
+    QVector<quint32>    mLongCodes;
+
+    void compact();
+
+    bool longCodes() const;
+    int  internText(const QString &text);
+    void setCode(const int row, const int code);
+    void compactDictionary();
+};
+
+// Cell texts stored by columns, so column operations and column scans touch only memory of these columns
+class TextColumns
+{
+public:
+    TextColumns();
+    ~TextColumns();
+
+    void clear();
+
+    int rowCount() const;
+    int columnCount() const;
+
+    void insertRows(const int row, const int count);
+    void removeRows(const int row, const int count);
+    void insertColumns(const int column, const int count);
+    void removeColumns(const int column, const int count);
+
+    QString text(const int row, const int column) const;
+    void    setText(const int row, const int column, const QString &text);
+
+    TextColumn *column(const int column) const;
+
+protected:
+    QList<TextColumn *> mColumns;
+    int                 mRowCount;
+
+private:
+    Q_DISABLE_COPY(TextColumns)
+};
+
+#endif // TEXTCOLUMNS_H
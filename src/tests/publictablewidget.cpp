@@ -1,138 +1,48 @@
 #include "publictablewidget.h"
 
-QList< QList<QBrush *> >  *PublicFastTable::getBackgroundBrushes()
+StyleTable                *PublicFastTable::getStyles()
 {
-    return mBackgroundBrushes;
+    return mStyles;
 }
 
-QList< QList<QColor *> >  *PublicFastTable::getForegroundColors()
+QList< QList<int> >       *PublicFastTable::getCellStyles()
 {
-    return mForegroundColors;
+    return mCellStyles;
 }
 
-QList< QList<QFont *> >   *PublicFastTable::getCellFonts()
+SpanIndex                 *PublicFastTable::getSpans()
 {
-    return mCellFonts;
+    return mSpans;
 }
 
-QList< QList<int> >       *PublicFastTable::getCellTextFlags()
+StyleTable                *PublicFastTable::horizontalHeader_GetStyles()
 {
-    return mCellTextFlags;
+    return mHorizontalHeader_Styles;
 }
 
-QList< QList<quint16> >   *PublicFastTable::getCellMergeX()
+QList< QList<int> >       *PublicFastTable::horizontalHeader_GetCellStyles()
 {
-    return mCellMergeX;
+    return mHorizontalHeader_CellStyles;
 }
 
-QList< QList<quint16> >   *PublicFastTable::getCellMergeY()
+SpanIndex                 *PublicFastTable::horizontalHeader_GetSpans()
 {
-    return mCellMergeY;
+    return mHorizontalHeader_Spans;
 }
 
-QList< QList<int> >       *PublicFastTable::getCellMergeParentRow()
+StyleTable                *PublicFastTable::verticalHeader_GetStyles()
 {
-    return mCellMergeParentRow;
+    return mVerticalHeader_Styles;
 }
 
-QList< QList<int> >       *PublicFastTable::getCellMergeParentColumn()
+QList< QList<int> >       *PublicFastTable::verticalHeader_GetCellStyles()
 {
-    return mCellMergeParentColumn;
+    return mVerticalHeader_CellStyles;
 }
 
-QList< QRect >            *PublicFastTable::getMerges()
+SpanIndex                 *PublicFastTable::verticalHeader_GetSpans()
 {
-    return mMerges;
-}
-
-QList< QList<QBrush *> >  *PublicFastTable::horizontalHeader_GetBackgroundBrushes()
-{
-    return mHorizontalHeader_BackgroundBrushes;
-}
-
-QList< QList<QColor *> >  *PublicFastTable::horizontalHeader_GetForegroundColors()
-{
-    return mHorizontalHeader_ForegroundColors;
-}
-
-QList< QList<QFont *> >   *PublicFastTable::horizontalHeader_GetCellFonts()
-{
-    return mHorizontalHeader_CellFonts;
-}
-
-QList< QList<int> >       *PublicFastTable::horizontalHeader_GetCellTextFlags()
-{
-    return mHorizontalHeader_CellTextFlags;
-}
-
-QList< QList<quint16> >   *PublicFastTable::horizontalHeader_GetCellMergeX()
-{
-    return mHorizontalHeader_CellMergeX;
-}
-
-QList< QList<quint16> >   *PublicFastTable::horizontalHeader_GetCellMergeY()
-{
-    return mHorizontalHeader_CellMergeY;
-}
-
-QList< QList<int> >       *PublicFastTable::horizontalHeader_GetCellMergeParentRow()
-{
-    return mHorizontalHeader_CellMergeParentRow;
-}
-
-QList< QList<int> >       *PublicFastTable::horizontalHeader_GetCellMergeParentColumn()
-{
-    return mHorizontalHeader_CellMergeParentColumn;
-}
-
-QList< QRect >            *PublicFastTable::horizontalHeader_GetMerges()
-{
-    return mHorizontalHeader_Merges;
-}
-
-QList< QList<QBrush *> >  *PublicFastTable::verticalHeader_GetBackgroundBrushes()
-{
-    return mVerticalHeader_BackgroundBrushes;
-}
-
-QList< QList<QColor *> >  *PublicFastTable::verticalHeader_GetForegroundColors()
-{
-    return mVerticalHeader_ForegroundColors;
-}
-
-QList< QList<QFont *> >   *PublicFastTable::verticalHeader_GetCellFonts()
-{
-    return mVerticalHeader_CellFonts;
-}
-
-QList< QList<int> >       *PublicFastTable::verticalHeader_GetCellTextFlags()
-{
-    return mVerticalHeader_CellTextFlags;
-}
-
-QList< QList<quint16> >   *PublicFastTable::verticalHeader_GetCellMergeX()
-{
-    return mVerticalHeader_CellMergeX;
-}
-
-QList< QList<quint16> >   *PublicFastTable::verticalHeader_GetCellMergeY()
-{
-    return mVerticalHeader_CellMergeY;
-}
-
-QList< QList<int> >       *PublicFastTable::verticalHeader_GetCellMergeParentRow()
-{
-    return mVerticalHeader_CellMergeParentRow;
-}
-
-QList< QList<int> >       *PublicFastTable::verticalHeader_GetCellMergeParentColumn()
-{
-    return mVerticalHeader_CellMergeParentColumn;
-}
-
-QList< QRect >            *PublicFastTable::verticalHeader_GetMerges()
-{
-    return mVerticalHeader_Merges;
+    return mVerticalHeader_Spans;
 }
 
 // ==============================================================================================================
@@ -272,22 +182,27 @@ QList< QStringList > *PublicCustomFastTable::getData()
     return mData;
 }
 
-QList< qint16 >      *PublicCustomFastTable::getRowHeights()
+TextColumns          *PublicCustomFastTable::getTextColumns()
+{
+    return mTextColumns;
+}
+
+SizeList             *PublicCustomFastTable::getRowHeights()
 {
     return mRowHeights;
 }
 
-QList< qint16 >      *PublicCustomFastTable::getColumnWidths()
+SizeList             *PublicCustomFastTable::getColumnWidths()
 {
     return mColumnWidths;
 }
 
-QList< int >         *PublicCustomFastTable::getOffsetX()
+OffsetIndex          *PublicCustomFastTable::getOffsetX()
 {
     return mOffsetX;
 }
 
-QList< int >         *PublicCustomFastTable::getOffsetY()
+OffsetIndex          *PublicCustomFastTable::getOffsetY()
 {
     return mOffsetY;
 }
@@ -322,24 +237,9 @@ QList< int >         *PublicCustomFastTable::verticalHeader_GetOffsetX()
     return mVerticalHeader_OffsetX;
 }
 
-QList< QList<bool> > *PublicCustomFastTable::getSelectedCells()
-{
-    return mSelectedCells;
-}
-
-QList< QPoint >      *PublicCustomFastTable::getCurSelection()
-{
-    return mCurSelection;
-}
-
-QList< int >         *PublicCustomFastTable::horizontalHeader_GetSelectedColumns()
-{
-    return mHorizontalHeader_SelectedColumns;
-}
-
-QList< int >         *PublicCustomFastTable::verticalHeader_GetSelectedRows()
+SelectionRanges      *PublicCustomFastTable::getSelection()
 {
-    return mVerticalHeader_SelectedRows;
+    return mSelection;
 }
 
 int PublicCustomFastTable::getCurrentRow()
@@ -412,7 +312,113 @@ CustomFastTableWidget::MouseLocation PublicCustomFastTable::getMouseLocationForS
     return mMouseLocationForShift;
 }
 
-QList< QList<bool> > *PublicCustomFastTable::getMouseSelectedCells()
+SelectionRanges *PublicCustomFastTable::getMouseBaseSelection()
+{
+    return mMouseBaseSelection;
+}
+
+QRect PublicCustomFastTable::getMouseSelectedRange()
+{
+    return mMouseSelectedRange;
+}
+
+QRect PublicCustomFastTable::getExposedCells(const QRect &area)
+{
+    return exposedCells(area);
+}
+
+QRect PublicCustomFastTable::getScrolledArea(const int dx, const int dy)
+{
+    return scrolledArea(dx, dy);
+}
+
+QRect PublicCustomFastTable::getDirtyArea(const QRect &range)
+{
+    return dirtyArea(range);
+}
+
+QString PublicCustomFastTable::getCachedText(const int row, const int column)
+{
+    return cachedText(row, column);
+}
+
+void PublicCustomFastTable::setShiftAnchor(const int row, const int column)
+{
+    mMouseXForShift=column;
+    mMouseYForShift=row;
+    mLastX=column;
+    mLastY=row;
+}
+
+void PublicCustomFastTable::doFillShiftSelection()
+{
+    fillShiftSelection();
+}
+
+void PublicCustomFastTable::doSelectRangeForHandlers(const int row, const int column)
+{
+    selectRangeForHandlers(column, row);
+}
+
+void PublicCustomFastTable::horizontalHeader_DoFillShiftSelection()
 {
-    return mMouseSelectedCells;
+    horizontalHeader_FillShiftSelection();
+}
+
+void PublicCustomFastTable::horizontalHeader_DoSelectRangeForHandlers(const int column)
+{
+    horizontalHeader_SelectRangeForHandlers(column);
+}
+
+void PublicCustomFastTable::verticalHeader_DoFillShiftSelection()
+{
+    verticalHeader_FillShiftSelection();
+}
+
+void PublicCustomFastTable::verticalHeader_DoSelectRangeForHandlers(const int row)
+{
+    verticalHeader_SelectRangeForHandlers(row);
+}
+
+void PublicCustomFastTable::doMouseRelease()
+{
+    QMouseEvent aEvent(QEvent::MouseButtonRelease, QPoint(-1, -1), Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    mouseReleaseEvent(&aEvent);
+}
+
+PublicAsyncDataProvider::PublicAsyncDataProvider(const int blockSize) :
+    AsyncDataProvider(blockSize)
+{
+}
+
+PublicAsyncDataProvider::~PublicAsyncDataProvider()
+{
+    stop();
+}
+
+QList<int> PublicAsyncDataProvider::getLoadedBlocks()
+{
+    QMutexLocker aLocker(&mLoadedMutex);
+
+    return mLoadedBlocks;
+}
+
+bool PublicAsyncDataProvider::isThreadRunning()
+{
+    return mThread->isRunning();
+}
+
+QList<QStringList> PublicAsyncDataProvider::loadRows(const int row, const int count)
+{
+    QList<QStringList> res;
+
+    for (int i=row; i<row+count; ++i)
+    {
+        res.append(QStringList()<<QString::number(i)<<"Row "+QString::number(i));
+    }
+
+    QMutexLocker aLocker(&mLoadedMutex);
+    mLoadedBlocks.append(row/blockSize());
+
+    return res;
 }
@@ -6,35 +6,17 @@
 class PublicFastTable : public FastTableWidget
 {
 public:
-    QList< QList<QBrush *> > *getBackgroundBrushes();
-    QList< QList<QColor *> > *getForegroundColors();
-    QList< QList<QFont *> >  *getCellFonts();
-    QList< QList<int> >      *getCellTextFlags();
-    QList< QList<quint16> >  *getCellMergeX();
-    QList< QList<quint16> >  *getCellMergeY();
-    QList< QList<int> >      *getCellMergeParentRow();
-    QList< QList<int> >      *getCellMergeParentColumn();
-    QList< QRect >           *getMerges();
-
-    QList< QList<QBrush *> > *horizontalHeader_GetBackgroundBrushes();
-    QList< QList<QColor *> > *horizontalHeader_GetForegroundColors();
-    QList< QList<QFont *> >  *horizontalHeader_GetCellFonts();
-    QList< QList<int> >      *horizontalHeader_GetCellTextFlags();
-    QList< QList<quint16> >  *horizontalHeader_GetCellMergeX();
-    QList< QList<quint16> >  *horizontalHeader_GetCellMergeY();
-    QList< QList<int> >      *horizontalHeader_GetCellMergeParentRow();
-    QList< QList<int> >      *horizontalHeader_GetCellMergeParentColumn();
-    QList< QRect >           *horizontalHeader_GetMerges();
-
-    QList< QList<QBrush *> > *verticalHeader_GetBackgroundBrushes();
-    QList< QList<QColor *> > *verticalHeader_GetForegroundColors();
-    QList< QList<QFont *> >  *verticalHeader_GetCellFonts();
-    QList< QList<int> >      *verticalHeader_GetCellTextFlags();
-    QList< QList<quint16> >  *verticalHeader_GetCellMergeX();
-    QList< QList<quint16> >  *verticalHeader_GetCellMergeY();
-    QList< QList<int> >      *verticalHeader_GetCellMergeParentRow();
-    QList< QList<int> >      *verticalHeader_GetCellMergeParentColumn();
-    QList< QRect >           *verticalHeader_GetMerges();
+    StyleTable               *getStyles();
+    QList< QList<int> >      *getCellStyles();
+    SpanIndex                *getSpans();
+
+    StyleTable               *horizontalHeader_GetStyles();
+    QList< QList<int> >      *horizontalHeader_GetCellStyles();
+    SpanIndex                *horizontalHeader_GetSpans();
+
+    StyleTable               *verticalHeader_GetStyles();
+    QList< QList<int> >      *verticalHeader_GetCellStyles();
+    SpanIndex                *verticalHeader_GetSpans();
 };
 
 class PublicCustomFastTable : public CustomFastTableWidget
@@ -75,10 +57,11 @@ public:
     int verticalHeader_GetVisibleRight();
 
     QList< QStringList > *getData();
-    QList< qint16 >      *getRowHeights();
-    QList< qint16 >      *getColumnWidths();
-    QList< int >         *getOffsetX();
-    QList< int >         *getOffsetY();
+    TextColumns          *getTextColumns();
+    SizeList             *getRowHeights();
+    SizeList             *getColumnWidths();
+    OffsetIndex          *getOffsetX();
+    OffsetIndex          *getOffsetY();
 
     QList< QStringList > *horizontalHeader_GetData();
     QList< qint16 >      *horizontalHeader_GetRowHeights();
@@ -88,10 +71,7 @@ public:
     QList< qint16 >      *verticalHeader_GetColumnWidths();
     QList< int >         *verticalHeader_GetOffsetX();
 
-    QList< QList<bool> > *getSelectedCells();
-    QList< QPoint >      *getCurSelection();
-    QList< int >         *horizontalHeader_GetSelectedColumns();
-    QList< int >         *verticalHeader_GetSelectedRows();
+    SelectionRanges      *getSelection();
 
     int getCurrentRow();
     int getCurrentColumn();
@@ -111,7 +91,38 @@ public:
     MouseLocation getMouseLocation();
     MouseLocation getMouseLocationForShift();
 
-    QList< QList<bool> > *getMouseSelectedCells();
+    SelectionRanges *getMouseBaseSelection();
+    QRect getMouseSelectedRange();
+
+    QRect getExposedCells(const QRect &area);
+    QRect getScrolledArea(const int dx, const int dy);
+    QRect getDirtyArea(const QRect &range);
+    QString getCachedText(const int row, const int column);
+
+    void setShiftAnchor(const int row, const int column);
+    void doFillShiftSelection();
+    void doSelectRangeForHandlers(const int row, const int column);
+    void horizontalHeader_DoFillShiftSelection();
+    void horizontalHeader_DoSelectRangeForHandlers(const int column);
+    void verticalHeader_DoFillShiftSelection();
+    void verticalHeader_DoSelectRangeForHandlers(const int row);
+    void doMouseRelease();
+};
+
+class PublicAsyncDataProvider : public AsyncDataProvider
+{
+public:
+    PublicAsyncDataProvider(const int blockSize);
+    ~PublicAsyncDataProvider();
+
+    QList<int> getLoadedBlocks();
+    bool       isThreadRunning();
+
+protected:
+    QMutex     mLoadedMutex;
+    QList<int> mLoadedBlocks;
+
+    QList<QStringList> loadRows(const int row, const int count);
 };
 
 #endif // PUBLICTABLEWIDGET_H
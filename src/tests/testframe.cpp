@@ -1,6 +1,13 @@
 #include "testframe.h"
 
 #include "publictablewidget.h"
+#include "bitgrid.h"
+#include "selectionranges.h"
+
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
 
 TestFrame::TestFrame(CustomFastTableWidget* aFastTable, QWidget *parent) :
     QWidget(parent),
@@ -82,6 +89,28 @@ TestFrame::TestFrame(CustomFastTableWidget* aFastTable, QWidget *parent) :
     addTestLabel("setSpan");
     addTestLabel("horizontalHeader_SetSpan");
     addTestLabel("verticalHeader_SetSpan");
+    addTestLabel("cellAt");
+    addTestLabel("updateVisibleRange(10M)");
+    addTestLabel("updateVisibleRange with spans(200K)");
+    addTestLabel("setRowHeight(2M)");
+    addTestLabel("uniformGeometry");
+    addTestLabel("setSizes(1M)");
+    addTestLabel("insertRows/removeRows");
+    addTestLabel("beginUpdate/endUpdate");
+    addTestLabel("Dirty region painting");
+    addTestLabel("Scroll blitting");
+    addTestLabel("Bit grid");
+    addTestLabel("Selection ranges");
+    addTestLabel("Selection flags");
+    addTestLabel("setRangeSelected/setSelection");
+    addTestLabel("Mouse selection");
+    addTestLabel("Columnar storage");
+    addTestLabel("Dictionary encoded columns");
+    addTestLabel("CellBlock");
+    addTestLabel("Asynchronous data provider");
+    addTestLabel("Row block cache");
+    addTestLabel("Mapped CSV file");
+    addTestLabel("CSV import");
 
     //-------------------------------------------------------------------------------------------------------------
 
@@ -99,75 +128,44 @@ TestFrame::TestFrame(CustomFastTableWidget* aFastTable, QWidget *parent) :
     mVerticalHeader_ColumnWidths            = (((PublicCustomFastTable*)mFastTable)->verticalHeader_GetColumnWidths());
     mVerticalHeader_OffsetX                 = (((PublicCustomFastTable*)mFastTable)->verticalHeader_GetOffsetX());
 
-    mSelectedCells                          = (((PublicCustomFastTable*)mFastTable)->getSelectedCells());
-    mCurSelection                           = (((PublicCustomFastTable*)mFastTable)->getCurSelection());
-    mHorizontalHeader_SelectedColumns       = (((PublicCustomFastTable*)mFastTable)->horizontalHeader_GetSelectedColumns());
-    mVerticalHeader_SelectedRows            = (((PublicCustomFastTable*)mFastTable)->verticalHeader_GetSelectedRows());
+    mSelection                              = (((PublicCustomFastTable*)mFastTable)->getSelection());
 
     if (mFastTable->inherits("FastTableWidget"))
     {
-        mBackgroundBrushes                      = (((PublicFastTable*)mFastTable)->getBackgroundBrushes());
-        mForegroundColors                       = (((PublicFastTable*)mFastTable)->getForegroundColors());
-        mCellFonts                              = (((PublicFastTable*)mFastTable)->getCellFonts());
-        mCellTextFlags                          = (((PublicFastTable*)mFastTable)->getCellTextFlags());
-        mCellMergeX                             = (((PublicFastTable*)mFastTable)->getCellMergeX());
-        mCellMergeY                             = (((PublicFastTable*)mFastTable)->getCellMergeY());
-        mCellMergeParentRow                     = (((PublicFastTable*)mFastTable)->getCellMergeParentRow());
-        mCellMergeParentColumn                  = (((PublicFastTable*)mFastTable)->getCellMergeParentColumn());
-        mMerges                                 = (((PublicFastTable*)mFastTable)->getMerges());
-
-        mHorizontalHeader_BackgroundBrushes     = (((PublicFastTable*)mFastTable)->horizontalHeader_GetBackgroundBrushes());
-        mHorizontalHeader_ForegroundColors      = (((PublicFastTable*)mFastTable)->horizontalHeader_GetForegroundColors());
-        mHorizontalHeader_CellFonts             = (((PublicFastTable*)mFastTable)->horizontalHeader_GetCellFonts());
-        mHorizontalHeader_CellTextFlags         = (((PublicFastTable*)mFastTable)->horizontalHeader_GetCellTextFlags());
-        mHorizontalHeader_CellMergeX            = (((PublicFastTable*)mFastTable)->horizontalHeader_GetCellMergeX());
-        mHorizontalHeader_CellMergeY            = (((PublicFastTable*)mFastTable)->horizontalHeader_GetCellMergeY());
-        mHorizontalHeader_CellMergeParentRow    = (((PublicFastTable*)mFastTable)->horizontalHeader_GetCellMergeParentRow());
-        mHorizontalHeader_CellMergeParentColumn = (((PublicFastTable*)mFastTable)->horizontalHeader_GetCellMergeParentColumn());
-        mHorizontalHeader_Merges                = (((PublicFastTable*)mFastTable)->horizontalHeader_GetMerges());
-
-        mVerticalHeader_BackgroundBrushes       = (((PublicFastTable*)mFastTable)->verticalHeader_GetBackgroundBrushes());
-        mVerticalHeader_ForegroundColors        = (((PublicFastTable*)mFastTable)->verticalHeader_GetForegroundColors());
-        mVerticalHeader_CellFonts               = (((PublicFastTable*)mFastTable)->verticalHeader_GetCellFonts());
-        mVerticalHeader_CellTextFlags           = (((PublicFastTable*)mFastTable)->verticalHeader_GetCellTextFlags());
-        mVerticalHeader_CellMergeX              = (((PublicFastTable*)mFastTable)->verticalHeader_GetCellMergeX());
-        mVerticalHeader_CellMergeY              = (((PublicFastTable*)mFastTable)->verticalHeader_GetCellMergeY());
-        mVerticalHeader_CellMergeParentRow      = (((PublicFastTable*)mFastTable)->verticalHeader_GetCellMergeParentRow());
-        mVerticalHeader_CellMergeParentColumn   = (((PublicFastTable*)mFastTable)->verticalHeader_GetCellMergeParentColumn());
-        mVerticalHeader_Merges                  = (((PublicFastTable*)mFastTable)->verticalHeader_GetMerges());
+        mStyles                                 = (((PublicFastTable*)mFastTable)->getStyles());
+        mCellStyles                             = (((PublicFastTable*)mFastTable)->getCellStyles());
+        mSpans                                  = (((PublicFastTable*)mFastTable)->getSpans());
+
+        mHorizontalHeader_Styles                = (((PublicFastTable*)mFastTable)->horizontalHeader_GetStyles());
+        mHorizontalHeader_CellStyles            = (((PublicFastTable*)mFastTable)->horizontalHeader_GetCellStyles());
+        mHorizontalHeader_Spans                 = (((PublicFastTable*)mFastTable)->horizontalHeader_GetSpans());
+
+        mVerticalHeader_Styles                  = (((PublicFastTable*)mFastTable)->verticalHeader_GetStyles());
+        mVerticalHeader_CellStyles              = (((PublicFastTable*)mFastTable)->verticalHeader_GetCellStyles());
+        mVerticalHeader_Spans                   = (((PublicFastTable*)mFastTable)->verticalHeader_GetSpans());
     }
     else
     {
-        mBackgroundBrushes                      = 0;
-        mForegroundColors                       = 0;
-        mCellFonts                              = 0;
-        mCellTextFlags                          = 0;
-        mCellMergeX                             = 0;
-        mCellMergeY                             = 0;
-        mCellMergeParentRow                     = 0;
-        mCellMergeParentColumn                  = 0;
-        mMerges                                 = 0;
-
-        mHorizontalHeader_BackgroundBrushes     = 0;
-        mHorizontalHeader_ForegroundColors      = 0;
-        mHorizontalHeader_CellFonts             = 0;
-        mHorizontalHeader_CellTextFlags         = 0;
-        mHorizontalHeader_CellMergeX            = 0;
-        mHorizontalHeader_CellMergeY            = 0;
-        mHorizontalHeader_CellMergeParentRow    = 0;
-        mHorizontalHeader_CellMergeParentColumn = 0;
-        mHorizontalHeader_Merges                = 0;
-
-        mVerticalHeader_BackgroundBrushes       = 0;
-        mVerticalHeader_ForegroundColors        = 0;
-        mVerticalHeader_CellFonts               = 0;
-        mVerticalHeader_CellTextFlags           = 0;
-        mVerticalHeader_CellMergeX              = 0;
-        mVerticalHeader_CellMergeY              = 0;
-        mVerticalHeader_CellMergeParentRow      = 0;
-        mVerticalHeader_CellMergeParentColumn   = 0;
-        mVerticalHeader_Merges                  = 0;
+        mStyles                                 = 0;
+        mCellStyles                             = 0;
+        mSpans                                  = 0;
+
+        mHorizontalHeader_Styles                = 0;
+        mHorizontalHeader_CellStyles            = 0;
+        mHorizontalHeader_Spans                 = 0;
+
+        mVerticalHeader_Styles                  = 0;
+        mVerticalHeader_CellStyles              = 0;
+        mVerticalHeader_Spans                   = 0;
     }
+
+    mSelectionChangedCount=0;
+    mCurrentCellChangedCount=0;
+    mCellChangedCount=0;
+
+    connect(mFastTable, SIGNAL(selectionChanged(QList<QRect>,QList<QRect>)), this, SLOT(fastTableSelectionChanged(QList<QRect>,QList<QRect>)));
+    connect(mFastTable, SIGNAL(currentCellChanged(int,int,int,int)), this, SLOT(fastTableCurrentCellChanged(int,int,int,int)));
+    connect(mFastTable, SIGNAL(cellChanged(int,int)), this, SLOT(fastTableCellChanged(int,int)));
 }
 
 TestFrame::~TestFrame()
@@ -186,7 +184,7 @@ void TestFrame::startTest()
     {
         success=true;
 
-        TEST_STEP(mCurSelection->length()==0);
+        TEST_STEP(mSelection->cellCount()==0);
         TEST_STEP(((PublicCustomFastTable*)mFastTable)->verticalHeader_GetTotalWidth()==0);
         TEST_STEP(((PublicCustomFastTable*)mFastTable)->horizontalHeader_GetTotalHeight()==0);
         TEST_STEP(((PublicCustomFastTable*)mFastTable)->getTotalWidth()==0);
@@ -1188,7 +1186,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)mFastTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mSelectedCells->at(i).at(j));
+                TEST_STEP(mSelection->contains(i, j));
 
                 if (!success)
                 {
@@ -1206,7 +1204,7 @@ void TestFrame::startTest()
         {
             for (int i=0; i<((PublicCustomFastTable*)mFastTable)->getRowCount(); ++i)
             {
-                TEST_STEP(mVerticalHeader_SelectedRows->at(i)==((PublicCustomFastTable*)mFastTable)->getColumnCount());
+                TEST_STEP(mSelection->rowCellCount(i)==((PublicCustomFastTable*)mFastTable)->getColumnCount());
 
                 if (!success)
                 {
@@ -1219,7 +1217,7 @@ void TestFrame::startTest()
         {
             for (int i=0; i<((PublicCustomFastTable*)mFastTable)->getColumnCount(); ++i)
             {
-                TEST_STEP(mHorizontalHeader_SelectedColumns->at(i)==((PublicCustomFastTable*)mFastTable)->getRowCount());
+                TEST_STEP(mSelection->columnCellCount(i)==((PublicCustomFastTable*)mFastTable)->getRowCount());
 
                 if (!success)
                 {
@@ -1228,12 +1226,12 @@ void TestFrame::startTest()
             }
         }
 
-        TEST_STEP(mCurSelection->length()==50*20);
+        TEST_STEP(mSelection->cellCount()==50*20);
 
         mFastTable->setCellSelected(10, 5, false);
 
-        TEST_STEP(!mSelectedCells->at(10).at(5));
-        TEST_STEP(mCurSelection->length()==50*20-1);
+        TEST_STEP(!mSelection->contains(10, 5));
+        TEST_STEP(mSelection->cellCount()==50*20-1);
 
         mFastTable->unselectRow(10);
 
@@ -1241,7 +1239,7 @@ void TestFrame::startTest()
         {
             for (int i=0; i<((PublicCustomFastTable*)mFastTable)->getColumnCount(); ++i)
             {
-                TEST_STEP(!mSelectedCells->at(10).at(i));
+                TEST_STEP(!mSelection->contains(10, i));
 
                 if (!success)
                 {
@@ -1250,8 +1248,8 @@ void TestFrame::startTest()
             }
         }
 
-        TEST_STEP(mVerticalHeader_SelectedRows->at(10)==0);
-        TEST_STEP(mCurSelection->length()==49*20);
+        TEST_STEP(mSelection->rowCellCount(10)==0);
+        TEST_STEP(mSelection->cellCount()==49*20);
 
         mFastTable->unselectColumn(5);
 
@@ -1259,7 +1257,7 @@ void TestFrame::startTest()
         {
             for (int i=0; i<((PublicCustomFastTable*)mFastTable)->getRowCount(); ++i)
             {
-                TEST_STEP(!mSelectedCells->at(i).at(5));
+                TEST_STEP(!mSelection->contains(i, 5));
 
                 if (!success)
                 {
@@ -1268,8 +1266,8 @@ void TestFrame::startTest()
             }
         }
 
-        TEST_STEP(mHorizontalHeader_SelectedColumns->at(5)==0);
-        TEST_STEP(mCurSelection->length()==49*19);
+        TEST_STEP(mSelection->columnCellCount(5)==0);
+        TEST_STEP(mSelection->cellCount()==49*19);
 
         mFastTable->unselectAll();
 
@@ -1279,7 +1277,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)mFastTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(!mSelectedCells->at(i).at(j));
+                    TEST_STEP(!mSelection->contains(i, j));
 
                     if (!success)
                     {
@@ -1298,7 +1296,7 @@ void TestFrame::startTest()
         {
             for (int i=0; i<((PublicCustomFastTable*)mFastTable)->getRowCount(); ++i)
             {
-                TEST_STEP(mVerticalHeader_SelectedRows->at(i)==0);
+                TEST_STEP(mSelection->rowCellCount(i)==0);
 
                 if (!success)
                 {
@@ -1311,7 +1309,7 @@ void TestFrame::startTest()
         {
             for (int i=0; i<((PublicCustomFastTable*)mFastTable)->getColumnCount(); ++i)
             {
-                TEST_STEP(mHorizontalHeader_SelectedColumns->at(i)==0);
+                TEST_STEP(mSelection->columnCellCount(i)==0);
 
                 if (!success)
                 {
@@ -1320,7 +1318,7 @@ void TestFrame::startTest()
             }
         }
 
-        TEST_STEP(mCurSelection->length()==0);
+        TEST_STEP(mSelection->cellCount()==0);
 
         testCompleted(success, "setCellSelected");
     }
@@ -1333,6 +1331,8 @@ void TestFrame::startTest()
 
         FastTableWidget* aTable=(FastTableWidget*)mFastTable;
 
+        TEST_STEP(mCellStyles->isEmpty());
+
         QBrush aNewBackgroundBrush(QColor(1, 2, 3));
 
         for (int i=0; i<aTable->rowCount(); ++i)
@@ -1347,8 +1347,9 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mBackgroundBrushes->at(i).at(j) && *mBackgroundBrushes->at(i).at(j)==aNewBackgroundBrush);
+                TEST_STEP(mStyles->backgroundBrush(CELL_STYLE(mCellStyles, i, j)) && *mStyles->backgroundBrush(CELL_STYLE(mCellStyles, i, j))==aNewBackgroundBrush);
                 TEST_STEP(aTable->backgroundBrush(i, j)==aNewBackgroundBrush);
+                TEST_STEP(mCellStyles->at(i).at(j)==mCellStyles->at(0).at(0));
 
                 if (!success)
                 {
@@ -1364,17 +1365,20 @@ void TestFrame::startTest()
 
         aTable->resetBackgroundBrush(10, 5);
 
-        TEST_STEP(mBackgroundBrushes->at(10).at(5)==0);
+        TEST_STEP(mStyles->backgroundBrush(CELL_STYLE(mCellStyles, 10, 5))==0);
 
         aTable->resetBackgroundBrushes();
 
+        TEST_STEP(mCellStyles->isEmpty());
+        TEST_STEP(mStyles->count()==1);
+
         if (success)
         {
             for (int i=0; i<((PublicCustomFastTable*)aTable)->getRowCount(); ++i)
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mBackgroundBrushes->at(i).at(j)==0);
+                    TEST_STEP(mStyles->backgroundBrush(CELL_STYLE(mCellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1418,7 +1422,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mHorizontalHeader_BackgroundBrushes->at(i).at(j) && *mHorizontalHeader_BackgroundBrushes->at(i).at(j)==aNewBackgroundBrush);
+                TEST_STEP(mHorizontalHeader_Styles->backgroundBrush(CELL_STYLE(mHorizontalHeader_CellStyles, i, j)) && *mHorizontalHeader_Styles->backgroundBrush(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==aNewBackgroundBrush);
                 TEST_STEP(aTable->horizontalHeader_BackgroundBrush(i, j)==aNewBackgroundBrush);
 
                 if (!success)
@@ -1435,7 +1439,7 @@ void TestFrame::startTest()
 
         aTable->horizontalHeader_ResetBackgroundBrush(1, 0);
 
-        TEST_STEP(mHorizontalHeader_BackgroundBrushes->at(1).at(0)==0);
+        TEST_STEP(mHorizontalHeader_Styles->backgroundBrush(CELL_STYLE(mHorizontalHeader_CellStyles, 1, 0))==0);
 
         aTable->horizontalHeader_ResetBackgroundBrushes();
 
@@ -1445,7 +1449,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mHorizontalHeader_BackgroundBrushes->at(i).at(j)==0);
+                    TEST_STEP(mHorizontalHeader_Styles->backgroundBrush(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1489,7 +1493,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
             {
-                TEST_STEP(mVerticalHeader_BackgroundBrushes->at(i).at(j) && *mVerticalHeader_BackgroundBrushes->at(i).at(j)==aNewBackgroundBrush);
+                TEST_STEP(mVerticalHeader_Styles->backgroundBrush(CELL_STYLE(mVerticalHeader_CellStyles, i, j)) && *mVerticalHeader_Styles->backgroundBrush(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==aNewBackgroundBrush);
                 TEST_STEP(aTable->verticalHeader_BackgroundBrush(i, j)==aNewBackgroundBrush);
 
                 if (!success)
@@ -1506,7 +1510,7 @@ void TestFrame::startTest()
 
         aTable->verticalHeader_ResetBackgroundBrush(1, 0);
 
-        TEST_STEP(mVerticalHeader_BackgroundBrushes->at(1).at(0)==0);
+        TEST_STEP(mVerticalHeader_Styles->backgroundBrush(CELL_STYLE(mVerticalHeader_CellStyles, 1, 0))==0);
 
         aTable->verticalHeader_ResetBackgroundBrushes();
 
@@ -1516,7 +1520,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
                 {
-                    TEST_STEP(mVerticalHeader_BackgroundBrushes->at(i).at(j)==0);
+                    TEST_STEP(mVerticalHeader_Styles->backgroundBrush(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1560,7 +1564,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mForegroundColors->at(i).at(j) && *mForegroundColors->at(i).at(j)==aNewForegroundColor);
+                TEST_STEP(mStyles->foregroundColor(CELL_STYLE(mCellStyles, i, j)) && *mStyles->foregroundColor(CELL_STYLE(mCellStyles, i, j))==aNewForegroundColor);
                 TEST_STEP(aTable->foregroundColor(i, j)==aNewForegroundColor);
 
                 if (!success)
@@ -1577,7 +1581,7 @@ void TestFrame::startTest()
 
         aTable->resetForegroundColor(10, 5);
 
-        TEST_STEP(mForegroundColors->at(10).at(5)==0);
+        TEST_STEP(mStyles->foregroundColor(CELL_STYLE(mCellStyles, 10, 5))==0);
 
         aTable->resetForegroundColors();
 
@@ -1587,7 +1591,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mForegroundColors->at(i).at(j)==0);
+                    TEST_STEP(mStyles->foregroundColor(CELL_STYLE(mCellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1631,7 +1635,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mHorizontalHeader_ForegroundColors->at(i).at(j) && *mHorizontalHeader_ForegroundColors->at(i).at(j)==aNewForegroundColor);
+                TEST_STEP(mHorizontalHeader_Styles->foregroundColor(CELL_STYLE(mHorizontalHeader_CellStyles, i, j)) && *mHorizontalHeader_Styles->foregroundColor(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==aNewForegroundColor);
                 TEST_STEP(aTable->horizontalHeader_ForegroundColor(i, j)==aNewForegroundColor);
 
                 if (!success)
@@ -1648,7 +1652,7 @@ void TestFrame::startTest()
 
         aTable->horizontalHeader_ResetForegroundColor(1, 0);
 
-        TEST_STEP(mHorizontalHeader_ForegroundColors->at(1).at(0)==0);
+        TEST_STEP(mHorizontalHeader_Styles->foregroundColor(CELL_STYLE(mHorizontalHeader_CellStyles, 1, 0))==0);
 
         aTable->horizontalHeader_ResetForegroundColors();
 
@@ -1658,7 +1662,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mHorizontalHeader_ForegroundColors->at(i).at(j)==0);
+                    TEST_STEP(mHorizontalHeader_Styles->foregroundColor(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1702,7 +1706,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
             {
-                TEST_STEP(mVerticalHeader_ForegroundColors->at(i).at(j) && *mVerticalHeader_ForegroundColors->at(i).at(j)==aNewForegroundColor);
+                TEST_STEP(mVerticalHeader_Styles->foregroundColor(CELL_STYLE(mVerticalHeader_CellStyles, i, j)) && *mVerticalHeader_Styles->foregroundColor(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==aNewForegroundColor);
                 TEST_STEP(aTable->verticalHeader_ForegroundColor(i, j)==aNewForegroundColor);
 
                 if (!success)
@@ -1719,7 +1723,7 @@ void TestFrame::startTest()
 
         aTable->verticalHeader_ResetForegroundColor(1, 0);
 
-        TEST_STEP(mVerticalHeader_ForegroundColors->at(1).at(0)==0);
+        TEST_STEP(mVerticalHeader_Styles->foregroundColor(CELL_STYLE(mVerticalHeader_CellStyles, 1, 0))==0);
 
         aTable->verticalHeader_ResetForegroundColors();
 
@@ -1729,7 +1733,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
                 {
-                    TEST_STEP(mVerticalHeader_ForegroundColors->at(i).at(j)==0);
+                    TEST_STEP(mVerticalHeader_Styles->foregroundColor(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1773,7 +1777,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mCellFonts->at(i).at(j) && *mCellFonts->at(i).at(j)==aNewCellFont);
+                TEST_STEP(mStyles->font(CELL_STYLE(mCellStyles, i, j)) && *mStyles->font(CELL_STYLE(mCellStyles, i, j))==aNewCellFont);
                 TEST_STEP(aTable->cellFont(i, j)==aNewCellFont);
 
                 if (!success)
@@ -1790,7 +1794,7 @@ void TestFrame::startTest()
 
         aTable->resetFont(10, 5);
 
-        TEST_STEP(mCellFonts->at(10).at(5)==0);
+        TEST_STEP(mStyles->font(CELL_STYLE(mCellStyles, 10, 5))==0);
 
         aTable->resetFonts();
 
@@ -1800,7 +1804,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mCellFonts->at(i).at(j)==0);
+                    TEST_STEP(mStyles->font(CELL_STYLE(mCellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1844,7 +1848,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mHorizontalHeader_CellFonts->at(i).at(j) && *mHorizontalHeader_CellFonts->at(i).at(j)==aNewCellFont);
+                TEST_STEP(mHorizontalHeader_Styles->font(CELL_STYLE(mHorizontalHeader_CellStyles, i, j)) && *mHorizontalHeader_Styles->font(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==aNewCellFont);
                 TEST_STEP(aTable->horizontalHeader_CellFont(i, j)==aNewCellFont);
 
                 if (!success)
@@ -1861,7 +1865,7 @@ void TestFrame::startTest()
 
         aTable->horizontalHeader_ResetFont(1, 0);
 
-        TEST_STEP(mHorizontalHeader_CellFonts->at(1).at(0)==0);
+        TEST_STEP(mHorizontalHeader_Styles->font(CELL_STYLE(mHorizontalHeader_CellStyles, 1, 0))==0);
 
         aTable->horizontalHeader_ResetFonts();
 
@@ -1871,7 +1875,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mHorizontalHeader_CellFonts->at(i).at(j)==0);
+                    TEST_STEP(mHorizontalHeader_Styles->font(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1915,7 +1919,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
             {
-                TEST_STEP(mVerticalHeader_CellFonts->at(i).at(j) && *mVerticalHeader_CellFonts->at(i).at(j)==aNewCellFont);
+                TEST_STEP(mVerticalHeader_Styles->font(CELL_STYLE(mVerticalHeader_CellStyles, i, j)) && *mVerticalHeader_Styles->font(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==aNewCellFont);
                 TEST_STEP(aTable->verticalHeader_CellFont(i, j)==aNewCellFont);
 
                 if (!success)
@@ -1932,7 +1936,7 @@ void TestFrame::startTest()
 
         aTable->verticalHeader_ResetFont(1, 0);
 
-        TEST_STEP(mVerticalHeader_CellFonts->at(1).at(0)==0);
+        TEST_STEP(mVerticalHeader_Styles->font(CELL_STYLE(mVerticalHeader_CellStyles, 1, 0))==0);
 
         aTable->verticalHeader_ResetFonts();
 
@@ -1942,7 +1946,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
                 {
-                    TEST_STEP(mVerticalHeader_CellFonts->at(i).at(j)==0);
+                    TEST_STEP(mVerticalHeader_Styles->font(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==0);
 
                     if (!success)
                     {
@@ -1986,7 +1990,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mCellTextFlags->at(i).at(j)==aNewFlag);
+                TEST_STEP(mStyles->textFlags(CELL_STYLE(mCellStyles, i, j))==aNewFlag);
                 TEST_STEP(aTable->cellTextFlags(i, j)==aNewFlag);
 
                 if (!success)
@@ -2013,7 +2017,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mCellTextFlags->at(i).at(j)==(FASTTABLE_DEFAULT_TEXT_FLAG));
+                    TEST_STEP(mStyles->textFlags(CELL_STYLE(mCellStyles, i, j))==(FASTTABLE_DEFAULT_TEXT_FLAG));
                     TEST_STEP(aTable->cellTextFlags(i, j)==(FASTTABLE_DEFAULT_TEXT_FLAG));
 
                     if (!success)
@@ -2058,7 +2062,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
             {
-                TEST_STEP(mHorizontalHeader_CellTextFlags->at(i).at(j)==aNewFlag);
+                TEST_STEP(mHorizontalHeader_Styles->textFlags(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==aNewFlag);
                 TEST_STEP(aTable->horizontalHeader_CellTextFlags(i, j)==aNewFlag);
 
                 if (!success)
@@ -2085,7 +2089,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->getColumnCount(); ++j)
                 {
-                    TEST_STEP(mHorizontalHeader_CellTextFlags->at(i).at(j)==(FASTTABLE_HEADER_DEFAULT_TEXT_FLAG));
+                    TEST_STEP(mHorizontalHeader_Styles->textFlags(CELL_STYLE(mHorizontalHeader_CellStyles, i, j))==(FASTTABLE_HEADER_DEFAULT_TEXT_FLAG));
                     TEST_STEP(aTable->horizontalHeader_CellTextFlags(i, j)==(FASTTABLE_HEADER_DEFAULT_TEXT_FLAG));
 
                     if (!success)
@@ -2130,7 +2134,7 @@ void TestFrame::startTest()
         {
             for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
             {
-                TEST_STEP(mVerticalHeader_CellTextFlags->at(i).at(j)==aNewFlag);
+                TEST_STEP(mVerticalHeader_Styles->textFlags(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==aNewFlag);
                 TEST_STEP(aTable->verticalHeader_CellTextFlags(i, j)==aNewFlag);
 
                 if (!success)
@@ -2157,7 +2161,7 @@ void TestFrame::startTest()
             {
                 for (int j=0; j<((PublicCustomFastTable*)aTable)->verticalHeader_GetColumnCount(); ++j)
                 {
-                    TEST_STEP(mVerticalHeader_CellTextFlags->at(i).at(j)==(FASTTABLE_DEFAULT_TEXT_FLAG));
+                    TEST_STEP(mVerticalHeader_Styles->textFlags(CELL_STYLE(mVerticalHeader_CellStyles, i, j))==(FASTTABLE_DEFAULT_TEXT_FLAG));
                     TEST_STEP(aTable->verticalHeader_CellTextFlags(i, j)==(FASTTABLE_DEFAULT_TEXT_FLAG));
 
                     if (!success)
@@ -2190,24 +2194,24 @@ void TestFrame::startTest()
 
         aTable->setSpan(1, 2, 2, 3);
 
-        TEST_STEP(mMerges->length()==1 && mMerges->at(0)==QRect(2, 1, 3, 2));
+        TEST_STEP(mSpans->spans().length()==1 && mSpans->spans().at(0)==QRect(2, 1, 3, 2));
 
         for (int i=1; i<=2; ++i)
         {
             for (int j=2; j<=4; ++j)
             {
-                TEST_STEP(mCellMergeParentRow->at(i).at(j)==1);
-                TEST_STEP(mCellMergeParentColumn->at(i).at(j)==2);
+                TEST_STEP(mSpans->parent(i, j).y()==1);
+                TEST_STEP(mSpans->parent(i, j).x()==2);
                 TEST_STEP(aTable->spanParent(i, j)==QPoint(2, 1));
             }
         }
 
-        TEST_STEP(mCellMergeX->at(1).at(2)==3);
-        TEST_STEP(mCellMergeY->at(1).at(2)==2);
+        TEST_STEP(mSpans->columnSpan(1, 2)==3);
+        TEST_STEP(mSpans->rowSpan(1, 2)==2);
 
         aTable->setSpan(0, 3, 2, 1);
 
-        TEST_STEP(mMerges->length()==1 && mMerges->at(0)==QRect(3, 0, 1, 2));
+        TEST_STEP(mSpans->spans().length()==1 && mSpans->spans().at(0)==QRect(3, 0, 1, 2));
 
         for (int i=1; i<=2; ++i)
         {
@@ -2215,29 +2219,29 @@ void TestFrame::startTest()
             {
                 if (i!=1 || j!=3)
                 {
-                    TEST_STEP(mCellMergeParentRow->at(i).at(j)==-1);
-                    TEST_STEP(mCellMergeParentColumn->at(i).at(j)==-1);
+                    TEST_STEP(mSpans->parent(i, j).y()==-1);
+                    TEST_STEP(mSpans->parent(i, j).x()==-1);
                     TEST_STEP(aTable->spanParent(i, j)==QPoint(-1, -1));
                 }
             }
         }
 
-        TEST_STEP(mCellMergeX->at(1).at(2)==1);
-        TEST_STEP(mCellMergeY->at(1).at(2)==1);
+        TEST_STEP(mSpans->columnSpan(1, 2)==1);
+        TEST_STEP(mSpans->rowSpan(1, 2)==1);
 
         for (int i=0; i<=1; ++i)
         {
-            TEST_STEP(mCellMergeParentRow->at(i).at(3)==0);
-            TEST_STEP(mCellMergeParentColumn->at(i).at(3)==3);
+            TEST_STEP(mSpans->parent(i, 3).y()==0);
+            TEST_STEP(mSpans->parent(i, 3).x()==3);
             TEST_STEP(aTable->spanParent(i, 3)==QPoint(3, 0));
         }
 
-        TEST_STEP(mCellMergeX->at(0).at(3)==1);
-        TEST_STEP(mCellMergeY->at(0).at(3)==2);
+        TEST_STEP(mSpans->columnSpan(0, 3)==1);
+        TEST_STEP(mSpans->rowSpan(0, 3)==2);
 
         aTable->clearSpans();
 
-        TEST_STEP(mMerges->length()==0);
+        TEST_STEP(mSpans->spans().length()==0);
 
         for (int i=0; i<((PublicCustomFastTable*)aTable)->getRowCount(); ++i)
         {
@@ -2246,10 +2250,10 @@ void TestFrame::startTest()
                 TEST_STEP(aTable->rowSpan(i, j)==1);
                 TEST_STEP(aTable->columnSpan(i, j)==1);
                 TEST_STEP(aTable->spanParent(i, j)==QPoint(-1, -1));
-                TEST_STEP(mCellMergeX->at(i).at(j)==1);
-                TEST_STEP(mCellMergeY->at(i).at(j)==1);
-                TEST_STEP(mCellMergeParentRow->at(i).at(j)==-1);
-                TEST_STEP(mCellMergeParentColumn->at(i).at(j)==-1);
+                TEST_STEP(mSpans->columnSpan(i, j)==1);
+                TEST_STEP(mSpans->rowSpan(i, j)==1);
+                TEST_STEP(mSpans->parent(i, j).y()==-1);
+                TEST_STEP(mSpans->parent(i, j).x()==-1);
 
                 if (!success)
                 {
@@ -2280,24 +2284,24 @@ void TestFrame::startTest()
 
         aTable->horizontalHeader_SetSpan(0, 2, 2, 3);
 
-        TEST_STEP(mHorizontalHeader_Merges->length()==1 && mHorizontalHeader_Merges->at(0)==QRect(2, 0, 3, 2));
+        TEST_STEP(mHorizontalHeader_Spans->spans().length()==1 && mHorizontalHeader_Spans->spans().at(0)==QRect(2, 0, 3, 2));
 
         for (int i=0; i<=1; ++i)
         {
             for (int j=2; j<=4; ++j)
             {
-                TEST_STEP(mHorizontalHeader_CellMergeParentRow->at(i).at(j)==0);
-                TEST_STEP(mHorizontalHeader_CellMergeParentColumn->at(i).at(j)==2);
+                TEST_STEP(mHorizontalHeader_Spans->parent(i, j).y()==0);
+                TEST_STEP(mHorizontalHeader_Spans->parent(i, j).x()==2);
                 TEST_STEP(aTable->horizontalHeader_SpanParent(i, j)==QPoint(2, 0));
             }
         }
 
-        TEST_STEP(mHorizontalHeader_CellMergeX->at(0).at(2)==3);
-        TEST_STEP(mHorizontalHeader_CellMergeY->at(0).at(2)==2);
+        TEST_STEP(mHorizontalHeader_Spans->columnSpan(0, 2)==3);
+        TEST_STEP(mHorizontalHeader_Spans->rowSpan(0, 2)==2);
 
         aTable->horizontalHeader_SetSpan(0, 1, 1, 2);
 
-        TEST_STEP(mHorizontalHeader_Merges->length()==1 && mHorizontalHeader_Merges->at(0)==QRect(1, 0, 2, 1));
+        TEST_STEP(mHorizontalHeader_Spans->spans().length()==1 && mHorizontalHeader_Spans->spans().at(0)==QRect(1, 0, 2, 1));
 
         for (int i=0; i<=1; ++i)
         {
@@ -2305,29 +2309,29 @@ void TestFrame::startTest()
             {
                 if (i!=0 || j!=2)
                 {
-                    TEST_STEP(mHorizontalHeader_CellMergeParentRow->at(i).at(j)==-1);
-                    TEST_STEP(mHorizontalHeader_CellMergeParentColumn->at(i).at(j)==-1);
+                    TEST_STEP(mHorizontalHeader_Spans->parent(i, j).y()==-1);
+                    TEST_STEP(mHorizontalHeader_Spans->parent(i, j).x()==-1);
                     TEST_STEP(aTable->horizontalHeader_SpanParent(i, j)==QPoint(-1, -1));
                 }
             }
         }
 
-        TEST_STEP(mHorizontalHeader_CellMergeX->at(0).at(2)==1);
-        TEST_STEP(mHorizontalHeader_CellMergeY->at(0).at(2)==1);
+        TEST_STEP(mHorizontalHeader_Spans->columnSpan(0, 2)==1);
+        TEST_STEP(mHorizontalHeader_Spans->rowSpan(0, 2)==1);
 
         for (int i=1; i<=2; ++i)
         {
-            TEST_STEP(mHorizontalHeader_CellMergeParentRow->at(0).at(i)==0);
-            TEST_STEP(mHorizontalHeader_CellMergeParentColumn->at(0).at(i)==1);
+            TEST_STEP(mHorizontalHeader_Spans->parent(0, i).y()==0);
+            TEST_STEP(mHorizontalHeader_Spans->parent(0, i).x()==1);
             TEST_STEP(aTable->horizontalHeader_SpanParent(0, i)==QPoint(1, 0));
         }
 
-        TEST_STEP(mHorizontalHeader_CellMergeX->at(0).at(1)==2);
-        TEST_STEP(mHorizontalHeader_CellMergeY->at(0).at(1)==1);
+        TEST_STEP(mHorizontalHeader_Spans->columnSpan(0, 1)==2);
+        TEST_STEP(mHorizontalHeader_Spans->rowSpan(0, 1)==1);
 
         aTable->horizontalHeader_ClearSpans();
 
-        TEST_STEP(mHorizontalHeader_Merges->length()==0);
+        TEST_STEP(mHorizontalHeader_Spans->spans().length()==0);
 
         for (int i=0; i<((PublicCustomFastTable*)aTable)->horizontalHeader_GetRowCount(); ++i)
         {
@@ -2336,10 +2340,10 @@ void TestFrame::startTest()
                 TEST_STEP(aTable->horizontalHeader_RowSpan(i, j)==1);
                 TEST_STEP(aTable->horizontalHeader_ColumnSpan(i, j)==1);
                 TEST_STEP(aTable->horizontalHeader_SpanParent(i, j)==QPoint(-1, -1));
-                TEST_STEP(mHorizontalHeader_CellMergeX->at(i).at(j)==1);
-                TEST_STEP(mHorizontalHeader_CellMergeY->at(i).at(j)==1);
-                TEST_STEP(mHorizontalHeader_CellMergeParentRow->at(i).at(j)==-1);
-                TEST_STEP(mHorizontalHeader_CellMergeParentColumn->at(i).at(j)==-1);
+                TEST_STEP(mHorizontalHeader_Spans->columnSpan(i, j)==1);
+                TEST_STEP(mHorizontalHeader_Spans->rowSpan(i, j)==1);
+                TEST_STEP(mHorizontalHeader_Spans->parent(i, j).y()==-1);
+                TEST_STEP(mHorizontalHeader_Spans->parent(i, j).x()==-1);
 
                 if (!success)
                 {
@@ -2370,41 +2374,41 @@ void TestFrame::startTest()
 
         aTable->verticalHeader_SetSpan(2, 0, 3, 1);
 
-        TEST_STEP(mVerticalHeader_Merges->length()==1 && mVerticalHeader_Merges->at(0)==QRect(0, 2, 1, 3));
+        TEST_STEP(mVerticalHeader_Spans->spans().length()==1 && mVerticalHeader_Spans->spans().at(0)==QRect(0, 2, 1, 3));
 
         for (int i=2; i<=4; ++i)
         {
-            TEST_STEP(mVerticalHeader_CellMergeParentRow->at(i).at(0)==2);
-            TEST_STEP(mVerticalHeader_CellMergeParentColumn->at(i).at(0)==0);
+            TEST_STEP(mVerticalHeader_Spans->parent(i, 0).y()==2);
+            TEST_STEP(mVerticalHeader_Spans->parent(i, 0).x()==0);
             TEST_STEP(aTable->verticalHeader_SpanParent(i, 0)==QPoint(0, 2));
         }
 
-        TEST_STEP(mVerticalHeader_CellMergeX->at(2).at(0)==1);
-        TEST_STEP(mVerticalHeader_CellMergeY->at(2).at(0)==3);
+        TEST_STEP(mVerticalHeader_Spans->columnSpan(2, 0)==1);
+        TEST_STEP(mVerticalHeader_Spans->rowSpan(2, 0)==3);
 
         aTable->verticalHeader_SetSpan(3, 0, 2, 1);
 
-        TEST_STEP(mVerticalHeader_Merges->length()==1 && mVerticalHeader_Merges->at(0)==QRect(0, 3, 1, 2));
+        TEST_STEP(mVerticalHeader_Spans->spans().length()==1 && mVerticalHeader_Spans->spans().at(0)==QRect(0, 3, 1, 2));
 
-        TEST_STEP(mVerticalHeader_CellMergeParentRow->at(2).at(0)==-1);
-        TEST_STEP(mVerticalHeader_CellMergeParentColumn->at(2).at(0)==-1);
+        TEST_STEP(mVerticalHeader_Spans->parent(2, 0).y()==-1);
+        TEST_STEP(mVerticalHeader_Spans->parent(2, 0).x()==-1);
         TEST_STEP(aTable->verticalHeader_SpanParent(2, 0)==QPoint(-1, -1));
-        TEST_STEP(mVerticalHeader_CellMergeX->at(2).at(0)==1);
-        TEST_STEP(mVerticalHeader_CellMergeY->at(2).at(0)==1);
+        TEST_STEP(mVerticalHeader_Spans->columnSpan(2, 0)==1);
+        TEST_STEP(mVerticalHeader_Spans->rowSpan(2, 0)==1);
 
         for (int i=3; i<=4; ++i)
         {
-            TEST_STEP(mVerticalHeader_CellMergeParentRow->at(i).at(0)==3);
-            TEST_STEP(mVerticalHeader_CellMergeParentColumn->at(i).at(0)==0);
+            TEST_STEP(mVerticalHeader_Spans->parent(i, 0).y()==3);
+            TEST_STEP(mVerticalHeader_Spans->parent(i, 0).x()==0);
             TEST_STEP(aTable->verticalHeader_SpanParent(i, 0)==QPoint(0, 3));
         }
 
-        TEST_STEP(mVerticalHeader_CellMergeX->at(3).at(0)==1);
-        TEST_STEP(mVerticalHeader_CellMergeY->at(3).at(0)==2);
+        TEST_STEP(mVerticalHeader_Spans->columnSpan(3, 0)==1);
+        TEST_STEP(mVerticalHeader_Spans->rowSpan(3, 0)==2);
 
         aTable->verticalHeader_ClearSpans();
 
-        TEST_STEP(mVerticalHeader_Merges->length()==0);
+        TEST_STEP(mVerticalHeader_Spans->spans().length()==0);
 
         for (int i=0; i<((PublicCustomFastTable*)aTable)->getRowCount(); ++i)
         {
@@ -2413,10 +2417,10 @@ void TestFrame::startTest()
                 TEST_STEP(aTable->verticalHeader_RowSpan(i, j)==1);
                 TEST_STEP(aTable->verticalHeader_ColumnSpan(i, j)==1);
                 TEST_STEP(aTable->verticalHeader_SpanParent(i, j)==QPoint(-1, -1));
-                TEST_STEP(mVerticalHeader_CellMergeX->at(i).at(j)==1);
-                TEST_STEP(mVerticalHeader_CellMergeY->at(i).at(j)==1);
-                TEST_STEP(mVerticalHeader_CellMergeParentRow->at(i).at(j)==-1);
-                TEST_STEP(mVerticalHeader_CellMergeParentColumn->at(i).at(j)==-1);
+                TEST_STEP(mVerticalHeader_Spans->columnSpan(i, j)==1);
+                TEST_STEP(mVerticalHeader_Spans->rowSpan(i, j)==1);
+                TEST_STEP(mVerticalHeader_Spans->parent(i, j).y()==-1);
+                TEST_STEP(mVerticalHeader_Spans->parent(i, j).x()==-1);
 
                 if (!success)
                 {
@@ -2436,201 +2440,1569 @@ void TestFrame::startTest()
     {
         testNotSupported("verticalHeader_SetSpan");
     }
-}
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": cellAt";
+    // ----------------------------------------------------------------
+    {
+        success=true;
 
-bool TestFrame::checkForSizes(int rows, int columns, int headerRows, int headerColumns)
-{
-    bool success=true;
+        PublicCustomFastTable *aTable=(PublicCustomFastTable*)new CustomFastTableWidget();
 
-    TEST_STEP(((PublicCustomFastTable*)mFastTable)->getRowCount()==rows);
-    TEST_STEP(((PublicCustomFastTable*)mFastTable)->getColumnCount()==columns);
-    TEST_STEP(((PublicCustomFastTable*)mFastTable)->horizontalHeader_GetRowCount()==headerRows);
-    TEST_STEP(((PublicCustomFastTable*)mFastTable)->verticalHeader_GetColumnCount()==headerColumns);
+        aTable->setAttribute(Qt::WA_DontShowOnScreen);
+        aTable->resize(800, 600);
+        aTable->show();
 
-    TEST_STEP((mData==0                                   || mData->length()==rows));
-    TEST_STEP((mRowHeights==0                             || mRowHeights->length()==rows));
-    TEST_STEP((mColumnWidths==0                           || mColumnWidths->length()==columns));
-    TEST_STEP((mOffsetX==0                                || mOffsetX->length()==columns));
-    TEST_STEP((mOffsetY==0                                || mOffsetY->length()==rows));
+        aTable->setSizes(3, 2, 1, 1);
 
-    TEST_STEP((mHorizontalHeader_Data==0                  || mHorizontalHeader_Data->length()==headerRows                  || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_RowHeights==0            || mHorizontalHeader_RowHeights->length()==headerRows            || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_OffsetY==0               || mHorizontalHeader_OffsetY->length()==headerRows               || rows<=0 || columns<=0));
+        int aHeaderWidth=aTable->verticalHeader_TotalWidth();
+        int aHeaderHeight=aTable->horizontalHeader_TotalHeight();
+        int aRight=aTable->columnOffset(1)+aTable->columnWidth(1);
+        int aBottom=aTable->rowOffset(2)+aTable->rowHeight(2);
 
-    TEST_STEP((mVerticalHeader_Data==0                    || mVerticalHeader_Data->length()==rows                          || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_ColumnWidths==0            || mVerticalHeader_ColumnWidths->length()==headerColumns         || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_OffsetX==0                 || mVerticalHeader_OffsetX->length()==headerColumns              || rows<=0 || columns<=0));
+        TEST_STEP(aRight<700 && aBottom<500);
 
-    TEST_STEP((mSelectedCells==0                          || mSelectedCells->length()==rows));
-    TEST_STEP((mHorizontalHeader_SelectedColumns==0       || mHorizontalHeader_SelectedColumns->length()==columns));
-    TEST_STEP((mVerticalHeader_SelectedRows==0            || mVerticalHeader_SelectedRows->length()==rows));
-
-    TEST_STEP((mBackgroundBrushes==0                      || mBackgroundBrushes->length()==rows));
-    TEST_STEP((mForegroundColors==0                       || mForegroundColors->length()==rows));
-    TEST_STEP((mCellFonts==0                              || mCellFonts->length()==rows));
-    TEST_STEP((mCellTextFlags==0                          || mCellTextFlags->length()==rows));
-    TEST_STEP((mCellMergeX==0                             || mCellMergeX->length()==rows));
-    TEST_STEP((mCellMergeY==0                             || mCellMergeY->length()==rows));
-    TEST_STEP((mCellMergeParentRow==0                     || mCellMergeParentRow->length()==rows));
-    TEST_STEP((mCellMergeParentColumn==0                  || mCellMergeParentColumn->length()==rows));
-
-    TEST_STEP((mHorizontalHeader_BackgroundBrushes==0     || mHorizontalHeader_BackgroundBrushes->length()==headerRows     || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_ForegroundColors==0      || mHorizontalHeader_ForegroundColors->length()==headerRows      || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_CellFonts==0             || mHorizontalHeader_CellFonts->length()==headerRows             || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_CellTextFlags==0         || mHorizontalHeader_CellTextFlags->length()==headerRows         || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_CellMergeX==0            || mHorizontalHeader_CellMergeX->length()==headerRows            || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_CellMergeY==0            || mHorizontalHeader_CellMergeY->length()==headerRows            || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_CellMergeParentRow==0    || mHorizontalHeader_CellMergeParentRow->length()==headerRows    || rows<=0 || columns<=0));
-    TEST_STEP((mHorizontalHeader_CellMergeParentColumn==0 || mHorizontalHeader_CellMergeParentColumn->length()==headerRows || rows<=0 || columns<=0));
-
-    TEST_STEP((mVerticalHeader_BackgroundBrushes==0       || mVerticalHeader_BackgroundBrushes->length()==rows             || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_ForegroundColors==0        || mVerticalHeader_ForegroundColors->length()==rows              || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_CellFonts==0               || mVerticalHeader_CellFonts->length()==rows                     || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_CellTextFlags==0           || mVerticalHeader_CellTextFlags->length()==rows                 || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_CellMergeX==0              || mVerticalHeader_CellMergeX->length()==rows                    || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_CellMergeY==0              || mVerticalHeader_CellMergeY->length()==rows                    || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_CellMergeParentRow==0      || mVerticalHeader_CellMergeParentRow->length()==rows            || rows<=0 || columns<=0));
-    TEST_STEP((mVerticalHeader_CellMergeParentColumn==0   || mVerticalHeader_CellMergeParentColumn->length()==rows         || rows<=0 || columns<=0));
+        TEST_STEP(aTable->cellAt(aRight-1, aBottom-1)==QPoint(1, 2));
+        TEST_STEP(aTable->cellAt(aRight, aHeaderHeight)==QPoint(-1, -1));
+        TEST_STEP(aTable->cellAt(aHeaderWidth, aBottom)==QPoint(-1, -1));
+        TEST_STEP(aTable->cellAt(aRight+50, aBottom+50)==QPoint(-1, -1));
 
+        TEST_STEP(aTable->horizontalHeader_CellAt(aRight-1, 0)==QPoint(1, 0));
+        TEST_STEP(aTable->horizontalHeader_CellAt(aRight, 0)==QPoint(-1, -1));
 
-    CHECK_COLUMN_COUNT(mData);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_Data);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_Data);
+        TEST_STEP(aTable->verticalHeader_CellAt(0, aBottom-1)==QPoint(0, 2));
+        TEST_STEP(aTable->verticalHeader_CellAt(0, aBottom)==QPoint(-1, -1));
 
-    CHECK_COLUMN_COUNT(mSelectedCells);
-
-    CHECK_COLUMN_COUNT(mBackgroundBrushes);
-    CHECK_COLUMN_COUNT(mForegroundColors);
-    CHECK_COLUMN_COUNT(mCellFonts);
-    CHECK_COLUMN_COUNT(mCellTextFlags);
-    CHECK_COLUMN_COUNT(mCellMergeX);
-    CHECK_COLUMN_COUNT(mCellMergeY);
-    CHECK_COLUMN_COUNT(mCellMergeParentRow);
-    CHECK_COLUMN_COUNT(mCellMergeParentColumn);
-
-    CHECK_COLUMN_COUNT(mHorizontalHeader_BackgroundBrushes);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_ForegroundColors);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_CellFonts);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_CellTextFlags);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_CellMergeX);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_CellMergeY);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_CellMergeParentRow);
-    CHECK_COLUMN_COUNT(mHorizontalHeader_CellMergeParentColumn);
-
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_BackgroundBrushes);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_ForegroundColors);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_CellFonts);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_CellTextFlags);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_CellMergeX);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_CellMergeY);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_CellMergeParentRow);
-    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_CellMergeParentColumn);
+        delete aTable;
 
-    return success;
-}
+        testCompleted(success, "cellAt");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": updateVisibleRange(10M)";
+    // ----------------------------------------------------------------
+    {
+        success=true;
 
-void TestFrame::addTestLabel(QString aTestName)
-{
-    int aCount=ui->testGridLayout->count()/3;
-    int row=aCount%25;
-    int column=aCount/25*3;
+        PublicCustomFastTable *aTable=(PublicCustomFastTable*)new CustomFastTableWidget();
 
-    QLabel *aLabel;
+        aTable->setAttribute(Qt::WA_DontShowOnScreen);
+        aTable->resize(800, 600);
+        aTable->show();
 
-    //------
+        aTable->setSizes(10000000, 10, 1, 1);
 
-    aLabel=new QLabel(QString::number(aCount+1), this);
+        for (int i=0; i<10; ++i)
+        {
+            aTable->setRowVisible(i*1000000+500, false);
+        }
 
-    ui->testGridLayout->addWidget(aLabel, row, column);
+        QScrollBar *aScrollBar=aTable->verticalScrollBar();
+        const int aJumps=1000;
 
-    //------
+        // Far jumps in both directions must give exact range without walking from the previous one
+        for (int i=0; i<aJumps && success; ++i)
+        {
+            aScrollBar->setValue((i & 1) ? aScrollBar->maximum()-i : (qint64)aScrollBar->maximum()*i/aJumps);
 
-    aLabel=new QLabel(aTestName, this);
+            int aTop=aTable->getVisibleTop();
+            int aBottom=aTable->getVisibleBottom();
+            int aMinY=aScrollBar->value()+aTable->horizontalHeader_GetTotalHeight();
 
-    aLabel->setAlignment(Qt::AlignVCenter | Qt::AlignRight);
+            TEST_STEP(aTop>=0 && aTop<=aBottom && aBottom<aTable->getRowCount());
+            TEST_STEP(aTable->rowVisible(aTop));
+            TEST_STEP(aTable->rowOffset(aTop)<=aMinY && aTable->rowOffset(aTop)+aTable->rowHeight(aTop)>aMinY);
+            TEST_STEP(aTable->rowOffset(aBottom)<=aScrollBar->value()+aTable->viewport()->height());
+        }
 
-    ui->testGridLayout->addWidget(aLabel, row, column+1);
+        delete aTable;
 
-    //------
+        testCompleted(success, "updateVisibleRange(10M)");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": updateVisibleRange with spans(200K)";
+    // ----------------------------------------------------------------
+    {
+        success=true;
 
-    aLabel=new QLabel("IN PROGRESS", this);
+        FastTableWidget *aTable=new FastTableWidget();
+        PublicCustomFastTable *aPublicTable=(PublicCustomFastTable*)aTable;
 
-    QFont aFont=aLabel->font();
-    aFont.setBold(true);
-    aLabel->setFont(aFont);
+        aTable->setAttribute(Qt::WA_DontShowOnScreen);
+        aTable->resize(800, 600);
+        aTable->show();
 
-    QPalette aPalette=aLabel->palette();
-    aPalette.setColor(QPalette::WindowText, QColor(0, 0, 255));
-    aLabel->setPalette(aPalette);
+        aTable->setSizes(200000, 10, 1, 1);
 
-    ui->testGridLayout->addWidget(aLabel, row, column+2);
-}
+        for (int i=0; i<200000; i+=100)
+        {
+            aTable->setSpan(i, 0, 50, 3);
+        }
 
-QLabel* TestFrame::getLabel(QString aTestName)
-{
-    for (int i=1; i<ui->testGridLayout->count(); i+=3)
+        aTable->horizontalScrollBar()->setValue(aTable->columnOffset(1)-aPublicTable->verticalHeader_GetTotalWidth()+1);
+
+        QScrollBar *aScrollBar=aTable->verticalScrollBar();
+        const int aJumps=1000;
+
+        // Spans crossing into the visible range must be found after every far jump
+        for (int i=0; i<aJumps && success; ++i)
+        {
+            aScrollBar->setValue((i & 1) ? aScrollBar->maximum()-i : (qint64)aScrollBar->maximum()*i/aJumps);
+
+            int aTop=aPublicTable->getVisibleTop();
+            int aBottom=aPublicTable->getVisibleBottom();
+            int aLeft=1;
+
+            for (int j=aTop; j<=aBottom; ++j)
+            {
+                if (aTable->spanParent(j, 1).x()==0)
+                {
+                    aLeft=0;
+                    break;
+                }
+            }
+
+            TEST_STEP(aPublicTable->getVisibleLeft()==aLeft);
+            TEST_STEP(aTable->spanParent(aTop, 0).y()<0 || aTable->spanParent(aTop, 0).y()==aTop);
+        }
+
+        delete aTable;
+
+        testCompleted(success, "updateVisibleRange with spans(200K)");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": setRowHeight(2M)";
+    // ----------------------------------------------------------------
     {
-        if (((QLabel*)ui->testGridLayout->itemAt(i)->widget())->text()==aTestName)
+        success=true;
+
+        PublicCustomFastTable *aTable=(PublicCustomFastTable*)new CustomFastTableWidget();
+
+        aTable->setSizes(2000000, 5, 1, 1);
+
+        // The tree is built once on the first lookup after sizes become different
+        aTable->setRowHeight(1, 10);
+
+        OffsetIndex *aOffsetY=aTable->getOffsetY();
+
+        TEST_STEP(aTable->rowOffset(2)==aTable->horizontalHeader_GetTotalHeight()+aTable->getDefaultHeight()+10);
+        TEST_STEP(aOffsetY->rebuildCount()==1);
+
+        const int aChanges=10000;
+
+        for (int i=0; i<aChanges; ++i)
         {
-            return (QLabel*)ui->testGridLayout->itemAt(i+1)->widget();
+            int aRow=(qint64)i*7919%aTable->getRowCount();
+
+            if (i & 1)
+            {
+                aTable->setRowVisible(aRow, !aTable->rowVisible(aRow));
+            }
+            else
+            {
+                aTable->setRowHeight(aRow, 10+i%50);
+            }
+
+            aTable->rowAtOffset(aTable->rowOffset(aRow));
         }
+
+        // Height and visibility changes only patch the tree
+        TEST_STEP(aOffsetY->rebuildCount()==1);
+
+        aTable->insertRow(1000);
+        aTable->removeRow(500000);
+        aTable->horizontalHeader_SetRowHeight(0, 50);
+
+        SizeList *aRowHeights=aTable->getRowHeights();
+        int aOffset=aTable->horizontalHeader_GetTotalHeight();
+
+        for (int i=0; i<aRowHeights->length(); ++i)
+        {
+            if (i%1000==0)
+            {
+                TEST_STEP(aTable->rowOffset(i)==aOffset);
+
+                if (aRowHeights->at(i)>0)
+                {
+                    TEST_STEP(aTable->rowAtOffset(aOffset)==i);
+                    TEST_STEP(aTable->rowAtOffset(aOffset+aRowHeights->at(i)-1)==i);
+                }
+            }
+
+            if (aRowHeights->at(i)>0)
+            {
+                aOffset+=aRowHeights->at(i);
+            }
+        }
+
+        TEST_STEP(aOffset==aTable->totalHeight());
+
+        delete aTable;
+
+        testCompleted(success, "setRowHeight(2M)");
     }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": uniformGeometry";
+    // ----------------------------------------------------------------
+    {
+        success=true;
 
-    return 0;
-}
+        PublicCustomFastTable *aTable=(PublicCustomFastTable*)new CustomFastTableWidget();
 
-void TestFrame::testCompleted(bool success, QString aTestName)
-{
-    if (success)
+        aTable->setSizes(10000000, 10, 1, 1);
+
+        int aDefaultHeight=aTable->getDefaultHeight();
+        int aHeaderHeight=aTable->horizontalHeader_GetTotalHeight();
+
+        TEST_STEP(aTable->getRowHeights()->isUniform());
+        TEST_STEP(aTable->getColumnWidths()->isUniform());
+        TEST_STEP(aTable->rowOffset(9999999)==aHeaderHeight+aDefaultHeight*9999999);
+        TEST_STEP(aTable->rowAtOffset(aHeaderHeight+aDefaultHeight*5000000)==5000000);
+        TEST_STEP(aTable->rowAtOffset(aHeaderHeight+aDefaultHeight*5000000-1)==4999999);
+        TEST_STEP(aTable->rowAtOffset(0)==0);
+        TEST_STEP(aTable->rowAtOffset(aTable->totalHeight()+100)==9999999);
+
+        aTable->setRowHeight(100, aDefaultHeight);
+        TEST_STEP(aTable->getRowHeights()->isUniform());
+
+        aTable->setRowHeight(100, aDefaultHeight+10);
+        TEST_STEP(!aTable->getRowHeights()->isUniform());
+        TEST_STEP(aTable->rowHeight(100)==aDefaultHeight+10);
+        TEST_STEP(aTable->rowOffset(100)==aHeaderHeight+aDefaultHeight*100);
+        TEST_STEP(aTable->rowOffset(101)==aHeaderHeight+aDefaultHeight*101+10);
+        TEST_STEP(aTable->rowAtOffset(aHeaderHeight+aDefaultHeight*101+5)==100);
+        TEST_STEP(aTable->rowAtOffset(aHeaderHeight+aDefaultHeight*101+10)==101);
+
+        aTable->clear();
+        aTable->setSizes(100, 10, 1, 1);
+        TEST_STEP(aTable->getRowHeights()->isUniform());
+
+        delete aTable;
+
+        testCompleted(success, "uniformGeometry");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": setSizes(1M)";
+    // ----------------------------------------------------------------
     {
-        testSuccess(aTestName);
+        success=true;
+
+        mFastTable->clear();
+        mFastTable->setSizes(20, 10, 2, 2);
+        mFastTable->setCurrentCell(19, 9);
+        mFastTable->setCellSelected(3, 3, true);
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            ((FastTableWidget*)mFastTable)->setSpan(15, 6, 4, 3);
+        }
+
+        mFastTable->setRowCount(17);
+
+        TEST_STEP(checkForSizes(17, 10, 2, 2));
+        TEST_STEP(mFastTable->currentCell()==QPoint(9, 16));
+        TEST_STEP(mSelection->cellCount()==2);
+        TEST_STEP(mSelection->columnCellCount(9)==1);
+
+        mFastTable->setColumnCount(7);
+
+        TEST_STEP(checkForSizes(17, 7, 2, 2));
+        TEST_STEP(mFastTable->currentCell()==QPoint(6, 16));
+        TEST_STEP(mSelection->rowCellCount(16)==1);
+        TEST_STEP(mFastTable->cellSelected(3, 3));
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            FastTableWidget* aTable=(FastTableWidget*)mFastTable;
+
+            TEST_STEP(mSpans->spans().length()==1 && mSpans->spans().at(0)==QRect(6, 15, 1, 2));
+            TEST_STEP(aTable->rowSpan(15, 6)==2);
+            TEST_STEP(aTable->columnSpan(15, 6)==1);
+
+            mFastTable->setRowCount(16);
+
+            TEST_STEP(mSpans->spans().length()==0);
+            TEST_STEP(aTable->spanParent(15, 6)==QPoint(-1, -1));
+        }
+
+        int aRebuildCount=mOffsetY->rebuildCount();
+
+        mFastTable->setSizes(1000000, 7, 2, 2);
+
+        TEST_STEP(checkForSizes(1000000, 7, 2, 2));
+
+        // Bulk resize keeps uniform geometry and doesn't allocate per-row sizes or offsets
+        TEST_STEP(mRowHeights->isUniform());
+        TEST_STEP(mOffsetY->rebuildCount()==aRebuildCount);
+
+        // New rows share one empty row until they are modified
+        TEST_STEP(mData==0 || mData->at(500000).constBegin()==mData->at(999999).constBegin());
+        TEST_STEP(mFastTable->totalHeight()==mFastTable->horizontalHeader_TotalHeight()+mFastTable->defaultHeight()*1000000);
+
+        mFastTable->setText(999999, 6, "Last");
+        TEST_STEP(mFastTable->text(999999, 6)=="Last");
+        TEST_STEP(mFastTable->text(999998, 6)=="");
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        TEST_STEP(checkForSizes(5, 3, 1, 1));
+
+        testCompleted(success, "setSizes(1M)");
     }
-    else
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": insertRows/removeRows";
+    // ----------------------------------------------------------------
     {
-        testFail(aTestName);
+        success=true;
+
+        mFastTable->clear();
+        mFastTable->setSizes(10, 6, 1, 1);
+        mFastTable->setText(5, 2, "A");
+        mFastTable->setCurrentCell(5, 2);
+        mFastTable->setCellSelected(8, 4, true);
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            ((FastTableWidget*)mFastTable)->setSpan(2, 1, 3, 2);
+        }
+
+        mFastTable->insertRows(3, 4);
+
+        TEST_STEP(checkForSizes(14, 6, 1, 1));
+        TEST_STEP(mFastTable->text(9, 2)=="A");
+        TEST_STEP(mFastTable->currentCell()==QPoint(2, 9));
+        TEST_STEP(mFastTable->cellSelected(12, 4));
+        TEST_STEP(mSelection->cellCount()==2);
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            FastTableWidget* aTable=(FastTableWidget*)mFastTable;
+
+            TEST_STEP(mSpans->spans().length()==1 && mSpans->spans().at(0)==QRect(1, 2, 2, 7));
+            TEST_STEP(aTable->rowSpan(2, 1)==7);
+            TEST_STEP(aTable->spanParent(6, 2)==QPoint(1, 2));
+        }
+
+        mFastTable->removeRows(1, 3);
+
+        TEST_STEP(checkForSizes(11, 6, 1, 1));
+        TEST_STEP(mFastTable->text(6, 2)=="A");
+        TEST_STEP(mFastTable->currentCell()==QPoint(2, 6));
+        TEST_STEP(mFastTable->cellSelected(9, 4));
+        TEST_STEP(mSelection->columnCellCount(4)==1);
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            FastTableWidget* aTable=(FastTableWidget*)mFastTable;
+
+            TEST_STEP(mSpans->spans().length()==1 && mSpans->spans().at(0)==QRect(1, 1, 2, 5));
+            TEST_STEP(aTable->rowSpan(1, 1)==5);
+            TEST_STEP(aTable->columnSpan(1, 1)==2);
+            TEST_STEP(aTable->spanParent(5, 2)==QPoint(1, 1));
+        }
+
+        mFastTable->insertColumns(0, 2);
+
+        TEST_STEP(checkForSizes(11, 8, 1, 1));
+        TEST_STEP(mFastTable->text(6, 4)=="A");
+        TEST_STEP(mFastTable->currentCell()==QPoint(4, 6));
+        TEST_STEP(mFastTable->cellSelected(9, 6));
+
+        mFastTable->removeColumns(3, 1);
+
+        TEST_STEP(checkForSizes(11, 7, 1, 1));
+        TEST_STEP(mFastTable->text(6, 3)=="A");
+        TEST_STEP(mFastTable->currentCell()==QPoint(3, 6));
+        TEST_STEP(mSelection->rowCellCount(9)==1);
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            FastTableWidget* aTable=(FastTableWidget*)mFastTable;
+
+            TEST_STEP(mSpans->spans().length()==1 && mSpans->spans().at(0)==QRect(3, 1, 1, 5));
+            TEST_STEP(aTable->rowSpan(1, 3)==5);
+            TEST_STEP(aTable->columnSpan(1, 3)==1);
+            TEST_STEP(aTable->spanParent(5, 3)==QPoint(3, 1));
+        }
+
+        mFastTable->removeRows(0, mFastTable->rowCount());
+
+        TEST_STEP(checkForSizes(0, 7, 1, 1));
+        TEST_STEP(mSelection->cellCount()==0);
+        TEST_STEP(mFastTable->currentRow()==-1);
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            TEST_STEP(mSpans->spans().length()==0);
+        }
+
+        testCompleted(success, "insertRows/removeRows");
     }
-}
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": beginUpdate/endUpdate";
+    // ----------------------------------------------------------------
+    {
+        success=true;
 
-void TestFrame::testSuccess(QString aTestName)
-{
-    QLabel *aLabel=getLabel(aTestName);
+        mFastTable->clear();
+        mFastTable->setSizes(10, 5, 1, 1);
 
-    QPalette aPalette;
+        int aHeaderWidth=mVerticalHeader_ColumnWidths->at(0);
+        int aBarMaximum=mFastTable->verticalScrollBar()->maximum();
 
-    aPalette.setColor(QPalette::WindowText, QColor(0, 128, 0));
+        mFastTable->setCurrentCell(0, 0);
 
-    aLabel->setText("SUCCESS");
-    aLabel->setPalette(aPalette);
+        mSelectionChangedCount=0;
+        mCurrentCellChangedCount=0;
+        mCellChangedCount=0;
 
-    emit testFinished();
-}
+        mFastTable->beginUpdate();
+        mFastTable->beginUpdate();
 
-void TestFrame::testFail(QString aTestName)
-{
-    QLabel *aLabel=getLabel(aTestName);
+        TEST_STEP(mFastTable->isUpdating());
 
-    QPalette aPalette;
+        mFastTable->setRowCount(100000);
 
-    aPalette.setColor(QPalette::WindowText, QColor(128, 0, 0));
+        mFastTable->setCurrentCell(2, 2, true);
+        mFastTable->setCurrentCell(3, 3, true);
 
-    aLabel->setText("FAIL");
-    aLabel->setPalette(aPalette);
+        for (int i=0; i<100; ++i)
+        {
+            mFastTable->setCellSelected(i, 1, true);
+        }
 
-    qWarning()<<"FAIL";
+        mFastTable->endUpdate();
 
-    emit testFinished();
-}
+        TEST_STEP(mFastTable->isUpdating());
+        TEST_STEP(mVerticalHeader_ColumnWidths->at(0)==aHeaderWidth);
+        TEST_STEP(mFastTable->verticalScrollBar()->maximum()==aBarMaximum);
 
-void TestFrame::testNotSupported(QString aTestName)
-{
-    QLabel *aLabel=getLabel(aTestName);
+        // Signals are held until the outermost endUpdate
+        TEST_STEP(mSelectionChangedCount==0);
+        TEST_STEP(mCurrentCellChangedCount==0);
+        TEST_STEP(mCellChangedCount==0);
 
-    QPalette aPalette;
+        mFastTable->endUpdate();
 
-    aPalette.setColor(QPalette::WindowText, QColor(0, 128, 128));
+        TEST_STEP(!mFastTable->isUpdating());
+        TEST_STEP(checkForSizes(100000, 5, 1, 1));
+        TEST_STEP(mVerticalHeader_ColumnWidths->at(0)>aHeaderWidth);
+        TEST_STEP(mFastTable->verticalScrollBar()->maximum()>aBarMaximum);
+        TEST_STEP(mSelection->columnCellCount(1)==100);
 
-    aLabel->setText("NOT SUPPORTED");
-    aLabel->setPalette(aPalette);
+        // Each signal is emitted once for the whole transaction
+        TEST_STEP(mSelectionChangedCount==1);
+        TEST_STEP(mCurrentCellChangedCount==1);
+        TEST_STEP(mCellChangedCount==1);
+        TEST_STEP(mPreviousCurrentCell==QPoint(0, 0));
+        TEST_STEP(mFastTable->currentCell()==QPoint(3, 3));
+        TEST_STEP(mDeselectedRanges.length()==0);
 
-    emit testFinished();
+        int aSelectedCount=0;
+
+        for (int i=0; i<mSelectedRanges.length(); ++i)
+        {
+            aSelectedCount+=mSelectedRanges.at(i).width()*mSelectedRanges.at(i).height();
+        }
+
+        TEST_STEP(aSelectedCount==100);
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "beginUpdate/endUpdate");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Dirty region painting";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        mFastTable->clear();
+        mFastTable->setSizes(50, 20, 1, 1);
+        mFastTable->scrollToCell(5, 3);
+
+        QRect aCellRect=mFastTable->cellRectangle(5, 3).translated(-mFastTable->horizontalScrollBar()->value(), -mFastTable->verticalScrollBar()->value());
+        QRect aExposedCells=((PublicCustomFastTable*)mFastTable)->getExposedCells(aCellRect.adjusted(1, 1, -1, -1));
+
+        TEST_STEP(aExposedCells.top()==5 && aExposedCells.bottom()==5);
+        TEST_STEP(aExposedCells.left()==3 && aExposedCells.right()==3);
+
+        if (mFastTable->inherits("FastTableWidget"))
+        {
+            ((FastTableWidget*)mFastTable)->setSpan(4, 2, 2, 2);
+
+            aExposedCells=((PublicCustomFastTable*)mFastTable)->getExposedCells(aCellRect.adjusted(1, 1, -1, -1));
+
+            TEST_STEP(aExposedCells.top()==4 && aExposedCells.bottom()==5);
+            TEST_STEP(aExposedCells.left()==2 && aExposedCells.right()==3);
+        }
+
+        // Range is updated with one rectangle from its first to its last cell
+        QRect aDirtyArea=((PublicCustomFastTable*)mFastTable)->getDirtyArea(QRect(2, 4, 3, 2));
+        QRect aLastCellRect=mFastTable->cellRectangle(5, 4).translated(-mFastTable->horizontalScrollBar()->value(), -mFastTable->verticalScrollBar()->value());
+
+        TEST_STEP(aDirtyArea.topLeft()==mFastTable->cellRectangle(4, 2).translated(-mFastTable->horizontalScrollBar()->value(), -mFastTable->verticalScrollBar()->value()).topLeft());
+        TEST_STEP(aDirtyArea.bottomRight()==aLastCellRect.bottomRight());
+        TEST_STEP(((PublicCustomFastTable*)mFastTable)->getExposedCells(aDirtyArea.adjusted(1, 1, -1, -1))==QRect(2, 4, 3, 2));
+        TEST_STEP(((PublicCustomFastTable*)mFastTable)->getDirtyArea(QRect(2, mFastTable->rowCount(), 3, 2)).isNull());
+
+        mFastTable->setText(5, 3, "Dirty");
+        mFastTable->setCurrentCell(5, 3);
+        mFastTable->viewport()->repaint(aCellRect);
+
+        TEST_STEP(mFastTable->text(5, 3)=="Dirty");
+        TEST_STEP(mSelection->cellCount()==1);
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "Dirty region painting");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Scroll blitting";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        PublicCustomFastTable *aTable=(PublicCustomFastTable*)new CustomFastTableWidget();
+
+        aTable->setAttribute(Qt::WA_DontShowOnScreen);
+        aTable->resize(800, 600);
+        aTable->show();
+
+        aTable->setSizes(1000, 50, 2, 2);
+
+        QSize aAreaSize=aTable->viewport()->size();
+        int aHeaderWidth=aTable->verticalHeader_GetTotalWidth();
+        int aHeaderHeight=aTable->horizontalHeader_GetTotalHeight();
+
+        QRect aCorner(0, 0, aHeaderWidth, aHeaderHeight);
+        QRect aVerticalHeader(0, 0, aHeaderWidth, aAreaSize.height());
+        QRect aHorizontalHeader(0, 0, aAreaSize.width(), aHeaderHeight);
+
+        TEST_STEP(aHeaderWidth>0 && aHeaderHeight>0);
+
+        // Horizontal scroll shifts cells and horizontal header, vertical header and corner stay
+        QRect aArea=aTable->getScrolledArea(-aTable->defaultWidth(), 0);
+
+        TEST_STEP(aArea==QRect(aHeaderWidth, 0, aAreaSize.width()-aHeaderWidth, aAreaSize.height()));
+        TEST_STEP(!aArea.intersects(aCorner));
+        TEST_STEP(!aArea.intersects(aVerticalHeader));
+
+        aArea=aTable->getScrolledArea(aTable->defaultWidth(), 0);
+
+        TEST_STEP(aArea==QRect(aHeaderWidth, 0, aAreaSize.width()-aHeaderWidth, aAreaSize.height()));
+
+        // Vertical scroll shifts cells and vertical header, horizontal header and corner stay
+        aArea=aTable->getScrolledArea(0, -aTable->defaultHeight());
+
+        TEST_STEP(aArea==QRect(0, aHeaderHeight, aAreaSize.width(), aAreaSize.height()-aHeaderHeight));
+        TEST_STEP(!aArea.intersects(aCorner));
+        TEST_STEP(!aArea.intersects(aHorizontalHeader));
+
+        aArea=aTable->getScrolledArea(0, aTable->defaultHeight());
+
+        TEST_STEP(aArea==QRect(0, aHeaderHeight, aAreaSize.width(), aAreaSize.height()-aHeaderHeight));
+
+        // Diagonal scrolls and scrolls over the whole cell area repaint everything
+        TEST_STEP(aTable->getScrolledArea(-aTable->defaultWidth(), -aTable->defaultHeight()).isNull());
+        TEST_STEP(aTable->getScrolledArea(aTable->defaultWidth(), -aTable->defaultHeight()).isNull());
+        TEST_STEP(aTable->getScrolledArea(aHeaderWidth-aAreaSize.width(), 0).isNull());
+        TEST_STEP(aTable->getScrolledArea(0, aHeaderHeight-aAreaSize.height()).isNull());
+
+        // Scrolling through the bars keeps visible range in sync with shifted content
+        aTable->verticalScrollBar()->setValue(aTable->defaultHeight()*10);
+        TEST_STEP(aTable->getVisibleTop()==10);
+
+        aTable->horizontalScrollBar()->setValue(aTable->defaultWidth()*5);
+        TEST_STEP(aTable->getVisibleLeft()==5);
+
+        delete aTable;
+
+        testCompleted(success, "Scroll blitting");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Bit grid";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        BitGrid aBits;
+        aBits.resize(3, 130);
+
+        TEST_STEP(!aBits.at(1, 5) && aBits.nextSetBit(1, 0)==-1 && aBits.nextClearBit(1, 0)==0);
+
+        aBits.setBit(1, 5, true);
+        aBits.setBit(1, 64, true);
+        aBits.setBit(2, 129, true);
+
+        TEST_STEP(aBits.at(1, 5) && aBits.at(1).at(64) && aBits.at(2, 129));
+        TEST_STEP(!aBits.at(1, 63) && !aBits.at(1, 65));
+        TEST_STEP(aBits.nextSetBit(1, 0)==5 && aBits.nextSetBit(1, 6)==64 && aBits.nextSetBit(1, 65)==-1);
+        TEST_STEP(aBits.nextSetBit(2, 0)==129);
+
+        aBits.removeColumns(10, 60);
+
+        TEST_STEP(aBits.columnCount()==70);
+        TEST_STEP(aBits.at(1, 5) && !aBits.at(1, 10) && aBits.at(2, 69));
+        TEST_STEP(aBits.nextSetBit(1, 6)==-1);
+
+        aBits.insertColumns(0, 70);
+
+        TEST_STEP(aBits.columnCount()==140);
+        TEST_STEP(aBits.at(1, 75) && aBits.at(2, 139) && !aBits.at(1, 5));
+
+        aBits.insertRows(1, 2);
+
+        TEST_STEP(aBits.rowCount()==5);
+        TEST_STEP(aBits.nextSetBit(1, 0)==-1 && aBits.nextSetBit(2, 0)==-1);
+        TEST_STEP(aBits.at(3, 75) && aBits.at(4, 139));
+
+        aBits.removeRows(0, 4);
+
+        TEST_STEP(aBits.rowCount()==1 && aBits.at(0, 139) && aBits.nextSetBit(0, 0)==139);
+
+        aBits.fill(true);
+
+        TEST_STEP(aBits.nextClearBit(0, 0)==-1 && aBits.at(0, 0));
+
+        aBits.fill(false);
+
+        TEST_STEP(aBits.nextSetBit(0, 0)==-1 && !aBits.at(0, 139));
+
+        testCompleted(success, "Bit grid");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Selection ranges";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        mFastTable->clear();
+        mFastTable->setSizes(3, 130, 1, 1);
+
+        mFastTable->setCellSelected(1, 5, true);
+        mFastTable->setCellSelected(1, 64, true);
+        mFastTable->setCellSelected(2, 129, true);
+
+        TEST_STEP(mSelection->contains(1, 5) && mSelection->contains(1, 64) && mSelection->contains(2, 129));
+        TEST_STEP(!mSelection->contains(1, 63) && !mSelection->contains(1, 65));
+        TEST_STEP(mSelection->rowCellCount(1)==2);
+
+        mFastTable->removeColumns(10, 60);
+
+        TEST_STEP(checkForSizes(3, 70, 1, 1));
+        TEST_STEP(mSelection->contains(1, 5) && !mSelection->contains(1, 10));
+        TEST_STEP(mSelection->contains(2, 69));
+        TEST_STEP(mSelection->rowCellCount(1)==1);
+        TEST_STEP(mSelection->cellCount()==2);
+
+        mFastTable->insertColumns(0, 70);
+
+        TEST_STEP(checkForSizes(3, 140, 1, 1));
+        TEST_STEP(mSelection->contains(1, 75) && mSelection->contains(2, 139));
+        TEST_STEP(!mSelection->contains(1, 5));
+
+        mFastTable->selectAll();
+
+        TEST_STEP(mSelection->cellCount()==3*140);
+        TEST_STEP(mSelection->columnCellCount(139)==3);
+        TEST_STEP(mFastTable->selectedRanges().length()==1);
+
+        mFastTable->setCellSelected(1, 70, false);
+
+        TEST_STEP(mSelection->cellCount()==3*140-1);
+        TEST_STEP(mSelection->ranges().length()==4);
+        TEST_STEP(mSelection->rowCellCount(1)==139);
+        TEST_STEP(mSelection->columnCellCount(70)==2);
+        TEST_STEP(!mFastTable->cellSelected(1, 70));
+
+        mFastTable->setCellSelected(1, 70, true);
+
+        TEST_STEP(mSelection->ranges().length()==1);
+        TEST_STEP(mSelection->isAllSelected());
+
+        mFastTable->unselectAll();
+
+        TEST_STEP(mSelection->cellCount()==0);
+        TEST_STEP(mSelection->ranges().length()==0);
+
+        mFastTable->selectColumn(3);
+        mFastTable->selectRow(0);
+
+        TEST_STEP(mSelection->cellCount()==3+140-1);
+        TEST_STEP(mSelection->columnCellCount(3)==3);
+        TEST_STEP(mFastTable->topLeftSelectedCell()==QPoint(0, 0));
+        TEST_STEP(mFastTable->selectedRanges().length()==2);
+        TEST_STEP(mFastTable->selectedRanges().at(0)==QRect(0, 0, 140, 1));
+        TEST_STEP(mFastTable->selectedRanges().at(1)==QRect(3, 1, 1, 2));
+
+        mFastTable->insertRows(1, 1);
+
+        TEST_STEP(mSelection->contains(0, 3) && !mSelection->contains(1, 3) && mSelection->contains(3, 3));
+        TEST_STEP(mSelection->columnCellCount(3)==3);
+
+        mFastTable->unselectAll();
+        mFastTable->selectRow(0);
+        mFastTable->selectRow(2);
+
+        TEST_STEP(mSelection->ranges().length()==2);
+
+        mFastTable->removeRow(1);
+
+        TEST_STEP(mSelection->ranges().length()==1);
+        TEST_STEP(mFastTable->selectedRanges().at(0)==QRect(0, 0, 140, 2));
+
+        mFastTable->unselectAll();
+
+        TEST_STEP(!mSelection->contains(2, 139));
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "Selection ranges");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Selection flags";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        SelectionRanges aSelection;
+        aSelection.resize(1000000, 1000);
+
+        for (int i=0; i<1000; i+=2)
+        {
+            aSelection.select(QRect(0, i*1000, 1000, 1));
+            aSelection.select(QRect(i, 0, 1, 1000000));
+        }
+
+        TEST_STEP(aSelection.explicitRanges().length()==0);
+        TEST_STEP(aSelection.rowSelected(2000) && !aSelection.rowSelected(2001));
+        TEST_STEP(aSelection.columnSelected(998) && !aSelection.columnSelected(999));
+        TEST_STEP(aSelection.cellCount()==500*1000+500*1000000LL-500*500);
+        TEST_STEP(aSelection.rowCellCount(0)==1000 && aSelection.rowCellCount(1)==500);
+        TEST_STEP(aSelection.columnCellCount(1)==500 && aSelection.columnCellCount(2)==1000000);
+
+        aSelection.unselect(QRect(1, 0, 1, 1));
+        aSelection.unselect(QRect(2, 0, 1, 1));
+        aSelection.unselect(QRect(4, 5, 1, 1));
+
+        TEST_STEP(aSelection.exceptionCount()==3);
+        TEST_STEP(!aSelection.contains(0, 1) && !aSelection.contains(0, 2) && !aSelection.contains(5, 4));
+        TEST_STEP(aSelection.contains(0, 3) && aSelection.contains(6, 4));
+        TEST_STEP(aSelection.rowCellCount(0)==998 && aSelection.rowCellCount(5)==499);
+        TEST_STEP(aSelection.columnCellCount(2)==999999);
+
+        aSelection.select(QRect(0, 0, 5, 6));
+
+        TEST_STEP(aSelection.exceptionCount()==0);
+        TEST_STEP(aSelection.contains(0, 1) && aSelection.contains(5, 4) && aSelection.contains(5, 1));
+        TEST_STEP(aSelection.explicitRanges().length()==2);
+        TEST_STEP(aSelection.explicitRanges().at(0)==QRect(1, 1, 1, 5));
+        TEST_STEP(aSelection.explicitRanges().at(1)==QRect(3, 1, 1, 5));
+
+        aSelection.unselect(QRect(0, 0, 1000, 1000000));
+
+        TEST_STEP(aSelection.isEmpty());
+        TEST_STEP(aSelection.ranges().length()==0);
+
+        aSelection.selectAll();
+        aSelection.unselect(QRect(10, 100, 500, 500000));
+
+        TEST_STEP(aSelection.exceptionCount()==0);
+        TEST_STEP(aSelection.explicitRanges().length()==2);
+        TEST_STEP(aSelection.rowSelected(99) && !aSelection.rowSelected(100) && aSelection.rowSelected(500100));
+        TEST_STEP(!aSelection.contains(100, 10) && aSelection.contains(100, 9) && aSelection.contains(100, 510));
+        TEST_STEP(aSelection.cellCount()==1000*1000000LL-500*500000LL);
+        TEST_STEP(aSelection.rowCellCount(300)==500 && aSelection.columnCellCount(10)==500000);
+
+        testCompleted(success, "Selection flags");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": setRangeSelected/setSelection";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        mFastTable->clear();
+        mFastTable->setSizes(100000, 5, 1, 1);
+
+        mSelectionChangedCount=0;
+
+        mFastTable->selectColumn(2);
+
+        TEST_STEP(mSelectionChangedCount==1);
+        TEST_STEP(mSelectedRanges.length()==1 && mSelectedRanges.at(0)==QRect(2, 0, 1, 100000));
+        TEST_STEP(mDeselectedRanges.length()==0);
+
+        mFastTable->setRangeSelected(QRect(1, 10, 3, 10), true);
+
+        TEST_STEP(mSelectionChangedCount==2);
+        TEST_STEP(mSelectedRanges.length()==2);
+        TEST_STEP(mSelection->cellCount()==100000+20);
+
+        mFastTable->setRangeSelected(QRect(1, 10, 3, 10), true);
+
+        TEST_STEP(mSelectionChangedCount==2);
+
+        mFastTable->setSelection(QList<QRect>()<<QRect(0, 0, 5, 2));
+
+        int aSelectedCount=0;
+        int aDeselectedCount=0;
+
+        for (int i=0; i<mSelectedRanges.length(); ++i)
+        {
+            aSelectedCount+=mSelectedRanges.at(i).width()*mSelectedRanges.at(i).height();
+        }
+
+        for (int i=0; i<mDeselectedRanges.length(); ++i)
+        {
+            aDeselectedCount+=mDeselectedRanges.at(i).width()*mDeselectedRanges.at(i).height();
+        }
+
+        TEST_STEP(mSelectionChangedCount==3);
+        TEST_STEP(mSelection->cellCount()==10);
+        TEST_STEP(aSelectedCount==8);
+        TEST_STEP(aDeselectedCount==100000+20-2);
+
+        mFastTable->beginUpdate();
+        mFastTable->setCellSelected(50, 4, true);
+        mFastTable->setCellSelected(50, 4, false);
+        mFastTable->selectRow(60);
+        mFastTable->endUpdate();
+
+        TEST_STEP(mSelectionChangedCount==4);
+        TEST_STEP(mSelectedRanges.length()==1 && mSelectedRanges.at(0)==QRect(0, 60, 5, 1));
+        TEST_STEP(mDeselectedRanges.length()==0);
+
+        mFastTable->beginUpdate();
+        mFastTable->setRangeSelected(QRect(0, 70, 5, 10), true);
+        mFastTable->setRangeSelected(QRect(0, 75, 5, 5), false);
+        mFastTable->setCellSelected(60, 0, false);
+        mFastTable->setCellSelected(60, 0, true);
+        mFastTable->endUpdate();
+
+        TEST_STEP(mSelectionChangedCount==5);
+        TEST_STEP(mSelectedRanges.length()==1 && mSelectedRanges.at(0)==QRect(0, 70, 5, 5));
+        TEST_STEP(mDeselectedRanges.length()==0);
+
+        mFastTable->unselectAll();
+
+        TEST_STEP(mSelectionChangedCount==6);
+        TEST_STEP(mSelection->cellCount()==0);
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "setRangeSelected/setSelection");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Mouse selection";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        PublicCustomFastTable *aTable=(PublicCustomFastTable*)mFastTable;
+
+        mFastTable->clear();
+        mFastTable->setSizes(20, 20, 1, 1);
+
+        // Ctrl selection made before shift selection
+        mFastTable->setCellSelected(1, 1, true);
+        mFastTable->setCellSelected(5, 5, true);
+        mFastTable->setRangeSelected(QRect(0, 8, 3, 1), true);
+        mFastTable->setCellSelected(12, 12, true);
+
+        TEST_STEP(mSelection->cellCount()==6);
+
+        mFastTable->setCurrentCell(1, 1, true);
+        aTable->setShiftAnchor(1, 1);
+        aTable->doFillShiftSelection();
+        aTable->doSelectRangeForHandlers(6, 6);
+
+        TEST_STEP(mSelection->cellCount()==36+4);
+        TEST_STEP(aTable->getMouseSelectedRange()==QRect(1, 1, 6, 6));
+
+        aTable->doSelectRangeForHandlers(9, 0);
+
+        TEST_STEP(mSelection->cellCount()==18+3);
+        TEST_STEP(mSelection->contains(5, 5) && !mSelection->contains(4, 4) && !mSelection->contains(2, 2));
+        TEST_STEP(mSelection->contains(8, 0) && mSelection->contains(8, 2) && mSelection->contains(9, 0));
+
+        aTable->doSelectRangeForHandlers(1, 1);
+
+        TEST_STEP(mSelection->cellCount()==6);
+        TEST_STEP(mSelection->contains(1, 1) && mSelection->contains(5, 5) && mSelection->contains(12, 12));
+        TEST_STEP(mSelection->contains(8, 0) && mSelection->contains(8, 1) && mSelection->contains(8, 2));
+
+        aTable->doMouseRelease();
+
+        TEST_STEP(aTable->getMouseSelectedRange().isEmpty());
+        TEST_STEP(aTable->getMouseBaseSelection()->rowCount()==0);
+
+        // Whole columns by horizontal header
+        mFastTable->setCurrentCell(19, 3, true);
+        aTable->setShiftAnchor(19, 3);
+        aTable->horizontalHeader_DoFillShiftSelection();
+        aTable->horizontalHeader_DoSelectRangeForHandlers(6);
+
+        TEST_STEP(mSelection->cellCount()==4*20+5);
+
+        aTable->horizontalHeader_DoSelectRangeForHandlers(3);
+
+        TEST_STEP(mSelection->cellCount()==20+6);
+        TEST_STEP(mSelection->contains(5, 5) && !mSelection->contains(0, 4));
+        TEST_STEP(mSelection->columnCellCount(3)==20);
+
+        aTable->doMouseRelease();
+
+        // Whole rows by vertical header
+        mFastTable->setCurrentCell(10, 19, true);
+        aTable->setShiftAnchor(10, 19);
+        aTable->verticalHeader_DoFillShiftSelection();
+        aTable->verticalHeader_DoSelectRangeForHandlers(13);
+
+        TEST_STEP(mSelection->cellCount()==4*20+16+5);
+
+        aTable->verticalHeader_DoSelectRangeForHandlers(10);
+
+        TEST_STEP(mSelection->cellCount()==20+19+6);
+        TEST_STEP(mSelection->contains(12, 12) && mSelection->contains(12, 3) && !mSelection->contains(12, 0));
+        TEST_STEP(mSelection->rowCellCount(10)==20);
+
+        aTable->doMouseRelease();
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "Mouse selection");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Columnar storage";
+    // ----------------------------------------------------------------
+    if (mData)
+    {
+        success=true;
+
+        mFastTable->clear();
+        mFastTable->setSizes(50, 4, 1, 1);
+
+        for (int i=0; i<mFastTable->rowCount(); ++i)
+        {
+            for (int j=0; j<mFastTable->columnCount(); ++j)
+            {
+                mFastTable->setText(i, j, QString::number(i*10+j));
+            }
+        }
+
+        TEST_STEP(mFastTable->dataStorage()==CustomFastTableWidget::RowStorage);
+
+        mFastTable->setDataStorage(CustomFastTableWidget::ColumnStorage);
+        mData=((PublicCustomFastTable*)mFastTable)->getData();
+
+        TextColumns *aTextColumns=((PublicCustomFastTable*)mFastTable)->getTextColumns();
+
+        TEST_STEP(mFastTable->dataStorage()==CustomFastTableWidget::ColumnStorage);
+        TEST_STEP(mData==0);
+        TEST_STEP(aTextColumns!=0 && aTextColumns->rowCount()==50 && aTextColumns->columnCount()==4);
+        TEST_STEP(mFastTable->text(0, 0)=="0" && mFastTable->text(49, 3)=="493" && mFastTable->text(25, 2)=="252");
+
+        mFastTable->setText(25, 2, "Long text that does not fit into the old place");
+        mFastTable->setText(26, 2, "x");
+
+        TEST_STEP(mFastTable->text(25, 2)=="Long text that does not fit into the old place");
+        TEST_STEP(mFastTable->text(26, 2)=="x");
+        TEST_STEP(mFastTable->text(27, 2)=="272");
+
+        mFastTable->insertColumns(1, 2);
+        mFastTable->removeColumns(4, 1);
+        mFastTable->insertRows(10, 5);
+        mFastTable->removeRows(0, 2);
+
+        TEST_STEP(aTextColumns->rowCount()==53 && aTextColumns->columnCount()==5);
+        TEST_STEP(checkForSizes(53, 5, 1, 1));
+        TEST_STEP(mFastTable->text(0, 0)=="20" && mFastTable->text(0, 1)=="" && mFastTable->text(0, 3)=="21" && mFastTable->text(0, 4)=="23");
+        TEST_STEP(mFastTable->text(8, 0)=="" && mFastTable->text(12, 0)=="" && mFastTable->text(12, 3)=="" && mFastTable->text(13, 0)=="100");
+        TEST_STEP(mFastTable->text(28, 0)=="250" && mFastTable->text(29, 0)=="260");
+
+        mFastTable->setSizes(60, 6, 1, 1);
+
+        TEST_STEP(aTextColumns->rowCount()==60 && aTextColumns->columnCount()==6);
+        TEST_STEP(mFastTable->text(59, 5)=="" && mFastTable->text(52, 4)=="493");
+
+        mFastTable->setDataStorage(CustomFastTableWidget::RowStorage);
+        mData=((PublicCustomFastTable*)mFastTable)->getData();
+
+        TEST_STEP(mFastTable->dataStorage()==CustomFastTableWidget::RowStorage);
+        TEST_STEP(((PublicCustomFastTable*)mFastTable)->getTextColumns()==0);
+        TEST_STEP(mData!=0);
+        TEST_STEP(checkForSizes(60, 6, 1, 1));
+        TEST_STEP(mData->at(28).at(0)=="250" && mData->at(52).at(4)=="493" && mData->at(59).at(5)=="");
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "Columnar storage");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Dictionary encoded columns";
+    // ----------------------------------------------------------------
+    if (mData)
+    {
+        success=true;
+
+        QStringList aSides;
+        aSides<<"BUY"<<"SELL"<<"SHORT";
+
+        mFastTable->clear();
+        mFastTable->setSizes(1000, 3, 1, 1);
+
+        for (int i=0; i<mFastTable->rowCount(); ++i)
+        {
+            mFastTable->setText(i, 0, QString::number(i));
+            mFastTable->setText(i, 1, aSides.at(i % 3));
+        }
+
+        mFastTable->setColumnDictionaryEncoded(1, true);
+        mData=((PublicCustomFastTable*)mFastTable)->getData();
+
+        const TextColumn *aColumn=mFastTable->textColumn(1);
+
+        TEST_STEP(mFastTable->dataStorage()==CustomFastTableWidget::ColumnStorage);
+        TEST_STEP(mFastTable->isColumnDictionaryEncoded(1));
+        TEST_STEP(!mFastTable->isColumnDictionaryEncoded(0));
+        TEST_STEP(aColumn->dictionaryCount()==4);
+        TEST_STEP(mFastTable->text(0, 1)=="BUY" && mFastTable->text(998, 1)=="SHORT" && mFastTable->text(500, 2)=="");
+        TEST_STEP(aColumn->code(3)==aColumn->findCode("BUY") && aColumn->findCode("CLOSE")==-1);
+
+        QVector<int> aOrder=aColumn->codeOrder();
+
+        TEST_STEP(aOrder.at(aColumn->findCode("BUY"))<aOrder.at(aColumn->findCode("SELL")));
+        TEST_STEP(aOrder.at(aColumn->findCode("SELL"))<aOrder.at(aColumn->findCode("SHORT")));
+
+        // Equality filter compares codes only
+        int aBuyCode=aColumn->findCode("BUY");
+        int aBuyRows=0;
+
+        for (int i=0; i<mFastTable->rowCount(); ++i)
+        {
+            if (aColumn->code(i)==aBuyCode)
+            {
+                ++aBuyRows;
+            }
+        }
+
+        TEST_STEP(aBuyRows==334);
+
+        mFastTable->setText(1, 1, "CLOSE");
+        mFastTable->insertRows(0, 10);
+        mFastTable->removeRows(500, 100);
+
+        TEST_STEP(mFastTable->text(0, 1)=="" && mFastTable->text(10, 1)=="BUY" && mFastTable->text(11, 1)=="CLOSE");
+        TEST_STEP(mFastTable->text(500, 1)==aSides.at(590 % 3) && mFastTable->text(500, 0)=="590");
+        TEST_STEP(aColumn->dictionaryCount()==5);
+
+        mFastTable->setColumnDictionaryEncoded(1, false);
+
+        TEST_STEP(!mFastTable->isColumnDictionaryEncoded(1));
+        TEST_STEP(mFastTable->text(11, 1)=="CLOSE" && mFastTable->text(12, 1)=="SHORT");
+
+        mFastTable->setDataStorage(CustomFastTableWidget::RowStorage);
+        mData=((PublicCustomFastTable*)mFastTable)->getData();
+
+        TEST_STEP(checkForSizes(910, 3, 1, 1));
+        TEST_STEP(mFastTable->textColumn(1)==0);
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "Dictionary encoded columns");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": CellBlock";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        CellBlock aBlock;
+        aBlock.reset(QRect(2, 10, 3, 4));
+
+        TEST_STEP(aBlock.cellCount()==12);
+        TEST_STEP(aBlock.fields()==CellBlock::NoFields);
+        TEST_STEP(aBlock.indexOf(10, 2)==0 && aBlock.indexOf(10, 4)==2 && aBlock.indexOf(13, 4)==11);
+        TEST_STEP(aBlock.indexOf(9, 2)==-1 && aBlock.indexOf(10, 5)==-1 && aBlock.indexOf(14, 3)==-1);
+
+        aBlock.texts()[aBlock.indexOf(11, 3)]="Text";
+        aBlock.textFlags().fill(Qt::AlignCenter);
+
+        TEST_STEP(aBlock.hasField(CellBlock::Texts) && aBlock.hasField(CellBlock::TextFlags));
+        TEST_STEP(!aBlock.hasField(CellBlock::BackgroundBrushes) && !aBlock.hasField(CellBlock::Fonts));
+        TEST_STEP(aBlock.text(4)=="Text" && aBlock.text(5)=="" && aBlock.textFlag(11)==Qt::AlignCenter);
+
+        aBlock.reset(QRect());
+
+        TEST_STEP(aBlock.cellCount()==0 && aBlock.fields()==CellBlock::NoFields && aBlock.indexOf(0, 0)==-1);
+
+        testCompleted(success, "CellBlock");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Asynchronous data provider";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        PublicAsyncDataProvider aProvider(10);
+        aProvider.setPrefetchBlocks(2);
+
+        mFastTable->clear();
+        mFastTable->setSizes(1000, 2, 1, 1);
+        mFastTable->scrollToTop();
+        mFastTable->setAsyncDataProvider(&aProvider);
+
+        QRect aVisibleRange=mFastTable->visibleRange();
+
+        TEST_STEP(mFastTable->asyncDataProvider()==&aProvider);
+        TEST_STEP(aVisibleRange.top()==0);
+
+        // Visible blocks and two blocks below are loaded
+        int aLastBlock=aVisibleRange.bottom()/aProvider.blockSize()+2;
+
+        QElapsedTimer aTimer;
+        aTimer.start();
+
+        while (!aProvider.isRowLoaded(aLastBlock*aProvider.blockSize()) && aTimer.elapsed()<5000)
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+
+        TEST_STEP(aProvider.isRowLoaded(0) && aProvider.isRowLoaded(aLastBlock*aProvider.blockSize()+9));
+        TEST_STEP(!aProvider.isRowLoaded((aLastBlock+1)*aProvider.blockSize()));
+        TEST_STEP(aProvider.text(5, 1)=="Row 5" && aProvider.text(aLastBlock*aProvider.blockSize(), 0)==QString::number(aLastBlock*aProvider.blockSize()));
+        TEST_STEP(aProvider.getLoadedBlocks().length()==aLastBlock+1);
+        TEST_STEP(aProvider.getLoadedBlocks().at(0)==0);
+
+        mFastTable->removeRows(0, 5);
+
+        TEST_STEP(!aProvider.isRowLoaded(0));
+
+        aTimer.restart();
+
+        while (!aProvider.isRowLoaded(0) && aTimer.elapsed()<5000)
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+
+        TEST_STEP(aProvider.text(0, 1)=="Row 0");
+
+        // Loaded blocks keep old columns, so they are loaded again
+        mFastTable->insertColumns(0, 1);
+
+        TEST_STEP(!aProvider.isRowLoaded(0));
+
+        aTimer.restart();
+
+        while (!aProvider.isRowLoaded(0) && aTimer.elapsed()<5000)
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+
+        TEST_STEP(aProvider.isRowLoaded(0));
+
+        mFastTable->removeColumns(0, 1);
+
+        TEST_STEP(!aProvider.isRowLoaded(0));
+
+        mFastTable->setAsyncDataProvider(0);
+
+        TEST_STEP(mFastTable->asyncDataProvider()==0);
+        TEST_STEP(!aProvider.isThreadRunning());
+
+        mFastTable->setSizes(5, 3, 1, 1);
+
+        testCompleted(success, "Asynchronous data provider");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Row block cache";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        QList<QStringList> aRows;
+        aRows.append(QStringList()<<"a"<<"b");
+        aRows.append(QStringList()<<"c"<<"d");
+
+        RowBlockCache aCache(2);
+
+        aCache.insert(0, aRows);
+
+        qint64 aBlockBytes=aCache.usedBytes();
+
+        TEST_STEP(aBlockBytes>0 && aCache.count()==1);
+
+        // Least recently used block is evicted
+        aCache.setBudget(aBlockBytes*2);
+        aCache.insert(1, aRows);
+
+        TEST_STEP(aCache.rows(0)!=0);
+
+        aCache.insert(2, aRows);
+
+        TEST_STEP(aCache.contains(0) && !aCache.contains(1) && aCache.contains(2));
+        TEST_STEP(aCache.usedBytes()==aBlockBytes*2);
+        TEST_STEP(aCache.rows(1)==0);
+        TEST_STEP(aCache.hits()==1 && aCache.misses()==1);
+
+        // Pinned block is kept even if it is the least recently used
+        aCache.setPinnedRows(0, 1);
+        aCache.rows(2);
+        aCache.insert(3, aRows);
+
+        TEST_STEP(aCache.contains(0) && !aCache.contains(2) && aCache.contains(3));
+        TEST_STEP(aCache.text(1, 1)=="d" && aCache.text(4, 0)=="" && aCache.containsRow(7) && !aCache.containsRow(8));
+
+        aCache.removeRows(1, 1);
+
+        TEST_STEP(!aCache.contains(0) && aCache.count()==1);
+
+        aCache.resetCounters();
+
+        TEST_STEP(aCache.hits()==0 && aCache.misses()==0);
+
+        aCache.clear();
+
+        TEST_STEP(aCache.count()==0 && aCache.usedBytes()==0);
+
+        if (mData)
+        {
+            mFastTable->clear();
+            mFastTable->setSizes(300, 2, 1, 1);
+            mFastTable->setText(260, 1, "x");
+            mFastTable->setRowCacheEnabled(true);
+
+            RowBlockCache *aRowCache=mFastTable->rowCache();
+
+            TEST_STEP(mFastTable->isRowCacheEnabled() && aRowCache->count()==0);
+
+            // The whole block of rows is cached on first access
+            TEST_STEP(((PublicCustomFastTable*)mFastTable)->getCachedText(260, 1)=="x");
+            TEST_STEP(aRowCache->contains(1) && aRowCache->containsRow(299) && !aRowCache->contains(0));
+            TEST_STEP(((PublicCustomFastTable*)mFastTable)->getCachedText(299, 0)=="");
+            TEST_STEP(aRowCache->hits()==1 && aRowCache->misses()==1);
+
+            mFastTable->setText(260, 1, "y");
+
+            TEST_STEP(!aRowCache->contains(1));
+            TEST_STEP(((PublicCustomFastTable*)mFastTable)->getCachedText(260, 1)=="y");
+
+            mFastTable->insertColumn(0);
+
+            TEST_STEP(aRowCache->count()==0);
+
+            mFastTable->setRowCacheEnabled(false);
+
+            TEST_STEP(!mFastTable->isRowCacheEnabled() && mFastTable->rowCache()==0);
+
+            mFastTable->setSizes(5, 3, 1, 1);
+        }
+
+        testCompleted(success, "Row block cache");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": Mapped CSV file";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        QString aFileName=QDir::tempPath()+"/fasttable_mapped_test.csv";
+
+        QFile aOutput(aFileName);
+        aOutput.open(QIODevice::WriteOnly);
+        aOutput.write("\xEF\xBB\xBF" "id,name,note\r\n");
+        aOutput.write("1,Alpha,\"a, b\"\r\n");
+        aOutput.write("2,\"Be\"\"ta\",\"multi\nline\"\r\n");
+        aOutput.write("3,Gamma,needle\n");
+        aOutput.write("4,Delta\xE2\x84\xAA");
+        aOutput.close();
+
+        MappedCsvFile aFile;
+
+        TEST_STEP(aFile.open(aFileName));
+        TEST_STEP(aFile.isOpen() && aFile.delimiter()==',');
+
+        QElapsedTimer aTimer;
+        aTimer.start();
+
+        while (aFile.isIndexing() && aTimer.elapsed()<5000)
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        }
+
+        TEST_STEP(!aFile.isIndexing() && aFile.progress()==100);
+        TEST_STEP(aFile.rowCount()==5 && aFile.columnCount()==3);
+        TEST_STEP(aFile.text(0, 0)=="id" && aFile.text(1, 2)=="a, b");
+        TEST_STEP(aFile.text(2, 1)=="Be\"ta" && aFile.text(2, 2)=="multi\nline");
+        TEST_STEP(aFile.text(4, 1)==QString::fromUtf8("Delta\xE2\x84\xAA") && aFile.text(4, 2)=="");
+        TEST_STEP(aFile.rowTexts(3)==(QStringList()<<"3"<<"Gamma"<<"needle"));
+        TEST_STEP(aFile.rowMayContain(3, "NEEDLE") && !aFile.rowMayContain(1, "needle"));
+
+        // KELVIN SIGN is folded to 'k' like QString::contains() does
+        TEST_STEP(aFile.rowMayContain(4, "deltak") && !aFile.rowMayContain(4, "deltak", Qt::CaseSensitive));
+        TEST_STEP(MappedCsvFile::parseRecord("x;\"y;z\"", 7, ';')==(QStringList()<<"x"<<"y;z"));
+
+        if (mData)
+        {
+            mFastTable->clear();
+            mFastTable->setMappedCsvFile(&aFile);
+
+            TEST_STEP(mFastTable->mappedCsvFile()==&aFile);
+            TEST_STEP(mFastTable->rowCount()==5 && mFastTable->columnCount()==3);
+            TEST_STEP(mFastTable->text(2, 1)=="Be\"ta");
+
+            mFastTable->setCurrentCell(0, 0);
+            mFastTable->searchNext("needle");
+
+            TEST_STEP(mFastTable->currentRow()==3 && mFastTable->currentColumn()==2);
+
+            // Closed file leaves empty table
+            aFile.close();
+
+            TEST_STEP(mFastTable->rowCount()==0);
+
+            mFastTable->setMappedCsvFile(0);
+
+            TEST_STEP(mFastTable->mappedCsvFile()==0);
+
+            mFastTable->setSizes(5, 3, 1, 1);
+        }
+
+        aFile.close();
+        QFile::remove(aFileName);
+
+        testCompleted(success, "Mapped CSV file");
+    }
+    // ----------------------------------------------------------------
+    qDebug()<<"TEST"<<(testNumber++)<<": CSV import";
+    // ----------------------------------------------------------------
+    {
+        success=true;
+
+        QString aFileName=QDir::tempPath()+"/fasttable_import_test.tsv";
+
+        QFile aOutput(aFileName);
+        aOutput.open(QIODevice::WriteOnly);
+
+        for (int i=0; i<1000; ++i)
+        {
+            aOutput.write(QString("%1\t\"Row\n%1\"\t\"\"\"%1\"\"\"\r\n").arg(i).toUtf8());
+        }
+
+        aOutput.write("Last");
+        aOutput.close();
+
+        CsvImporter aImporter;
+
+        // Small chunks have borders inside quoted fields
+        aImporter.setChunkSize(10);
+
+        TEST_STEP(aImporter.chunkSize()==10);
+        TEST_STEP(aImporter.start(aFileName, '\t'));
+
+        aImporter.wait();
+
+        TEST_STEP(!aImporter.isRunning() && !aImporter.isCancelled());
+        TEST_STEP(aImporter.rowCount()==1001 && aImporter.columnCount()==3);
+        TEST_STEP(aImporter.rowsPerSecond()>0);
+
+        QList<QStringList> aRows=aImporter.takeRows();
+
+        TEST_STEP(aRows.length()==1001 && aImporter.rowCount()==0);
+        TEST_STEP(aRows.at(0)==(QStringList()<<"0"<<"Row\n0"<<"\"0\""));
+        TEST_STEP(aRows.at(999).at(2)=="\"999\"" && aRows.at(1000)==(QStringList()<<"Last"));
+
+        if (mData)
+        {
+            mFastTable->clear();
+            mFastTable->setTexts(aRows);
+
+            TEST_STEP(mFastTable->rowCount()==1001 && mFastTable->columnCount()==3);
+            TEST_STEP(mFastTable->text(500, 1)=="Row\n500" && mFastTable->text(1000, 0)=="Last" && mFastTable->text(1000, 2)=="");
+
+            mFastTable->setSizes(5, 3, 1, 1);
+        }
+
+        // Cancelled import doesn't give rows
+        TEST_STEP(aImporter.start(aFileName, '\t'));
+
+        aImporter.cancel();
+        aImporter.wait();
+
+        TEST_STEP(aImporter.isCancelled() && aImporter.rowCount()==0);
+
+        QFile::remove(aFileName);
+
+        testCompleted(success, "CSV import");
+    }
+}
+
+bool TestFrame::checkForSizes(int rows, int columns, int headerRows, int headerColumns)
+{
+    bool success=true;
+
+    TEST_STEP(((PublicCustomFastTable*)mFastTable)->getRowCount()==rows);
+    TEST_STEP(((PublicCustomFastTable*)mFastTable)->getColumnCount()==columns);
+    TEST_STEP(((PublicCustomFastTable*)mFastTable)->horizontalHeader_GetRowCount()==headerRows);
+    TEST_STEP(((PublicCustomFastTable*)mFastTable)->verticalHeader_GetColumnCount()==headerColumns);
+
+    TEST_STEP((mData==0                                   || mData->length()==rows));
+    TEST_STEP((mRowHeights==0                             || mRowHeights->length()==rows));
+    TEST_STEP((mColumnWidths==0                           || mColumnWidths->length()==columns));
+    TEST_STEP((mOffsetX==0                                || mOffsetX->length()==columns));
+    TEST_STEP((mOffsetY==0                                || mOffsetY->length()==rows));
+
+    TEST_STEP((mHorizontalHeader_Data==0                  || mHorizontalHeader_Data->length()==headerRows                  || rows<=0 || columns<=0));
+    TEST_STEP((mHorizontalHeader_RowHeights==0            || mHorizontalHeader_RowHeights->length()==headerRows            || rows<=0 || columns<=0));
+    TEST_STEP((mHorizontalHeader_OffsetY==0               || mHorizontalHeader_OffsetY->length()==headerRows               || rows<=0 || columns<=0));
+
+    TEST_STEP((mVerticalHeader_Data==0                    || mVerticalHeader_Data->length()==rows                          || rows<=0 || columns<=0));
+    TEST_STEP((mVerticalHeader_ColumnWidths==0            || mVerticalHeader_ColumnWidths->length()==headerColumns         || rows<=0 || columns<=0));
+    TEST_STEP((mVerticalHeader_OffsetX==0                 || mVerticalHeader_OffsetX->length()==headerColumns              || rows<=0 || columns<=0));
+
+    TEST_STEP((mSelection==0                              || mSelection->rowCount()==rows));
+    TEST_STEP((mSelection==0                              || mSelection->columnCount()==columns));
+
+    TEST_STEP((mCellStyles==0                             || mCellStyles->isEmpty() || mCellStyles->length()==rows));
+    TEST_STEP((mHorizontalHeader_CellStyles==0            || mHorizontalHeader_CellStyles->isEmpty() || mHorizontalHeader_CellStyles->length()==headerRows || rows<=0 || columns<=0));
+    TEST_STEP((mVerticalHeader_CellStyles==0              || mVerticalHeader_CellStyles->isEmpty() || mVerticalHeader_CellStyles->length()==rows || rows<=0 || columns<=0));
+
+
+    CHECK_COLUMN_COUNT(mData);
+    CHECK_COLUMN_COUNT(mHorizontalHeader_Data);
+    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_Data);
+
+    CHECK_COLUMN_COUNT(mCellStyles);
+    CHECK_COLUMN_COUNT(mHorizontalHeader_CellStyles);
+    CHECK_VERTICAL_COLUMN_COUNT(mVerticalHeader_CellStyles);
+
+    CHECK_SPANS(mSpans, rows, columns);
+    CHECK_SPANS(mHorizontalHeader_Spans, headerRows, columns);
+    CHECK_SPANS(mVerticalHeader_Spans, rows, headerColumns);
+
+    return success;
+}
+
+void TestFrame::addTestLabel(QString aTestName)
+{
+    int aCount=ui->testGridLayout->count()/3;
+    int row=aCount%25;
+    int column=aCount/25*3;
+
+    QLabel *aLabel;
+
+    //------
+
+    aLabel=new QLabel(QString::number(aCount+1), this);
+
+    ui->testGridLayout->addWidget(aLabel, row, column);
+
+    //------
+
+    aLabel=new QLabel(aTestName, this);
+
+    aLabel->setAlignment(Qt::AlignVCenter | Qt::AlignRight);
+
+    ui->testGridLayout->addWidget(aLabel, row, column+1);
+
+    //------
+
+    aLabel=new QLabel("IN PROGRESS", this);
+
+    QFont aFont=aLabel->font();
+    aFont.setBold(true);
+    aLabel->setFont(aFont);
+
+    QPalette aPalette=aLabel->palette();
+    aPalette.setColor(QPalette::WindowText, QColor(0, 0, 255));
+    aLabel->setPalette(aPalette);
+
+    ui->testGridLayout->addWidget(aLabel, row, column+2);
+}
+
+QLabel* TestFrame::getLabel(QString aTestName)
+{
+    for (int i=1; i<ui->testGridLayout->count(); i+=3)
+    {
+        if (((QLabel*)ui->testGridLayout->itemAt(i)->widget())->text()==aTestName)
+        {
+            return (QLabel*)ui->testGridLayout->itemAt(i+1)->widget();
+        }
+    }
+
+    return 0;
+}
+
+void TestFrame::testCompleted(bool success, QString aTestName)
+{
+    if (success)
+    {
+        testSuccess(aTestName);
+    }
+    else
+    {
+        testFail(aTestName);
+    }
+}
+
+void TestFrame::testSuccess(QString aTestName)
+{
+    QLabel *aLabel=getLabel(aTestName);
+
+    QPalette aPalette;
+
+    aPalette.setColor(QPalette::WindowText, QColor(0, 128, 0));
+
+    aLabel->setText("SUCCESS");
+    aLabel->setPalette(aPalette);
+
+    emit testFinished();
+}
+
+void TestFrame::testFail(QString aTestName)
+{
+    QLabel *aLabel=getLabel(aTestName);
+
+    QPalette aPalette;
+
+    aPalette.setColor(QPalette::WindowText, QColor(128, 0, 0));
+
+    aLabel->setText("FAIL");
+    aLabel->setPalette(aPalette);
+
+    qWarning()<<"FAIL";
+
+    emit testFinished();
+}
+
+void TestFrame::testNotSupported(QString aTestName)
+{
+    QLabel *aLabel=getLabel(aTestName);
+
+    QPalette aPalette;
+
+    aPalette.setColor(QPalette::WindowText, QColor(0, 128, 128));
+
+    aLabel->setText("NOT SUPPORTED");
+    aLabel->setPalette(aPalette);
+
+    emit testFinished();
+}
+
+void TestFrame::fastTableSelectionChanged(const QList<QRect> &selected, const QList<QRect> &deselected)
+{
+    mSelectionChangedCount++;
+    mSelectedRanges=selected;
+    mDeselectedRanges=deselected;
+}
+
+void TestFrame::fastTableCurrentCellChanged(int /*currentRow*/, int /*currentColumn*/, int previousRow, int previousColumn)
+{
+    mCurrentCellChangedCount++;
+    mPreviousCurrentCell=QPoint(previousColumn, previousRow);
+}
+
+void TestFrame::fastTableCellChanged(int /*row*/, int /*column*/)
+{
+    mCellChangedCount++;
 }
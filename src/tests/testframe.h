@@ -45,6 +45,21 @@
                                               }\
                                           }
 
+#define CELL_STYLE(cellStyles, row, column) (cellStyles->isEmpty() ? 0 : cellStyles->at(row).at(column))
+
+#define CHECK_SPANS(spans, rowCount, columnCount) if (success && spans)\
+                                                  {\
+                                                      for (int i=0; i<spans->spans().length(); ++i)\
+                                                      {\
+                                                          TEST_STEP(QRect(0, 0, columnCount, rowCount).contains(spans->spans().at(i)))\
+                                                          \
+                                                          if (!success)\
+                                                          {\
+                                                              break;\
+                                                          }\
+                                                      }\
+                                                  }
+
 namespace Ui {
     class TestFrame;
 }
@@ -55,10 +70,10 @@ class TestFrame : public QWidget
 
 public:
     QList< QStringList >     *mData;
-    QList< qint16 >          *mRowHeights;
-    QList< qint16 >          *mColumnWidths;
-    QList< int >             *mOffsetX;
-    QList< int >             *mOffsetY;
+    SizeList                 *mRowHeights;
+    SizeList                 *mColumnWidths;
+    OffsetIndex              *mOffsetX;
+    OffsetIndex              *mOffsetY;
 
     QList< QStringList >     *mHorizontalHeader_Data;
     QList< qint16 >          *mHorizontalHeader_RowHeights;
@@ -68,40 +83,27 @@ public:
     QList< qint16 >          *mVerticalHeader_ColumnWidths;
     QList< int >             *mVerticalHeader_OffsetX;
 
-    QList< QList<bool> >     *mSelectedCells;
-    QList< QPoint >          *mCurSelection;
-    QList< int >             *mHorizontalHeader_SelectedColumns;
-    QList< int >             *mVerticalHeader_SelectedRows;
-
-    QList< QList<QBrush *> > *mBackgroundBrushes;
-    QList< QList<QColor *> > *mForegroundColors;
-    QList< QList<QFont *> >  *mCellFonts;
-    QList< QList<int> >      *mCellTextFlags;
-    QList< QList<quint16> >  *mCellMergeX;
-    QList< QList<quint16> >  *mCellMergeY;
-    QList< QList<int> >      *mCellMergeParentRow;
-    QList< QList<int> >      *mCellMergeParentColumn;
-    QList< QRect >           *mMerges;
-
-    QList< QList<QBrush *> > *mHorizontalHeader_BackgroundBrushes;
-    QList< QList<QColor *> > *mHorizontalHeader_ForegroundColors;
-    QList< QList<QFont *> >  *mHorizontalHeader_CellFonts;
-    QList< QList<int> >      *mHorizontalHeader_CellTextFlags;
-    QList< QList<quint16> >  *mHorizontalHeader_CellMergeX;
-    QList< QList<quint16> >  *mHorizontalHeader_CellMergeY;
-    QList< QList<int> >      *mHorizontalHeader_CellMergeParentRow;
-    QList< QList<int> >      *mHorizontalHeader_CellMergeParentColumn;
-    QList< QRect >           *mHorizontalHeader_Merges;
-
-    QList< QList<QBrush *> > *mVerticalHeader_BackgroundBrushes;
-    QList< QList<QColor *> > *mVerticalHeader_ForegroundColors;
-    QList< QList<QFont *> >  *mVerticalHeader_CellFonts;
-    QList< QList<int> >      *mVerticalHeader_CellTextFlags;
-    QList< QList<quint16> >  *mVerticalHeader_CellMergeX;
-    QList< QList<quint16> >  *mVerticalHeader_CellMergeY;
-    QList< QList<int> >      *mVerticalHeader_CellMergeParentRow;
-    QList< QList<int> >      *mVerticalHeader_CellMergeParentColumn;
-    QList< QRect >           *mVerticalHeader_Merges;
+    SelectionRanges          *mSelection;
+
+    StyleTable               *mStyles;
+    QList< QList<int> >      *mCellStyles;
+    SpanIndex                *mSpans;
+
+    StyleTable               *mHorizontalHeader_Styles;
+    QList< QList<int> >      *mHorizontalHeader_CellStyles;
+    SpanIndex                *mHorizontalHeader_Spans;
+
+    StyleTable               *mVerticalHeader_Styles;
+    QList< QList<int> >      *mVerticalHeader_CellStyles;
+    SpanIndex                *mVerticalHeader_Spans;
+
+    int                       mSelectionChangedCount;
+    QList< QRect >            mSelectedRanges;
+    QList< QRect >            mDeselectedRanges;
+
+    int                       mCurrentCellChangedCount;
+    QPoint                    mPreviousCurrentCell;
+    int                       mCellChangedCount;
 
     //---------------------------------------------------------------------------
 
@@ -124,6 +126,11 @@ public:
     inline void testFail(QString aTestName);
     inline void testNotSupported(QString aTestName);
 
+public slots:
+    void fastTableSelectionChanged(const QList<QRect> &selected, const QList<QRect> &deselected);
+    void fastTableCurrentCellChanged(int currentRow, int currentColumn, int previousRow, int previousColumn);
+    void fastTableCellChanged(int row, int column);
+
 signals:
     void testFinished();
 };